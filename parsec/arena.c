@@ -11,6 +11,7 @@
 #include "parsec/data_internal.h"
 #include "parsec/utils/debug.h"
 #include "parsec/papi_sde.h"
+#include "parsec/live_metrics.h"
 #include <limits.h>
 
 #if defined(PARSEC_PROF_TRACE_ACTIVE_ARENA_SET)
@@ -112,6 +113,7 @@ static void parsec_arena_destructor(parsec_arena_t* arena)
             PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, "Arena:\tfree element base ptr %p, data ptr %p (from arena %p)",
                                 item, ((parsec_arena_chunk_t*)item)->data, arena);
             TRACE_FREE(arena_memory_free_key, -arena->elem_size, item);
+            parsec_live_arena(0, -(int64_t)arena->elem_size);
             arena->data_free(item);
         }
         PARSEC_OBJ_DESTRUCT(&arena->area_lifo);
@@ -142,6 +144,7 @@ parsec_arena_get_chunk( parsec_arena_t *arena, size_t size, parsec_data_allocate
             size = sizeof( parsec_list_item_t );
         item = (parsec_list_item_t *)alloc( size );
         TRACE_MALLOC(arena_memory_alloc_key, size, item);
+        parsec_live_arena(0, arena->elem_size);
         PARSEC_OBJ_CONSTRUCT(item, parsec_list_item_t);
         assert(NULL != item);
     }
@@ -156,6 +159,7 @@ parsec_arena_release_chunk(parsec_arena_t* arena,
                           parsec_arena_chunk_t *chunk)
 {
     TRACE_FREE(arena_memory_unused_key, -arena->elem_size*chunk->count, chunk);
+    parsec_live_arena(-(int64_t)(arena->elem_size*chunk->count), 0);
 
     if( (chunk->count == 1) && (arena->released < arena->max_released) ) {
         PARSEC_DEBUG_VERBOSE(10, parsec_debug_output, "Arena:\tpush a data of size %zu from arena %p, aligned by %zu, base ptr %p, data ptr %p, sizeof prefix %zu(%zd)",
@@ -171,6 +175,7 @@ parsec_arena_release_chunk(parsec_arena_t* arena,
             arena->elem_size, chunk->count, arena, arena->alignment, chunk, chunk->data, sizeof(parsec_arena_chunk_t),
             PARSEC_ARENA_MIN_ALIGNMENT(arena->alignment));
     TRACE_FREE(arena_memory_free_key, -arena->elem_size*chunk->count, chunk);
+    parsec_live_arena(0, -(int64_t)(arena->elem_size*chunk->count));
     if(arena->max_used != 0 && arena->max_used != INT32_MAX)
         (void)parsec_atomic_fetch_sub_int32(&arena->used, chunk->count);
     arena->data_free(chunk);
@@ -207,6 +212,7 @@ int  parsec_arena_allocate_device_private(parsec_data_copy_t *copy,
         PARSEC_OBJ_CONSTRUCT(&chunk->item, parsec_list_item_t);
 
         TRACE_MALLOC(arena_memory_alloc_key, size, chunk);
+        parsec_live_arena(0, arena->elem_size * count);
     }
     if(NULL == chunk) return PARSEC_ERR_OUT_OF_RESOURCE;  /* no more */
 
@@ -214,6 +220,7 @@ int  parsec_arena_allocate_device_private(parsec_data_copy_t *copy,
     PARSEC_LIST_ITEM_SINGLETON( &chunk->item );
 #endif
     TRACE_MALLOC(arena_memory_used_key, size, chunk);
+    parsec_live_arena(arena->elem_size * count, 0);
 
     chunk->origin = arena;
     chunk->count = count;
@@ -6,9 +6,29 @@
 
 #include "parsec/parsec_config.h"
 #include "parsec/class/barrier.h"
+#include "parsec/sys/atomic.h"
 
 #if PARSEC_IMPLEMENT_BARRIERS
 
+#include <limits.h>
+#if defined(PARSEC_HAVE_FUTEX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif  /* defined(PARSEC_HAVE_FUTEX) */
+
+/* Polls of the generation before going to sleep, a few microseconds: long
+ * enough to cover the arrival of the other threads of a short round, short
+ * enough not to matter when the barrier is only crossed at the end of the
+ * run. */
+#define PARSEC_BARRIER_SPIN_COUNT 4096
+
+static inline void parsec_barrier_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__ ("pause");
+#endif
+}
+
 int parsec_barrier_init(parsec_barrier_t* barrier, const void* attr, unsigned int count)
 {
     int rc;
@@ -20,6 +40,13 @@ int parsec_barrier_init(parsec_barrier_t* barrier, const void* attr, unsigned in
     barrier->count      = count;
     barrier->curcount   = 0;
     barrier->generation = 0;
+    barrier->sleepers   = 0;
+    /* Spinning threads would steal the processor of the threads they wait for */
+    barrier->spin       = PARSEC_BARRIER_SPIN_COUNT;
+#if defined(PARSEC_HAVE_SYSCONF)
+    if( (long)count > sysconf(_SC_NPROCESSORS_ONLN) )
+        barrier->spin = 0;
+#endif  /* defined(PARSEC_HAVE_SYSCONF) */
     if( 0 != (rc = pthread_cond_init(&(barrier->cond), NULL)) ) {
         pthread_mutex_destroy( &(barrier->mutex) );
         return rc;
@@ -29,25 +56,51 @@ int parsec_barrier_init(parsec_barrier_t* barrier, const void* attr, unsigned in
 
 int parsec_barrier_wait(parsec_barrier_t* barrier)
 {
-    int generation;
+    /* The generation cannot change before this thread arrives */
+    int32_t generation = barrier->generation;
+    int i;
 
-    pthread_mutex_lock( &(barrier->mutex) );
-    if( (barrier->curcount + 1) == barrier->count) {
-        barrier->generation++;
+    if( (parsec_atomic_fetch_inc_int32(&barrier->curcount) + 1) == barrier->count ) {
         barrier->curcount = 0;
-        pthread_cond_broadcast( &(barrier->cond) );
-        pthread_mutex_unlock( &(barrier->mutex) );
+        /* Release the others; the full barrier of the increment orders it
+         * with the read of the sleepers, see below */
+        (void)parsec_atomic_fetch_inc_int32(&barrier->generation);
+        if( 0 != barrier->sleepers ) {
+#if defined(PARSEC_HAVE_FUTEX)
+            syscall(SYS_futex, &barrier->generation, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+            pthread_mutex_lock( &(barrier->mutex) );
+            pthread_cond_broadcast( &(barrier->cond) );
+            pthread_mutex_unlock( &(barrier->mutex) );
+#endif  /* defined(PARSEC_HAVE_FUTEX) */
+        }
         return 1;
     }
-    barrier->curcount++;
-    generation = barrier->generation;
-    for(;;) {
+
+    for( i = 0; i < barrier->spin; i++ ) {
+        if( generation != barrier->generation )
+            return 0;
+        parsec_barrier_relax();
+    }
+
+    /* A sleeper registers before checking the generation a last time, the
+     * last thread bumps the generation before checking for sleepers: one of
+     * them sees the other. */
+#if defined(PARSEC_HAVE_FUTEX)
+    (void)parsec_atomic_fetch_inc_int32(&barrier->sleepers);
+    while( generation == barrier->generation ) {
+        syscall(SYS_futex, &barrier->generation, FUTEX_WAIT_PRIVATE, generation, NULL, NULL, 0);
+    }
+    (void)parsec_atomic_fetch_dec_int32(&barrier->sleepers);
+#else
+    pthread_mutex_lock( &(barrier->mutex) );
+    (void)parsec_atomic_fetch_inc_int32(&barrier->sleepers);
+    while( generation == barrier->generation ) {
         pthread_cond_wait( &(barrier->cond), &(barrier->mutex) );
-        if( generation != barrier->generation ) {
-            break;
-        }
     }
+    (void)parsec_atomic_fetch_dec_int32(&barrier->sleepers);
     pthread_mutex_unlock( &(barrier->mutex) );
+#endif  /* defined(PARSEC_HAVE_FUTEX) */
     return 0;
 }
 
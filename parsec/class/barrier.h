@@ -19,7 +19,13 @@
  *
  *  @brief Synchronization barriers between threads of a same node
  *
- *  @details This follows the implementation of pthread_barrier(3)
+ *  @details This follows the API of pthread_barrier(3). The threads
+ *  count their arrivals on a shared counter, and the last thread to arrive
+ *  resets the counter and releases the others by bumping a generation
+ *  number, so the barrier can be crossed again right away. The others spin
+ *  on the generation for a while (only when there are no more threads than
+ *  processors), then sleep on it, on a futex where available, on a
+ *  condition otherwise.
  *
  */
 
@@ -54,9 +60,13 @@ typedef pthread_barrier_t parsec_barrier_t;
  */
 typedef struct parsec_barrier_t {
     int                 count;       /**< Number of threads expected to enter the barrier */
-    volatile int        curcount;    /**< Number of threads currently inside the barrier */
-    volatile int        generation;  /**< Unique number used to count how many times this
-                                      *   barrier was used, and enable debugging unmatching barriers */
+    int                 spin;        /**< Number of polls of the generation before sleeping */
+    volatile int32_t    curcount;    /**< Number of threads currently inside the barrier */
+    volatile int32_t    generation;  /**< Unique number used to count how many times this
+                                      *   barrier was used, the threads inside the barrier
+                                      *   wait for it to change */
+    volatile int32_t    sleepers;    /**< Number of threads sleeping on the generation, the
+                                      *   last thread only wakes them up when there are some */
     pthread_mutex_t     mutex;       /**< Lock on the barrier, to make threads wait passively */
     pthread_cond_t      cond;        /**< Condition on the barrier, to allow waking up threads that wait
                                       *   passively once all threads have joined the barrier */
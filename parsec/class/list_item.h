@@ -275,6 +275,106 @@ parsec_list_item_ring_push_sorted( parsec_list_item_t* ring,
     return ring;
 }
 
+/**
+ * @brief
+ *   Add an item at the head of an items ring
+ *
+ * @details
+ *   item becomes the first item of ring. Sorting the resulting ring with
+ *   parsec_list_item_ring_sort gives the same order as inserting each item
+ *   with parsec_list_item_ring_push_sorted, in O(n log n) instead of O(n^2).
+ * @param[inout] ring the ring of items, or NULL
+ * @param[inout] item the item to add
+ * @return item, the head of the newly formed ring of items
+ * @remark This function is not thread safe
+ */
+static inline parsec_list_item_t*
+parsec_list_item_ring_push_front( parsec_list_item_t* ring,
+                                  parsec_list_item_t* item )
+{
+    parsec_list_item_singleton(item);
+    if( NULL != ring ) {
+        parsec_list_item_ring_push(ring, item);
+    }
+    return item;
+}
+
+/* Merge two NULL terminated chains sorted by decreasing priority; on equal
+ * priorities the items of a come first. */
+static inline parsec_list_item_t*
+parsec_list_item_chain_merge_sorted( parsec_list_item_t* a,
+                                     parsec_list_item_t* b,
+                                     size_t off )
+{
+    parsec_list_item_t *head = NULL, *tail = NULL, *e;
+
+    while( NULL != a || NULL != b ) {
+        if( NULL == b || (NULL != a && !A_LOWER_PRIORITY_THAN_B(a, b, off)) ) {
+            e = a; a = (parsec_list_item_t*)a->list_next;
+        } else {
+            e = b; b = (parsec_list_item_t*)b->list_next;
+        }
+        if( NULL == tail ) head = e;
+        else tail->list_next = e;
+        tail = e;
+        if( NULL == a ) { tail->list_next = b; break; }
+        if( NULL == b ) { tail->list_next = a; break; }
+    }
+    return head;
+}
+
+/**
+ * @brief
+ *   Sort a ring of items by decreasing priority
+ *
+ * @details
+ *   Assuming there is an integer off bytes after the beginning of each item,
+ *   sorts the ring with a stable bottom-up merge sort: items of equal
+ *   priority keep their relative order.
+ * @param[inout] ring the ring of items, or NULL
+ * @param[in] off the offset where the integer to use to sort items can be found
+ * @return the head of the sorted ring of items
+ * @remark This function is not thread safe
+ */
+static inline parsec_list_item_t*
+parsec_list_item_ring_sort( parsec_list_item_t* ring,
+                            size_t off )
+{
+    /* bins[i] is a sorted chain of 2^i items, coming before the ones of bins[j<i] in the ring */
+    parsec_list_item_t *bins[8 * sizeof(size_t)] = { NULL };
+    parsec_list_item_t *item, *next, *carry, *prev;
+    int i, max = 0;
+
+    if( NULL == ring || ring->list_next == ring ) return ring;
+
+    ((parsec_list_item_t*)ring->list_prev)->list_next = NULL;
+    for( item = ring; NULL != item; item = next ) {
+        next = (parsec_list_item_t*)item->list_next;
+        item->list_next = NULL;
+        carry = item;
+        for( i = 0; NULL != bins[i]; i++ ) {
+            carry = parsec_list_item_chain_merge_sorted(bins[i], carry, off);
+            bins[i] = NULL;
+        }
+        bins[i] = carry;
+        if( i > max ) max = i;
+    }
+    for( carry = NULL, i = 0; i <= max; i++ ) {
+        if( NULL == bins[i] ) continue;
+        carry = (NULL == carry) ? bins[i] : parsec_list_item_chain_merge_sorted(bins[i], carry, off);
+    }
+
+    /* restore the backward links, and close the ring */
+    for( prev = carry, item = (parsec_list_item_t*)carry->list_next;
+         NULL != item;
+         prev = item, item = (parsec_list_item_t*)item->list_next ) {
+        item->list_prev = prev;
+    }
+    prev->list_next = carry;
+    carry->list_prev = prev;
+    return carry;
+}
+
 /* This is debug helpers for list items accounting */
 /**
  * Don't include the implementation in the doxygen documentation
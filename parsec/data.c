@@ -10,6 +10,7 @@
 #include "parsec/mca/device/device.h"
 #include "parsec/utils/debug.h"
 #include "parsec/data_internal.h"
+#include "parsec/data_compress.h"
 #include "parsec/arena.h"
 #include "parsec/parsec_description_structures.h"
 #include "parsec/sys/atomic.h"
@@ -69,6 +70,8 @@ static void parsec_data_construct(parsec_data_t* obj )
     for( uint32_t i = 0; i < parsec_nb_devices;
          obj->device_copies[i] = NULL, i++ );
     obj->dc               = NULL;
+    obj->reshape_cache    = NULL;
+    obj->compressed       = NULL;
     obj->lock             = unlocked; /* Can't directly assign to PARSEC_ATOMIC_UNLOCKED because of C syntax */
     PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, "Allocate data %p", obj);
 }
@@ -76,6 +79,8 @@ static void parsec_data_construct(parsec_data_t* obj )
 static void parsec_data_destruct(parsec_data_t* obj )
 {
     PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, "Release data %p", obj);
+    parsec_reshape_cache_purge(obj, NULL);
+    parsec_data_compress_forget(obj, NULL);
     for( uint32_t i = 0; i < parsec_nb_devices; i++ ) {
         parsec_data_copy_t *copy = NULL;
         parsec_device_module_t *device = parsec_mca_device_get(i);
@@ -192,6 +197,10 @@ int parsec_data_copy_detach(parsec_data_t* data,
         return PARSEC_ERR_NOT_FOUND;
     }
     data->device_copies[device] = copy->older;
+    if( NULL != data->reshape_cache )
+        parsec_reshape_cache_purge(data, copy);
+    if( NULL != data->compressed )
+        parsec_data_compress_forget(data, copy);
 
     copy->original     = NULL;
     copy->older        = NULL;
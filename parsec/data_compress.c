@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/constants.h"
+#include "parsec/data_compress.h"
+#include "parsec/data_distribution.h"
+#include "parsec/parsec_internal.h"
+#include "parsec/mca/device/device.h"
+#include "parsec/class/list.h"
+#include "parsec/sys/atomic.h"
+#include "parsec/utils/debug.h"
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#if defined(PARSEC_HAVE_CLOCK_GETTIME)
+#include <time.h>
+#else
+#include <sys/time.h>
+#endif  /* defined(PARSEC_HAVE_CLOCK_GETTIME) */
+#if defined(PARSEC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif  /* defined(PARSEC_HAVE_UNISTD_H) */
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#if defined(MADV_DONTNEED) && defined(PARSEC_HAVE_UNISTD_H)
+#define PARSEC_DATA_COMPRESS_SUPPORTED 1
+#endif
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+
+/**
+ * The codec works on 64-bit words, and encodes the payload as a sequence of
+ * 32-bit tokens: runs of zero words, runs of words repeating the previous
+ * one, and runs of literal words copied after the token. This keeps the
+ * compression and the restoration at memory speed, and handles well the
+ * sparse or constant regions of the tiles. A tile is only kept compressed if
+ * the codec saves at least a quarter of its size.
+ */
+#define PARSEC_COMPRESS_TOKEN_ZEROS    0x0U
+#define PARSEC_COMPRESS_TOKEN_REPEAT   0x1U
+#define PARSEC_COMPRESS_TOKEN_LITERAL  0x2U
+#define PARSEC_COMPRESS_TOKEN_SHIFT    30
+#define PARSEC_COMPRESS_TOKEN_MAX      ((1U << PARSEC_COMPRESS_TOKEN_SHIFT) - 1)
+
+volatile int32_t parsec_data_compress_nb_collections = 0;
+
+/* Activity of all the collections, reported at parsec_fini */
+static parsec_data_compress_stats_t parsec_data_compress_totals;
+
+typedef struct parsec_data_compress_s {
+    parsec_atomic_lock_t          lock;      /**< protects the lists and resident */
+    parsec_list_t                 lru;       /**< uncompressed tiles, most recently used first */
+    parsec_list_t                 cold;      /**< tiles evicted from the lru, compressed or not */
+    size_t                        budget;    /**< bytes of tiles allowed in the lru */
+    size_t                        page_size;
+    int64_t                       resident;  /**< bytes of the tiles in the lru */
+    parsec_data_compress_stats_t  stats;     /**< updated atomically */
+} parsec_data_compress_t;
+
+/**
+ * Compression state of a tracked data, hanging from data->compressed and
+ * protected by the lock of the data. It is only freed with the data locked,
+ * so the eviction and the release, which find it through the lists of the
+ * collection, lock the data before releasing the lock of the collection.
+ */
+typedef struct parsec_data_compressed_s {
+    parsec_list_item_t      super;            /**< chained in the lru or in the cold list */
+    parsec_data_compress_t *ctx;
+    parsec_data_t          *data;
+    parsec_data_copy_t     *copy;             /**< the tracked copy of the collection */
+    parsec_list_t          *list;             /**< the list holding the tile */
+    void                   *blob;             /**< compressed pages, NULL when uncompressed */
+    size_t                  blob_size;
+    size_t                  offset;           /**< first compressed byte of the payload */
+    size_t                  length;           /**< bytes of the payload compressed (whole pages) */
+    uint32_t                rejected_version; /**< version of the copy that did not compress */
+    int                     rejected;
+} parsec_data_compressed_t;
+
+#define PARSEC_COMPRESS_STAT_ADD(ctx, field, value)                               \
+    do {                                                                          \
+        parsec_atomic_fetch_add_int64(&(ctx)->stats.field, (value));             \
+        parsec_atomic_fetch_add_int64(&parsec_data_compress_totals.field, (value)); \
+    } while(0)
+
+static inline int64_t parsec_data_compress_now(void)
+{
+#if defined(PARSEC_HAVE_CLOCK_GETTIME)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000000 + (int64_t)tv.tv_usec * 1000;
+#endif  /* defined(PARSEC_HAVE_CLOCK_GETTIME) */
+}
+
+/**
+ * Encode nb words of in into out, without writing more than limit bytes.
+ *
+ * @return the size of the encoded stream, or 0 if it exceeds limit.
+ */
+static size_t
+parsec_compress_words(const uint64_t *in, size_t nb, uint8_t *out, size_t limit)
+{
+    size_t i = 0, pos = 0, run, need;
+    uint32_t kind, token;
+
+    while( i < nb ) {
+        if( 0 == in[i] ) {
+            kind = PARSEC_COMPRESS_TOKEN_ZEROS;
+            for( run = 1; (i + run < nb) && (run < PARSEC_COMPRESS_TOKEN_MAX) &&
+                          (0 == in[i + run]); run++ );
+        } else if( (i > 0) && (in[i] == in[i - 1]) ) {
+            kind = PARSEC_COMPRESS_TOKEN_REPEAT;
+            for( run = 1; (i + run < nb) && (run < PARSEC_COMPRESS_TOKEN_MAX) &&
+                          (in[i + run] == in[i]); run++ );
+        } else {
+            kind = PARSEC_COMPRESS_TOKEN_LITERAL;
+            for( run = 1; (i + run < nb) && (run < PARSEC_COMPRESS_TOKEN_MAX) &&
+                          (0 != in[i + run]) && (in[i + run] != in[i + run - 1]); run++ );
+        }
+        need = sizeof(uint32_t) + ((PARSEC_COMPRESS_TOKEN_LITERAL == kind) ? run * sizeof(uint64_t) : 0);
+        if( pos + need > limit )
+            return 0;
+        token = (kind << PARSEC_COMPRESS_TOKEN_SHIFT) | (uint32_t)run;
+        memcpy(out + pos, &token, sizeof(uint32_t));
+        pos += sizeof(uint32_t);
+        if( PARSEC_COMPRESS_TOKEN_LITERAL == kind ) {
+            memcpy(out + pos, in + i, run * sizeof(uint64_t));
+            pos += run * sizeof(uint64_t);
+        }
+        i += run;
+    }
+    return pos;
+}
+
+static void
+parsec_decompress_words(const uint8_t *in, size_t size, uint64_t *out)
+{
+    size_t i = 0, pos = 0, run, k;
+    uint32_t token;
+
+    while( pos < size ) {
+        memcpy(&token, in + pos, sizeof(uint32_t));
+        pos += sizeof(uint32_t);
+        run = token & PARSEC_COMPRESS_TOKEN_MAX;
+        switch( token >> PARSEC_COMPRESS_TOKEN_SHIFT ) {
+        case PARSEC_COMPRESS_TOKEN_ZEROS:
+            memset(out + i, 0, run * sizeof(uint64_t));
+            break;
+        case PARSEC_COMPRESS_TOKEN_REPEAT:
+            for( k = 0; k < run; k++ )
+                out[i + k] = out[i - 1];
+            break;
+        default:
+            memcpy(out + i, in + pos, run * sizeof(uint64_t));
+            pos += run * sizeof(uint64_t);
+        }
+        i += run;
+    }
+}
+
+/* Restore the payload of a compressed tile. Called with the data locked. */
+static void
+parsec_data_compress_restore(parsec_data_compressed_t *state)
+{
+    parsec_data_compress_t *ctx = state->ctx;
+    int64_t start = parsec_data_compress_now();
+
+    parsec_decompress_words(state->blob, state->blob_size,
+                            (uint64_t*)((char*)state->copy->device_private + state->offset));
+    free(state->blob);
+    state->blob = NULL;
+
+    PARSEC_COMPRESS_STAT_ADD(ctx, nb_compressed, -1);
+    PARSEC_COMPRESS_STAT_ADD(ctx, nb_decompressions, 1);
+    PARSEC_COMPRESS_STAT_ADD(ctx, decompress_ns, parsec_data_compress_now() - start);
+}
+
+/* Can the tracked copy be compressed now? Called with the data locked. */
+static int
+parsec_data_compress_eligible(parsec_data_compressed_t *state)
+{
+    parsec_data_t *data = state->data;
+    parsec_data_copy_t *copy = state->copy;
+
+    if( (&state->ctx->cold != state->list) || (NULL != state->blob) )
+        return 0;  /* used again since it was evicted from the lru */
+    if( (copy != data->device_copies[0]) || (NULL == copy->device_private) )
+        return 0;
+    /* Anybody else than the collection holding the copy may access it */
+    if( (1 != copy->super.super.obj_reference_count) || (0 != copy->readers) )
+        return 0;
+    for( uint32_t i = 1; i < parsec_nb_devices; i++ )
+        if( NULL != data->device_copies[i] ) return 0;
+    if( state->rejected && (state->rejected_version == copy->version) )
+        return 0;
+    return 1;
+}
+
+#if defined(PARSEC_DATA_COMPRESS_SUPPORTED)
+/* Compress the whole pages of the payload and release them. Called with the
+ * data locked. */
+static void
+parsec_data_compress_tile(parsec_data_compressed_t *state)
+{
+    parsec_data_compress_t *ctx = state->ctx;
+    parsec_data_copy_t *copy = state->copy;
+    uintptr_t ptr = (uintptr_t)copy->device_private;
+    uintptr_t first = (ptr + ctx->page_size - 1) & ~(uintptr_t)(ctx->page_size - 1);
+    uintptr_t last = (ptr + state->data->nb_elts) & ~(uintptr_t)(ctx->page_size - 1);
+    int64_t start = parsec_data_compress_now();
+    size_t length, limit, size = 0;
+    uint8_t *blob = NULL, *shrunk;
+
+    if( last > first ) {
+        length = last - first;
+        limit = length - length / 4;
+        blob = (uint8_t*)malloc(limit);
+        if( NULL != blob )
+            size = parsec_compress_words((const uint64_t*)first, length / sizeof(uint64_t), blob, limit);
+        /* the pages cannot be released (locked or pinned memory) */
+        if( (0 != size) && (0 != madvise((void*)first, length, MADV_DONTNEED)) )
+            size = 0;
+    }
+    if( 0 == size ) {
+        free(blob);
+        state->rejected = 1;
+        state->rejected_version = copy->version;
+        PARSEC_COMPRESS_STAT_ADD(ctx, nb_rejected, 1);
+        PARSEC_COMPRESS_STAT_ADD(ctx, compress_ns, parsec_data_compress_now() - start);
+        return;
+    }
+    /* shrinking cannot fail in practice, keep the larger buffer if it does */
+    shrunk = realloc(blob, size);
+    if( NULL != shrunk )
+        blob = shrunk;
+    state->blob = blob;
+    state->blob_size = size;
+    state->offset = first - ptr;
+    state->length = length;
+    state->rejected = 0;
+
+    PARSEC_COMPRESS_STAT_ADD(ctx, nb_compressed, 1);
+    PARSEC_COMPRESS_STAT_ADD(ctx, nb_compressions, 1);
+    PARSEC_COMPRESS_STAT_ADD(ctx, bytes_in, (int64_t)length);
+    PARSEC_COMPRESS_STAT_ADD(ctx, bytes_out, (int64_t)size);
+    PARSEC_COMPRESS_STAT_ADD(ctx, compress_ns, parsec_data_compress_now() - start);
+}
+#endif  /* defined(PARSEC_DATA_COMPRESS_SUPPORTED) */
+
+/**
+ * Move the least recently used tile of the collection to the cold list, and
+ * compress it if nobody is using it.
+ *
+ * @return 0 if the lru is empty, 1 otherwise.
+ */
+static int
+parsec_data_compress_evict(parsec_data_compress_t *ctx)
+{
+    parsec_data_compressed_t *state;
+    parsec_data_t *data;
+
+    parsec_atomic_lock(&ctx->lock);
+    state = (parsec_data_compressed_t*)parsec_list_nolock_pop_back(&ctx->lru);
+    if( NULL == state ) {
+        parsec_atomic_unlock(&ctx->lock);
+        return 0;
+    }
+    data = state->data;
+    ctx->resident -= data->nb_elts;
+    state->list = &ctx->cold;
+    parsec_list_nolock_push_front(&ctx->cold, &state->super);
+    /* The lock order is data then collection: a data locked by somebody
+     * else is in use, leave it uncompressed in the cold list. */
+    if( !parsec_atomic_trylock(&data->lock) ) {
+        parsec_atomic_unlock(&ctx->lock);
+        return 1;
+    }
+    parsec_atomic_unlock(&ctx->lock);
+
+    if( parsec_data_compress_eligible(state) ) {
+#if defined(PARSEC_DATA_COMPRESS_SUPPORTED)
+        parsec_data_compress_tile(state);
+#endif  /* defined(PARSEC_DATA_COMPRESS_SUPPORTED) */
+    }
+    parsec_atomic_unlock(&data->lock);
+    return 1;
+}
+
+void parsec_data_compress_touch(parsec_data_copy_t *copy)
+{
+    parsec_data_compressed_t *state;
+    parsec_data_compress_t *ctx;
+    parsec_data_t *data;
+
+    if( (NULL == copy) || (NULL == (data = copy->original)) )
+        return;
+    if( (NULL == data->compressed) &&
+        ((NULL == data->dc) || (NULL == data->dc->compress) || (copy != data->device_copies[0])) )
+        return;
+
+    parsec_atomic_lock(&data->lock);
+    if( NULL == (state = data->compressed) ) {
+        /* first use of the tile since the compression was enabled */
+        if( (NULL == data->dc) || (NULL == (ctx = data->dc->compress)) || (copy != data->device_copies[0]) ) {
+            parsec_atomic_unlock(&data->lock);
+            return;
+        }
+        state = (parsec_data_compressed_t*)calloc(1, sizeof(parsec_data_compressed_t));
+        PARSEC_OBJ_CONSTRUCT(state, parsec_list_item_t);
+        state->ctx  = ctx;
+        state->data = data;
+        state->copy = copy;
+        data->compressed = state;
+    } else if( state->copy != copy ) {
+        parsec_atomic_unlock(&data->lock);
+        return;
+    }
+    ctx = state->ctx;
+    if( NULL != state->blob )
+        parsec_data_compress_restore(state);
+
+    parsec_atomic_lock(&ctx->lock);
+    if( &ctx->lru == state->list ) {
+        parsec_list_nolock_remove(&ctx->lru, &state->super);
+    } else {
+        if( NULL != state->list )
+            parsec_list_nolock_remove(state->list, &state->super);
+        state->list = &ctx->lru;
+        ctx->resident += data->nb_elts;
+    }
+    parsec_list_nolock_push_front(&ctx->lru, &state->super);
+    parsec_atomic_unlock(&ctx->lock);
+    parsec_atomic_unlock(&data->lock);
+}
+
+void parsec_data_compress_task_data(parsec_task_t *task)
+{
+    const parsec_task_class_t *tc = task->task_class;
+    parsec_data_collection_t *dc;
+    parsec_data_copy_t *copy;
+
+    for( int i = 0; i < tc->nb_flows; i++ ) {
+        for( int j = 0; j < 2; j++ ) {
+            copy = (0 == j) ? task->data[i].data_in : task->data[i].data_out;
+            if( (NULL == copy) || (NULL == copy->original) ) continue;
+            if( (1 == j) && (copy == task->data[i].data_in) ) continue;
+            parsec_data_compress_touch(copy);
+        }
+    }
+    /* The copies of the task are retained, they are not compressed here */
+    for( int i = 0; i < tc->nb_flows; i++ ) {
+        copy = task->data[i].data_in;
+        if( (NULL == copy) || (NULL == copy->original) ||
+            (NULL == (dc = copy->original->dc)) || (NULL == dc->compress) ) continue;
+        while( (dc->compress->resident > (int64_t)dc->compress->budget) &&
+               parsec_data_compress_evict(dc->compress) );
+    }
+}
+
+void parsec_data_compress_forget(parsec_data_t *data, parsec_data_copy_t *copy)
+{
+    parsec_data_compressed_t *state;
+    parsec_data_compress_t *ctx;
+
+    /* Only the copies of the collection, on the main memory, are tracked */
+    if( (NULL == data->compressed) || ((NULL != copy) && (0 != copy->device_index)) )
+        return;
+    parsec_atomic_lock(&data->lock);
+    state = data->compressed;
+    if( (NULL == state) || ((NULL != copy) && (state->copy != copy)) ) {
+        parsec_atomic_unlock(&data->lock);
+        return;
+    }
+    ctx = state->ctx;
+    data->compressed = NULL;
+    parsec_atomic_lock(&ctx->lock);
+    if( NULL != state->list ) {
+        parsec_list_nolock_remove(state->list, &state->super);
+        if( &ctx->lru == state->list )
+            ctx->resident -= data->nb_elts;
+    }
+    parsec_atomic_unlock(&ctx->lock);
+    parsec_atomic_unlock(&data->lock);
+    if( NULL != state->blob ) {
+        free(state->blob);
+        PARSEC_COMPRESS_STAT_ADD(ctx, nb_compressed, -1);
+    }
+    PARSEC_OBJ_DESTRUCT(state);
+    free(state);
+}
+
+/* Stop tracking all the tiles of a collection, restoring them if asked to */
+static void
+parsec_data_compress_release(parsec_data_collection_t *d, int restore)
+{
+    parsec_data_compress_t *ctx = d->compress;
+    parsec_data_compressed_t *state;
+    parsec_data_t *data;
+
+    if( NULL == ctx ) return;
+    d->compress = NULL;
+    parsec_atomic_fetch_dec_int32(&parsec_data_compress_nb_collections);
+
+    while( 1 ) {
+        parsec_atomic_lock(&ctx->lock);
+        state = (parsec_data_compressed_t*)PARSEC_LIST_ITERATOR_FIRST(&ctx->lru);
+        if( PARSEC_LIST_ITERATOR_END(&ctx->lru) == (parsec_list_item_t*)state )
+            state = (parsec_data_compressed_t*)PARSEC_LIST_ITERATOR_FIRST(&ctx->cold);
+        if( PARSEC_LIST_ITERATOR_END(&ctx->cold) == (parsec_list_item_t*)state ) {
+            parsec_atomic_unlock(&ctx->lock);
+            break;
+        }
+        data = state->data;
+        /* same lock order as the eviction, retry if the data is busy */
+        if( !parsec_atomic_trylock(&data->lock) ) {
+            parsec_atomic_unlock(&ctx->lock);
+            continue;
+        }
+        parsec_list_nolock_remove(state->list, &state->super);
+        state->list = NULL;
+        parsec_atomic_unlock(&ctx->lock);
+
+        if( NULL != state->blob ) {
+            if( restore ) {
+                parsec_data_compress_restore(state);
+            } else {
+                free(state->blob);
+                PARSEC_COMPRESS_STAT_ADD(ctx, nb_compressed, -1);
+            }
+        }
+        data->compressed = NULL;
+        parsec_atomic_unlock(&data->lock);
+        PARSEC_OBJ_DESTRUCT(state);
+        free(state);
+    }
+    PARSEC_OBJ_DESTRUCT(&ctx->lru);
+    PARSEC_OBJ_DESTRUCT(&ctx->cold);
+    free(ctx);
+}
+
+int parsec_data_collection_enable_compression(parsec_data_collection_t *d, size_t budget)
+{
+#if defined(PARSEC_DATA_COMPRESS_SUPPORTED)
+    parsec_data_compress_t *ctx;
+    parsec_atomic_lock_t unlocked = PARSEC_ATOMIC_UNLOCKED;
+
+    if( NULL != d->compress ) {
+        d->compress->budget = budget;
+        return PARSEC_SUCCESS;
+    }
+    ctx = (parsec_data_compress_t*)calloc(1, sizeof(parsec_data_compress_t));
+    ctx->lock = unlocked;
+    PARSEC_OBJ_CONSTRUCT(&ctx->lru, parsec_list_t);
+    PARSEC_OBJ_CONSTRUCT(&ctx->cold, parsec_list_t);
+    ctx->budget = budget;
+    ctx->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    d->compress = ctx;
+    parsec_atomic_fetch_inc_int32(&parsec_data_compress_nb_collections);
+    return PARSEC_SUCCESS;
+#else
+    (void)d; (void)budget;
+    return PARSEC_ERR_NOT_SUPPORTED;
+#endif  /* defined(PARSEC_DATA_COMPRESS_SUPPORTED) */
+}
+
+void parsec_data_collection_disable_compression(parsec_data_collection_t *d)
+{
+    parsec_data_compress_release(d, 1);
+}
+
+void parsec_data_compress_destroy(parsec_data_collection_t *d)
+{
+    parsec_data_compress_release(d, 0);
+}
+
+void parsec_data_collection_compression_stats(const parsec_data_collection_t *d,
+                                              parsec_data_compress_stats_t *stats)
+{
+    if( NULL == d->compress ) {
+        memset(stats, 0, sizeof(parsec_data_compress_stats_t));
+        return;
+    }
+    *stats = d->compress->stats;
+}
+
+void parsec_data_compress_fini(void)
+{
+    parsec_data_compress_stats_t *t = &parsec_data_compress_totals;
+
+    if( 0 == (t->nb_compressions + t->nb_rejected) )
+        return;
+    parsec_inform("==== Tile Compression...\n"
+                  "-------------------------------------------------------------\n"
+                  "Compressed Tiles            : %10" PRId64 "\n"
+                  "Rejected Tiles              : %10" PRId64 "\n"
+                  "Restored Tiles              : %10" PRId64 "\n"
+                  "Compressed Input (MB)       : %10.3f\n"
+                  "Compressed Output (MB)      : %10.3f\n"
+                  "Compression Ratio           : %10.2f\n"
+                  "Compression Time (secs)     : %10.3f\n"
+                  "Restoration Time (secs)     : %10.3f\n"
+                  "-------------------------------------------------------------\n",
+                  t->nb_compressions, t->nb_rejected, t->nb_decompressions,
+                  t->bytes_in / (1024.0 * 1024.0), t->bytes_out / (1024.0 * 1024.0),
+                  (0 == t->bytes_out) ? 0.0 : (double)t->bytes_in / (double)t->bytes_out,
+                  t->compress_ns / 1e9, t->decompress_ns / 1e9);
+    memset(t, 0, sizeof(parsec_data_compress_stats_t));
+}
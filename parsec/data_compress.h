@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#if !defined(PARSEC_CONFIG_H_HAS_BEEN_INCLUDED)
+#error data_compress.h header should only be used after parsec_config.h has been included.
+#endif  /* !defined(PARSEC_CONFIG_H_HAS_BEEN_INCLUDED) */
+
+#ifndef PARSEC_DATA_COMPRESS_H_HAS_BEEN_INCLUDED
+#define PARSEC_DATA_COMPRESS_H_HAS_BEEN_INCLUDED
+
+/** @addtogroup parsec_internal_data
+ *  @{
+ */
+
+#include "parsec/data_internal.h"
+
+BEGIN_C_DECLS
+
+struct parsec_task_s;
+
+/**
+ * In-memory compression of the cold tiles of the data collections (see
+ * parsec_data_collection_enable_compression). Every access to the payload of
+ * a collection copy by the runtime must be preceded by a touch of the copy,
+ * done while the copy is retained: the touch restores the payload if needed,
+ * and a retained copy is never compressed.
+ */
+
+/**
+ * Number of data collections with compression enabled. The hooks below are
+ * only called while it is not zero.
+ */
+PARSEC_DECLSPEC extern volatile int32_t parsec_data_compress_nb_collections;
+
+/* Restore the payload of copy if it is compressed, and mark it as recently used */
+void parsec_data_compress_touch(parsec_data_copy_t *copy);
+
+/* Touch the copies used by a task about to be executed, and compress the
+ * coldest tiles of their collections if they exceed their budget */
+void parsec_data_compress_task_data(struct parsec_task_s *task);
+
+/* Stop tracking data (or only copy if not NULL), dropping its compressed payload */
+void parsec_data_compress_forget(parsec_data_t *data, parsec_data_copy_t *copy);
+
+/* Stop compressing the tiles of a collection that is being destroyed,
+ * without restoring them */
+void parsec_data_compress_destroy(parsec_data_collection_t *d);
+
+/* Report the compression activity of the process, if any */
+void parsec_data_compress_fini(void);
+
+END_C_DECLS
+
+/** @} */
+
+#endif  /* PARSEC_DATA_COMPRESS_H_HAS_BEEN_INCLUDED */
@@ -188,9 +188,8 @@ add_task_to_list(parsec_execution_stream_t *es,
 
     PARSEC_COPY_EXECUTION_CONTEXT(new_context, newcontext);
     new_context->status = PARSEC_TASK_STATUS_NONE;
-    pready_list[vpid_dst] = (parsec_task_t*)parsec_list_item_ring_push_sorted( (parsec_list_item_t*)(pready_list[vpid_dst]),
-                                                                               (parsec_list_item_t*)new_context,
-                                                                               parsec_execution_context_priority_comparator );
+    pready_list[vpid_dst] = (parsec_task_t*)parsec_list_item_ring_push_front( (parsec_list_item_t*)(pready_list[vpid_dst]),
+                                                                              (parsec_list_item_t*)new_context );
 
     (void)oldcontext; (void)dep; (void)rank_src; (void)rank_dst; (void)vpid_dst; (void)data;
     (void)successor_repo; (void)successor_repo_key;
@@ -14,6 +14,7 @@
 #include "parsec/data_distribution.h"
 #include "parsec/data_dist/matrix/matrix.h"
 #include "parsec/data_dist/matrix/two_dim_rectangle_cyclic.h"
+#include "parsec/data_dist/matrix/two_dim_rectangle_cyclic_ooc.h"
 #include "parsec/data_dist/matrix/sym_two_dim_rectangle_cyclic.h"
 #include "parsec/data_dist/matrix/two_dim_tabular.h"
 
@@ -181,7 +182,14 @@ parsec_tiled_matrix_submatrix( parsec_tiled_matrix_t *tdesc,
         return NULL;
     }
 
-    if( tdesc->dtype & parsec_matrix_block_cyclic_type ) {
+    if( tdesc->dtype & parsec_matrix_block_cyclic_ooc_type ) {
+        newdesc = (parsec_tiled_matrix_t*) malloc ( sizeof(parsec_matrix_block_cyclic_ooc_t) );
+        memcpy( newdesc, tdesc, sizeof(parsec_matrix_block_cyclic_ooc_t) );
+        /* the parent keeps the ownership of the file and of the resident set */
+        ((parsec_matrix_block_cyclic_ooc_t*)newdesc)->filename = NULL;
+        ((parsec_matrix_block_cyclic_ooc_t*)newdesc)->fd = -1;
+    }
+    else if( tdesc->dtype & parsec_matrix_block_cyclic_type ) {
         newdesc = (parsec_tiled_matrix_t*) malloc ( sizeof(parsec_matrix_block_cyclic_t) );
         memcpy( newdesc, tdesc, sizeof(parsec_matrix_block_cyclic_t) );
     }
@@ -197,6 +205,8 @@ parsec_tiled_matrix_submatrix( parsec_tiled_matrix_t *tdesc,
         return NULL;
     }
 
+    /* The tiles are shared with the original matrix, which tracks their compression */
+    newdesc->super.compress = NULL;
     // Submatrix parameters
     newdesc->i = i;
     newdesc->j = j;
@@ -92,7 +92,8 @@ enum {
   parsec_matrix_type = 0x01,
   parsec_matrix_block_cyclic_type = 0x2,
   parsec_matrix_sym_block_cyclic_type = 0x4,
-  parsec_matrix_tabular_type = 0x8
+  parsec_matrix_tabular_type = 0x8,
+  parsec_matrix_block_cyclic_ooc_type = 0x10
 };
 
 typedef struct parsec_tiled_matrix_s {
@@ -237,6 +238,57 @@ int parsec_redistribute(parsec_context_t *parsec,
                         int disi_source, int disj_source,
                         int disi_target, int disj_target);
 
+/**
+ * @brief Non-blocking function of the aggregated redistribute for PTG
+ *
+ * @details
+ * Computes the communication schedule from the source and target
+ * distributions, and sends all the fragments of the submatrix between
+ * a pair of ranks in a single message, packed from the source tiles and
+ * unpacked into the target tiles. The local fragments are copied while
+ * the messages are in flight.
+ *
+ * @param [in] source: source distribution, already distributed and allocated
+ * @param [out] target: target distribution, redistributed and allocated
+ * @param [in] size_row: row size to be redistributed
+ * @param [in] size_col: column size to be redistributed
+ * @param [in] disi_source: row displacement in source
+ * @param [in] disj_source: column displacement in source
+ * @param [in] disi_target: row displacement in target
+ * @param [in] disj_target: column displacement in target
+ * @return the parsec object to schedule.
+ */
+parsec_taskpool_t*
+parsec_redistribute_aggregate_New(parsec_tiled_matrix_t *source,
+                                  parsec_tiled_matrix_t *target,
+                                  int size_row, int size_col,
+                                  int disi_source, int disj_source,
+                                  int disi_target, int disj_target);
+
+/**
+ * @brief Redistribute source to target of PTG, with one message per
+ * pair of ranks
+ *
+ * @details
+ * Source and target could be ANY distribuiton with ANY displacement
+ * in both source and target.
+ *
+ * @param [in] source: source distribution, already distributed and allocated
+ * @param [out] target: target distribution, redistributed and allocated
+ * @param [in] size_row: row size to be redistributed
+ * @param [in] size_col: column size to be redistributed
+ * @param [in] disi_source: row displacement in source
+ * @param [in] disj_source: column displacement in source
+ * @param [in] disi_target: row displacement in target
+ * @param [in] disj_target: column displacement in target
+ */
+int parsec_redistribute_aggregate(parsec_context_t *parsec,
+                                  parsec_tiled_matrix_t *source,
+                                  parsec_tiled_matrix_t *target,
+                                  int size_row, int size_col,
+                                  int disi_source, int disj_source,
+                                  int disi_target, int disj_target);
+
 /**
  * @brief Non-blocking function of redistribute for DTD
  *
@@ -121,3 +121,98 @@ CORE_redistribute_reshuffle_copy(DTYPE *T, DTYPE *Y, const int mb,
     MOVE_SUBMATRIX(mb, nb, Y, 0, 0, Y_LDA, T, 0, 0, T_LDA);
 }
 
+
+/**
+ * @brief Rectangular fragment of the redistributed submatrix that lies
+ * in a single tile of the source and a single tile of the target
+ */
+typedef struct parsec_redistribute_fragment_s {
+    int m_Y, n_Y;   /**< source tile */
+    int i_Y, j_Y;   /**< offset of the fragment in the source tile */
+    int m_T, n_T;   /**< target tile */
+    int i_T, j_T;   /**< offset of the fragment in the target tile */
+    int rows, cols; /**< size of the fragment */
+    int64_t offset; /**< offset of the fragment in its message, in elements */
+} parsec_redistribute_fragment_t;
+
+/**
+ * @brief Communication schedule of the aggregated redistribution
+ *
+ * @details
+ * Lists, for every other rank, the fragments the local rank sends to it
+ * and receives from it. Both ranks of a pair enumerate the fragments in
+ * the same order, so a message is the concatenation of its fragments
+ * without any header. The fragments that stay on the local rank are in
+ * send[myrank].
+ */
+typedef struct parsec_redistribute_schedule_s {
+    int nodes;
+    int myrank;
+    int *nb_send;                             /**< number of fragments sent to each rank */
+    int *nb_recv;                             /**< number of fragments received from each rank */
+    int64_t *send_elts;                       /**< number of elements sent to each rank */
+    int64_t *recv_elts;                       /**< number of elements received from each rank */
+    parsec_redistribute_fragment_t **send;    /**< fragments sent to each rank */
+    parsec_redistribute_fragment_t **recv;    /**< fragments received from each rank */
+} parsec_redistribute_schedule_t;
+
+/**
+ * @brief Compute the communication schedule of the local rank
+ *
+ * @return the schedule, NULL if out of memory
+ */
+parsec_redistribute_schedule_t*
+parsec_redistribute_schedule_new(parsec_tiled_matrix_t *dcY,
+                                 parsec_tiled_matrix_t *dcT,
+                                 int size_row, int size_col,
+                                 int disi_Y, int disj_Y,
+                                 int disi_T, int disj_T);
+
+void parsec_redistribute_schedule_free(parsec_redistribute_schedule_t *schedule);
+
+/**
+ * @brief Number of elements sent from rank src to rank dst, known
+ * only when one of them is the local rank
+ */
+static inline int64_t
+parsec_redistribute_schedule_count(const parsec_redistribute_schedule_t *schedule,
+                                   int src, int dst)
+{
+    if( src == schedule->myrank )
+        return schedule->send_elts[dst];
+    if( dst == schedule->myrank )
+        return schedule->recv_elts[src];
+    return 0;
+}
+
+/**
+ * @brief Number of fragments sent from rank src to rank dst, known
+ * only when one of them is the local rank
+ */
+static inline int
+parsec_redistribute_schedule_nb_fragments(const parsec_redistribute_schedule_t *schedule,
+                                          int src, int dst)
+{
+    if( src == schedule->myrank )
+        return schedule->nb_send[dst];
+    if( dst == schedule->myrank )
+        return schedule->nb_recv[src];
+    return 0;
+}
+
+/**
+ * @brief Fragment i sent from rank src to rank dst, an empty fragment
+ * when neither of them is the local rank
+ */
+static inline const parsec_redistribute_fragment_t *
+parsec_redistribute_schedule_fragment(const parsec_redistribute_schedule_t *schedule,
+                                      int src, int dst, int i)
+{
+    static const parsec_redistribute_fragment_t none = { 0 };
+
+    if( src == schedule->myrank )
+        return &schedule->send[dst][i];
+    if( dst == schedule->myrank )
+        return &schedule->recv[src][i];
+    return &none;
+}
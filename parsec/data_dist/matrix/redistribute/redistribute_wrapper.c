@@ -6,6 +6,9 @@
 #include "redistribute_internal.h"
 #include "redistribute.h"
 #include "redistribute_reshuffle.h"
+#include "redistribute_aggregate.h"
+#include <stdarg.h>
+#include <limits.h>
 
 static inline int parsec_imin(int a, int b)
 {
@@ -205,3 +208,369 @@ int parsec_redistribute(parsec_context_t *parsec,
     return PARSEC_ERR_NOT_SUPPORTED;
 }
 
+
+/**
+ * @brief Segment of the redistributed submatrix along one dimension,
+ * that lies in a single tile of the source and of the target
+ */
+typedef struct {
+    int len;        /**< length of the segment */
+    int t_Y, o_Y;   /**< source tile and offset in the tile */
+    int t_T, o_T;   /**< target tile and offset in the tile */
+} redistribute_segment_t;
+
+/**
+ * @brief Cut size elements at displacement dis_Y in tiles of b_Y and at
+ * dis_T in tiles of b_T in segments, returns the number of segments
+ *
+ * @details
+ * With segments NULL, the segments are only counted.
+ */
+static int
+redistribute_segments(int size, int dis_Y, int b_Y, int dis_T, int b_T,
+                      redistribute_segment_t *segments)
+{
+    int nb = 0;
+
+    for( int g = 0; g < size; nb++ ) {
+        int p_Y = dis_Y + g, p_T = dis_T + g;
+        int len = parsec_imin(parsec_imin(b_Y - p_Y % b_Y, b_T - p_T % b_T), size - g);
+        g += len;
+        if( NULL == segments )
+            continue;
+        segments[nb].len = len;
+        segments[nb].t_Y = p_Y / b_Y;
+        segments[nb].o_Y = p_Y % b_Y;
+        segments[nb].t_T = p_T / b_T;
+        segments[nb].o_T = p_T % b_T;
+    }
+    return nb;
+}
+
+/**
+ * @brief Compute the communication schedule of the local rank
+ *
+ * @details
+ * The submatrix is cut in fragments by the intersection of the row and
+ * column segments of the source and target tilings. The fragments are
+ * enumerated column segment by column segment on every rank, which gives
+ * the order of the fragments in the messages.
+ */
+parsec_redistribute_schedule_t*
+parsec_redistribute_schedule_new(parsec_tiled_matrix_t *dcY,
+                                 parsec_tiled_matrix_t *dcT,
+                                 int size_row, int size_col,
+                                 int disi_Y, int disj_Y,
+                                 int disi_T, int disj_T)
+{
+    parsec_redistribute_schedule_t *schedule;
+    redistribute_segment_t *rows, *cols;
+    int nb_rows, nb_cols, nodes = dcY->super.nodes, myrank = dcY->super.myrank;
+
+    /* The cut points of both tilings are not aligned in general, count the
+     * segments before storing them */
+    nb_rows = redistribute_segments(size_row, disi_Y, dcY->mb, disi_T, dcT->mb, NULL);
+    nb_cols = redistribute_segments(size_col, disj_Y, dcY->nb, disj_T, dcT->nb, NULL);
+    schedule = calloc(1, sizeof(parsec_redistribute_schedule_t));
+    rows = malloc(nb_rows * sizeof(redistribute_segment_t));
+    cols = malloc(nb_cols * sizeof(redistribute_segment_t));
+    if( NULL == schedule || NULL == rows || NULL == cols )
+        goto error;
+    schedule->nodes = nodes;
+    schedule->myrank = myrank;
+    schedule->nb_send = calloc(nodes, sizeof(int));
+    schedule->nb_recv = calloc(nodes, sizeof(int));
+    schedule->send_elts = calloc(nodes, sizeof(int64_t));
+    schedule->recv_elts = calloc(nodes, sizeof(int64_t));
+    schedule->send = calloc(nodes, sizeof(parsec_redistribute_fragment_t*));
+    schedule->recv = calloc(nodes, sizeof(parsec_redistribute_fragment_t*));
+    if( NULL == schedule->nb_send || NULL == schedule->nb_recv ||
+        NULL == schedule->send_elts || NULL == schedule->recv_elts ||
+        NULL == schedule->send || NULL == schedule->recv )
+        goto error;
+
+    redistribute_segments(size_row, disi_Y, dcY->mb, disi_T, dcT->mb, rows);
+    redistribute_segments(size_col, disj_Y, dcY->nb, disj_T, dcT->nb, cols);
+
+    /* First pass counts the fragments, the second one stores them */
+    for( int pass = 0; pass < 2; pass++ ) {
+        if( 1 == pass ) {
+            for( int r = 0; r < nodes; r++ ) {
+                if( 0 != schedule->nb_send[r] &&
+                    NULL == (schedule->send[r] = malloc(schedule->nb_send[r] * sizeof(parsec_redistribute_fragment_t))) )
+                    goto error;
+                if( 0 != schedule->nb_recv[r] &&
+                    NULL == (schedule->recv[r] = malloc(schedule->nb_recv[r] * sizeof(parsec_redistribute_fragment_t))) )
+                    goto error;
+                schedule->nb_send[r] = schedule->nb_recv[r] = 0;
+            }
+        }
+        for( int c = 0; c < nb_cols; c++ ) {
+            for( int r = 0; r < nb_rows; r++ ) {
+                int rank_Y = parsec_data_collection_rank_of_2d(&dcY->super, rows[r].t_Y, cols[c].t_Y);
+                int rank_T = parsec_data_collection_rank_of_2d(&dcT->super, rows[r].t_T, cols[c].t_T);
+                parsec_redistribute_fragment_t *f;
+
+                if( myrank == rank_Y ) {
+                    if( 0 == pass ) {
+                        schedule->nb_send[rank_T]++;
+                        schedule->send_elts[rank_T] += (int64_t)rows[r].len * cols[c].len;
+                        continue;
+                    }
+                    f = &schedule->send[rank_T][schedule->nb_send[rank_T]++];
+                } else if( myrank == rank_T ) {
+                    if( 0 == pass ) {
+                        schedule->nb_recv[rank_Y]++;
+                        schedule->recv_elts[rank_Y] += (int64_t)rows[r].len * cols[c].len;
+                        continue;
+                    }
+                    f = &schedule->recv[rank_Y][schedule->nb_recv[rank_Y]++];
+                } else {
+                    continue;
+                }
+                f->m_Y = rows[r].t_Y; f->i_Y = rows[r].o_Y;
+                f->n_Y = cols[c].t_Y; f->j_Y = cols[c].o_Y;
+                f->m_T = rows[r].t_T; f->i_T = rows[r].o_T;
+                f->n_T = cols[c].t_T; f->j_T = cols[c].o_T;
+                f->rows = rows[r].len;
+                f->cols = cols[c].len;
+            }
+        }
+    }
+
+    /* Place the fragments in their message */
+    for( int r = 0; r < nodes; r++ ) {
+        int64_t offset = 0;
+        for( int i = 0; i < schedule->nb_send[r]; i++ ) {
+            schedule->send[r][i].offset = offset;
+            offset += (int64_t)schedule->send[r][i].rows * schedule->send[r][i].cols;
+        }
+        offset = 0;
+        for( int i = 0; i < schedule->nb_recv[r]; i++ ) {
+            schedule->recv[r][i].offset = offset;
+            offset += (int64_t)schedule->recv[r][i].rows * schedule->recv[r][i].cols;
+        }
+    }
+
+    free(rows);
+    free(cols);
+    return schedule;
+
+  error:
+    free(rows);
+    free(cols);
+    parsec_redistribute_schedule_free(schedule);
+    return NULL;
+}
+
+void parsec_redistribute_schedule_free(parsec_redistribute_schedule_t *schedule)
+{
+    if( NULL == schedule )
+        return;
+    for( int r = 0; r < schedule->nodes; r++ ) {
+        if( NULL != schedule->send ) free(schedule->send[r]);
+        if( NULL != schedule->recv ) free(schedule->recv[r]);
+    }
+    free(schedule->nb_send);
+    free(schedule->nb_recv);
+    free(schedule->send_elts);
+    free(schedule->recv_elts);
+    free(schedule->send);
+    free(schedule->recv);
+    free(schedule);
+}
+
+/*
+ * Collection with one element per rank, on which the tasks of the
+ * aggregated redistribution are placed.
+ */
+static uint32_t redistribute_ranks_rank_of(parsec_data_collection_t *dc, ...)
+{
+    va_list ap;
+    int r;
+    (void)dc;
+    va_start(ap, dc);
+    r = va_arg(ap, int);
+    va_end(ap);
+    return r;
+}
+
+static uint32_t redistribute_ranks_rank_of_key(parsec_data_collection_t *dc, parsec_data_key_t key)
+{
+    (void)dc;
+    return (uint32_t)key;
+}
+
+static int32_t redistribute_ranks_vpid_of(parsec_data_collection_t *dc, ...)
+{
+    (void)dc;
+    return 0;
+}
+
+static int32_t redistribute_ranks_vpid_of_key(parsec_data_collection_t *dc, parsec_data_key_t key)
+{
+    (void)dc; (void)key;
+    return 0;
+}
+
+static parsec_data_t* redistribute_ranks_data_of(parsec_data_collection_t *dc, ...)
+{
+    (void)dc;
+    return NULL;
+}
+
+static parsec_data_t* redistribute_ranks_data_of_key(parsec_data_collection_t *dc, parsec_data_key_t key)
+{
+    (void)dc; (void)key;
+    return NULL;
+}
+
+static parsec_data_key_t redistribute_ranks_data_key(parsec_data_collection_t *dc, ...)
+{
+    va_list ap;
+    int r;
+    (void)dc;
+    va_start(ap, dc);
+    r = va_arg(ap, int);
+    va_end(ap);
+    return (parsec_data_key_t)r;
+}
+
+/**
+ * @brief New function for the aggregated redistribute
+ *
+ * @param [in] dcY: the data, already distributed and allocated
+ * @param [out] dcT: the data, redistributed and allocated
+ * @param [in] size_row: row size to be redistributed
+ * @param [in] size_col: column size to be redistributed
+ * @param [in] disi_Y: row displacement in dcY
+ * @param [in] disj_Y: column displacement in dcY
+ * @param [in] disi_T: row displacement in dcT
+ * @param [in] disj_T: column displacement in dcT
+ * @return the parsec object to schedule.
+ */
+parsec_taskpool_t*
+parsec_redistribute_aggregate_New(parsec_tiled_matrix_t *dcY,
+                                  parsec_tiled_matrix_t *dcT,
+                                  int size_row, int size_col,
+                                  int disi_Y, int disj_Y,
+                                  int disi_T, int disj_T)
+{
+    parsec_redistribute_aggregate_taskpool_t* taskpool = NULL;
+    parsec_redistribute_schedule_t *schedule;
+    parsec_data_collection_t *ranks;
+
+    if( size_row < 1 || size_col < 1 ) {
+        if( 0 == dcY->super.myrank )
+            parsec_warning("ERROR: Submatrix size should be bigger than 1\n");
+        return NULL;
+    }
+
+    if( disi_Y < 0 || disj_Y < 0 ||
+        disi_T < 0 || disj_T < 0 ) {
+        if( 0 == dcY->super.myrank )
+            parsec_warning("ERROR: Submatrix displacement should not be negative\n");
+        return NULL;
+    }
+
+    if( (disi_Y+size_row > dcY->lmt*dcY->mb) ||
+        (disj_Y+size_col > dcY->lnt*dcY->nb) ){
+        if( 0 == dcY->super.myrank )
+            parsec_warning("ERROR: Submatrix exceed SOURCE size\n");
+        return NULL;
+    }
+
+    if( (disi_T+size_row > dcT->lmt*dcT->mb)
+        || (disj_T+size_col > dcT->lnt*dcT->nb) ){
+        if( 0 == dcY->super.myrank )
+            parsec_warning("ERROR: Submatrix exceed TARGET size\n");
+        return NULL;
+    }
+
+    schedule = parsec_redistribute_schedule_new(dcY, dcT, size_row, size_col,
+                                                disi_Y, disj_Y, disi_T, disj_T);
+    ranks = malloc(sizeof(parsec_data_collection_t));
+    if( NULL == schedule || NULL == ranks ) {
+        parsec_warning("ERROR: Not enough memory for the redistribution schedule\n");
+        parsec_redistribute_schedule_free(schedule);
+        free(ranks);
+        return NULL;
+    }
+    /* The messages are described by a count of elements */
+    for( int r = 0; r < schedule->nodes; r++ ) {
+        if( schedule->send_elts[r] > INT_MAX || schedule->recv_elts[r] > INT_MAX ) {
+            parsec_warning("ERROR: Redistribution message of more than INT_MAX elements\n");
+            parsec_redistribute_schedule_free(schedule);
+            free(ranks);
+            return NULL;
+        }
+    }
+    parsec_data_collection_init(ranks, dcY->super.nodes, dcY->super.myrank);
+    ranks->rank_of        = redistribute_ranks_rank_of;
+    ranks->rank_of_key    = redistribute_ranks_rank_of_key;
+    ranks->vpid_of        = redistribute_ranks_vpid_of;
+    ranks->vpid_of_key    = redistribute_ranks_vpid_of_key;
+    ranks->data_of        = redistribute_ranks_data_of;
+    ranks->data_of_key    = redistribute_ranks_data_of_key;
+    ranks->data_key       = redistribute_ranks_data_key;
+
+    taskpool = parsec_redistribute_aggregate_new(dcY, dcT, ranks, schedule);
+
+    parsec_add2arena(&taskpool->arenas_datatypes[PARSEC_redistribute_aggregate_DEFAULT_ADT_IDX],
+                     MY_TYPE, PARSEC_MATRIX_FULL,
+                     1, 1, 1, 1,
+                     PARSEC_ARENA_ALIGNMENT_SSE, -1 );
+
+    return (parsec_taskpool_t*)taskpool;
+}
+
+/**
+ * @param [inout] the parsec object to destroy
+ */
+static void
+__parsec_redistribute_aggregate_destructor(parsec_redistribute_aggregate_taskpool_t *taskpool)
+{
+    parsec_del2arena(&taskpool->arenas_datatypes[PARSEC_redistribute_aggregate_DEFAULT_ADT_IDX]);
+    parsec_redistribute_schedule_free(taskpool->_g_schedule);
+    parsec_data_collection_destroy(taskpool->_g_descR);
+    free(taskpool->_g_descR);
+}
+
+PARSEC_OBJ_CLASS_INSTANCE(parsec_redistribute_aggregate_taskpool_t, parsec_taskpool_t,
+                          NULL, __parsec_redistribute_aggregate_destructor);
+
+/**
+ * @brief Redistribute dcY to dcT in PTG, with one message per pair of ranks
+ *
+ * @param [in] dcY: source distribution, already distributed and allocated
+ * @param [out] dcT: target distribution, redistributed and allocated
+ * @param [in] size_row: row size to be redistributed
+ * @param [in] size_col: column size to be redistributed
+ * @param [in] disi_Y: row displacement in dcY
+ * @param [in] disj_Y: column displacement in dcY
+ * @param [in] disi_T: row displacement in dcT
+ * @param [in] disj_T: column displacement in dcT
+ */
+int parsec_redistribute_aggregate(parsec_context_t *parsec,
+                                  parsec_tiled_matrix_t *dcY,
+                                  parsec_tiled_matrix_t *dcT,
+                                  int size_row, int size_col,
+                                  int disi_Y, int disj_Y,
+                                  int disi_T, int disj_T)
+{
+    parsec_taskpool_t *parsec_redistribute_ptg = NULL;
+
+    parsec_redistribute_ptg = parsec_redistribute_aggregate_New(
+                              dcY, dcT, size_row, size_col, disi_Y,
+                              disj_Y, disi_T, disj_T);
+
+    if( NULL != parsec_redistribute_ptg ){
+        parsec_context_add_taskpool(parsec, parsec_redistribute_ptg);
+        parsec_context_start(parsec);
+        parsec_context_wait(parsec);
+        parsec_taskpool_free(parsec_redistribute_ptg);
+        return PARSEC_SUCCESS;
+    }
+
+    return PARSEC_ERR_NOT_SUPPORTED;
+}
@@ -45,6 +45,7 @@ subtile_desc_t *subtile_desc_create( const parsec_tiled_matrix_t *tdesc,
     o->rank_of_key  = subtile_rank_of_key;
     o->vpid_of_key  = subtile_vpid_of_key;
     o->data_of_key  = subtile_data_of_key;
+    parsec_data_collection_clear_fixed_arity(o);
 
     /* Memory is allready registered at direct upper level */
     o->register_memory   = NULL;
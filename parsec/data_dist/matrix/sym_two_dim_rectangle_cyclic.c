@@ -252,6 +252,7 @@ void parsec_matrix_sym_block_cyclic_init(parsec_matrix_sym_block_cyclic_t * dc,
     o->vpid_of_key = sym_twoDBC_vpid_of_key;
     o->data_of     = sym_twoDBC_data_of;
     o->data_of_key = sym_twoDBC_data_of_key;
+    parsec_data_collection_clear_fixed_arity(o);
 
     o->register_memory   = sym_twoDBC_memory_register;
     o->unregister_memory = sym_twoDBC_memory_unregister;
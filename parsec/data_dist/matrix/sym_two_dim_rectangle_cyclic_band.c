@@ -125,4 +125,5 @@ void parsec_matrix_sym_block_cyclic_band_init( parsec_matrix_sym_block_cyclic_ba
     dc->rank_of_key  = sym_twoDBC_band_rank_of_key;
     dc->vpid_of_key  = sym_twoDBC_band_vpid_of_key;
     dc->data_of_key  = sym_twoDBC_band_data_of_key;
+    parsec_data_collection_clear_fixed_arity(dc);
 }
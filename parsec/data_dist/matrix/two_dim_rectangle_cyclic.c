@@ -13,9 +13,13 @@
 #include "parsec/mca/device/device.h"
 #include "parsec/vpmap.h"
 
-static uint32_t twoDBC_rank_of(parsec_data_collection_t* dc, ...);
 static int32_t twoDBC_vpid_of(parsec_data_collection_t* dc, ...);
 static parsec_data_t* twoDBC_data_of(parsec_data_collection_t* dc, ...);
+static uint32_t twoDBC_rank_of_2d(parsec_data_collection_t* dc, int m, int n);
+static int32_t twoDBC_vpid_of_2d(parsec_data_collection_t* dc, int m, int n);
+static parsec_data_t* twoDBC_data_of_2d(parsec_data_collection_t* dc, int m, int n);
+static void twoDBC_rank_of_batch(parsec_data_collection_t* dc, int count, const int *m, const int *n, uint32_t *ranks);
+static void twoDBC_data_of_batch(parsec_data_collection_t* dc, int count, const int *m, const int *n, parsec_data_t **datas);
 static uint32_t twoDBC_rank_of_key(parsec_data_collection_t* dc, parsec_data_key_t key);
 static int32_t twoDBC_vpid_of_key(parsec_data_collection_t* dc, parsec_data_key_t key);
 static parsec_data_t* twoDBC_data_of_key(parsec_data_collection_t* dc, parsec_data_key_t key);
@@ -192,12 +196,20 @@ void parsec_matrix_block_cyclic_init(parsec_matrix_block_cyclic_t * dc,
 
     /* set the methods */
     if( (kp == 1) && (kq == 1) ) {
-        o->rank_of      = twoDBC_rank_of;
+        o->rank_of      = parsec_matrix_block_cyclic_rank_of;
         o->vpid_of      = twoDBC_vpid_of;
         o->data_of      = twoDBC_data_of;
         o->rank_of_key  = twoDBC_rank_of_key;
         o->vpid_of_key  = twoDBC_vpid_of_key;
         o->data_of_key  = twoDBC_data_of_key;
+        o->rank_of_2d   = twoDBC_rank_of_2d;
+        o->vpid_of_2d   = twoDBC_vpid_of_2d;
+        o->data_of_2d   = twoDBC_data_of_2d;
+        o->rank_of_batch = twoDBC_rank_of_batch;
+        o->data_of_batch = twoDBC_data_of_batch;
+        o->rank_of_paired = o->rank_of;
+        o->vpid_of_paired = o->vpid_of;
+        o->data_of_paired = o->data_of;
     } else {
 #if !PARSEC_KCYCLIC_WITH_VIEW
         o->rank_of      = twoDBC_kcyclic_rank_of;
@@ -206,6 +218,7 @@ void parsec_matrix_block_cyclic_init(parsec_matrix_block_cyclic_t * dc,
         o->rank_of_key  = twoDBC_kcyclic_rank_of_key;
         o->vpid_of_key  = twoDBC_kcyclic_vpid_of_key;
         o->data_of_key  = twoDBC_kcyclic_data_of_key;
+        parsec_data_collection_clear_fixed_arity(o);
 #else
         parsec_matrix_block_cyclic_kview(dc, dc, kp, kq);
 #endif /* PARSEC_KCYCLIC_WITH_VIEW */
@@ -255,13 +268,10 @@ void parsec_matrix_block_cyclic_key2coords(parsec_data_collection_t *desc,
  * Set of functions with no k-cyclicity support
  *
  */
-static uint32_t twoDBC_rank_of(parsec_data_collection_t * desc, ...)
+uint32_t parsec_matrix_block_cyclic_rank_of(parsec_data_collection_t * desc, ...)
 {
-    int cr, m, n;
-    int rr;
-    int res;
+    int m, n;
     va_list ap;
-    parsec_matrix_block_cyclic_t * dc = (parsec_matrix_block_cyclic_t *)desc;
 
     /* Get coordinates */
     va_start(ap, desc);
@@ -269,35 +279,49 @@ static uint32_t twoDBC_rank_of(parsec_data_collection_t * desc, ...)
     n = va_arg(ap, unsigned int);
     va_end(ap);
 
-    /* Assert using local info */
-    assert( m < dc->super.mt );
-    assert( n < dc->super.nt );
-
-    /* Offset by (i,j) to translate (m,n) in the global matrix */
-    m += dc->super.i / dc->super.mb;
-    n += dc->super.j / dc->super.nb;
+    return parsec_matrix_block_cyclic_rank_of_inline((parsec_matrix_block_cyclic_t *)desc, m, n);
+}
 
-    /* P(rr, cr) has the tile, compute the mpi rank*/
-    rr = (m % dc->grid.rows + dc->grid.ip) % dc->grid.rows;
-    cr = (n % dc->grid.cols + dc->grid.jq) % dc->grid.cols;
-    res = rr * dc->grid.cols + cr;
+static uint32_t twoDBC_rank_of_2d(parsec_data_collection_t *desc, int m, int n)
+{
+    return parsec_matrix_block_cyclic_rank_of_inline((parsec_matrix_block_cyclic_t *)desc, m, n);
+}
 
-    return res;
+static void twoDBC_rank_of_batch(parsec_data_collection_t *desc, int count,
+                                 const int *m, const int *n, uint32_t *ranks)
+{
+    const parsec_matrix_block_cyclic_t *dc = (const parsec_matrix_block_cyclic_t *)desc;
+    for( int i = 0; i < count; i++ ) {
+        ranks[i] = parsec_matrix_block_cyclic_rank_of_inline(dc, m[i], n[i]);
+    }
 }
 
 static uint32_t twoDBC_rank_of_key(parsec_data_collection_t *desc, parsec_data_key_t key)
 {
     int m, n;
     parsec_matrix_block_cyclic_key2coords(desc, key, &m, &n);
-    return twoDBC_rank_of(desc, m, n);
+    return parsec_matrix_block_cyclic_rank_of_inline((parsec_matrix_block_cyclic_t *)desc, m, n);
 }
 
 static int32_t twoDBC_vpid_of(parsec_data_collection_t *desc, ...)
 {
-    int m, n, p, q, pq;
+    int m, n;
+    va_list ap;
+
+    /* Get coordinates */
+    va_start(ap, desc);
+    m = (int)va_arg(ap, unsigned int);
+    n = (int)va_arg(ap, unsigned int);
+    va_end(ap);
+
+    return twoDBC_vpid_of_2d(desc, m, n);
+}
+
+static int32_t twoDBC_vpid_of_2d(parsec_data_collection_t *desc, int m, int n)
+{
+    int p, q, pq;
     int local_m, local_n;
     parsec_matrix_block_cyclic_t * dc;
-    va_list ap;
     int32_t vpid;
     dc = (parsec_matrix_block_cyclic_t *)desc;
 
@@ -310,18 +334,12 @@ static int32_t twoDBC_vpid_of(parsec_data_collection_t *desc, ...)
     p = dc->grid.vp_p;
     assert(p*q == pq);
 
-    /* Get coordinates */
-    va_start(ap, desc);
-    m = (int)va_arg(ap, unsigned int);
-    n = (int)va_arg(ap, unsigned int);
-    va_end(ap);
-
     /* Assert using local info */
     assert( m < dc->super.mt );
     assert( n < dc->super.nt );
 
 #if defined(DISTRIBUTED)
-    assert(desc->myrank == twoDBC_rank_of(desc, m, n));
+    assert(desc->myrank == parsec_matrix_block_cyclic_rank_of(desc, m, n));
 #endif
 
     /* Offset by (i,j) to translate (m,n) in the global matrix */
@@ -345,7 +363,7 @@ static int32_t twoDBC_vpid_of_key(parsec_data_collection_t *desc, parsec_data_ke
 {
     int m, n;
     parsec_matrix_block_cyclic_key2coords(desc, key, &m, &n);
-    return twoDBC_vpid_of(desc, m, n);
+    return twoDBC_vpid_of_2d(desc, m, n);
 }
 
 static inline int twoDBC_coordinates_to_position(parsec_matrix_block_cyclic_t *dc, int m, int n){
@@ -367,11 +385,8 @@ static inline int twoDBC_coordinates_to_position(parsec_matrix_block_cyclic_t *d
 
 static parsec_data_t* twoDBC_data_of(parsec_data_collection_t *desc, ...)
 {
-    int m, n, position;
-    size_t pos = 0;
+    int m, n;
     va_list ap;
-    parsec_matrix_block_cyclic_t * dc;
-    dc = (parsec_matrix_block_cyclic_t *)desc;
 
     /* Get coordinates */
     va_start(ap, desc);
@@ -379,12 +394,22 @@ static parsec_data_t* twoDBC_data_of(parsec_data_collection_t *desc, ...)
     n = (int)va_arg(ap, unsigned int);
     va_end(ap);
 
+    return twoDBC_data_of_2d(desc, m, n);
+}
+
+static parsec_data_t* twoDBC_data_of_2d(parsec_data_collection_t *desc, int m, int n)
+{
+    int position;
+    size_t pos = 0;
+    parsec_matrix_block_cyclic_t * dc;
+    dc = (parsec_matrix_block_cyclic_t *)desc;
+
     /* Assert using local info */
     assert( m < dc->super.mt );
     assert( n < dc->super.nt );
 
 #if defined(DISTRIBUTED)
-    assert(desc->myrank == twoDBC_rank_of(desc, m, n));
+    assert(desc->myrank == parsec_matrix_block_cyclic_rank_of(desc, m, n));
 #endif
 
     /* Offset by (i,j) to translate (m,n) in the global matrix */
@@ -415,7 +440,15 @@ static parsec_data_t* twoDBC_data_of_key(parsec_data_collection_t *desc, parsec_
 {
     int m, n;
     parsec_matrix_block_cyclic_key2coords(desc, key, &m, &n);
-    return twoDBC_data_of(desc, m, n);
+    return twoDBC_data_of_2d(desc, m, n);
+}
+
+static void twoDBC_data_of_batch(parsec_data_collection_t *desc, int count,
+                                 const int *m, const int *n, parsec_data_t **datas)
+{
+    for( int i = 0; i < count; i++ ) {
+        datas[i] = twoDBC_data_of_2d(desc, m[i], n[i]);
+    }
 }
 
 /****
@@ -436,6 +469,8 @@ void parsec_matrix_block_cyclic_kview( parsec_matrix_block_cyclic_t* target,
     target->super.super.rank_of_key = twoDBC_kview_rank_of_key;
     target->super.super.data_of_key = twoDBC_kview_data_of_key;
     target->super.super.vpid_of_key = twoDBC_kview_vpid_of_key;
+    target->super.super.compress    = NULL;  /* the tiles are tracked by the origin */
+    parsec_data_collection_clear_fixed_arity(&target->super.super);
 }
 
 static inline unsigned int kview_compute_m(parsec_matrix_block_cyclic_t* desc, unsigned int m)
@@ -473,7 +508,7 @@ static uint32_t twoDBC_kview_rank_of(parsec_data_collection_t* dc, ...)
     va_end(ap);
     sm = kview_compute_m(desc, m);
     sn = kview_compute_n(desc, n);
-    return twoDBC_rank_of(dc, sm, sn);
+    return parsec_matrix_block_cyclic_rank_of(dc, sm, sn);
 }
 
 static uint32_t twoDBC_kview_rank_of_key(parsec_data_collection_t *desc, parsec_data_key_t key)
@@ -494,7 +529,7 @@ static int32_t twoDBC_kview_vpid_of(parsec_data_collection_t* dc, ...)
     va_end(ap);
     m = kview_compute_m(desc, m);
     n = kview_compute_n(desc, n);
-    return twoDBC_vpid_of(dc, m, n);
+    return twoDBC_vpid_of_2d(dc, m, n);
 }
 
 static int32_t twoDBC_kview_vpid_of_key(parsec_data_collection_t *desc, parsec_data_key_t key)
@@ -515,7 +550,7 @@ static parsec_data_t* twoDBC_kview_data_of(parsec_data_collection_t* dc, ...)
     va_end(ap);
     m = kview_compute_m(desc, m);
     n = kview_compute_n(desc, n);
-    return twoDBC_data_of(dc, m, n);
+    return twoDBC_data_of_2d(dc, m, n);
 }
 
 static parsec_data_t* twoDBC_kview_data_of_key(parsec_data_collection_t *desc, parsec_data_key_t key)
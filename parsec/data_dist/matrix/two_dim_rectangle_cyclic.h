@@ -129,6 +129,35 @@ void parsec_matrix_block_cyclic_kview( parsec_matrix_block_cyclic_t* target,
                                  parsec_matrix_block_cyclic_t* origin,
                                  int kp, int kq );
 
+/**
+ * rank_of of the 2-D block cyclic distribution without k-cyclicity. It is
+ * exposed so that callers can recognize the distribution of a collection and
+ * use parsec_matrix_block_cyclic_rank_of_inline instead of the indirect call.
+ */
+uint32_t parsec_matrix_block_cyclic_rank_of(parsec_data_collection_t* dc, ...);
+
+/**
+ * Inlined computation of the rank owning tile (m, n) of a 2-D block cyclic
+ * distribution without k-cyclicity.
+ */
+static inline uint32_t
+parsec_matrix_block_cyclic_rank_of_inline(const parsec_matrix_block_cyclic_t *dc, int m, int n)
+{
+    int rr, cr;
+
+    assert( m < dc->super.mt );
+    assert( n < dc->super.nt );
+
+    /* Offset by (i,j) to translate (m,n) in the global matrix */
+    m += dc->super.i / dc->super.mb;
+    n += dc->super.j / dc->super.nb;
+
+    /* P(rr, cr) has the tile, compute the mpi rank*/
+    rr = (m % dc->grid.rows + dc->grid.ip) % dc->grid.rows;
+    cr = (n % dc->grid.cols + dc->grid.jq) % dc->grid.cols;
+    return (uint32_t)(rr * dc->grid.cols + cr);
+}
+
 /* include deprecated symbols */
 #include "parsec/data_dist/matrix/deprecated/two_dim_rectangle_cyclic.h"
 
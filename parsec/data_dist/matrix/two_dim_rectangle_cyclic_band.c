@@ -128,4 +128,5 @@ void parsec_matrix_block_cyclic_band_init( parsec_matrix_block_cyclic_band_t *de
     dc->rank_of_key  = twoDBC_band_rank_of_key;
     dc->vpid_of_key  = twoDBC_band_vpid_of_key;
     dc->data_of_key  = twoDBC_band_data_of_key;
+    parsec_data_collection_clear_fixed_arity(dc);
 }
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/parsec_internal.h"
+#include "parsec/utils/debug.h"
+#include "parsec/data_dist/matrix/matrix.h"
+#include "parsec/data_dist/matrix/two_dim_rectangle_cyclic_ooc.h"
+#include "parsec/data_dist/matrix/matrix_internal.h"
+#include "parsec/mca/device/device.h"
+#include "parsec/class/list.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#if defined(PARSEC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif  /* defined(PARSEC_HAVE_UNISTD_H) */
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+
+/**
+ * A local tile, as tracked by the resident set.
+ */
+typedef struct parsec_matrix_ooc_tile_s {
+    parsec_list_item_t super;
+    int32_t            resident;  /**< the tile is in the resident set */
+} parsec_matrix_ooc_tile_t;
+
+PARSEC_OBJ_CLASS_INSTANCE(parsec_matrix_ooc_tile_t, parsec_list_item_t, NULL, NULL);
+
+/**
+ * The resident set, ordered from the most recently used tile to the least
+ * recently used one. All fields are protected by the lock of the list.
+ */
+typedef struct parsec_matrix_ooc_lru_s {
+    parsec_list_t             lru;
+    parsec_matrix_ooc_tile_t *tiles;  /**< one per local tile */
+    int                       fd;     /**< backing file, owned by the parent matrix */
+    parsec_matrix_ooc_stats_t stats;
+} parsec_matrix_ooc_lru_t;
+
+static parsec_data_t* twoDBC_ooc_data_of(parsec_data_collection_t* dc, ...);
+static parsec_data_t* twoDBC_ooc_data_of_key(parsec_data_collection_t* dc, parsec_data_key_t key);
+static parsec_data_t* twoDBC_ooc_data_of_2d(parsec_data_collection_t* dc, int m, int n);
+static void twoDBC_ooc_data_of_batch(parsec_data_collection_t* dc, int count, const int *m, const int *n, parsec_data_t **datas);
+static int twoDBC_ooc_prefetch(parsec_data_collection_t* dc, parsec_data_key_t key);
+static void twoDBC_ooc_access(parsec_data_collection_t* dc, parsec_data_key_t key);
+
+static int twoDBC_ooc_memory_register(parsec_data_collection_t* desc, parsec_device_module_t* device)
+{
+    parsec_matrix_block_cyclic_ooc_t * dc = (parsec_matrix_block_cyclic_ooc_t *)desc;
+    if( (NULL == dc->super.mat ) || (dc->super.super.nb_local_tiles == 0)) {
+        return PARSEC_SUCCESS;
+    }
+    return device->memory_register(device, desc, dc->super.mat, dc->map_size);
+}
+
+static int twoDBC_ooc_memory_unregister(parsec_data_collection_t* desc, parsec_device_module_t* device)
+{
+    parsec_matrix_block_cyclic_ooc_t * dc = (parsec_matrix_block_cyclic_ooc_t *)desc;
+    if( (NULL == dc->super.mat ) || (dc->super.super.nb_local_tiles == 0)) {
+        return PARSEC_SUCCESS;
+    }
+    return device->memory_unregister(device, desc, dc->super.mat);
+}
+
+int parsec_matrix_block_cyclic_ooc_init(parsec_matrix_block_cyclic_ooc_t * dc,
+                                        parsec_matrix_type_t mtype,
+                                        int myrank,
+                                        int mb,    int nb,   /* Tile size */
+                                        int lm,    int ln,   /* Global matrix size (what is stored)*/
+                                        int i,     int j,    /* Staring point in the global matrix */
+                                        int m,     int n,    /* Submatrix size (the one concerned by the computation */
+                                        int P,     int Q,    /* process process grid */
+                                        int ip,    int jq,   /* starting point on the process grid */
+                                        const char *filename,
+                                        int max_resident)
+{
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+    parsec_data_collection_t *o     = &(dc->super.super.super);
+    parsec_tiled_matrix_t    *tdesc = &(dc->super.super);
+    parsec_matrix_ooc_lru_t  *lru;
+    size_t page_size, tile_size;
+    struct stat sb;
+    int rc;
+
+    parsec_matrix_block_cyclic_init(&dc->super, mtype, PARSEC_MATRIX_TILE, myrank,
+                                    mb, nb, lm, ln, i, j, m, n, P, Q, 1, 1, ip, jq);
+    tdesc->dtype |= parsec_matrix_block_cyclic_ooc_type;
+
+    dc->fd           = -1;
+    dc->max_resident = max_resident;
+    dc->lru          = NULL;
+    if( 1 == tdesc->super.nodes ) {
+        dc->filename = strdup(filename);
+    } else {
+        rc = asprintf(&dc->filename, "%s.%d", filename, myrank);
+        if( rc < 0 ) dc->filename = NULL;
+    }
+    if( NULL == dc->filename ) goto fail;
+
+    /* Each tile starts on a page boundary, so that it can be evicted without
+     * disturbing its neighbors. */
+    page_size = (size_t)sysconf(_SC_PAGESIZE);
+    tile_size = (size_t)tdesc->bsiz * (size_t)parsec_datadist_getsizeoftype(mtype);
+    dc->tile_stride = ((tile_size + page_size - 1) / page_size) * page_size;
+    dc->map_size    = dc->tile_stride * (size_t)tdesc->nb_local_tiles;
+
+    dc->fd = open(dc->filename, O_RDWR | O_CREAT, 0600);
+    if( -1 == dc->fd ) {
+        parsec_warning("Unable to open the backing file %s of an out-of-core matrix: %s",
+                       dc->filename, strerror(errno));
+        goto fail;
+    }
+    if( 0 != fstat(dc->fd, &sb) ) goto fail_io;
+    if( (size_t)sb.st_size < dc->map_size ) {
+        if( 0 != ftruncate(dc->fd, (off_t)dc->map_size) ) goto fail_io;
+    }
+    if( 0 != dc->map_size ) {
+        dc->super.mat = mmap(NULL, dc->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, dc->fd, 0);
+        if( MAP_FAILED == dc->super.mat ) {
+            dc->super.mat = NULL;
+            goto fail_io;
+        }
+        /* The tiles are brought in on demand, in no particular order */
+        (void)madvise(dc->super.mat, dc->map_size, MADV_RANDOM);
+    }
+
+    lru = (parsec_matrix_ooc_lru_t*)calloc(1, sizeof(parsec_matrix_ooc_lru_t));
+    PARSEC_OBJ_CONSTRUCT(&lru->lru, parsec_list_t);
+    lru->tiles = (parsec_matrix_ooc_tile_t*)calloc(tdesc->nb_local_tiles, sizeof(parsec_matrix_ooc_tile_t));
+    for( int t = 0; t < tdesc->nb_local_tiles; t++ ) {
+        PARSEC_OBJ_CONSTRUCT(&lru->tiles[t], parsec_matrix_ooc_tile_t);
+    }
+    lru->fd = dc->fd;
+    dc->lru = lru;
+
+    /* the block cyclic rank_of and its fixed-arity versions are kept, the
+     * data accessors are all overridden */
+    o->data_of           = twoDBC_ooc_data_of;
+    o->data_of_key       = twoDBC_ooc_data_of_key;
+    o->data_of_2d        = twoDBC_ooc_data_of_2d;
+    o->data_of_batch     = twoDBC_ooc_data_of_batch;
+    o->data_of_paired    = o->data_of;
+    o->register_memory   = twoDBC_ooc_memory_register;
+    o->unregister_memory = twoDBC_ooc_memory_unregister;
+    parsec_data_collection_set_prefetch(o, twoDBC_ooc_prefetch, twoDBC_ooc_access);
+
+    PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, "parsec_matrix_block_cyclic_ooc_init: \n"
+                         "      dc = %p, file = %s, nb_local_tiles = %d, tile_stride = %zu, max_resident = %d",
+                         dc, dc->filename, tdesc->nb_local_tiles, dc->tile_stride, dc->max_resident);
+    return PARSEC_SUCCESS;
+
+  fail_io:
+    parsec_warning("Unable to map the backing file %s of an out-of-core matrix: %s",
+                   dc->filename, strerror(errno));
+  fail:
+    if( -1 != dc->fd ) close(dc->fd);
+    dc->fd = -1;
+    free(dc->filename);
+    dc->filename = NULL;
+    parsec_tiled_matrix_destroy(tdesc);
+    return PARSEC_ERROR;
+#else
+    (void)dc; (void)mtype; (void)myrank; (void)mb; (void)nb; (void)lm; (void)ln;
+    (void)i; (void)j; (void)m; (void)n; (void)P; (void)Q; (void)ip; (void)jq;
+    (void)filename; (void)max_resident;
+    parsec_warning("Out-of-core matrices require mmap support");
+    return PARSEC_ERR_NOT_IMPLEMENTED;
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+}
+
+void parsec_matrix_block_cyclic_ooc_destroy(parsec_matrix_block_cyclic_ooc_t * dc)
+{
+    parsec_tiled_matrix_t *tdesc = &(dc->super.super);
+    parsec_matrix_ooc_lru_t *lru = dc->lru;
+
+    /* A submatrix shares the mapping, the file and the resident set of its
+     * parent, which releases them */
+    if( NULL == dc->filename ) return;
+
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+    if( NULL != dc->super.mat ) {
+        if( 0 != msync(dc->super.mat, dc->map_size, MS_SYNC) ) {
+            parsec_warning("Unable to write back the out-of-core matrix to %s: %s",
+                           dc->filename, strerror(errno));
+        }
+        munmap(dc->super.mat, dc->map_size);
+        dc->super.mat = NULL;
+    }
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+    if( -1 != dc->fd ) close(dc->fd);
+    dc->fd = -1;
+    free(dc->filename);
+    dc->filename = NULL;
+
+    if( NULL != lru ) {
+        /* The tiles are not OBJ_RELEASEd, the list only needs to be empty */
+        while( NULL != parsec_list_nolock_pop_front(&lru->lru) );
+        for( int t = 0; t < tdesc->nb_local_tiles; t++ ) {
+            PARSEC_OBJ_DESTRUCT(&lru->tiles[t]);
+        }
+        PARSEC_OBJ_DESTRUCT(&lru->lru);
+        free(lru->tiles);
+        free(lru);
+        dc->lru = NULL;
+    }
+    parsec_tiled_matrix_destroy(tdesc);
+}
+
+void parsec_matrix_block_cyclic_ooc_stats(const parsec_matrix_block_cyclic_ooc_t * dc,
+                                          parsec_matrix_ooc_stats_t *stats)
+{
+    parsec_matrix_ooc_lru_t *lru = dc->lru;
+
+    parsec_list_lock(&lru->lru);
+    *stats = lru->stats;
+    parsec_list_unlock(&lru->lru);
+}
+
+/*
+ * Release the pages of a tile. Unmapping the pages of a shared file mapping
+ * leaves them in the page cache, so the tile is first written back to the
+ * file, then unmapped, and its now clean pages are dropped from the page
+ * cache. The content of the tile is preserved even if it is being accessed
+ * concurrently: it will simply be read back, and pages dirtied in between
+ * stay in the page cache until the kernel writes them back.
+ */
+static void twoDBC_ooc_evict(parsec_matrix_block_cyclic_ooc_t *dc, int position)
+{
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+    size_t offset = (size_t)position * dc->tile_stride;
+    void *addr = (char*)dc->super.mat + offset;
+
+    if( 0 != msync(addr, dc->tile_stride, MS_SYNC) ) {
+        parsec_warning("Unable to write back a tile of the out-of-core matrix: %s", strerror(errno));
+        return;
+    }
+    (void)madvise(addr, dc->tile_stride, MADV_DONTNEED);
+#if defined(POSIX_FADV_DONTNEED)
+    (void)posix_fadvise(dc->lru->fd, (off_t)offset, (off_t)dc->tile_stride, POSIX_FADV_DONTNEED);
+#endif  /* defined(POSIX_FADV_DONTNEED) */
+#else
+    (void)dc; (void)position;
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+}
+
+/*
+ * Mark a local tile as the most recently used one, adding it to the resident
+ * set if necessary and evicting the least recently used tile if the resident
+ * set grows beyond max_resident.
+ */
+static void twoDBC_ooc_touch(parsec_matrix_block_cyclic_ooc_t *dc, int position, int prefetch)
+{
+    parsec_matrix_ooc_lru_t *lru = dc->lru;
+    parsec_matrix_ooc_tile_t *tile = &lru->tiles[position];
+    parsec_matrix_ooc_tile_t *victim = NULL;
+    int was_resident;
+
+    parsec_list_lock(&lru->lru);
+    was_resident = tile->resident;
+    if( was_resident ) {
+        parsec_list_nolock_remove(&lru->lru, &tile->super);
+    } else {
+        tile->resident = 1;
+        lru->stats.nb_resident++;
+        if( prefetch ) lru->stats.nb_prefetches++;
+        else lru->stats.nb_faults++;
+        if( (dc->max_resident > 0) && (lru->stats.nb_resident > dc->max_resident) ) {
+            victim = (parsec_matrix_ooc_tile_t*)parsec_list_nolock_pop_back(&lru->lru);
+            victim->resident = 0;
+            lru->stats.nb_resident--;
+            lru->stats.nb_evictions++;
+        }
+    }
+    parsec_list_nolock_push_front(&lru->lru, &tile->super);
+    parsec_list_unlock(&lru->lru);
+
+    if( NULL != victim ) {
+        twoDBC_ooc_evict(dc, (int)(victim - lru->tiles));
+    }
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+    if( !was_resident && prefetch ) {
+        (void)madvise((char*)dc->super.mat + (size_t)position * dc->tile_stride,
+                      dc->tile_stride, MADV_WILLNEED);
+    }
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+}
+
+/* m and n are the coordinates in the global matrix */
+static inline int twoDBC_ooc_coordinates_to_position(parsec_matrix_block_cyclic_ooc_t *dc, int m, int n)
+{
+    int local_m, local_n;
+
+    local_m = m / dc->super.grid.rows;
+    assert( (m % dc->super.grid.rows) == dc->super.grid.rrank );
+    local_n = n / dc->super.grid.cols;
+    assert( (n % dc->super.grid.cols) == dc->super.grid.crank );
+
+    return dc->super.nb_elem_r * local_n + local_m;
+}
+
+static parsec_data_t* twoDBC_ooc_data_of(parsec_data_collection_t *desc, ...)
+{
+    int m, n;
+    va_list ap;
+
+    /* Get coordinates */
+    va_start(ap, desc);
+    m = (int)va_arg(ap, unsigned int);
+    n = (int)va_arg(ap, unsigned int);
+    va_end(ap);
+
+    return twoDBC_ooc_data_of_2d(desc, m, n);
+}
+
+static parsec_data_t* twoDBC_ooc_data_of_2d(parsec_data_collection_t *desc, int m, int n)
+{
+    int position;
+    parsec_matrix_block_cyclic_ooc_t * dc;
+    dc = (parsec_matrix_block_cyclic_ooc_t *)desc;
+
+    /* Assert using local info */
+    assert( m < dc->super.super.mt );
+    assert( n < dc->super.super.nt );
+
+#if defined(DISTRIBUTED)
+    assert(desc->myrank == parsec_matrix_block_cyclic_rank_of(desc, m, n));
+#endif
+
+    /* Offset by (i,j) to translate (m,n) in the global matrix */
+    m += dc->super.super.i / dc->super.super.mb;
+    n += dc->super.super.j / dc->super.super.nb;
+
+    position = twoDBC_ooc_coordinates_to_position(dc, m, n);
+    twoDBC_ooc_touch(dc, position, 0);
+
+    return parsec_tiled_matrix_create_data( &dc->super.super,
+                                            (char*)dc->super.mat + (size_t)position * dc->tile_stride,
+                                            position, (n * dc->super.super.lmt) + m );
+}
+
+static parsec_data_t* twoDBC_ooc_data_of_key(parsec_data_collection_t *desc, parsec_data_key_t key)
+{
+    int m, n;
+    parsec_matrix_block_cyclic_key2coords(desc, key, &m, &n);
+    return twoDBC_ooc_data_of_2d(desc, m, n);
+}
+
+static void twoDBC_ooc_data_of_batch(parsec_data_collection_t *desc, int count,
+                                     const int *m, const int *n, parsec_data_t **datas)
+{
+    for( int i = 0; i < count; i++ ) {
+        datas[i] = twoDBC_ooc_data_of_2d(desc, m[i], n[i]);
+    }
+}
+
+/* The position of a local tile from its key, -1 if the tile is not local */
+static inline int twoDBC_ooc_key_to_position(parsec_matrix_block_cyclic_ooc_t *dc, parsec_data_key_t key)
+{
+    /* The key is built from the coordinates in the global matrix */
+    int m = key % dc->super.super.lmt;
+    int n = key / dc->super.super.lmt;
+
+    if( ((m % dc->super.grid.rows) != dc->super.grid.rrank) ||
+        ((n % dc->super.grid.cols) != dc->super.grid.crank) ) {
+        return -1;
+    }
+    return twoDBC_ooc_coordinates_to_position(dc, m, n);
+}
+
+static int twoDBC_ooc_prefetch(parsec_data_collection_t *desc, parsec_data_key_t key)
+{
+    parsec_matrix_block_cyclic_ooc_t * dc = (parsec_matrix_block_cyclic_ooc_t *)desc;
+    int position = twoDBC_ooc_key_to_position(dc, key);
+
+    if( -1 == position ) {
+        return PARSEC_ERR_NOT_FOUND;  /* not a local tile */
+    }
+    twoDBC_ooc_touch(dc, position, 1);
+    return PARSEC_SUCCESS;
+}
+
+/*
+ * A task starts using a tile, whatever the way it got the tile: this is where
+ * the number of resident tiles is actually bounded.
+ */
+static void twoDBC_ooc_access(parsec_data_collection_t *desc, parsec_data_key_t key)
+{
+    parsec_matrix_block_cyclic_ooc_t * dc = (parsec_matrix_block_cyclic_ooc_t *)desc;
+    int position = twoDBC_ooc_key_to_position(dc, key);
+
+    if( -1 != position ) {
+        twoDBC_ooc_touch(dc, position, 0);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+#ifndef __TWO_DIM_RECTANGLE_CYCLIC_OOC_H__
+#define __TWO_DIM_RECTANGLE_CYCLIC_OOC_H__
+
+#include "parsec/data_dist/matrix/two_dim_rectangle_cyclic.h"
+
+BEGIN_C_DECLS
+
+/*
+ * Out-of-core 2-D block cyclic distribution. The local tiles are stored in a
+ * file mapped in memory, and are only brought in memory when they are
+ * accessed (data_of, or a task starting to use them) or when a task using
+ * them becomes ready (prefetch). The collection keeps track of the resident
+ * tiles, and once more than max_resident tiles are resident the least
+ * recently used one is evicted (written back to the file, and its pages
+ * released). Accesses made outside of data_of and of the tasks, for instance
+ * through the mat pointer, are not accounted for.
+ *
+ * The tiles are stored one after the other in the file, each tile starting on
+ * a page boundary. The content of the file is preserved between runs.
+ *
+ * A submatrix (parsec_tiled_matrix_submatrix) shares the mapping, the file and
+ * the resident tiles of its parent: it must not outlive the parent, and
+ * parsec_matrix_block_cyclic_ooc_destroy does not release anything for it.
+ */
+
+struct parsec_matrix_ooc_lru_s;
+
+typedef struct parsec_matrix_block_cyclic_ooc {
+    parsec_matrix_block_cyclic_t super;
+    char   *filename;     /**< file backing the local tiles, NULL for a submatrix */
+    int     fd;           /**< file descriptor of the backing file, -1 for a submatrix */
+    size_t  tile_stride;  /**< distance in bytes between two tiles in the file */
+    size_t  map_size;     /**< size of the mapping (and of the file) */
+    int     max_resident; /**< maximum number of resident tiles, 0 for no limit */
+    struct parsec_matrix_ooc_lru_s *lru; /**< resident tiles, shared with the submatrices */
+} parsec_matrix_block_cyclic_ooc_t;
+
+/**
+ * Counters describing the activity of an out-of-core collection.
+ */
+typedef struct parsec_matrix_ooc_stats_s {
+    int32_t nb_resident;   /**< number of tiles currently resident */
+    int64_t nb_faults;     /**< tiles brought in memory by data_of */
+    int64_t nb_prefetches; /**< tiles brought in memory ahead of a ready task */
+    int64_t nb_evictions;  /**< tiles evicted to honor max_resident */
+} parsec_matrix_ooc_stats_t;
+
+/**
+ * Initialize the description of an out-of-core 2-D block cyclic distributed
+ * matrix, with tile storage and without k-cyclicity. The parameters have the
+ * same meaning as for parsec_matrix_block_cyclic_init.
+ *
+ * @param filename the file storing the local tiles. It is created if it does
+ *   not exist, and extended if it is too small. When more than one process is
+ *   involved, the rank of the process is appended to the name.
+ * @param max_resident the maximum number of local tiles resident in memory, 0
+ *   for no limit.
+ * @return PARSEC_SUCCESS, or PARSEC_ERROR if the file cannot be mapped.
+ */
+int parsec_matrix_block_cyclic_ooc_init(parsec_matrix_block_cyclic_ooc_t * dc,
+                                        parsec_matrix_type_t mtype,
+                                        int myrank,
+                                        int mb,    int nb,   /* Tile size */
+                                        int lm,    int ln,   /* Global matrix size (what is stored)*/
+                                        int i,     int j,    /* Staring point in the global matrix */
+                                        int m,     int n,    /* Submatrix size (the one concerned by the computation */
+                                        int p,     int q,    /* process process grid*/
+                                        int ip,    int jq,   /* starting point on the process grid*/
+                                        const char *filename,
+                                        int max_resident);
+
+/**
+ * Write back all the tiles to the file, unmap it and release the
+ * collection. The file is kept.
+ */
+void parsec_matrix_block_cyclic_ooc_destroy(parsec_matrix_block_cyclic_ooc_t * dc);
+
+/**
+ * Retrieve the activity counters of the collection.
+ */
+void parsec_matrix_block_cyclic_ooc_stats(const parsec_matrix_block_cyclic_ooc_t * dc,
+                                          parsec_matrix_ooc_stats_t *stats);
+
+END_C_DECLS
+
+#endif /* __TWO_DIM_RECTANGLE_CYCLIC_OOC_H__*/
@@ -14,6 +14,8 @@
 #include "parsec/runtime.h"
 #include "parsec/data.h"
 #include <string.h>
+#include <errno.h>
+#include <math.h>
 #if defined(__WINDOWS__)
 #define _CRT_RAND_S
 #include <stdlib.h>
@@ -146,6 +148,7 @@ void parsec_matrix_tabular_init(parsec_matrix_tabular_t * dc,
     dc->super.super.vpid_of_key = twoDTD_vpid_of_key;
     dc->super.super.data_of     = twoDTD_data_of;
     dc->super.super.data_of_key = twoDTD_data_of_key;
+    parsec_data_collection_clear_fixed_arity(&dc->super.super);
 
     if( NULL != table ) {
         parsec_matrix_tabular_set_table( dc, table );
@@ -296,3 +299,209 @@ void parsec_matrix_tabular_clone_table_structure(parsec_matrix_tabular_t *Src, p
 
     parsec_matrix_tabular_set_table(Dst, table);
 }
+
+static parsec_two_dim_td_table_t *twoDTD_table_new(int nbtiles)
+{
+    parsec_two_dim_td_table_t *table;
+
+    table = (parsec_two_dim_td_table_t*)calloc(1, sizeof(parsec_two_dim_td_table_t)
+                                               + (nbtiles-1)*sizeof(parsec_two_dim_td_table_elem_t) );
+    table->nbelem = nbtiles;
+    return table;
+}
+
+/*
+ * Spread the local tiles of table over the virtual processes
+ */
+static void twoDTD_table_set_vpids(parsec_matrix_tabular_t *dc, parsec_two_dim_td_table_t *table)
+{
+    int nbvp = vpmap_get_nb_vp(), nb_local = 0;
+
+    for(int k = 0; k < table->nbelem; k++) {
+        if( table->elems[k].rank == dc->super.super.myrank ) {
+            table->elems[k].vpid = nb_local++ % nbvp;
+        } else {
+            table->elems[k].vpid = -1;
+        }
+    }
+}
+
+/*
+ * Coordinates of the d-th cell of the Hilbert curve of a side x side
+ * square, side being a power of 2
+ */
+static void twoDTD_hilbert_d2xy(int side, int64_t d, int *x, int *y)
+{
+    int rx, ry, tmp;
+
+    *x = *y = 0;
+    for(int s = 1; s < side; s *= 2) {
+        rx = 1 & (int)(d / 2);
+        ry = 1 & (int)(d ^ rx);
+        if( 0 == ry ) {
+            if( 1 == rx ) {
+                *x = s - 1 - *x;
+                *y = s - 1 - *y;
+            }
+            tmp = *x; *x = *y; *y = tmp;
+        }
+        *x += s * rx;
+        *y += s * ry;
+        d /= 4;
+    }
+}
+
+void parsec_matrix_tabular_costs_from_function(parsec_matrix_tabular_t *dc,
+                                               parsec_matrix_tabular_cost_fn_t fn, void *op_data,
+                                               double *costs)
+{
+    int m, n;
+
+    for(n = 0; n < dc->super.lnt; n++) {
+        for(m = 0; m < dc->super.lmt; m++) {
+            costs[(n * dc->super.lmt) + m] = fn(m, n, op_data);
+        }
+    }
+}
+
+int parsec_matrix_tabular_costs_from_file(parsec_matrix_tabular_t *dc,
+                                          const char *filename, double *costs)
+{
+    int nbtiles = dc->super.lmt * dc->super.lnt;
+    char line[256];
+    uint64_t key;
+    double cost;
+    FILE *f;
+
+    f = fopen(filename, "r");
+    if( NULL == f ) {
+        parsec_warning("Unable to open the tile costs file %s: %s", filename, strerror(errno));
+        return PARSEC_ERR_NOT_FOUND;
+    }
+    memset(costs, 0, nbtiles * sizeof(double));
+    while( NULL != fgets(line, sizeof(line), f) ) {
+        if( '#' == line[0] ) continue;
+        if( 2 != sscanf(line, "%" SCNu64 " %lf", &key, &cost) ) continue;
+        if( key >= (uint64_t)nbtiles ) {
+            parsec_debug_verbose(10, parsec_debug_output,
+                                 "Ignore the cost of tile %" PRIu64 " out of the %d tiles of the matrix",
+                                 key, nbtiles);
+            continue;
+        }
+        costs[key] += cost;
+    }
+    fclose(f);
+    return PARSEC_SUCCESS;
+}
+
+parsec_two_dim_td_table_t *parsec_matrix_tabular_balanced_table(parsec_matrix_tabular_t *dc,
+                                                                const double *costs, int cycles)
+{
+    int lmt = dc->super.lmt, lnt = dc->super.lnt, nbtiles = lmt * lnt;
+    int nodes = dc->super.super.nodes, parts, side, m, n, k, p, uniform;
+    parsec_two_dim_td_table_t *table;
+    double total = 0.0, prefix = 0.0, target, c;
+
+    if( cycles < 1 ) cycles = 1;
+    parts = nodes * cycles;
+
+    for(k = 0; k < nbtiles; k++) {
+        if( costs[k] > 0.0 ) total += costs[k];
+    }
+    /* Without any cost, balance the number of tiles */
+    uniform = !(total > 0.0);
+    if( uniform ) total = (double)nbtiles;
+    target = total / (double)parts;
+
+    table = twoDTD_table_new(nbtiles);
+    for(side = 1; side < lmt || side < lnt; side *= 2) ;
+    for(int64_t d = 0; d < (int64_t)side * side; d++) {
+        twoDTD_hilbert_d2xy(side, d, &m, &n);
+        if( m >= lmt || n >= lnt ) continue;
+        k = (n * lmt) + m;
+        c = uniform ? 1.0 : (costs[k] > 0.0 ? costs[k] : 0.0);
+        /* A tile goes to the segment that holds the middle of its cost */
+        p = (int)((prefix + c / 2.0) / target);
+        if( p >= parts ) p = parts - 1;
+        prefix += c;
+        table->elems[k].rank = p % nodes;
+    }
+    twoDTD_table_set_vpids(dc, table);
+    return table;
+}
+
+void parsec_matrix_tabular_set_balanced_table(parsec_matrix_tabular_t *dc,
+                                              const double *costs, int cycles)
+{
+    parsec_matrix_tabular_set_table(dc, parsec_matrix_tabular_balanced_table(dc, costs, cycles));
+}
+
+parsec_two_dim_td_table_t *parsec_matrix_tabular_rebalance(parsec_matrix_tabular_t *dc,
+                                                           const double *costs, double tolerance,
+                                                           int **moved, int *nb_moved)
+{
+    int lmt = dc->super.lmt, lnt = dc->super.lnt, nbtiles = lmt * lnt;
+    int nodes = dc->super.super.nodes, rmax, rmin, best, best_adj, adj, nb, m, n, k;
+    parsec_two_dim_td_table_t *table;
+    double *loads, average = 0.0, gap, best_dist, c;
+
+    assert( NULL != dc->tiles_table );
+    table = twoDTD_table_new(nbtiles);
+    loads = (double*)calloc(nodes, sizeof(double));
+    for(k = 0; k < nbtiles; k++) {
+        table->elems[k].rank = dc->tiles_table->elems[k].rank;
+        c = costs[k] > 0.0 ? costs[k] : 0.0;
+        loads[table->elems[k].rank] += c;
+        average += c;
+    }
+    average /= (double)nodes;
+
+    /* Every move strictly decreases the sum of the squares of the loads */
+    for(int iter = 0; iter < nbtiles * nodes; iter++) {
+        rmax = rmin = 0;
+        for(int r = 1; r < nodes; r++) {
+            if( loads[r] > loads[rmax] ) rmax = r;
+            if( loads[r] < loads[rmin] ) rmin = r;
+        }
+        if( loads[rmax] <= (1.0 + tolerance) * average ) break;
+        gap = loads[rmax] - loads[rmin];
+
+        /* Pick the tile that best evens the two ranks, among the tiles
+         * next to the region of rmin if any */
+        best = -1; best_adj = 0; best_dist = gap;
+        for(n = 0; n < lnt; n++) {
+            for(m = 0; m < lmt; m++) {
+                k = (n * lmt) + m;
+                c = costs[k];
+                if( (uint32_t)rmax != table->elems[k].rank || !(c > 0.0) || !(c < gap) ) continue;
+                adj = ((m > 0       && (uint32_t)rmin == table->elems[k-1].rank) ||
+                       (m < lmt - 1 && (uint32_t)rmin == table->elems[k+1].rank) ||
+                       (n > 0       && (uint32_t)rmin == table->elems[k-lmt].rank) ||
+                       (n < lnt - 1 && (uint32_t)rmin == table->elems[k+lmt].rank));
+                if( adj < best_adj ) continue;
+                if( adj == best_adj && fabs(c - gap / 2.0) >= best_dist ) continue;
+                best = k; best_adj = adj; best_dist = fabs(c - gap / 2.0);
+            }
+        }
+        if( -1 == best ) break;
+        table->elems[best].rank = rmin;
+        loads[rmax] -= costs[best];
+        loads[rmin] += costs[best];
+    }
+    free(loads);
+    twoDTD_table_set_vpids(dc, table);
+
+    nb = 0;
+    for(k = 0; k < nbtiles; k++) {
+        if( table->elems[k].rank != dc->tiles_table->elems[k].rank ) nb++;
+    }
+    if( NULL != moved ) {
+        *moved = (int*)malloc((nb > 0 ? nb : 1) * sizeof(int));
+        nb = 0;
+        for(k = 0; k < nbtiles; k++) {
+            if( table->elems[k].rank != dc->tiles_table->elems[k].rank ) (*moved)[nb++] = k;
+        }
+    }
+    if( NULL != nb_moved ) *nb_moved = nb;
+    return table;
+}
@@ -67,6 +67,62 @@ void parsec_matrix_tabular_set_user_table(parsec_matrix_tabular_t *dc, parsec_tw
 void parsec_matrix_tabular_set_random_table(parsec_matrix_tabular_t *dc, unsigned int seed);
 void parsec_matrix_tabular_clone_table_structure(parsec_matrix_tabular_t *Src, parsec_matrix_tabular_t *Dst);
 
+/**
+ * Cost model of the tiles, used to build balanced tables.
+ * @param m row index of the tile in the entire matrix
+ * @param n column index of the tile in the entire matrix
+ * @param op_data user data
+ * @return the estimated cost of the work on tile (m, n)
+ */
+typedef double (*parsec_matrix_tabular_cost_fn_t)(int m, int n, void *op_data);
+
+/**
+ * Fill costs, an array of lmt * lnt elements in column major order, with
+ * the estimates of the cost model fn.
+ */
+void parsec_matrix_tabular_costs_from_function(parsec_matrix_tabular_t *dc,
+                                               parsec_matrix_tabular_cost_fn_t fn, void *op_data,
+                                               double *costs);
+
+/**
+ * Fill costs, an array of lmt * lnt elements in column major order, with
+ * the time spent in the tasks of each tile during a previous run, as
+ * extracted from its profiling trace by parsec-dbp2costs. The tiles are
+ * identified by their key, which is (n * lmt + m) for the tiled matrices.
+ * @return PARSEC_SUCCESS, or PARSEC_ERR_NOT_FOUND if the file cannot be read
+ */
+int parsec_matrix_tabular_costs_from_file(parsec_matrix_tabular_t *dc,
+                                          const char *filename, double *costs);
+
+/**
+ * Build a table that gives each rank about the same total cost. The tiles
+ * are ordered along a Hilbert curve, which keeps neighbouring tiles
+ * together, and the curve is cut in nodes * cycles segments of equal cost
+ * dealt cyclically to the ranks: a single cycle gives each rank one compact
+ * region, more cycles spread the work of each region over more ranks.
+ * All the ranks must provide the same costs. The table can be given to
+ * parsec_matrix_tabular_set_table.
+ */
+parsec_two_dim_td_table_t *parsec_matrix_tabular_balanced_table(parsec_matrix_tabular_t *dc,
+                                                                const double *costs, int cycles);
+void parsec_matrix_tabular_set_balanced_table(parsec_matrix_tabular_t *dc,
+                                              const double *costs, int cycles);
+
+/**
+ * Build a table from the table of dc, for new costs, that moves as few tiles
+ * as possible. Tiles are moved from the most to the least loaded rank,
+ * preferring tiles next to the region of the least loaded rank, until no
+ * rank exceeds the average load by more than tolerance (0.05 for 5%).
+ * @param moved if not NULL, returns the keys of the tiles changing of rank,
+ *        to be released with free
+ * @param nb_moved if not NULL, returns the number of moved tiles
+ * @return the new table, to be given to a new collection whose content can
+ *         be moved with parsec_redistribute
+ */
+parsec_two_dim_td_table_t *parsec_matrix_tabular_rebalance(parsec_matrix_tabular_t *dc,
+                                                           const double *costs, double tolerance,
+                                                           int **moved, int *nb_moved);
+
 /* include deprecated symbols */
 #include "parsec/data_dist/matrix/deprecated/two_dim_tabular.h"
 
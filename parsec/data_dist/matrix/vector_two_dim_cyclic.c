@@ -14,6 +14,9 @@
 static uint32_t vector_twoDBC_rank_of(parsec_data_collection_t* dc, ...);
 static int32_t  vector_twoDBC_vpid_of(parsec_data_collection_t* dc, ...);
 static parsec_data_t* vector_twoDBC_data_of(parsec_data_collection_t* dc, ...);
+static uint32_t vector_twoDBC_rank_of_2d(parsec_data_collection_t* dc, int m, int n);
+static int32_t  vector_twoDBC_vpid_of_2d(parsec_data_collection_t* dc, int m, int n);
+static parsec_data_t* vector_twoDBC_data_of_2d(parsec_data_collection_t* dc, int m, int n);
 
 #if defined(PARSEC_PROF_TRACE) || defined(PARSEC_HAVE_CUDA)
 static parsec_data_key_t vector_twoDBC_data_key(struct parsec_data_collection_s *desc, ...);
@@ -124,6 +127,12 @@ void parsec_vector_two_dim_cyclic_init( parsec_vector_two_dim_cyclic_t * dc,
     o->rank_of = vector_twoDBC_rank_of;
     o->vpid_of = vector_twoDBC_vpid_of;
     o->data_of = vector_twoDBC_data_of;
+    o->rank_of_2d = vector_twoDBC_rank_of_2d;
+    o->vpid_of_2d = vector_twoDBC_vpid_of_2d;
+    o->data_of_2d = vector_twoDBC_data_of_2d;
+    o->rank_of_paired = o->rank_of;
+    o->vpid_of_paired = o->vpid_of;
+    o->data_of_paired = o->data_of;
 
 #if defined(PARSEC_PROF_TRACE) || defined(PARSEC_HAVE_CUDA)
     o->data_key      = vector_twoDBC_data_key;
@@ -157,19 +166,27 @@ void parsec_vector_two_dim_cyclic_init( parsec_vector_two_dim_cyclic_t * dc,
  */
 static uint32_t vector_twoDBC_rank_of(parsec_data_collection_t * desc, ...)
 {
-    unsigned int m;
-    unsigned int rr = 0;
-    unsigned int cr = 0;
-    unsigned int res;
+    int m;
     va_list ap;
-    parsec_vector_two_dim_cyclic_t * dc;
-    dc = (parsec_vector_two_dim_cyclic_t *)desc;
 
     /* Get coordinates */
     va_start(ap, desc);
-    m = va_arg(ap, unsigned int);
+    m = (int)va_arg(ap, unsigned int);
     va_end(ap);
 
+    return vector_twoDBC_rank_of_2d(desc, m, 0);
+}
+
+static uint32_t vector_twoDBC_rank_of_2d(parsec_data_collection_t * desc, int _m, int n)
+{
+    unsigned int m = (unsigned int)_m;
+    unsigned int rr = 0;
+    unsigned int cr = 0;
+    unsigned int res;
+    parsec_vector_two_dim_cyclic_t * dc;
+    dc = (parsec_vector_two_dim_cyclic_t *)desc;
+    (void)n;
+
     /* Offset by (i,j) to translate (m,n) in the global matrix */
     m += dc->super.i / dc->super.mb;
 
@@ -187,13 +204,26 @@ static uint32_t vector_twoDBC_rank_of(parsec_data_collection_t * desc, ...)
 
 static int32_t vector_twoDBC_vpid_of(parsec_data_collection_t *desc, ...)
 {
-    int m, p, q, pq;
+    int m;
+    va_list ap;
+
+    /* Get coordinates */
+    va_start(ap, desc);
+    m = (int)va_arg(ap, unsigned int);
+    va_end(ap);
+
+    return vector_twoDBC_vpid_of_2d(desc, m, 0);
+}
+
+static int32_t vector_twoDBC_vpid_of_2d(parsec_data_collection_t *desc, int m, int n)
+{
+    int p, q, pq;
     int local_m = 0;
     int local_n = 0;
     parsec_vector_two_dim_cyclic_t * dc;
-    va_list ap;
     int32_t vpid;
     dc = (parsec_vector_two_dim_cyclic_t *)desc;
+    (void)n;
 
     /* If 1 VP, always return 0 */
     pq = vpmap_get_nb_vp();
@@ -204,11 +234,6 @@ static int32_t vector_twoDBC_vpid_of(parsec_data_collection_t *desc, ...)
     q = dc->grid.vp_q;
     assert(p*q == pq);
 
-    /* Get coordinates */
-    va_start(ap, desc);
-    m = (int)va_arg(ap, unsigned int);
-    va_end(ap);
-
     /* Offset by (i,j) to translate (m,n) in the global matrix */
     m += dc->super.i / dc->super.mb;
 
@@ -232,17 +257,24 @@ static int32_t vector_twoDBC_vpid_of(parsec_data_collection_t *desc, ...)
 static parsec_data_t* vector_twoDBC_data_of(parsec_data_collection_t *desc, ...)
 {
     int m;
-    size_t pos = 0;
-    int local_m;
     va_list ap;
-    parsec_vector_two_dim_cyclic_t * dc;
-    dc = (parsec_vector_two_dim_cyclic_t *)desc;
 
     /* Get coordinates */
     va_start(ap, desc);
     m = (int)va_arg(ap, unsigned int);
     va_end(ap);
 
+    return vector_twoDBC_data_of_2d(desc, m, 0);
+}
+
+static parsec_data_t* vector_twoDBC_data_of_2d(parsec_data_collection_t *desc, int m, int n)
+{
+    size_t pos = 0;
+    int local_m;
+    parsec_vector_two_dim_cyclic_t * dc;
+    dc = (parsec_vector_two_dim_cyclic_t *)desc;
+    (void)n;
+
     /* Offset by (i,j) to translate (m,n) in the global matrix */
     m += dc->super.i / dc->super.mb;
 
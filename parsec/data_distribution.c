@@ -6,7 +6,9 @@
 
 #include "parsec/parsec_config.h"
 #include "parsec/data_distribution.h"
+#include "parsec/data_compress.h"
 #include "parsec/utils/debug.h"
+#include "parsec/sys/atomic.h"
 
 #if defined(PARSEC_HAVE_STDARG_H)
 #include <stdarg.h>
@@ -23,6 +25,8 @@
 static parsec_hash_table_t *parsec_dc_hash_table = NULL;
 static int parsec_dc_hash_table_size = 101;
 
+volatile int32_t parsec_data_collection_nb_prefetch = 0;
+
 static parsec_key_fn_t dc_key_fns = {
     .key_equal = parsec_hash_table_generic_64bits_key_equal,
     .key_print = parsec_hash_table_generic_64bits_key_print,
@@ -91,9 +95,25 @@ parsec_data_collection_init(parsec_data_collection_t *d,
     d->default_dtt = PARSEC_DATATYPE_NULL;
 }
 
+void
+parsec_data_collection_set_prefetch(parsec_data_collection_t *d,
+                                    int (*prefetch)(parsec_data_collection_t *d, parsec_data_key_t key),
+                                    void (*access)(parsec_data_collection_t *d, parsec_data_key_t key))
+{
+    if( NULL == d->prefetch && NULL != prefetch ) {
+        parsec_atomic_fetch_inc_int32(&parsec_data_collection_nb_prefetch);
+    } else if( NULL != d->prefetch && NULL == prefetch ) {
+        parsec_atomic_fetch_dec_int32(&parsec_data_collection_nb_prefetch);
+    }
+    d->prefetch = prefetch;
+    d->access   = (NULL != prefetch) ? access : NULL;
+}
+
 void
 parsec_data_collection_destroy(parsec_data_collection_t *d)
 {
+    parsec_data_collection_set_prefetch(d, NULL, NULL);
+    parsec_data_compress_destroy(d);
 #if defined(PARSEC_PROF_TRACE)
     if( NULL != d->key_dim ) free(d->key_dim);
     d->key_dim = NULL;
@@ -110,8 +130,13 @@ void parsec_data_collection_set_key( parsec_data_collection_t* d, const char* na
 {
     char *kdim = (NULL != d->key_dim)? d->key_dim: "";
     char dim[strlen(name) + strlen(kdim) + 4];
+    char key[strlen(name) + 20], value[32];
     (d)->key_base = strdup(name);
     sprintf(dim, "%s%s", name, kdim);
     parsec_profiling_add_information( "DIMENSION", dim );
+    /* The tasks events identify their collection by its address (dc_key) */
+    sprintf(key, "DATA_COLLECTION:%s", name);
+    snprintf(value, sizeof(value), "%" PRIu64, (uint64_t)(uintptr_t)d);
+    parsec_profiling_add_information( key, value );
 }
 #endif  /* defined(PARSEC_PROF_TRACE) */
@@ -44,6 +44,10 @@ struct parsec_data_s {
                                                   * are multiple choices. -1 means no preference. */
     struct parsec_data_collection_s*     dc;
     uint32_t                   nb_elts;          /* size in bytes of the memory layout */
+    struct parsec_reshape_cache_s *reshape_cache; /* reshaped copies shared by the consumers, lazily
+                                                  * allocated (see parsec_reshape.c) */
+    struct parsec_data_compressed_s *compressed; /* compression state of the collection copy, lazily
+                                                  * allocated (see data_compress.c) */
     struct parsec_data_copy_s *device_copies[1]; /* this array allocated according to the number of devices
                                                   * (parsec_supported_number_of_devices). It points to the most recent
                                                   * version of the data.
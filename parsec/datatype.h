@@ -123,6 +123,55 @@ int parsec_type_match(parsec_datatype_t dtt1,
  * @return PARSEC_SUCCESS if it was created with MPI_Type_contiguous, PARSEC_ERROR otherwise.
  */
 int parsec_type_contiguous(parsec_datatype_t dtt);
+
+/**
+ * Native pack/unpack engine. A datatype is decoded once into a flat list of
+ * contiguous byte blocks (in type map order), which allows local conversions
+ * between two layouts to be done with plain memory copies, from any thread,
+ * without going through the communication library.
+ */
+typedef struct parsec_type_native_layout_s parsec_type_native_layout_t;
+
+/**
+ * Initialize (resp. release) the cache of decoded layouts. Must be called from
+ * a thread allowed to call into MPI.
+ */
+int parsec_type_native_init(void);
+int parsec_type_native_fini(void);
+
+/**
+ * Return the decoded layout of a datatype, decoding and caching it if
+ * necessary. This function calls into MPI and must therefore only be used by
+ * threads allowed to do so.
+ * @param[in] parsec_datatype_t datatype
+ * @return the layout, to be released with parsec_type_native_release, or NULL
+ * if the datatype cannot be handled natively.
+ */
+parsec_type_native_layout_t* parsec_type_native_decode(parsec_datatype_t dtt);
+
+/**
+ * Return the cached layout of a datatype, without calling into MPI.
+ * @param[in] parsec_datatype_t datatype
+ * @return the layout, to be released with parsec_type_native_release, or NULL
+ * if the datatype has not been decoded yet or cannot be handled natively.
+ */
+parsec_type_native_layout_t* parsec_type_native_find(parsec_datatype_t dtt);
+
+/**
+ * Release a layout returned by parsec_type_native_decode or
+ * parsec_type_native_find. The layout remains valid until then, even if the
+ * datatype is freed in the meantime.
+ */
+void parsec_type_native_release(parsec_type_native_layout_t *layout);
+
+/**
+ * Copy src_count elements of layout src_layout from src into dst_count
+ * elements of layout dst_layout in dst, with the same semantic as a matching
+ * send/receive.
+ * @return PARSEC_SUCCESS, or PARSEC_ERROR if the destination is too small.
+ */
+int parsec_type_native_copy(void *dst, const parsec_type_native_layout_t *dst_layout, uint64_t dst_count,
+                            const void *src, const parsec_type_native_layout_t *src_layout, uint64_t src_count);
 END_C_DECLS
 
 /** @} */
@@ -150,3 +150,38 @@ int parsec_type_contiguous(parsec_datatype_t dtt)
     (void)dtt;
     return PARSEC_SUCCESS;
 }
+
+int parsec_type_native_init(void)
+{
+    return PARSEC_SUCCESS;
+}
+
+int parsec_type_native_fini(void)
+{
+    return PARSEC_SUCCESS;
+}
+
+parsec_type_native_layout_t* parsec_type_native_decode(parsec_datatype_t dtt)
+{
+    (void)dtt;
+    return NULL;
+}
+
+parsec_type_native_layout_t* parsec_type_native_find(parsec_datatype_t dtt)
+{
+    (void)dtt;
+    return NULL;
+}
+
+void parsec_type_native_release(parsec_type_native_layout_t *layout)
+{
+    (void)layout;
+}
+
+int parsec_type_native_copy(void *dst, const parsec_type_native_layout_t *dst_layout, uint64_t dst_count,
+                            const void *src, const parsec_type_native_layout_t *src_layout, uint64_t src_count)
+{
+    (void)dst; (void)dst_layout; (void)dst_count;
+    (void)src; (void)src_layout; (void)src_count;
+    return PARSEC_ERR_NOT_IMPLEMENTED;
+}
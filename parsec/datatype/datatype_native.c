@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/datatype.h"
+#include "parsec/class/parsec_hash_table.h"
+#include "parsec/sys/atomic.h"
+#include "parsec/utils/debug.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(PARSEC_HAVE_MPI)
+#error __FILE__ should only be used when MPI support is enabled.
+#endif  /* !defined(PARSEC_HAVE_MPI) */
+
+/**
+ * Native pack/unpack engine: MPI datatypes are decoded (through the envelope
+ * and contents of their constructors) into a flat list of contiguous byte
+ * blocks, stored in type map order and with adjacent blocks merged. Copying
+ * between two layouts is then a simple walk over the two block lists, and
+ * each contiguous run is moved with a memcpy the compiler and the libc are
+ * free to vectorize.
+ *
+ * Decoding calls into MPI, and is therefore restricted to threads allowed to
+ * do so. Decoded layouts are cached in a hash table keyed by the datatype
+ * handle, and can be looked up and used by any thread. The cache entry of a
+ * derived datatype is attached to the datatype as an MPI attribute, such that
+ * it is evicted when the datatype is freed (and its handle possibly reused).
+ * The layouts are reference counted: the cache holds one reference, and each
+ * lookup returns a new one, so a layout evicted while a thread is copying
+ * with it is only freed once that thread releases it.
+ */
+
+/* Datatypes decoding into more blocks than this are left to MPI */
+#define PARSEC_TYPE_NATIVE_MAX_BLOCKS (1 << 16)
+
+typedef struct parsec_type_native_block_s {
+    ptrdiff_t disp;    /**< Displacement in bytes from the start of the element */
+    size_t    length;  /**< Length in bytes of the contiguous block */
+} parsec_type_native_block_t;
+
+struct parsec_type_native_layout_s {
+    parsec_hash_table_item_t   ht_item;
+    parsec_datatype_t          dtt;
+    int                        supported;  /**< 0 if the datatype must be handled by MPI */
+    int                        named;      /**< predefined datatypes are never freed */
+    volatile int32_t           refcount;   /**< the cache and the threads using the layout */
+    size_t                     size;       /**< Number of bytes of data in one element */
+    ptrdiff_t                  extent;     /**< Distance between two consecutive elements */
+    int                        nb_blocks;
+    parsec_type_native_block_t blocks[1];
+};
+
+typedef struct native_builder_s {
+    parsec_type_native_block_t *blocks;
+    int                         nb_blocks;
+    int                         allocated;
+} native_builder_t;
+
+static parsec_hash_table_t *native_layouts = NULL;
+static int native_keyval = MPI_KEYVAL_INVALID;
+
+static parsec_key_fn_t native_key_fns = {
+    .key_equal = parsec_hash_table_generic_64bits_key_equal,
+    .key_print = parsec_hash_table_generic_64bits_key_print,
+    .key_hash  = parsec_hash_table_generic_64bits_key_hash
+};
+
+#define NATIVE_KEY(dtt) ((parsec_key_t)(uintptr_t)(dtt))
+
+static int native_builder_append(native_builder_t *b, ptrdiff_t disp, size_t length)
+{
+    if( 0 == length ) return 0;
+    if( b->nb_blocks > 0 ) {
+        parsec_type_native_block_t *last = &b->blocks[b->nb_blocks-1];
+        if( last->disp + (ptrdiff_t)last->length == disp ) {
+            last->length += length;
+            return 0;
+        }
+    }
+    if( b->nb_blocks == b->allocated ) {
+        if( b->allocated >= PARSEC_TYPE_NATIVE_MAX_BLOCKS ) return -1;
+        b->allocated = (0 == b->allocated) ? 16 : 2 * b->allocated;
+        b->blocks = realloc(b->blocks, b->allocated * sizeof(parsec_type_native_block_t));
+    }
+    b->blocks[b->nb_blocks].disp   = disp;
+    b->blocks[b->nb_blocks].length = length;
+    b->nb_blocks++;
+    return 0;
+}
+
+/* Append count consecutive copies of the child layout, starting at disp */
+static int native_builder_repeat(native_builder_t *b, const native_builder_t *child,
+                                 ptrdiff_t extent, ptrdiff_t disp, int count)
+{
+    if( 1 == child->nb_blocks && (ptrdiff_t)child->blocks[0].length == extent ) {
+        /* dense child: all the copies form a single block */
+        return native_builder_append(b, disp + child->blocks[0].disp, (size_t)count * extent);
+    }
+    for( int k = 0; k < count; k++ ) {
+        for( int i = 0; i < child->nb_blocks; i++ ) {
+            if( 0 != native_builder_append(b, disp + k * extent + child->blocks[i].disp,
+                                           child->blocks[i].length) )
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static int native_flatten(MPI_Datatype dtt, native_builder_t *b, ptrdiff_t disp);
+
+static int native_flatten_child(MPI_Datatype dtt, native_builder_t *child, ptrdiff_t *extent)
+{
+    MPI_Aint lb, ext;
+    child->nb_blocks = 0;
+    if( MPI_SUCCESS != MPI_Type_get_extent(dtt, &lb, &ext) ) return -1;
+    *extent = ext;
+    return native_flatten(dtt, child, 0);
+}
+
+static int native_flatten_subarray(native_builder_t *b, const native_builder_t *child, ptrdiff_t extent,
+                                   ptrdiff_t disp, int ndims, const int *sizes, const int *subsizes,
+                                   const int *starts, int order)
+{
+    ptrdiff_t stride[ndims];
+    int idx[ndims], d, fast, rc = 0;
+
+    for( d = 0; d < ndims; d++ ) {
+        if( 0 == subsizes[d] ) return 0;
+        idx[d] = 0;
+    }
+    if( MPI_ORDER_C == order ) {
+        fast = ndims - 1;
+        stride[fast] = extent;
+        for( d = fast - 1; d >= 0; d-- ) stride[d] = stride[d+1] * sizes[d+1];
+    } else {
+        fast = 0;
+        stride[0] = extent;
+        for( d = 1; d < ndims; d++ ) stride[d] = stride[d-1] * sizes[d-1];
+    }
+    /* Walk the subarray in type map order, one contiguous row at a time */
+    while( 1 ) {
+        ptrdiff_t offset = disp;
+        for( d = 0; d < ndims; d++ ) offset += (ptrdiff_t)(starts[d] + idx[d]) * stride[d];
+        if( 0 != (rc = native_builder_repeat(b, child, extent, offset, subsizes[fast])) )
+            return rc;
+        if( MPI_ORDER_C == order ) {
+            for( d = fast - 1; d >= 0; d-- ) {
+                if( ++idx[d] < subsizes[d] ) break;
+                idx[d] = 0;
+            }
+            if( d < 0 ) break;
+        } else {
+            for( d = fast + 1; d < ndims; d++ ) {
+                if( ++idx[d] < subsizes[d] ) break;
+                idx[d] = 0;
+            }
+            if( d >= ndims ) break;
+        }
+    }
+    return 0;
+}
+
+/* Append the blocks of one element of dtt, located at disp */
+static int native_flatten(MPI_Datatype dtt, native_builder_t *b, ptrdiff_t disp)
+{
+    int ni, na, nd, combiner, count, i, rc = -1;
+    int *ints;
+    MPI_Aint *addrs;
+    MPI_Datatype *types;
+    native_builder_t child = { NULL, 0, 0 };
+    ptrdiff_t extent;
+
+    if( MPI_SUCCESS != MPI_Type_get_envelope(dtt, &ni, &na, &nd, &combiner) ) return -1;
+    if( MPI_COMBINER_NAMED == combiner ) {
+        MPI_Aint lb, ext;
+        int size;
+        MPI_Type_size(dtt, &size);
+        MPI_Type_get_extent(dtt, &lb, &ext);
+        /* predefined types with holes (e.g. MPI_DOUBLE_INT) are left to MPI */
+        if( (MPI_Aint)size != ext || 0 != lb ) return -1;
+        return native_builder_append(b, disp, size);
+    }
+
+    ints  = (int*)malloc((ni + 1) * sizeof(int));
+    addrs = (MPI_Aint*)malloc((na + 1) * sizeof(MPI_Aint));
+    types = (MPI_Datatype*)malloc((nd + 1) * sizeof(MPI_Datatype));
+    if( MPI_SUCCESS != MPI_Type_get_contents(dtt, ni, na, nd, ints, addrs, types) ) {
+        nd = 0;
+        goto cleanup;
+    }
+
+    switch( combiner ) {
+    case MPI_COMBINER_DUP:
+    case MPI_COMBINER_RESIZED:
+        rc = native_flatten(types[0], b, disp);
+        break;
+    case MPI_COMBINER_CONTIGUOUS:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        rc = native_builder_repeat(b, &child, extent, disp, ints[0]);
+        break;
+    case MPI_COMBINER_VECTOR:
+    case MPI_COMBINER_HVECTOR:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        for( rc = 0, i = 0; (0 == rc) && (i < ints[0]); i++ ) {
+            ptrdiff_t stride = (MPI_COMBINER_VECTOR == combiner) ? (ptrdiff_t)ints[2] * extent : addrs[0];
+            rc = native_builder_repeat(b, &child, extent, disp + i * stride, ints[1]);
+        }
+        break;
+    case MPI_COMBINER_INDEXED:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        count = ints[0];
+        for( rc = 0, i = 0; (0 == rc) && (i < count); i++ )
+            rc = native_builder_repeat(b, &child, extent, disp + (ptrdiff_t)ints[1+count+i] * extent, ints[1+i]);
+        break;
+    case MPI_COMBINER_HINDEXED:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        for( rc = 0, i = 0; (0 == rc) && (i < ints[0]); i++ )
+            rc = native_builder_repeat(b, &child, extent, disp + addrs[i], ints[1+i]);
+        break;
+    case MPI_COMBINER_INDEXED_BLOCK:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        for( rc = 0, i = 0; (0 == rc) && (i < ints[0]); i++ )
+            rc = native_builder_repeat(b, &child, extent, disp + (ptrdiff_t)ints[2+i] * extent, ints[1]);
+        break;
+#if defined(PARSEC_HAVE_MPI_30)
+    case MPI_COMBINER_HINDEXED_BLOCK:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        for( rc = 0, i = 0; (0 == rc) && (i < ints[0]); i++ )
+            rc = native_builder_repeat(b, &child, extent, disp + addrs[i], ints[1]);
+        break;
+#endif  /* defined(PARSEC_HAVE_MPI_30) */
+    case MPI_COMBINER_STRUCT:
+        for( rc = 0, i = 0; (0 == rc) && (i < ints[0]); i++ ) {
+            if( 0 != (rc = native_flatten_child(types[i], &child, &extent)) ) break;
+            rc = native_builder_repeat(b, &child, extent, disp + addrs[i], ints[1+i]);
+        }
+        break;
+    case MPI_COMBINER_SUBARRAY:
+        if( 0 != native_flatten_child(types[0], &child, &extent) ) break;
+        count = ints[0];
+        rc = native_flatten_subarray(b, &child, extent, disp, count,
+                                     &ints[1], &ints[1+count], &ints[1+2*count], ints[1+3*count]);
+        break;
+    default:
+        /* darray and the Fortran specific constructors are left to MPI */
+        break;
+    }
+
+  cleanup:
+    for( i = 0; i < nd; i++ ) {
+        int tni, tna, tnd, tcombiner;
+        MPI_Type_get_envelope(types[i], &tni, &tna, &tnd, &tcombiner);
+        if( MPI_COMBINER_NAMED != tcombiner )
+            MPI_Type_free(&types[i]);
+    }
+    free(child.blocks);
+    free(ints); free(addrs); free(types);
+    return rc;
+}
+
+static parsec_type_native_layout_t* native_layout_build(parsec_datatype_t dtt)
+{
+    parsec_type_native_layout_t *layout;
+    native_builder_t b = { NULL, 0, 0 };
+    int ni, na, nd, combiner = MPI_COMBINER_NAMED, size, supported;
+    MPI_Aint lb, extent;
+    size_t total = 0;
+
+    supported = (MPI_SUCCESS == MPI_Type_get_envelope(dtt, &ni, &na, &nd, &combiner)) &&
+                (MPI_SUCCESS == MPI_Type_size(dtt, &size)) &&
+                (MPI_SUCCESS == MPI_Type_get_extent(dtt, &lb, &extent)) &&
+                (0 == native_flatten(dtt, &b, 0));
+    for( int i = 0; supported && i < b.nb_blocks; i++ )
+        total += b.blocks[i].length;
+    if( supported && (total != (size_t)size) ) supported = 0;
+    if( !supported ) b.nb_blocks = 0;
+
+    layout = (parsec_type_native_layout_t*)malloc(sizeof(parsec_type_native_layout_t) +
+                                                  b.nb_blocks * sizeof(parsec_type_native_block_t));
+    layout->ht_item.key = NATIVE_KEY(dtt);
+    layout->dtt         = dtt;
+    layout->supported   = supported;
+    layout->named       = (MPI_COMBINER_NAMED == combiner);
+    layout->refcount    = 1;
+    layout->size        = supported ? (size_t)size : 0;
+    layout->extent      = supported ? extent : 0;
+    layout->nb_blocks   = b.nb_blocks;
+    if( b.nb_blocks > 0 )
+        memcpy(layout->blocks, b.blocks, b.nb_blocks * sizeof(parsec_type_native_block_t));
+    free(b.blocks);
+    PARSEC_DEBUG_VERBOSE(20, parsec_debug_output,
+                         "Native layout of datatype %p: %s, %d blocks, size %zu extent %td",
+                         (void*)(uintptr_t)dtt, supported ? "supported" : "unsupported",
+                         layout->nb_blocks, layout->size, layout->extent);
+    return layout;
+}
+
+void parsec_type_native_release(parsec_type_native_layout_t *layout)
+{
+    if( (NULL != layout) && (1 == parsec_atomic_fetch_dec_int32(&layout->refcount)) )
+        free(layout);
+}
+
+static int native_layout_delete_attr(MPI_Datatype dtt, int keyval, void *attr_val, void *extra_state)
+{
+    parsec_type_native_layout_t *layout = (parsec_type_native_layout_t*)attr_val;
+    parsec_hash_table_remove(native_layouts, layout->ht_item.key);
+    /* the threads still copying with the layout keep it alive */
+    parsec_type_native_release(layout);
+    (void)dtt; (void)keyval; (void)extra_state;
+    return MPI_SUCCESS;
+}
+
+int parsec_type_native_init(void)
+{
+    if( NULL != native_layouts ) return PARSEC_SUCCESS;
+    native_layouts = PARSEC_OBJ_NEW(parsec_hash_table_t);
+    parsec_hash_table_init(native_layouts,
+                           offsetof(parsec_type_native_layout_t, ht_item),
+                           4, native_key_fns, NULL);
+    if( MPI_SUCCESS != MPI_Type_create_keyval(MPI_TYPE_NULL_COPY_FN, native_layout_delete_attr,
+                                              &native_keyval, NULL) ) {
+        native_keyval = MPI_KEYVAL_INVALID;
+    }
+    return PARSEC_SUCCESS;
+}
+
+static void native_layout_release(void *item, void *cb_data)
+{
+    parsec_type_native_layout_t *layout = (parsec_type_native_layout_t*)item;
+    (void)cb_data;
+    if( !layout->named && (MPI_KEYVAL_INVALID != native_keyval) ) {
+        /* the attribute delete callback removes and releases the layout */
+        MPI_Type_delete_attr(layout->dtt, native_keyval);
+        return;
+    }
+    parsec_hash_table_remove(native_layouts, layout->ht_item.key);
+    parsec_type_native_release(layout);
+}
+
+int parsec_type_native_fini(void)
+{
+    if( NULL == native_layouts ) return PARSEC_SUCCESS;
+    parsec_hash_table_for_all(native_layouts, native_layout_release, NULL);
+    if( MPI_KEYVAL_INVALID != native_keyval )
+        MPI_Type_free_keyval(&native_keyval);
+    parsec_hash_table_fini(native_layouts);
+    PARSEC_OBJ_RELEASE(native_layouts);
+    native_layouts = NULL;
+    return PARSEC_SUCCESS;
+}
+
+parsec_type_native_layout_t* parsec_type_native_decode(parsec_datatype_t dtt)
+{
+    parsec_type_native_layout_t *layout;
+    parsec_key_t key = NATIVE_KEY(dtt);
+
+    if( (NULL == native_layouts) || (PARSEC_DATATYPE_NULL == dtt) ) return NULL;
+
+    parsec_hash_table_lock_bucket(native_layouts, key);
+    layout = parsec_hash_table_nolock_find(native_layouts, key);
+    if( NULL == layout ) {
+        layout = native_layout_build(dtt);
+        if( !layout->named &&
+            ((MPI_KEYVAL_INVALID == native_keyval) ||
+             (MPI_SUCCESS != MPI_Type_set_attr(dtt, native_keyval, layout))) ) {
+            /* without eviction on free the handle cannot be safely cached */
+            parsec_hash_table_unlock_bucket(native_layouts, key);
+            free(layout);
+            return NULL;
+        }
+        parsec_hash_table_nolock_insert(native_layouts, &layout->ht_item);
+    }
+    if( !layout->supported ) layout = NULL;
+    else parsec_atomic_fetch_inc_int32(&layout->refcount);
+    parsec_hash_table_unlock_bucket(native_layouts, key);
+    return layout;
+}
+
+parsec_type_native_layout_t* parsec_type_native_find(parsec_datatype_t dtt)
+{
+    parsec_type_native_layout_t *layout;
+    parsec_key_t key = NATIVE_KEY(dtt);
+
+    if( (NULL == native_layouts) || (PARSEC_DATATYPE_NULL == dtt) ) return NULL;
+    /* retain under the bucket lock, before an eviction can release it */
+    parsec_hash_table_lock_bucket(native_layouts, key);
+    layout = parsec_hash_table_nolock_find(native_layouts, key);
+    if( (NULL != layout) && !layout->supported ) layout = NULL;
+    if( NULL != layout ) parsec_atomic_fetch_inc_int32(&layout->refcount);
+    parsec_hash_table_unlock_bucket(native_layouts, key);
+    return layout;
+}
+
+int parsec_type_native_copy(void *dst, const parsec_type_native_layout_t *dst_layout, uint64_t dst_count,
+                            const void *src, const parsec_type_native_layout_t *src_layout, uint64_t src_count)
+{
+    const parsec_type_native_block_t *sblk, *dblk;
+    uint64_t selem = 0, delem = 0;
+    size_t remaining, soff = 0, doff = 0;
+    int sidx = 0, didx = 0;
+
+    remaining = src_count * src_layout->size;
+    if( remaining > dst_count * dst_layout->size ) return PARSEC_ERROR;
+    if( 0 == remaining ) return PARSEC_SUCCESS;
+
+    /* Both sides dense: a single copy */
+    if( (1 == src_layout->nb_blocks) && ((ptrdiff_t)src_layout->size == src_layout->extent) &&
+        (1 == dst_layout->nb_blocks) && ((ptrdiff_t)dst_layout->size == dst_layout->extent) ) {
+        memcpy((char*)dst + dst_layout->blocks[0].disp,
+               (const char*)src + src_layout->blocks[0].disp, remaining);
+        return PARSEC_SUCCESS;
+    }
+
+    sblk = &src_layout->blocks[0];
+    dblk = &dst_layout->blocks[0];
+    while( remaining > 0 ) {
+        size_t len = sblk->length - soff;
+        if( len > dblk->length - doff ) len = dblk->length - doff;
+        if( len > remaining ) len = remaining;
+        memcpy((char*)dst + delem * dst_layout->extent + dblk->disp + doff,
+               (const char*)src + selem * src_layout->extent + sblk->disp + soff, len);
+        remaining -= len;
+        soff += len;
+        doff += len;
+        if( soff == sblk->length ) {
+            soff = 0;
+            if( ++sidx == src_layout->nb_blocks ) { sidx = 0; selem++; }
+            sblk = &src_layout->blocks[sidx];
+        }
+        if( doff == dblk->length ) {
+            doff = 0;
+            if( ++didx == dst_layout->nb_blocks ) { didx = 0; delem++; }
+            dblk = &dst_layout->blocks[didx];
+        }
+    }
+    return PARSEC_SUCCESS;
+}
@@ -63,6 +63,42 @@ struct parsec_data_collection_s {
     char      *key;
 
     parsec_datatype_t       default_dtt; /**< default datatype for the datacopies of this data collection*/
+
+    /* in-memory compression of the cold local tiles (NULL when disabled, see
+     * parsec_data_collection_enable_compression) */
+    struct parsec_data_compress_s *compress;
+
+    /* advise the collection that a local task using the data is ready to be
+     * executed, so that the data can be brought closer beforehand, and notify
+     * it when the task starts using the data (both optional, see
+     * parsec_data_collection_set_prefetch) */
+    int  (*prefetch)(parsec_data_collection_t *d, parsec_data_key_t key);
+    void (*access)(parsec_data_collection_t *d, parsec_data_key_t key);
+
+    /* Optional fixed-arity accessors for collections indexed by one or two
+     * coordinates (1D collections ignore n). When provided, they must be
+     * equivalent to the variadic accessors above, and are used instead of
+     * them by the runtime and the generated code, but only while rank_of,
+     * vpid_of (resp. data_of) is still the accessor recorded in
+     * rank_of_paired, vpid_of_paired (resp. data_of_paired) by the
+     * distribution that installed them. Overriding a variadic accessor thus
+     * disables the matching fixed-arity and batched ones. */
+    uint32_t       (*rank_of_2d)(parsec_data_collection_t *d, int m, int n);
+    int32_t        (*vpid_of_2d)(parsec_data_collection_t *d, int m, int n);
+    parsec_data_t* (*data_of_2d)(parsec_data_collection_t *d, int m, int n);
+
+    /* Optional batched accessors, resolving count coordinates in a single
+     * call (n can be NULL for 1D collections). The same rule applies. */
+    void (*rank_of_batch)(parsec_data_collection_t *d, int count,
+                          const int *m, const int *n, uint32_t *ranks);
+    void (*data_of_batch)(parsec_data_collection_t *d, int count,
+                          const int *m, const int *n, parsec_data_t **datas);
+
+    /* The variadic accessors the fixed-arity and batched accessors above are
+     * equivalent to. */
+    uint32_t       (*rank_of_paired)(parsec_data_collection_t *d, ...);
+    int32_t        (*vpid_of_paired)(parsec_data_collection_t *d, ...);
+    parsec_data_t* (*data_of_paired)(parsec_data_collection_t *d, ...);
 };
 
 /**
@@ -75,6 +111,145 @@ parsec_data_collection_init(parsec_data_collection_t *d,
 void
 parsec_data_collection_destroy(parsec_data_collection_t *d);
 
+/**
+ * Remove the fixed-arity and batched accessors of a collection, such that the
+ * variadic accessors are used instead.
+ */
+static inline void
+parsec_data_collection_clear_fixed_arity(parsec_data_collection_t *d)
+{
+    d->rank_of_2d     = NULL;
+    d->vpid_of_2d     = NULL;
+    d->data_of_2d     = NULL;
+    d->rank_of_batch  = NULL;
+    d->data_of_batch  = NULL;
+    d->rank_of_paired = NULL;
+    d->vpid_of_paired = NULL;
+    d->data_of_paired = NULL;
+}
+
+/**
+ * Resolve the rank, virtual process or data of a 1D or 2D collection, using
+ * the fixed-arity accessors when the collection provides them and still uses
+ * the variadic accessors they were installed with.
+ */
+static inline uint32_t
+parsec_data_collection_rank_of_2d(parsec_data_collection_t *d, int m, int n)
+{
+    if( (NULL != d->rank_of_2d) && (d->rank_of == d->rank_of_paired) )
+        return d->rank_of_2d(d, m, n);
+    return d->rank_of(d, m, n);
+}
+
+static inline int32_t
+parsec_data_collection_vpid_of_2d(parsec_data_collection_t *d, int m, int n)
+{
+    if( (NULL != d->vpid_of_2d) && (d->vpid_of == d->vpid_of_paired) )
+        return d->vpid_of_2d(d, m, n);
+    return d->vpid_of(d, m, n);
+}
+
+static inline parsec_data_t*
+parsec_data_collection_data_of_2d(parsec_data_collection_t *d, int m, int n)
+{
+    if( (NULL != d->data_of_2d) && (d->data_of == d->data_of_paired) )
+        return d->data_of_2d(d, m, n);
+    return d->data_of(d, m, n);
+}
+
+/**
+ * Resolve the ranks (resp. data) of count coordinates of a 1D or 2D
+ * collection at once (n can be NULL for 1D collections).
+ */
+static inline void
+parsec_data_collection_rank_of_batch(parsec_data_collection_t *d, int count,
+                                     const int *m, const int *n, uint32_t *ranks)
+{
+    if( (NULL != d->rank_of_batch) && (d->rank_of == d->rank_of_paired) ) {
+        d->rank_of_batch(d, count, m, n, ranks);
+        return;
+    }
+    for( int i = 0; i < count; i++ )
+        ranks[i] = parsec_data_collection_rank_of_2d(d, m[i], (NULL == n) ? 0 : n[i]);
+}
+
+static inline void
+parsec_data_collection_data_of_batch(parsec_data_collection_t *d, int count,
+                                     const int *m, const int *n, parsec_data_t **datas)
+{
+    if( (NULL != d->data_of_batch) && (d->data_of == d->data_of_paired) ) {
+        d->data_of_batch(d, count, m, n, datas);
+        return;
+    }
+    for( int i = 0; i < count; i++ )
+        datas[i] = parsec_data_collection_data_of_2d(d, m[i], (NULL == n) ? 0 : n[i]);
+}
+
+/**
+ * Install (or remove, when prefetch is NULL) the prefetch and access methods
+ * of a data collection. The runtime only inspects the data used by the ready
+ * and the starting tasks while at least one collection has a prefetch method,
+ * and then only calls the methods of the collections of these data.
+ */
+void
+parsec_data_collection_set_prefetch(parsec_data_collection_t *d,
+                                    int (*prefetch)(parsec_data_collection_t *d, parsec_data_key_t key),
+                                    void (*access)(parsec_data_collection_t *d, parsec_data_key_t key));
+
+/**
+ * Number of data collections with a prefetch method.
+ */
+PARSEC_DECLSPEC extern volatile int32_t parsec_data_collection_nb_prefetch;
+
+/**
+ * Counters describing the in-memory compression of a data collection.
+ */
+typedef struct parsec_data_compress_stats_s {
+    int64_t nb_compressed;     /**< tiles currently compressed */
+    int64_t nb_compressions;   /**< tiles compressed */
+    int64_t nb_decompressions; /**< tiles restored when accessed again */
+    int64_t nb_rejected;       /**< tiles that did not compress well enough */
+    int64_t bytes_in;          /**< bytes of the compressed tiles */
+    int64_t bytes_out;         /**< bytes produced by the compressor for these tiles */
+    int64_t compress_ns;       /**< time spent compressing, in nanoseconds */
+    int64_t decompress_ns;     /**< time spent restoring, in nanoseconds */
+} parsec_data_compress_stats_t;
+
+/**
+ * Compress in memory the payload of the local tiles of a collection that
+ * have not been accessed recently. The tiles used by the tasks are kept in a
+ * least recently used order, and once more than budget bytes of them are held
+ * uncompressed the coldest ones are compressed with a lossless codec and
+ * their pages are released to the system. A compressed tile is restored when
+ * a task (or a local copy) accesses it again. A tile is only compressed when
+ * nothing else than the collection references its copy, and a tile that did
+ * not compress is not attempted again until its version changes.
+ *
+ * The content of the compressed tiles must not be accessed outside of the
+ * runtime: disable the compression before reading the collection directly.
+ * The compression must not be enabled or disabled while tasks are using the
+ * collection.
+ *
+ * @return PARSEC_SUCCESS, or PARSEC_ERR_NOT_SUPPORTED if the pages of a tile
+ *   cannot be released on this system.
+ */
+PARSEC_DECLSPEC int
+parsec_data_collection_enable_compression(parsec_data_collection_t *d, size_t budget);
+
+/**
+ * Restore all the compressed tiles of a collection and stop compressing.
+ */
+PARSEC_DECLSPEC void
+parsec_data_collection_disable_compression(parsec_data_collection_t *d);
+
+/**
+ * Retrieve the compression counters of a collection (all zeros when the
+ * compression is not enabled).
+ */
+PARSEC_DECLSPEC void
+parsec_data_collection_compression_stats(const parsec_data_collection_t *d,
+                                         parsec_data_compress_stats_t *stats);
+
 PARSEC_DECLSPEC int
 parsec_data_dist_init(void);
 
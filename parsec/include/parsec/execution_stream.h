@@ -53,12 +53,17 @@ struct parsec_execution_stream_s {
      */
     struct parsec_task_s* next_task;
 
+    struct parsec_live_es_s *live_metrics;  /**< Record of this stream in the live metrics, NULL if disabled */
+
+    volatile int32_t busy;  /**< With persistent workers, the stream may be working on a task of the round */
+
 #if defined(PARSEC_SIM)
     int largest_simulation_date;
 #endif
 
 #if defined(PARSEC_PROF_PINS)
     struct parsec_pins_next_callback_s pins_events_cb[PARSEC_PINS_FLAG_COUNT];
+    uint32_t                           pins_events_mask;  /**< bit i set when pins_events_cb[i] is not empty */
 #endif  /* defined(PARSEC_PROF_PINS) */
 
 #if defined(PARSEC_PROF_RUSAGE_EU)
@@ -107,6 +112,8 @@ struct parsec_vp_s {
 #define PARSEC_CONTEXT_FLAG_CONTEXT_ACTIVE 0x0002
 /* The communication substrate supports multithreaded operations. */
 #define PARSEC_CONTEXT_FLAG_COMM_MT        0x0004
+/* The threads stay in the scheduling loop between the rounds (persistent workers). */
+#define PARSEC_CONTEXT_FLAG_WORKERS_LOOPING 0x0008
 
 /**
  * All virtual processes belong to a single physical
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2009-2015 The University of Tennessee and The University
+ * Copyright (c) 2009-2024 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  */
@@ -12,7 +12,64 @@
 
 /** TIMING SYSTEM-SPECIFICS **/
 
-#if defined(PARSEC_HAVE_CLOCK_GETTIME)
+#if defined(PARSEC_PROF_TIMER_TSC) && defined(PARSEC_HAVE_CLOCK_GETTIME) && defined(__x86_64__)
+/**
+ * The invariant TSC of the processor when it has one and the operating
+ * system keeps it synchronized between the cores, CLOCK_MONOTONIC
+ * otherwise. The source is selected once, on the first time taken or in
+ * parsec_init, and never changes afterwards. The times are raw counts of
+ * the source, the durations are converted to nanoseconds with a factor
+ * calibrated against CLOCK_MONOTONIC.
+ */
+#include <time.h>
+#define PARSEC_HAVE_TIMER_TSC
+
+#define PARSEC_TIMER_SOURCE_UNKNOWN    0
+#define PARSEC_TIMER_SOURCE_TSC        1
+#define PARSEC_TIMER_SOURCE_MONOTONIC  2
+
+BEGIN_C_DECLS
+
+PARSEC_DECLSPEC extern int parsec_timer_source;
+/** Nanoseconds per TSC tick as a 32.32 fixed point number, 0 until calibrated */
+PARSEC_DECLSPEC extern uint64_t parsec_timer_tsc_mult;
+
+/** Select the source of the time (if not done yet) and calibrate the TSC */
+PARSEC_DECLSPEC void parsec_timer_init(void);
+PARSEC_DECLSPEC uint64_t parsec_timer_tsc_calibrate(void);
+PARSEC_DECLSPEC uint64_t parsec_timer_take_time_slow(void);
+
+END_C_DECLS
+
+typedef uint64_t parsec_time_t;
+static inline parsec_time_t take_time(void)
+{
+    if( PARSEC_LIKELY(PARSEC_TIMER_SOURCE_TSC == parsec_timer_source) ) {
+        unsigned hi, lo;
+        __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+        return ( (uint64_t)lo)|( ((uint64_t)hi)<<32 );
+    }
+    return parsec_timer_take_time_slow();
+}
+
+#define TIMER_UNIT "nanosecond"
+static inline uint64_t diff_time( parsec_time_t start, parsec_time_t end )
+{
+    uint64_t diff = end - start;
+    if( PARSEC_TIMER_SOURCE_TSC == parsec_timer_source ) {
+        uint64_t mult = parsec_timer_tsc_mult;
+        if( PARSEC_UNLIKELY(0 == mult) )
+            mult = parsec_timer_tsc_calibrate();
+        diff = (uint64_t)(((unsigned __int128)diff * mult) >> 32);
+    }
+    return diff;
+}
+static inline int time_less( parsec_time_t start, parsec_time_t end )
+{
+    return start < end;
+}
+#define ZERO_TIME 0
+#elif defined(PARSEC_HAVE_CLOCK_GETTIME)
 #include <unistd.h>
 #include <time.h>
 typedef struct timespec parsec_time_t;
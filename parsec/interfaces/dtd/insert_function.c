@@ -70,6 +70,8 @@ int parsec_dtd_window_size             = 8000;   /**< Default window size */
 int parsec_dtd_threshold_size          = 4000;   /**< Default threshold size of tasks for master thread to wait on */
 static int parsec_dtd_task_hash_table_size = 1<<16; /**< Default task hash table size */
 static int parsec_dtd_tile_hash_table_size = 1<<16; /**< Default tile hash table size */
+static size_t parsec_dtd_war_rename_max = 0;   /**< Memory cap of the renamed copies, 0 disables the renaming */
+static volatile int64_t parsec_dtd_war_renamed_bytes = 0;   /**< Memory held by the renamed copies */
 
 int parsec_dtd_dump_traversal_info = 60; /**< Level for printing traversal info */
 int insert_task_trace_keyin = -1;
@@ -350,6 +352,7 @@ void parsec_dtd_taskpool_constructor(parsec_dtd_taskpool_t *tp)
                            DTD_key_fns,
                            tp->function_h_table);
 
+    tp->new_tile_dc.tile_h_table = NULL;  /* registered when enqueued */
     tp->super.startup_hook = parsec_dtd_startup;
     tp->super.task_classes_array = (const parsec_task_class_t **)malloc(
             PARSEC_DTD_NB_TASK_CLASSES * sizeof(parsec_task_class_t *));
@@ -513,6 +516,13 @@ parsec_dtd_lazy_init(void)
                                         "Registers the supplied size overriding the default size of threshold size",
                                         false, false, parsec_dtd_threshold_size, &parsec_dtd_threshold_size);
 
+    /* Registering mca param for the memory cap of write-after-read renaming */
+    (void)parsec_mca_param_reg_sizet_name("dtd", "war_rename_max",
+                                          "Maximum amount of memory (in bytes) used by the extra versions of the tiles "
+                                          "created when a writer is renamed instead of waiting for the previous readers "
+                                          "of a tile. Once reached, writers wait for the readers. 0 (default) disables renaming",
+                                          false, false, parsec_dtd_war_rename_max, &parsec_dtd_war_rename_max);
+
     /* Registering mca param for threshold size */
     (void)parsec_mca_param_reg_int_name("dtd", "profile_verbose",
                                         "This param turns events that profiles task insertion and other dtd overheads",
@@ -1216,6 +1226,37 @@ parsec_dtd_tile_retain(parsec_dtd_tile_t *tile)
     PARSEC_OBJ_RETAIN(tile);
 }
 
+static inline int64_t
+parsec_dtd_renamed_copy_size(parsec_data_copy_t *copy)
+{
+    return (int64_t)copy->arena_chunk->count * (int64_t)copy->arena_chunk->origin->elem_size;
+}
+
+/* **************************************************************************** */
+/**
+ * This function drops the renamed copy of a tile
+ *
+ * The reference the tile holds on its most recent renamed copy is released,
+ * the copy itself goes back to its arena once the tasks using it are done.
+ * This is called by the flush, after the renamed version has been copied
+ * back into the original copy.
+ *
+ * @param[in,out]   tile
+ *                      Tile whose renamed copy is dropped
+ *
+ * @ingroup         DTD_INTERFACE_INTERNAL
+ */
+void
+parsec_dtd_tile_release_renamed_copy(parsec_dtd_tile_t *tile)
+{
+    parsec_data_copy_t *renamed = tile->renamed_copy;
+
+    if( NULL == renamed ) return;
+    tile->renamed_copy = NULL;
+    (void)parsec_atomic_fetch_sub_int64(&parsec_dtd_war_renamed_bytes, parsec_dtd_renamed_copy_size(renamed));
+    parsec_dtd_release_data_copy(renamed);
+}
+
 /* **************************************************************************** */
 /**
  * This function releases the master-structure and pushes them back in mempool
@@ -1292,6 +1333,7 @@ parsec_dtd_tile_of(parsec_data_collection_t *dc, parsec_data_key_t key)
         tile->key = (uint64_t)0x00000000 | key;
         tile->rank = dc->rank_of_key(dc, tile->key);
         tile->flushed = NOT_FLUSHED;
+        tile->renamed_copy = NULL;
         if( tile->rank == (int)dc->myrank ) {
             tile->data_copy = (dc->data_of_key(dc, tile->key))->device_copies[0];
             assert(NULL != tile->data_copy);
@@ -1343,6 +1385,7 @@ parsec_dtd_tile_t *parsec_dtd_tile_new(parsec_taskpool_t *tp, int rank)
     tile->rank = rank;
     tile->flushed = NOT_FLUSHED;
     tile->data_copy = NULL;
+    tile->renamed_copy = NULL;
 
     parsec_dtd_tile_insert(tile->key, tile, &dtd_tp->new_tile_dc);
 
@@ -1378,6 +1421,29 @@ static inline parsec_key_t DTD_make_key_identity(const parsec_taskpool_t *tp, co
     return (parsec_key_t)(uintptr_t)t[0].value;
 }
 
+/**
+ * Unregister the collection of the tiles created by parsec_dtd_tile_new, if
+ * the taskpool registered it when it was enqueued and it is still
+ * registered.
+ */
+static void parsec_dtd_new_tile_dc_fini(parsec_dtd_taskpool_t *dtd_tp)
+{
+    if( NULL == dtd_tp->new_tile_dc.tile_h_table ) return;
+    parsec_dtd_data_collection_fini(&dtd_tp->new_tile_dc);
+    parsec_data_collection_destroy(&dtd_tp->new_tile_dc);
+    dtd_tp->new_tile_dc.tile_h_table = NULL;
+}
+
+/**
+ * Termination of a DTD taskpool: the tiles created by parsec_dtd_tile_new
+ * are all released, their collection can be unregistered.
+ */
+static void parsec_dtd_taskpool_termination_detected(parsec_taskpool_t *tp)
+{
+    parsec_dtd_new_tile_dc_fini((parsec_dtd_taskpool_t *)tp);
+    parsec_taskpool_termination_detected(tp);
+}
+
 int parsec_dtd_update_runtime_task( parsec_taskpool_t *tp, int32_t count )
 {
     int remaining = tp->tdm.module->taskpool_addto_runtime_actions( tp, count );
@@ -1437,10 +1503,14 @@ parsec_dtd_taskpool_new(void)
     __tp->super.update_nb_runtime_task = parsec_dtd_update_runtime_task;
 
     __tp->super.devices_index_mask = 0;
+    /* Renamed copies only live in main memory, they are not tracked by the accelerators */
+    __tp->war_renaming = (0 != parsec_dtd_war_rename_max);
     for( i = 0; i < (int)parsec_nb_devices; i++ ) {
         parsec_device_module_t *device = parsec_mca_device_get(i);
         if( NULL == device ) continue;
         __tp->super.devices_index_mask |= (1 << device->device_index);
+        if( !(device->type & (PARSEC_DEV_CPU | PARSEC_DEV_RECURSIVE)) )
+            __tp->war_renaming = 0;
     }
 
     /* Keeping track of total tasks to be executed per taskpool for the window */
@@ -1465,7 +1535,7 @@ parsec_dtd_taskpool_new(void)
     }
 
     parsec_termdet_open_module(&__tp->super, "local");
-    __tp->super.tdm.module->monitor_taskpool(&__tp->super, parsec_taskpool_termination_detected);
+    __tp->super.tdm.module->monitor_taskpool(&__tp->super, parsec_dtd_taskpool_termination_detected);
     __tp->super.tdm.module->taskpool_set_nb_tasks(&__tp->super, PARSEC_RUNTIME_RESERVED_NB_TASKS);
     __tp->super.tdm.module->taskpool_set_runtime_actions(&__tp->super, 0);
 
@@ -1513,9 +1583,8 @@ parsec_dtd_taskpool_retain(parsec_taskpool_t *tp)
 void
 parsec_dtd_taskpool_release(parsec_taskpool_t *tp)
 {
-    parsec_dtd_taskpool_t *dtd_tp = (parsec_dtd_taskpool_t *)tp;
-    parsec_dtd_data_collection_fini(&dtd_tp->new_tile_dc);
-    parsec_data_collection_destroy(&dtd_tp->new_tile_dc);
+    /* for the taskpools that never reached their termination */
+    parsec_dtd_new_tile_dc_fini((parsec_dtd_taskpool_t *)tp);
     PARSEC_OBJ_RELEASE(tp);
 }
 
@@ -1700,9 +1769,8 @@ dtd_release_dep_fct(parsec_execution_stream_t *es,
 #endif
 
             arg->ready_lists[dst_vpid] = (parsec_task_t *)
-                    parsec_list_item_ring_push_sorted((parsec_list_item_t *)arg->ready_lists[dst_vpid],
-                                                      &current_task->super.super,
-                                                      parsec_execution_context_priority_comparator);
+                    parsec_list_item_ring_push_front((parsec_list_item_t *)arg->ready_lists[dst_vpid],
+                                                     &current_task->super.super);
             return PARSEC_ITERATE_CONTINUE; /* Returns the status of the task being activated */
         } else {
             return PARSEC_ITERATE_STOP;
@@ -2009,6 +2077,100 @@ parsec_dtd_remote_task_release(parsec_dtd_task_t *this_task)
     assert(object->obj_reference_count >= 1);
 }
 
+/* **************************************************************************** */
+/**
+ * Write-after-read renaming of the data of a flow
+ *
+ * Instead of waiting for the readers of its copy, a writer receives a fresh
+ * copy from the arena of the flow, filled with the current version unless the
+ * flow is write-only. The readers keep the older version while the writer and
+ * its successors use the new one, which travels along the flows like any
+ * arena copy: the original copy remains the head of the data of the tile.
+ * The tile keeps the most recent renamed copy until the flush brings it back
+ * into the original copy, older renamed copies return to the arena with their
+ * last reader. The memory of the renamed copies held by the tiles is capped
+ * by the dtd_war_rename_max MCA parameter.
+ *
+ * @param[in,out]   this_task
+ *                      The local writer task
+ * @param[in]       flow_index
+ *                      The flow whose copy is still being read
+ * @return
+ *              PARSEC_SUCCESS if the flow now uses a renamed copy, an error
+ *              code if the writer has to wait for the readers
+ *
+ * @ingroup     DTD_INTERFACE_INTERNAL
+ */
+static int
+parsec_dtd_rename_data_copy(parsec_dtd_task_t *this_task, int flow_index)
+{
+    parsec_dtd_taskpool_t *dtd_tp = (parsec_dtd_taskpool_t *)this_task->super.taskpool;
+    parsec_dtd_flow_info_t *flow = FLOW_OF(this_task, flow_index);
+    parsec_dtd_tile_t *tile = flow->tile;
+    parsec_data_copy_t *copy = this_task->super.data[flow_index].data_in, *renamed;
+    parsec_data_t *data;
+    parsec_arena_datatype_t *adt;
+    size_t count;
+    int64_t size;
+    int i;
+
+    /* Only the most recent version of data owned by this rank can be renamed */
+    if( !dtd_tp->war_renaming ||
+        PARSEC_DTD_FLUSH_TC_ID == this_task->super.task_class->task_class_id ||
+        (flow->op_type & (PARSEC_DONT_TRACK | PARSEC_PULLIN)) ||
+        NULL == tile || NULL == tile->data_copy ||
+        copy != ((NULL != tile->renamed_copy) ? tile->renamed_copy : tile->data_copy) ||
+        NULL == (data = tile->data_copy->original) || 0 == data->nb_elts ) {
+        return PARSEC_ERR_NOT_SUPPORTED;
+    }
+    /* The copy is shared with the other flows of the task using the same data */
+    for( i = 0; i < this_task->super.task_class->nb_flows; i++ ) {
+        if( (i != flow_index) && (copy == this_task->super.data[i].data_in) ) {
+            return PARSEC_ERR_NOT_SUPPORTED;
+        }
+    }
+    adt = parsec_dtd_get_arena_datatype(dtd_tp->super.context, flow->arena_index);
+    if( NULL == adt || NULL == adt->arena || 0 == adt->arena->elem_size ) {
+        return PARSEC_ERR_NOT_SUPPORTED;
+    }
+
+    count = (data->nb_elts + adt->arena->elem_size - 1) / adt->arena->elem_size;
+    size = (int64_t)(count * adt->arena->elem_size);
+    if( (parsec_atomic_fetch_add_int64(&parsec_dtd_war_renamed_bytes, size) + size) > (int64_t)parsec_dtd_war_rename_max ) {
+        (void)parsec_atomic_fetch_sub_int64(&parsec_dtd_war_renamed_bytes, size);
+        return PARSEC_ERR_OUT_OF_RESOURCE;
+    }
+    renamed = parsec_arena_get_copy(adt->arena, count, 0, copy->dtt);
+    if( NULL == renamed ) {
+        (void)parsec_atomic_fetch_sub_int64(&parsec_dtd_war_renamed_bytes, size);
+        return PARSEC_ERR_OUT_OF_RESOURCE;
+    }
+    /* A write-only flow overwrites the previous content */
+    if( PARSEC_OUTPUT != (flow->op_type & PARSEC_GET_OP_TYPE) ) {
+        memcpy(renamed->device_private, copy->device_private, data->nb_elts);
+    }
+    renamed->version = copy->version;
+    renamed->coherency_state = copy->coherency_state;
+
+    /* The tile keeps the most recent version, the older one is released by
+     * its last reader */
+    parsec_dtd_retain_data_copy(renamed);
+    if( NULL != tile->renamed_copy ) {
+        assert(copy == tile->renamed_copy);
+        (void)parsec_atomic_fetch_sub_int64(&parsec_dtd_war_renamed_bytes, parsec_dtd_renamed_copy_size(copy));
+        parsec_dtd_release_data_copy(copy);
+    }
+    tile->renamed_copy = renamed;
+
+    this_task->super.data[flow_index].data_in = renamed;
+    parsec_dtd_release_data_copy(copy);
+
+    PARSEC_DEBUG_VERBOSE(parsec_dtd_dump_traversal_info, parsec_dtd_debug_output,
+                         "Renamed copy %p of tile %" PRIu64 " into %p for task %s\n",
+                         copy, tile->key, renamed, this_task->super.task_class->name);
+    return PARSEC_SUCCESS;
+}
+
 /* Prepare_input function */
 int
 data_lookup_of_dtd_task(parsec_execution_stream_t *es,
@@ -2038,7 +2200,17 @@ data_lookup_of_dtd_task(parsec_execution_stream_t *es,
         if( PARSEC_INOUT == op_type_on_current_flow ||
             PARSEC_OUTPUT == op_type_on_current_flow ) {
             if( copy->readers > 0 ) {
-                return PARSEC_HOOK_RETURN_AGAIN;
+                /* Rename the data rather than waiting for the readers */
+                if( PARSEC_SUCCESS != parsec_dtd_rename_data_copy(current_task, current_dep) ) {
+                    return PARSEC_HOOK_RETURN_AGAIN;
+                }
+            }
+            /* The flush writes the renamed version back into the original copy */
+            if( PARSEC_DTD_FLUSH_TC_ID == current_task->super.task_class->task_class_id ) {
+                parsec_dtd_tile_t *tile = (FLOW_OF(current_task, current_dep))->tile;
+                if( (NULL != tile->renamed_copy) && (tile->data_copy->readers > 0) ) {
+                    return PARSEC_HOOK_RETURN_AGAIN;
+                }
             }
 
             /* printf("[data_lookup_of_dtd_task] %s, data[current_dep].data_in->readers = %d\n", this_task->task_class->name, current_task->super.data[current_dep].data_in->readers); */
@@ -205,6 +205,8 @@ struct parsec_dtd_tile_s {
     int32_t                   rank;
     uint64_t                  key;
     parsec_data_copy_t       *data_copy;
+    parsec_data_copy_t       *renamed_copy; /**< Most recent version created by a write-after-read
+                                             *   renaming, copied back into data_copy by the flush */
     parsec_data_collection_t *dc;
     parsec_dtd_tile_user_t    last_user;
     parsec_dtd_tile_user_t    last_writer;
@@ -224,6 +226,7 @@ struct parsec_dtd_taskpool_s {
     parsec_taskpool_t            super;
     parsec_thread_mempool_t     *mempool_owner;
     int                          enqueue_flag;
+    int                          war_renaming; /**< writers may rename the copies still being read */
     int                          task_id;
     int                          task_window_size;
     int32_t                      task_threshold_size;
@@ -412,6 +415,9 @@ parsec_dtd_template_release( const parsec_task_class_t *tc );
 void
 parsec_dtd_tile_retain( parsec_dtd_tile_t *tile );
 
+void
+parsec_dtd_tile_release_renamed_copy( parsec_dtd_tile_t *tile );
+
 void
 parsec_dtd_tile_release( parsec_dtd_tile_t *tile );
 
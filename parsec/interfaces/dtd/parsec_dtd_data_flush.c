@@ -39,6 +39,20 @@ parsec_dtd_data_flush_sndrcv(parsec_execution_stream_t *es,
 
     assert(tile != NULL);
 
+    if( (tile->rank == current_task->rank) && (NULL != tile->renamed_copy) ) {
+        /* The tile was renamed by a writer, converge back to the original copy */
+        int renamed_is_last = (current_task->super.data[0].data_in == tile->renamed_copy);
+        if( renamed_is_last ) {
+            memcpy(tile->data_copy->device_private, tile->renamed_copy->device_private,
+                   tile->data_copy->original->nb_elts);
+            tile->data_copy->version = tile->renamed_copy->version;
+        }
+        parsec_dtd_tile_release_renamed_copy(tile);
+        if( renamed_is_last ) {
+            return PARSEC_HOOK_RETURN_DONE;
+        }
+    }
+
 #if defined(DISTRIBUTED)
     if(tile->rank == current_task->rank) { /* this is a receive task*/
         if( current_task->super.data[0].data_in != tile->data_copy ) {
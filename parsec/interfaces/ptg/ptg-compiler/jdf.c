@@ -31,6 +31,7 @@ static char *FUNCTION_PROPERTY_KEYWORDS[] = {
     JDF_PROP_UD_FIND_DEPS_FN_NAME,
     JDF_PROP_UD_ALLOC_DEPS_FN_NAME,
     JDF_PROP_UD_FREE_DEPS_FN_NAME,
+    JDF_PROP_DEP_MANAGEMENT_NAME,
     NULL
 };
 
@@ -1815,3 +1816,387 @@ int jdf_assign_ldef_index(jdf_function_entry_t *f)
     }
     return 0;
 }
+
+/**
+ * Compile-time constant globals.
+ *
+ * A global becomes a compile-time constant when it carries the "constant"
+ * property (constant = <expr>, the expression can only use the previous
+ * constants), or when it is defined on the command line with
+ * --constant NAME=VALUE. A global is never made constant implicitly. The
+ * references to the constants of integral type are replaced by their value in
+ * the JDF expressions, and the resulting expressions are simplified. Guards that fold to a constant
+ * transform the dependencies into unconditional ones, or mark them as dead so
+ * that the code generator can skip them entirely.
+ */
+static int jdf_expr_is_int_cst(const jdf_expr_t *e)
+{
+    return (NULL != e) && (JDF_CST == e->op) && (EXPR_TYPE_INT32 == e->jdf_type);
+}
+
+static int jdf_expr_is_pure(const jdf_expr_t *e)
+{
+    if( NULL == e ) return 1;
+    switch( e->op ) {
+    case JDF_C_CODE: return 0;
+    case JDF_CST: case JDF_VAR: case JDF_STRING: return 1;
+    case JDF_NOT: return jdf_expr_is_pure(e->jdf_ua);
+    case JDF_TERNARY: case JDF_RANGE:
+        return jdf_expr_is_pure(e->jdf_ta1) && jdf_expr_is_pure(e->jdf_ta2) &&
+            jdf_expr_is_pure(e->jdf_ta3);
+    default:
+        return jdf_expr_is_pure(e->jdf_ba1) && jdf_expr_is_pure(e->jdf_ba2);
+    }
+}
+
+static int jdf_expr_is_boolean(const jdf_expr_t *e)
+{
+    switch( e->op ) {
+    case JDF_EQUAL: case JDF_NOTEQUAL: case JDF_AND: case JDF_OR:
+    case JDF_LESS: case JDF_LEQ: case JDF_MORE: case JDF_MEQ: case JDF_NOT:
+        return 1;
+    case JDF_CST:
+        return jdf_expr_is_int_cst(e) && (0 == e->jdf_cst || 1 == e->jdf_cst);
+    default:
+        return 0;
+    }
+}
+
+/* Replace the content of an expression, but keep its place in the lists and
+ * its local definition information. */
+static void jdf_expr_replace(jdf_expr_t *e, const jdf_expr_t *src)
+{
+    e->op = src->op;
+    if( JDF_OP_IS_CST(src->op) ) {
+        e->jdf_type = src->jdf_type;
+        e->u.v.w    = src->u.v.w;
+    } else {
+        e->u = src->u;
+    }
+}
+
+static void jdf_expr_set_int_cst(jdf_expr_t *e, int32_t value)
+{
+    e->op       = JDF_CST;
+    e->jdf_type = EXPR_TYPE_INT32;
+    e->jdf_cst  = value;
+}
+
+/* Compute a binary operation on two constants, following the C semantic.
+ * Return 0 if the result cannot be safely computed at compile time. */
+static int jdf_fold_binary_op(jdf_expr_operand_t op, int64_t a, int64_t b, int64_t *r)
+{
+    switch( op ) {
+    case JDF_EQUAL:    *r = (a == b); break;
+    case JDF_NOTEQUAL: *r = (a != b); break;
+    case JDF_AND:      *r = (a && b); break;
+    case JDF_OR:       *r = (a || b); break;
+    case JDF_XOR:      *r = (a ^ b);  break;
+    case JDF_LESS:     *r = (a < b);  break;
+    case JDF_LEQ:      *r = (a <= b); break;
+    case JDF_MORE:     *r = (a > b);  break;
+    case JDF_MEQ:      *r = (a >= b); break;
+    case JDF_PLUS:     *r = a + b;    break;
+    case JDF_MINUS:    *r = a - b;    break;
+    case JDF_TIMES:    *r = a * b;    break;
+    case JDF_DIV:
+        if( 0 == b ) return 0;
+        *r = a / b; break;
+    case JDF_MODULO:
+        if( 0 == b ) return 0;
+        *r = a % b; break;
+    case JDF_SHL:
+        if( (b < 0) || (b > 31) || (a < 0) ) return 0;
+        *r = a << b; break;
+    case JDF_SHR:
+        if( (b < 0) || (b > 31) ) return 0;
+        *r = a >> b; break;
+    default:
+        return 0;
+    }
+    return (*r >= INT32_MIN) && (*r <= INT32_MAX);
+}
+
+/* Return 1 if name is defined locally to f (parameter, local or local
+ * definition), thus masking any global with the same name. */
+static int jdf_fold_name_is_local(const jdf_function_entry_t *f, const char *name)
+{
+    const jdf_variable_list_t *vl;
+    const jdf_dataflow_t *fl;
+    const jdf_dep_t *dep;
+    const jdf_expr_t *ld;
+
+    if( NULL == f ) return 0;
+    for( vl = f->locals; NULL != vl; vl = vl->next ) {
+        if( !strcmp(vl->name, name) ) return 1;
+        for( ld = vl->expr->local_variables; NULL != ld; ld = ld->next )
+            if( (NULL != ld->alias) && !strcmp(ld->alias, name) ) return 1;
+    }
+    for( fl = f->dataflow; NULL != fl; fl = fl->next ) {
+        for( dep = fl->deps; NULL != dep; dep = dep->next ) {
+            for( ld = dep->local_defs; NULL != ld; ld = ld->next )
+                if( (NULL != ld->alias) && !strcmp(ld->alias, name) ) return 1;
+            for( ld = (NULL == dep->guard->calltrue) ? NULL : dep->guard->calltrue->local_defs; NULL != ld; ld = ld->next )
+                if( (NULL != ld->alias) && !strcmp(ld->alias, name) ) return 1;
+            for( ld = (NULL == dep->guard->callfalse) ? NULL : dep->guard->callfalse->local_defs; NULL != ld; ld = ld->next )
+                if( (NULL != ld->alias) && !strcmp(ld->alias, name) ) return 1;
+        }
+    }
+    return 0;
+}
+
+/* The JDF expressions are computed on integers: the constants declared with
+ * another type are not folded in them, only specialized in the generated
+ * code with their declared type. */
+static int jdf_global_is_integral(const jdf_global_entry_t *g)
+{
+    static const char *integral_types[] = { "int", "int32_t", "int64_t", "long", NULL };
+    const jdf_expr_t *type = jdf_find_property(g->properties, "type", NULL);
+
+    if( NULL == type ) return 1;
+    if( (JDF_STRING != type->op) && (JDF_VAR != type->op) ) return 0;
+    for( int i = 0; NULL != integral_types[i]; i++ )
+        if( !strcmp(type->jdf_var, integral_types[i]) ) return 1;
+    return 0;
+}
+
+/* The value of a constant global that can be folded in the JDF expressions */
+static const jdf_expr_t *jdf_global_foldable_value(const jdf_global_entry_t *globals, const char *name)
+{
+    const jdf_global_entry_t *g;
+
+    for( g = globals; NULL != g; g = g->next ) {
+        if( strcmp(g->name, name) ) continue;
+        return jdf_global_is_integral(g) ? jdf_global_constant_value(g, name) : NULL;
+    }
+    return NULL;
+}
+
+const jdf_expr_t *jdf_global_constant_value( const jdf_global_entry_t *globals, const char *name )
+{
+    const jdf_global_entry_t *g;
+    jdf_expr_t *value;
+
+    for( g = globals; NULL != g; g = g->next ) {
+        if( strcmp(g->name, name) ) continue;
+        value = jdf_find_property(g->properties, JDF_PROP_CONSTANT_NAME, NULL);
+        return jdf_expr_is_int_cst(value) ? value : NULL;
+    }
+    return NULL;
+}
+
+static void jdf_global_set_constant(jdf_global_entry_t *g, jdf_expr_t *value)
+{
+    jdf_def_list_t *prop;
+
+    if( NULL != jdf_find_property(g->properties, JDF_PROP_CONSTANT_NAME, &prop) ) {
+        prop->expr = value;
+        return;
+    }
+    prop = (jdf_def_list_t*)calloc(1, sizeof(jdf_def_list_t));
+    prop->name = strdup(JDF_PROP_CONSTANT_NAME);
+    prop->expr = value;
+    JDF_OBJECT_LINENO(prop) = JDF_OBJECT_LINENO(g);
+    prop->next = g->properties;
+    g->properties = prop;
+}
+
+/* Fold the expression e (and its sub-expressions) in place. Return the number
+ * of simplifications applied. */
+static int jdf_fold_expr(jdf_expr_t *e, const jdf_t *jdf, const jdf_function_entry_t *f)
+{
+    const jdf_expr_t *cst;
+    int64_t r;
+    int changes = 0;
+
+    if( NULL == e ) return 0;
+
+    for( jdf_expr_t *ld = e->local_variables; NULL != ld; ld = ld->next )
+        if( ld != e ) changes += jdf_fold_expr(ld, jdf, f);
+
+    switch( e->op ) {
+    case JDF_VAR:
+        if( jdf_fold_name_is_local(f, e->jdf_var) ) break;
+        if( NULL != (cst = jdf_global_foldable_value(jdf->globals, e->jdf_var)) ) {
+            jdf_expr_set_int_cst(e, cst->jdf_cst);
+            changes++;
+        }
+        break;
+    case JDF_CST: case JDF_STRING: case JDF_C_CODE:
+        break;
+    case JDF_NOT:
+        changes += jdf_fold_expr(e->jdf_ua, jdf, f);
+        if( jdf_expr_is_int_cst(e->jdf_ua) ) {
+            jdf_expr_set_int_cst(e, !e->jdf_ua->jdf_cst);
+            changes++;
+        }
+        break;
+    case JDF_RANGE:
+        /* Only the bounds and the increment can be simplified */
+        changes += jdf_fold_expr(e->jdf_ta1, jdf, f);
+        changes += jdf_fold_expr(e->jdf_ta2, jdf, f);
+        changes += jdf_fold_expr(e->jdf_ta3, jdf, f);
+        break;
+    case JDF_TERNARY:
+        changes += jdf_fold_expr(e->jdf_tat, jdf, f);
+        changes += jdf_fold_expr(e->jdf_ta1, jdf, f);
+        changes += jdf_fold_expr(e->jdf_ta2, jdf, f);
+        if( jdf_expr_is_int_cst(e->jdf_tat) ) {
+            jdf_expr_replace(e, (0 != e->jdf_tat->jdf_cst) ? e->jdf_ta1 : e->jdf_ta2);
+            changes++;
+        }
+        break;
+    default: {
+        jdf_expr_t *a = e->jdf_ba1, *b = e->jdf_ba2, *c, *o;
+        changes += jdf_fold_expr(a, jdf, f);
+        changes += jdf_fold_expr(b, jdf, f);
+        if( jdf_expr_is_int_cst(a) && jdf_expr_is_int_cst(b) ) {
+            if( jdf_fold_binary_op(e->op, a->jdf_cst, b->jdf_cst, &r) ) {
+                jdf_expr_set_int_cst(e, (int32_t)r);
+                changes++;
+            }
+            break;
+        }
+        /* Algebraic simplifications with a single constant operand */
+        if( jdf_expr_is_int_cst(a) )      { c = a; o = b; }
+        else if( jdf_expr_is_int_cst(b) ) { c = b; o = a; }
+        else break;
+        switch( e->op ) {
+        case JDF_AND:
+            if( 0 == c->jdf_cst && jdf_expr_is_pure(o) ) { jdf_expr_set_int_cst(e, 0); changes++; }
+            else if( 0 != c->jdf_cst && jdf_expr_is_boolean(o) ) { jdf_expr_replace(e, o); changes++; }
+            break;
+        case JDF_OR:
+            if( 0 != c->jdf_cst && jdf_expr_is_pure(o) ) { jdf_expr_set_int_cst(e, 1); changes++; }
+            else if( 0 == c->jdf_cst && jdf_expr_is_boolean(o) ) { jdf_expr_replace(e, o); changes++; }
+            break;
+        case JDF_PLUS:
+            if( 0 == c->jdf_cst ) { jdf_expr_replace(e, o); changes++; }
+            break;
+        case JDF_MINUS:
+            if( (c == b) && (0 == c->jdf_cst) ) { jdf_expr_replace(e, o); changes++; }
+            break;
+        case JDF_TIMES:
+            if( 1 == c->jdf_cst ) { jdf_expr_replace(e, o); changes++; }
+            else if( 0 == c->jdf_cst && jdf_expr_is_pure(o) ) { jdf_expr_set_int_cst(e, 0); changes++; }
+            break;
+        case JDF_DIV:
+            if( (c == b) && (1 == c->jdf_cst) ) { jdf_expr_replace(e, o); changes++; }
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+    }
+    return changes;
+}
+
+static int jdf_fold_expr_list(jdf_expr_t *el, const jdf_t *jdf, const jdf_function_entry_t *f)
+{
+    int changes = 0;
+    for( ; NULL != el; el = el->next )
+        changes += jdf_fold_expr(el, jdf, f);
+    return changes;
+}
+
+static int jdf_fold_datatype(jdf_datatransfer_type_t *dt, const jdf_t *jdf, const jdf_function_entry_t *f)
+{
+    return jdf_fold_expr(dt->type, jdf, f) + jdf_fold_expr(dt->layout, jdf, f) +
+        jdf_fold_expr(dt->count, jdf, f) + jdf_fold_expr(dt->displ, jdf, f);
+}
+
+static int jdf_fold_call(jdf_call_t *call, const jdf_t *jdf, const jdf_function_entry_t *f)
+{
+    if( NULL == call ) return 0;
+    return jdf_fold_expr_list(call->local_defs, jdf, f) +
+        jdf_fold_expr_list(call->parameters, jdf, f);
+}
+
+static int jdf_fold_dep(jdf_dep_t *dep, const jdf_t *jdf, const jdf_function_entry_t *f)
+{
+    jdf_guarded_call_t *guard = dep->guard;
+    int changes;
+
+    changes  = jdf_fold_expr_list(dep->local_defs, jdf, f);
+    changes += jdf_fold_datatype(&dep->datatype_local, jdf, f);
+    changes += jdf_fold_datatype(&dep->datatype_remote, jdf, f);
+    changes += jdf_fold_datatype(&dep->datatype_data, jdf, f);
+    changes += jdf_fold_call(guard->calltrue, jdf, f);
+    changes += jdf_fold_call(guard->callfalse, jdf, f);
+    if( JDF_GUARD_UNCONDITIONAL == guard->guard_type )
+        return changes;
+
+    changes += jdf_fold_expr(guard->guard, jdf, f);
+    if( !jdf_expr_is_int_cst(guard->guard) )
+        return changes;
+    /* The guard is known at compile time, simplify the dependency */
+    if( JDF_GUARD_TERNARY == guard->guard_type ) {
+        if( 0 == guard->guard->jdf_cst )
+            guard->calltrue = guard->callfalse;
+        guard->callfalse  = NULL;
+        guard->guard      = NULL;
+        guard->guard_type = JDF_GUARD_UNCONDITIONAL;
+        changes++;
+    } else if( 0 != guard->guard->jdf_cst ) {
+        guard->guard      = NULL;
+        guard->guard_type = JDF_GUARD_UNCONDITIONAL;
+        changes++;
+    }  /* otherwise the dependency is dead, see JDF_IS_DEP_DEAD */
+    return changes;
+}
+
+int jdf_fold_constants( jdf_t *jdf )
+{
+    jdf_global_entry_t *g;
+    jdf_function_entry_t *f;
+    jdf_variable_list_t *vl;
+    jdf_dataflow_t *fl;
+    jdf_dep_t *dep;
+    jdf_def_list_t *c;
+    jdf_expr_t *value;
+    int changes = 0, nb_constants = 0;
+
+    /* Command line constants take precedence over the JDF properties */
+    for( c = JDF_COMPILER_GLOBAL_ARGS.constants; NULL != c; c = c->next ) {
+        for( g = jdf->globals; NULL != g; g = g->next )
+            if( !strcmp(g->name, c->name) ) break;
+        if( NULL == g ) {
+            jdf_warn(JDF_OBJECT_LINENO(jdf), "Constant %s defined on the command line is not a global of the JDF\n",
+                     c->name);
+            continue;
+        }
+        jdf_global_set_constant(g, c->expr);
+    }
+
+    /* Globals are defined in order, each one can only depend on the previous ones */
+    for( g = jdf->globals; NULL != g; g = g->next ) {
+        value = jdf_find_property(g->properties, JDF_PROP_CONSTANT_NAME, NULL);
+        if( NULL != value ) {
+            jdf_fold_expr(value, jdf, NULL);
+            if( !jdf_expr_is_int_cst(value) ) {
+                jdf_fatal(JDF_OBJECT_LINENO(g), "Global %s: the %s property must be an integer constant expression\n",
+                          g->name, JDF_PROP_CONSTANT_NAME);
+                return -1;
+            }
+            nb_constants++;
+        }
+    }
+    if( 0 == nb_constants )
+        return 0;
+
+    for( f = jdf->functions; NULL != f; f = f->next ) {
+        for( vl = f->locals; NULL != vl; vl = vl->next )
+            changes += jdf_fold_expr(vl->expr, jdf, f);
+        if( NULL != f->predicate )
+            changes += jdf_fold_call(f->predicate, jdf, f);
+        changes += jdf_fold_expr(f->priority, jdf, f);
+        changes += jdf_fold_expr(f->simcost, jdf, f);
+        for( fl = f->dataflow; NULL != fl; fl = fl->next )
+            for( dep = fl->deps; NULL != dep; dep = dep->next )
+                changes += jdf_fold_dep(dep, jdf, f);
+    }
+    DO_DEBUG_VERBOSE(1, fprintf(stderr, "%d constant globals, %d expressions simplified\n",
+                                nb_constants, changes));
+    return changes;
+}
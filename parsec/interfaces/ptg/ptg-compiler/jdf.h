@@ -89,9 +89,24 @@ int jdf_sanity_checks( jdf_warning_mask_t mask );
 #define DEP_MANAGEMENT_DYNAMIC_HASH_TABLE 1
 #define DEP_MANAGEMENT_INDEX_ARRAY_STRING        "index-array"
 #define DEP_MANAGEMENT_INDEX_ARRAY        2
+#define DEP_MANAGEMENT_PAGED_ARRAY_STRING        "paged-array"
+#define DEP_MANAGEMENT_PAGED_ARRAY        3
+
+/**
+ * Task classes carrying this property use the named dependencies tracking
+ * method instead of the one selected on the command line with -M.
+ */
+#define JDF_PROP_DEP_MANAGEMENT_NAME             "dep_management"
 
 #define DISABLE_DEP_WARNING_PROPERTY_NAME        "warning"
 
+/**
+ * Globals carrying this property (or set with --constant on the command line)
+ * are compile-time constants: their value is folded in all the expressions of
+ * the JDF, and the generated code is specialized accordingly.
+ */
+#define JDF_PROP_CONSTANT_NAME                   "constant"
+
 typedef struct jdf_compiler_global_args {
     char *input;
     char *output_c;
@@ -104,6 +119,7 @@ typedef struct jdf_compiler_global_args {
     int   dep_management;
     int   noline;  /**< Don't dump the jdf line number in the generate .c file */
     struct jdf_name_list *ignore_properties; /**< Properties to ignore */
+    struct jdf_def_list  *constants;  /**< Globals defined as constants on the command line */
 } jdf_compiler_global_args_t;
 extern jdf_compiler_global_args_t JDF_COMPILER_GLOBAL_ARGS;
 
@@ -214,6 +230,7 @@ typedef struct jdf_function_entry {
     struct jdf_param_list     *parameters;
     jdf_flags_t                flags;
     jdf_flags_t                user_defines;
+    int32_t                    dep_management;
     int32_t                    task_class_id;
     int32_t                    nb_max_local_def;
     struct jdf_variable_list  *locals;
@@ -506,6 +523,28 @@ jdf_def_list_t *jdf_add_function_property(jdf_def_list_t **properties, const cha
  */
 jdf_def_list_t *jdf_add_string_property(jdf_def_list_t **properties, const char *prop_name, const char *prop_value);
 
+/**
+ * Return the folded value of a compile-time constant global, or NULL if the
+ * global named name is not a constant.
+ */
+const jdf_expr_t *jdf_global_constant_value( const jdf_global_entry_t *globals, const char *name );
+
+/**
+ * Fold the compile-time constant globals in all the expressions of the JDF,
+ * simplify the resulting expressions and the guards of the dependencies.
+ * Return the number of simplifications, or -1 on error.
+ */
+int jdf_fold_constants( jdf_t *jdf );
+
+/**
+ * Return true if the guard of the dependency has been folded to false at
+ * compile time: the dependency can never be activated.
+ */
+#define JDF_IS_DEP_DEAD(DEP)                                            \
+    ((JDF_GUARD_BINARY == (DEP)->guard->guard_type) &&                  \
+     (JDF_CST == (DEP)->guard->guard->op) &&                            \
+     (0 == (DEP)->guard->guard->jdf_cst))
+
 /**
  * Function cleanup and management. Available in jdf.c
  */
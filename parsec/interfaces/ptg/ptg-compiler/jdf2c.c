@@ -291,11 +291,28 @@ static char* dump_globals(void** elem, void *arg)
 {
     string_arena_t *sa = (string_arena_t*)arg;
     jdf_global_entry_t* global = (jdf_global_entry_t*)elem;
+    const jdf_expr_t *cst;
 
     string_arena_init(sa);
     if( NULL != global->data ) {
         string_arena_add_string(sa, "%s "TASKPOOL_GLOBAL_PREFIX"_g_%s",
                                 global->name, global->name );
+    } else if( NULL != (cst = jdf_global_constant_value(current_jdf.globals, global->name)) ) {
+        /* compile-time constant: let the C compiler specialize the code, with
+         * the declared type of the global */
+        jdf_expr_t *type_str = jdf_find_property( global->properties, "type", NULL );
+        if( NULL == type_str ) {
+            string_arena_add_string(sa, "%s (%d)", global->name, cst->jdf_cst );
+        } else {
+            expr_info_t info = EMPTY_EXPR_INFO;
+            info.sa = string_arena_new(8);
+            info.prefix = "";
+            info.suffix = "";
+            info.assignments = "assignments";
+            string_arena_add_string(sa, "%s ((%s)%d)", global->name,
+                                    dump_expr((void**)type_str, &info), cst->jdf_cst );
+            string_arena_free(info.sa);
+        }
     } else {
         string_arena_add_string(sa, "%s ("TASKPOOL_GLOBAL_PREFIX"_g_%s)",
                                 global->name, global->name );
@@ -303,6 +320,34 @@ static char* dump_globals(void** elem, void *arg)
     return string_arena_get_string(sa);
 }
 
+/**
+ * dump_accessor:
+ *   Dump the call to the accessor (data_of, rank_of or vpid_of) of a
+ *   collection. Collections indexed by one or two coordinates go through the
+ *   fixed-arity accessors when the collection provides them, the others use
+ *   the varargs indirect call.
+ */
+static void dump_accessor(string_arena_t *sa, const jdf_data_entry_t* data, const char *accessor)
+{
+    int i;
+
+    if( (1 == data->nbparams) || (2 == data->nbparams) ) {
+        string_arena_add_string(sa, "parsec_data_collection_%s_2d((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s, (%s_d0), ",
+                                accessor, data->dname, data->dname);
+        if( 2 == data->nbparams )
+            string_arena_add_string(sa, "(%s_d1))", data->dname);
+        else
+            string_arena_add_string(sa, "0)");
+        return;
+    }
+    string_arena_add_string(sa, "((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s)->%s((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s",
+                            data->dname, accessor, data->dname);
+    for( i = 0; i < data->nbparams; i++ ) {
+        string_arena_add_string(sa, ", (%s_d%d)", data->dname, i );
+    }
+    string_arena_add_string(sa, ")" );
+}
+
 /**
  * dump_data:
  *   Dump a global symbol like
@@ -319,12 +364,31 @@ static char* dump_data(void** elem, void *arg)
     for( i = 1; i < data->nbparams; i++ ) {
         string_arena_add_string(sa, ", %s_d%d", data->dname, i );
     }
-    string_arena_add_string(sa, ")  (((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s)->data_of((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s",
-                            data->dname, data->dname);
-    for( i = 0; i < data->nbparams; i++ ) {
-        string_arena_add_string(sa, ", (%s_d%d)", data->dname, i );
+    string_arena_add_string(sa, ")  (");
+    dump_accessor(sa, data, "data_of");
+    string_arena_add_string(sa, ")" );
+    return string_arena_get_string(sa);
+}
+
+/**
+ * dump_vpid:
+ *   Dump a global symbol like
+ *     #define vpid_of_ABC(A0, A1) (__parsec_tp->super.ABC->vpid_of(__parsec_tp->super.ABC, A0, A1))
+ */
+static char* dump_vpid(void** elem, void *arg)
+{
+    jdf_data_entry_t* data = (jdf_data_entry_t*)elem;
+    string_arena_t *sa = (string_arena_t*)arg;
+    int i;
+
+    string_arena_init(sa);
+    string_arena_add_string(sa, "%s(%s_d%d", data->dname, data->dname, 0 );
+    for( i = 1; i < data->nbparams; i++ ) {
+        string_arena_add_string(sa, ", %s_d%d", data->dname, i );
     }
-    string_arena_add_string(sa, "))" );
+    string_arena_add_string(sa, ")  (");
+    dump_accessor(sa, data, "vpid_of");
+    string_arena_add_string(sa, ")" );
     return string_arena_get_string(sa);
 }
 
@@ -358,6 +422,9 @@ static int expr_requires_assignment(const jdf_expr_t *expr, int inc_locals)
  * dump_rank:
  *   Dump a global symbol like
  *     #define rank_of_ABC(A0, A1) (__parsec_tp->super.ABC->rank_of(__parsec_tp->super.ABC, A0, A1))
+ *   For 2D collections, the rank of the 2D block cyclic distribution is
+ *   inlined when the collection uses it, instead of the accessor call (see
+ *   jdf_generate_rank_of_block_cyclic).
  */
 static char* dump_rank(void** elem, void *arg)
 {
@@ -370,12 +437,16 @@ static char* dump_rank(void** elem, void *arg)
     for( i = 1; i < data->nbparams; i++ ) {
         string_arena_add_string(sa, ", %s_d%d", data->dname, i );
     }
-    string_arena_add_string(sa, ")  (((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s)->rank_of((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s",
-                            data->dname, data->dname);
-    for( i = 0; i < data->nbparams; i++ ) {
-        string_arena_add_string(sa, ", (%s_d%d)", data->dname, i );
+    string_arena_add_string(sa, ")  (");
+    if( 2 == data->nbparams ) {
+        string_arena_add_string(sa, JDF2C_NAMESPACE"rank_of_block_cyclic("TASKPOOL_GLOBAL_PREFIX"_g_%s, (%s_d0), (%s_d1), \\\n    ",
+                                data->dname, data->dname, data->dname);
+        dump_accessor(sa, data, "rank_of");
+        string_arena_add_string(sa, "))" );
+        return string_arena_get_string(sa);
     }
-    string_arena_add_string(sa, "))" );
+    dump_accessor(sa, data, "rank_of");
+    string_arena_add_string(sa, ")" );
     return string_arena_get_string(sa);
 }
 
@@ -911,8 +982,11 @@ static char *dump_globals_init(void **elem, void *arg)
 
     /* No default value ? */
     if( NULL == prop ) {
+        const jdf_expr_t *cst = jdf_global_constant_value(current_jdf.globals, global->name);
         if( NULL == hidden ) /* Hidden variable or not ? */
             string_arena_add_string(sa, TASKPOOL_GLOBAL_PREFIX"_g_%s = %s;", global->name, global->name);
+        else if( NULL != cst )  /* Hidden constants are initialized with their value */
+            string_arena_add_string(sa, TASKPOOL_GLOBAL_PREFIX"_g_%s = %d;", global->name, cst->jdf_cst);
     } else {
         expr_info_t info = EMPTY_EXPR_INFO;
         info.sa = string_arena_new(8);
@@ -1055,6 +1129,34 @@ static char *dump_name_of_hidden_globals_without_default(void **elem, void *_)
     return global_var->name;
 }
 
+/**
+ * dump_constant_globals_check:
+ *  Globals that are compile-time constants but are still provided by the
+ *  user to _new must match the value used during the code generation.
+ */
+static char *dump_constant_globals_check(void **elem, void *arg)
+{
+    jdf_global_entry_t* global = (jdf_global_entry_t*)elem;
+    string_arena_t *sa = (string_arena_t*)arg;
+    const jdf_expr_t *cst = jdf_global_constant_value(current_jdf.globals, global->name);
+
+    if( (NULL == cst) ||
+        (NULL != jdf_find_property( global->properties, "hidden", NULL )) ||
+        (NULL != jdf_find_property( global->properties, "default", NULL )) ||
+        (NULL != global->expression) )
+        return NULL;
+
+    string_arena_init(sa);
+    string_arena_add_string(sa,
+                            "if( %d != (%s) ) {\n"
+                            "    parsec_warning(\"parsec_%s_new: %s was compiled as the constant %d but %%d was provided\", (int)(%s));\n"
+                            "    return NULL;\n"
+                            "  }",
+                            cst->jdf_cst, global->name,
+                            jdf_basename, global->name, cst->jdf_cst, global->name);
+    return string_arena_get_string(sa);
+}
+
 /** Utils: observers for the jdf **/
 
 static int jdf_symbol_is_global(const jdf_global_entry_t *globals, const char *name)
@@ -1481,6 +1583,42 @@ static void jdf_generate_predeclarations( const jdf_t *jdf )
     (void)rc;
 }
 
+/**
+ * Returns 1 if a global of the JDF is declared with the type of the 2D block
+ * cyclic distribution, in which case its header is included by the
+ * generated code.
+ */
+static int jdf_uses_block_cyclic(const jdf_t *jdf)
+{
+    const jdf_global_entry_t *g;
+    const jdf_expr_t *type;
+
+    for( g = jdf->globals; NULL != g; g = g->next ) {
+        type = jdf_find_property(g->properties, "type", NULL);
+        if( (NULL != type) && ((JDF_STRING == type->op) || (JDF_VAR == type->op)) &&
+            (NULL != strstr(type->jdf_var, "parsec_matrix_block_cyclic_t")) )
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * Generate the helper used by the rank_of macros of the 2D collections: when
+ * the header of the 2D block cyclic distribution has been included, by the
+ * generated code or by the prologue, the rank of the collections using this
+ * distribution is computed inline instead of calling the accessor.
+ */
+static void jdf_generate_rank_of_block_cyclic(void)
+{
+    coutput("#if defined(__TWO_DIM_RECTANGLE_CYCLIC_H__)\n"
+            "#define "JDF2C_NAMESPACE"rank_of_block_cyclic(dc, m, n, generic) \\\n"
+            "  ((((parsec_data_collection_t*)(dc))->rank_of == parsec_matrix_block_cyclic_rank_of) ? \\\n"
+            "   parsec_matrix_block_cyclic_rank_of_inline((const parsec_matrix_block_cyclic_t*)(dc), (m), (n)) : (generic))\n"
+            "#else\n"
+            "#define "JDF2C_NAMESPACE"rank_of_block_cyclic(dc, m, n, generic) (generic)\n"
+            "#endif  /* defined(__TWO_DIM_RECTANGLE_CYCLIC_H__) */\n\n");
+}
+
 /**
  * Dump a minimalistic code including all the includes and all the defines that
  * can be used in the prologue. Keep this small so that we don't generate code
@@ -1496,6 +1634,7 @@ static void jdf_minimal_code_before_prologue(const jdf_t *jdf)
             "#include \"parsec/parsec_internal.h\"\n"
             "#include \"parsec/ayudame.h\"\n"
             "#include \"parsec/execution_stream.h\"\n"
+            "%s"
             "#if defined(PARSEC_HAVE_CUDA)\n"
             "#include \"parsec/mca/device/cuda/device_cuda.h\"\n"
             "#endif  /* defined(PARSEC_HAVE_CUDA) */\n"
@@ -1508,6 +1647,7 @@ static void jdf_minimal_code_before_prologue(const jdf_t *jdf)
             "#define PARSEC_%s_NB_DATA %d\n\n"
             "typedef struct __parsec_%s_internal_taskpool_s __parsec_%s_internal_taskpool_t;\n"
             "struct parsec_%s_internal_taskpool_s;\n\n",
+            jdf_uses_block_cyclic(jdf) ? "#include \"parsec/data_dist/matrix/two_dim_rectangle_cyclic.h\"\n" : "",
             jdf_basename, nbfunctions,
             jdf_basename, nbdata,
             jdf_basename, jdf_basename,
@@ -1515,6 +1655,21 @@ static void jdf_minimal_code_before_prologue(const jdf_t *jdf)
     jdf_generate_predeclarations(jdf);
 }
 
+/**
+ * Returns 1 if at least one task class of the JDF tracks its dependencies
+ * with the dep_management method, 0 otherwise.
+ */
+static int jdf_uses_dep_management(const jdf_t *jdf, int dep_management)
+{
+    const jdf_function_entry_t *f;
+
+    for(f = jdf->functions; NULL != f; f = f->next) {
+        if( dep_management == f->dep_management )
+            return 1;
+    }
+    return 0;
+}
+
 static void jdf_generate_structure(jdf_t *jdf)
 {
     int nbfunctions, need_profile = 0;
@@ -1593,9 +1748,13 @@ static void jdf_generate_structure(jdf_t *jdf)
     coutput("/* Data Access Macros */\n%s\n",
             UTIL_DUMP_LIST(sa1, jdf->data, next,
                            dump_data, sa2, "", "#define data_of_", "\n", "\n"));
+    jdf_generate_rank_of_block_cyclic();
     coutput("%s\n",
             UTIL_DUMP_LIST(sa1, jdf->data, next,
                            dump_rank, sa2, "", "#define rank_of_", "\n", "\n"));
+    coutput("%s\n",
+            UTIL_DUMP_LIST(sa1, jdf->data, next,
+                           dump_vpid, sa2, "", "#define vpid_of_", "\n", "\n"));
 
     coutput("/* Functions Predicates */\n%s\n",
             UTIL_DUMP_LIST(sa1, jdf->functions, next,
@@ -1616,7 +1775,7 @@ static void jdf_generate_structure(jdf_t *jdf)
         }
     }
 
-    if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+    if( jdf_uses_dep_management(jdf, DEP_MANAGEMENT_INDEX_ARRAY) ) {
         coutput("/* Dependency Tracking Allocation Macro */\n"
                 "#define ALLOCATE_DEP_TRACKING(DEPS, vMIN, vMAX, vNAME, FLAG)                  \\\n"
                 "do {                                                                          \\\n"
@@ -3091,7 +3250,7 @@ static void jdf_generate_startup_tasks(const jdf_t *jdf, const jdf_function_entr
     jdf_generate_direct_input_conditions(jdf, f, f->dataflow);
 
     coutput("%s  if( NULL != ((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s)->vpid_of ) {\n"
-            "%s    vpid = ((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s)->vpid_of((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s, %s);\n"
+            "%s    vpid = vpid_of_%s(%s);\n"
             "%s    assert(context->nb_vp >= vpid);\n"
             "%s  } else {\n"
             "%s    vpid = (vpid + 1) %% context->nb_vp;  /* spread the initial joy */\n"
@@ -3099,7 +3258,7 @@ static void jdf_generate_startup_tasks(const jdf_t *jdf, const jdf_function_entr
             "%s  new_task = (%s*)parsec_thread_mempool_allocate( context->virtual_processes[vpid]->execution_streams[0]->context_mempool );\n"
             "%s  new_task->status = PARSEC_TASK_STATUS_NONE;\n",
             indent(nesting), f->predicate->func_or_mem,
-            indent(nesting), f->predicate->func_or_mem, f->predicate->func_or_mem,
+            indent(nesting), f->predicate->func_or_mem,
             UTIL_DUMP_LIST(sa2, f->predicate->parameters, next,
                            dump_expr, (void*)&info1,
                            "", "", ", ", ""),
@@ -3158,10 +3317,9 @@ static void jdf_generate_startup_tasks(const jdf_t *jdf, const jdf_function_entr
             "#endif\n", indent(nesting), indent(nesting), indent(nesting), indent(nesting), indent(nesting));
 
     coutput("%s  parsec_dependencies_mark_task_as_startup((parsec_task_t*)new_task, es);\n"
-            "%s  pready_ring[vpid] = parsec_list_item_ring_push_sorted(pready_ring[vpid],\n"
-            "%s                                                        (parsec_list_item_t*)new_task,\n"
-            "%s                                                        parsec_execution_context_priority_comparator);\n"
-            "%s  nb_tasks++;\n", indent(nesting), indent(nesting), indent(nesting), indent(nesting), indent(nesting));
+            "%s  pready_ring[vpid] = parsec_list_item_ring_push_front(pready_ring[vpid],\n"
+            "%s                                                       (parsec_list_item_t*)new_task);\n"
+            "%s  nb_tasks++;\n", indent(nesting), indent(nesting), indent(nesting), indent(nesting));
     coutput("%s restore_context_%d:  /* we jump here just so that we have code after the label */\n", indent(nesting), ctx_level);
     coutput("%s  restore_context = 0;\n"
             "%s  (void)restore_context;\n"
@@ -3410,7 +3568,7 @@ static void jdf_generate_internal_init(const jdf_t *jdf, const jdf_function_entr
     if( 0 != (f->user_defines & JDF_FUNCTION_HAS_UD_HASH_STRUCT) ) {
         dep_key_fn_name = strdup( jdf_property_get_string(f->properties, JDF_PROP_UD_HASH_STRUCT_NAME, NULL) );
     } else {
-        if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE) {
+        if( f->dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE) {
             if( asprintf(&dep_key_fn_name, "%s_%s_deps_key_functions", jdf_basename, fname) <= 0 ) {
                 fprintf(stderr, "Cannot allocate internal memory for the PTG compiler\n");
                 exit(-1);
@@ -3455,7 +3613,7 @@ static void jdf_generate_internal_init(const jdf_t *jdf, const jdf_function_entr
             parsec_get_name(jdf, f, "parsec_assignment_t"),
             UTIL_DUMP_LIST_FIELD(sa1, f->locals, next, name, dump_string, NULL,
                                      "  ", ".", ".value = 0, ", ".value = 0 "));
-        if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+        if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
             coutput("  parsec_dependencies_t *dep = NULL;\n");
         }
         coutput("%s",
@@ -3634,7 +3792,7 @@ static void jdf_generate_internal_init(const jdf_t *jdf, const jdf_function_entr
             }
         }
 
-        if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+        if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
             /* If no tasks have been generated during the last loop, there is no need
              * to have any dependencies.
              */
@@ -3758,10 +3916,19 @@ static void jdf_generate_internal_init(const jdf_t *jdf, const jdf_function_entr
         coutput("  __parsec_tp->super.super.dependencies_array[%d] = %s(__parsec_tp);\n",
                 f->task_class_id, jdf_property_get_function(f->properties, JDF_PROP_UD_ALLOC_DEPS_FN_NAME, NULL));
     } else {
-        if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+        if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
             coutput("  __parsec_tp->super.super.dependencies_array[%d] = dep;\n",
                     f->task_class_id);
-        } else if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ||
+        } else if( f->dep_management == DEP_MANAGEMENT_PAGED_ARRAY ) {
+            /* The keys are collision-free and bounded by the product of the ranges */
+            coutput("  PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, \"Allocating paged dependencies for %s\");\n"
+                    "  __parsec_tp->super.super.dependencies_array[%d] = parsec_paged_dependencies_new(1",
+                    f->fname, f->task_class_id);
+            for(pl = f->parameters; NULL != pl; pl = pl->next) {
+                coutput("\n      * (uint64_t)parsec_imax(0, __parsec_tp->%s_%s_range)", f->fname, pl->name);
+            }
+            coutput(");\n");
+        } else if( f->dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ||
                    0 != (f->user_defines & JDF_FUNCTION_HAS_UD_HASH_STRUCT)) {
             coutput("  __parsec_tp->super.super.dependencies_array[%d] = PARSEC_OBJ_NEW(parsec_hash_table_t);\n"
                     "  parsec_hash_table_init(__parsec_tp->super.super.dependencies_array[%d], offsetof(parsec_hashable_dependency_t, ht_item), 10, %s, this_task->taskpool);\n",
@@ -4227,12 +4394,14 @@ static void jdf_generate_one_function( const jdf_t *jdf, jdf_function_entry_t *f
     string_arena_add_string(sa, "  .incarnations = __%s_chores,\n", prefix);
 
     if( !(f->user_defines & JDF_FUNCTION_HAS_UD_DEPENDENCIES_FUNS) ) {
-        if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+        if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
             sprintf(prefix, "find_deps_%s_%s", jdf_basename, f->fname);
             jdf_generate_code_find_deps(jdf, f, prefix);
             (void)jdf_add_function_property(&f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, prefix);
-        } else if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
+        } else if( f->dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
             (void)jdf_add_function_property(&f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, "parsec_hash_find_deps");
+        } else if( f->dep_management == DEP_MANAGEMENT_PAGED_ARRAY ) {
+            (void)jdf_add_function_property(&f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, "parsec_paged_find_deps");
         }
     }
     string_arena_add_string(sa, "  .find_deps = %s,\n", jdf_property_get_function(f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, NULL));
@@ -4288,9 +4457,10 @@ static void jdf_generate_one_function( const jdf_t *jdf, jdf_function_entry_t *f
      * the tasks, the value returned from this function is not PARSEC_UNDETERMINED_NB_TASKS
      * (which means the runtime will have to count the completed tasks).
      */
-    if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+    if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ||
+        f->dep_management == DEP_MANAGEMENT_PAGED_ARRAY ) {
         string_arena_add_string(sa, "  .release_task = (parsec_hook_t*)parsec_release_task_to_mempool_update_nbtasks,\n");
-    } else if ( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
+    } else if ( f->dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
         /* If we have a user-defined find_deps function, don't generate the hashtable_dep release task, keep
          * just counting, if needed */
         sprintf(prefix, "release_task_of_%s_%s", jdf_basename, f->fname);
@@ -4475,7 +4645,8 @@ static void jdf_generate_destructor( const jdf_t *jdf )
             "{\n"
             "  uint32_t i;\n",
             jdf_basename, jdf_basename);
-    if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+    if( jdf_uses_dep_management(jdf, DEP_MANAGEMENT_INDEX_ARRAY) ||
+        jdf_uses_dep_management(jdf, DEP_MANAGEMENT_PAGED_ARRAY) ) {
         coutput("  size_t dependencies_size = 0;\n");
     }
 
@@ -4509,11 +4680,14 @@ static void jdf_generate_destructor( const jdf_t *jdf )
     coutput("  /* Release the dependencies arrays for this object */\n");
     for(f = jdf->functions; NULL != f; f = f->next) {
         if( !( f->user_defines & JDF_FUNCTION_HAS_UD_DEPENDENCIES_FUNS ) ) {
-            if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+            if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
                 coutput("  if(NULL != __parsec_tp->super.super.dependencies_array[%d])\n"
                         "    dependencies_size += parsec_destruct_dependencies( __parsec_tp->super.super.dependencies_array[%d] );\n",
                         f->task_class_id, f->task_class_id);
-            } else if (JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
+            } else if( f->dep_management == DEP_MANAGEMENT_PAGED_ARRAY ) {
+                coutput("  dependencies_size += parsec_paged_dependencies_destruct( __parsec_tp->super.super.dependencies_array[%d] );\n",
+                        f->task_class_id);
+            } else if (f->dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
                 coutput("  parsec_hash_table_fini( (parsec_hash_table_t*)__parsec_tp->super.super.dependencies_array[%d] );\n"
                         "  PARSEC_OBJ_RELEASE(__parsec_tp->super.super.dependencies_array[%d]);\n",
                         f->task_class_id, f->task_class_id);
@@ -4530,7 +4704,8 @@ static void jdf_generate_destructor( const jdf_t *jdf )
     coutput("  free( __parsec_tp->super.super.dependencies_array );\n"
             "  __parsec_tp->super.super.dependencies_array = NULL;\n");
 
-    if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+    if( jdf_uses_dep_management(jdf, DEP_MANAGEMENT_INDEX_ARRAY) ||
+        jdf_uses_dep_management(jdf, DEP_MANAGEMENT_PAGED_ARRAY) ) {
         coutput("#if defined(PARSEC_PROF_TRACE)\n"
                 "  {\n"
                 "    char meminfo[128];\n"
@@ -4755,6 +4930,11 @@ static void jdf_generate_new_function( const jdf_t* jdf )
                                 "", "", ", ", ""));
     }
 
+    string_arena_init(sa1);
+    string_arena_init(sa2);
+    coutput("%s", UTIL_DUMP_LIST(sa1, jdf->globals, next,
+                                 dump_constant_globals_check, sa2, "", "  ", "\n", "\n"));
+
     coutput("  __parsec_%s_internal_taskpool_t *__parsec_tp = PARSEC_OBJ_NEW(__parsec_%s_internal_taskpool_t);\n",
             jdf_basename, jdf_basename);
 
@@ -7257,6 +7437,64 @@ static void jdf_generate_code_release_deps(const jdf_t *jdf, const jdf_function_
         "\n");
 }
 
+/**
+ * Collects in mask the locals of f used by the expression e. Returns 0 on
+ * success, and -1 if the expression cannot be analyzed (inline C code, local
+ * definitions).
+ */
+static int jdf_expr_collect_locals(const jdf_function_entry_t *f, const jdf_expr_t *e, uint32_t *mask)
+{
+    const jdf_variable_list_t *vl;
+    int i;
+
+    if( NULL == e ) return 0;
+    if( NULL != e->local_variables ) return -1;
+    switch( e->op ) {
+    case JDF_CST: case JDF_STRING:
+        return 0;
+    case JDF_VAR:
+        for(vl = f->locals, i = 0; NULL != vl; vl = vl->next, i++) {
+            if( 0 == strcmp(vl->name, e->jdf_var) ) {
+                *mask |= (1U << i);
+                break;
+            }
+        }
+        return 0;  /* otherwise this is a global */
+    case JDF_C_CODE: case JDF_RANGE:
+        return -1;
+    case JDF_TERNARY:
+        if( 0 != jdf_expr_collect_locals(f, e->jdf_tat, mask) ) return -1;
+        if( 0 != jdf_expr_collect_locals(f, e->jdf_ta1, mask) ) return -1;
+        return jdf_expr_collect_locals(f, e->jdf_ta2, mask);
+    case JDF_NOT:
+        return jdf_expr_collect_locals(f, e->jdf_ua, mask);
+    default:
+        if( JDF_OP_IS_BINARY(e->op) ) {
+            if( 0 != jdf_expr_collect_locals(f, e->jdf_ba1, mask) ) return -1;
+            return jdf_expr_collect_locals(f, e->jdf_ba2, mask);
+        }
+    }
+    return -1;
+}
+
+/**
+ * Returns 1 if the call iterates over a range of successors (broadcast), in
+ * which case the affinity and priority of the successors are memoized.
+ */
+static int jdf_call_has_range(const jdf_call_t *call)
+{
+    const jdf_expr_t *el, *ld;
+
+    for(ld = call->local_defs; NULL != ld; ld = ld->next)
+        if( JDF_RANGE == ld->op ) return 1;
+    for(el = call->parameters; NULL != el; el = el->next) {
+        if( JDF_RANGE == el->op ) return 1;
+        for(ld = el->local_variables; NULL != ld; ld = ld->next)
+            if( JDF_RANGE == ld->op ) return 1;
+    }
+    return 0;
+}
+
 static char *jdf_dump_context_assignment(string_arena_t *sa_open,
                                          const jdf_t *jdf,
                                          const jdf_function_entry_t *sourcef,
@@ -7269,12 +7507,13 @@ static char *jdf_dump_context_assignment(string_arena_t *sa_open,
                                          const char *var)
 {
     expr_info_t local_info = EMPTY_EXPR_INFO, dest_info = EMPTY_EXPR_INFO;
-    int nbparam_given, nbparam_required, i, nbopen;
+    int nbparam_given, nbparam_required, i, nbopen, memoize, memoize_prio;
     const jdf_function_entry_t *targetf;
     string_arena_t *sa2, *sa1, *sa_close;
     jdf_variable_list_t *vl;
     jdf_param_list_t *nl;
     jdf_expr_t *el;
+    uint32_t prio_locals = 0;
 
     (void)sourcef;
     
@@ -7312,6 +7551,28 @@ static char *jdf_dump_context_assignment(string_arena_t *sa_open,
     string_arena_add_string(sa_open, "%s%s%s.task_class = __parsec_tp->super.super.task_classes_array[%s_%s.task_class_id];\n",
                             prefix, indent(nbopen), var, jdf_basename, targetf->fname);
 
+    /* When the call iterates over many successors, the affinity and the
+     * priority usually follow a simpler pattern than the successors
+     * themselves: remember the last arguments and skip the evaluation when
+     * they did not change. */
+    memoize = jdf_call_has_range(call);
+    memoize_prio = memoize && (NULL != targetf->priority) &&
+        (0 == jdf_expr_collect_locals(targetf, targetf->priority, &prio_locals));
+    if( memoize ) {
+        string_arena_add_string(sa_open, "%s%s  int "JDF2C_NAMESPACE"aff_valid = 0", prefix, indent(nbopen));
+        for(el = targetf->predicate->parameters, i = 0; NULL != el; el = el->next, i++)
+            string_arena_add_string(sa_open, ", "JDF2C_NAMESPACE"aff%d = 0", i);
+        string_arena_add_string(sa_open, ";  /* memoized affinity of the successors */\n");
+    }
+    if( memoize_prio ) {
+        string_arena_add_string(sa_open, "%s%s  int32_t "JDF2C_NAMESPACE"prio_valid = 0, "JDF2C_NAMESPACE"prio = 0",
+                                prefix, indent(nbopen));
+        for(vl = targetf->locals, i = 0; NULL != vl; vl = vl->next, i++)
+            if( prio_locals & (1U << i) )
+                string_arena_add_string(sa_open, ", "JDF2C_NAMESPACE"prio_%s = 0", vl->name);
+        string_arena_add_string(sa_open, ";  /* memoized priority of the successors */\n");
+    }
+
     nbparam_given = 0;
     for(el = call->parameters; el != NULL; el = el->next) {
         nbparam_given++;
@@ -7489,24 +7750,75 @@ static char *jdf_dump_context_assignment(string_arena_t *sa_open,
         }
     }
 
-    string_arena_add_string(sa_open,
-                            "#if defined(DISTRIBUTED)\n"
-                            "%s%s  rank_dst = rank_of_%s(%s);\n",
-                            prefix, indent(nbopen), targetf->predicate->func_or_mem,
-                            UTIL_DUMP_LIST(sa2, targetf->predicate->parameters, next,
-                                           dump_expr, (void*)&dest_info,
-                                           "", "", ", ", ""));
-    string_arena_add_string(sa_open,
-                            "%s%s  if( (NULL != es) && (rank_dst == es->virtual_process->parsec_context->my_rank) )\n"
-                            "#endif /* DISTRIBUTED */\n"
-                            "%s%s    vpid_dst = ((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s)->vpid_of((parsec_data_collection_t*)"TASKPOOL_GLOBAL_PREFIX"_g_%s, %s);\n",
-                            prefix, indent(nbopen),
-                            prefix, indent(nbopen), targetf->predicate->func_or_mem, targetf->predicate->func_or_mem,
-                            UTIL_DUMP_LIST(sa2, targetf->predicate->parameters, next,
-                                           dump_expr, (void*)&dest_info,
-                                           "", "", ", ", ""));
+    if( memoize ) {
+        string_arena_t *sa_args = string_arena_new(64);
 
-    if( NULL != targetf->priority ) {
+        string_arena_add_string(sa_open, "%s%s  if( !"JDF2C_NAMESPACE"aff_valid", prefix, indent(nbopen));
+        for(el = targetf->predicate->parameters, i = 0; NULL != el; el = el->next, i++) {
+            string_arena_add_string(sa_open, " || ("JDF2C_NAMESPACE"aff%d != (%s))",
+                                    i, dump_expr((void**)el, &dest_info));
+        }
+        string_arena_add_string(sa_open, " ) {\n"
+                                "%s%s    "JDF2C_NAMESPACE"aff_valid = 1;\n",
+                                prefix, indent(nbopen));
+        for(el = targetf->predicate->parameters, i = 0; NULL != el; el = el->next, i++) {
+            string_arena_add_string(sa_open, "%s%s    "JDF2C_NAMESPACE"aff%d = %s;\n",
+                                    prefix, indent(nbopen), i, dump_expr((void**)el, &dest_info));
+            string_arena_add_string(sa_args, "%s"JDF2C_NAMESPACE"aff%d", (0 == i) ? "" : ", ", i);
+        }
+        string_arena_add_string(sa_open,
+                                "#if defined(DISTRIBUTED)\n"
+                                "%s%s    rank_dst = rank_of_%s(%s);\n"
+                                "%s%s    if( (NULL != es) && (rank_dst == es->virtual_process->parsec_context->my_rank) )\n"
+                                "#endif /* DISTRIBUTED */\n"
+                                "%s%s      vpid_dst = vpid_of_%s(%s);\n"
+                                "%s%s  }\n",
+                                prefix, indent(nbopen), targetf->predicate->func_or_mem, string_arena_get_string(sa_args),
+                                prefix, indent(nbopen),
+                                prefix, indent(nbopen), targetf->predicate->func_or_mem,
+                                string_arena_get_string(sa_args),
+                                prefix, indent(nbopen));
+        string_arena_free(sa_args);
+    } else {
+        string_arena_add_string(sa_open,
+                                "#if defined(DISTRIBUTED)\n"
+                                "%s%s  rank_dst = rank_of_%s(%s);\n",
+                                prefix, indent(nbopen), targetf->predicate->func_or_mem,
+                                UTIL_DUMP_LIST(sa2, targetf->predicate->parameters, next,
+                                               dump_expr, (void*)&dest_info,
+                                               "", "", ", ", ""));
+        string_arena_add_string(sa_open,
+                                "%s%s  if( (NULL != es) && (rank_dst == es->virtual_process->parsec_context->my_rank) )\n"
+                                "#endif /* DISTRIBUTED */\n"
+                                "%s%s    vpid_dst = vpid_of_%s(%s);\n",
+                                prefix, indent(nbopen),
+                                prefix, indent(nbopen), targetf->predicate->func_or_mem,
+                                UTIL_DUMP_LIST(sa2, targetf->predicate->parameters, next,
+                                               dump_expr, (void*)&dest_info,
+                                               "", "", ", ", ""));
+    }
+
+    if( memoize_prio ) {
+        string_arena_add_string(sa_open, "%s%s  if( !"JDF2C_NAMESPACE"prio_valid", prefix, indent(nbopen));
+        for(vl = targetf->locals, i = 0; NULL != vl; vl = vl->next, i++)
+            if( prio_locals & (1U << i) )
+                string_arena_add_string(sa_open, " || ("JDF2C_NAMESPACE"prio_%s != ncc->locals.%s.value)",
+                                        vl->name, vl->name);
+        string_arena_add_string(sa_open, " ) {\n"
+                                "%s%s    "JDF2C_NAMESPACE"prio_valid = 1;\n",
+                                prefix, indent(nbopen));
+        for(vl = targetf->locals, i = 0; NULL != vl; vl = vl->next, i++)
+            if( prio_locals & (1U << i) )
+                string_arena_add_string(sa_open, "%s%s    "JDF2C_NAMESPACE"prio_%s = ncc->locals.%s.value;\n",
+                                        prefix, indent(nbopen), vl->name, vl->name);
+        string_arena_add_string(sa_open,
+                                "%s%s    "JDF2C_NAMESPACE"prio = priority_of_%s_%s_as_expr_fct(__parsec_tp, &ncc->locals);\n"
+                                "%s%s  }\n"
+                                "%s%s  %s.priority = __parsec_tp->super.super.priority + "JDF2C_NAMESPACE"prio;\n",
+                                prefix, indent(nbopen), jdf_basename, targetf->fname,
+                                prefix, indent(nbopen),
+                                prefix, indent(nbopen), var);
+    } else if( NULL != targetf->priority ) {
         string_arena_add_string(sa_open,
                                 "%s%s  %s.priority = __parsec_tp->super.super.priority + priority_of_%s_%s_as_expr_fct(__parsec_tp, &ncc->locals);\n",
                                 prefix, indent(nbopen), var, jdf_basename, targetf->fname);
@@ -7713,6 +8025,9 @@ jdf_generate_code_iterate_successors_or_predecessors(const jdf_t *jdf,
             /* Special case for the arena definition for WRITE-only flows */
             if( JDF_IS_DEP_WRITE_ONLY_INPUT_TYPE(dl) )
                 continue;
+            /* The guard was folded to false at compile time */
+            if( JDF_IS_DEP_DEAD(dl) )
+                continue;
 
             string_arena_init(sa_tmp_arena);
             string_arena_init(sa_tmp_count);
@@ -8245,6 +8560,33 @@ static void jdf_check_user_defined_internals(jdf_t *jdf)
             f->user_defines |= JDF_FUNCTION_HAS_UD_STARTUP_TASKS_FUN;
         }
 
+        f->dep_management = JDF_COMPILER_GLOBAL_ARGS.dep_management;
+        if( NULL != (expr = jdf_find_property(f->properties, JDF_PROP_DEP_MANAGEMENT_NAME, &property)) ) {
+            const char *method = (JDF_OP_IS_VAR(expr->op) || JDF_OP_IS_STRING(expr->op)) ? expr->jdf_var : "";
+            if( 0 == strcmp(method, DEP_MANAGEMENT_INDEX_ARRAY_STRING) ) {
+                f->dep_management = DEP_MANAGEMENT_INDEX_ARRAY;
+            } else if( 0 == strcmp(method, DEP_MANAGEMENT_DYNAMIC_HASH_TABLE_STRING) ) {
+                f->dep_management = DEP_MANAGEMENT_DYNAMIC_HASH_TABLE;
+            } else if( 0 == strcmp(method, DEP_MANAGEMENT_PAGED_ARRAY_STRING) ) {
+                f->dep_management = DEP_MANAGEMENT_PAGED_ARRAY;
+            } else {
+                jdf_fatal(JDF_OBJECT_LINENO(property),
+                          "Unknown dependencies management method for task class %s (expected '%s', '%s' or '%s')\n",
+                          f->fname, DEP_MANAGEMENT_INDEX_ARRAY_STRING, DEP_MANAGEMENT_PAGED_ARRAY_STRING,
+                          DEP_MANAGEMENT_DYNAMIC_HASH_TABLE_STRING);
+                exit(1);
+            }
+        }
+        if( (DEP_MANAGEMENT_PAGED_ARRAY == f->dep_management) &&
+            (f->user_defines & JDF_FUNCTION_HAS_UD_MAKE_KEY) ) {
+            /* The pages are indexed by the generated collision-free key, bounded by the ranges */
+            jdf_warn(JDF_OBJECT_LINENO(f),
+                     "Task class %s has a user-defined %s, the '%s' dependencies management cannot be used "
+                     "and '%s' is used instead\n", f->fname, JDF_PROP_UD_MAKE_KEY_FN_NAME,
+                     DEP_MANAGEMENT_PAGED_ARRAY_STRING, DEP_MANAGEMENT_DYNAMIC_HASH_TABLE_STRING);
+            f->dep_management = DEP_MANAGEMENT_DYNAMIC_HASH_TABLE;
+        }
+
         if( NULL != (expr = jdf_find_property(f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, &property)) ) {
             var_to_c_code(expr);
             if( NULL == (expr = jdf_find_property(f->properties, JDF_PROP_UD_ALLOC_DEPS_FN_NAME, &property)) ) {
@@ -8265,10 +8607,12 @@ static void jdf_check_user_defined_internals(jdf_t *jdf)
             }
             f->user_defines |= JDF_FUNCTION_HAS_UD_DEPENDENCIES_FUNS;
         } else {
-            if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
+            if( f->dep_management == DEP_MANAGEMENT_INDEX_ARRAY ) {
                 (void)jdf_add_function_property(&f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, "parsec_default_find_deps");
-            } else if( JDF_COMPILER_GLOBAL_ARGS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
+            } else if( f->dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ) {
                 (void)jdf_add_function_property(&f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, "parsec_hash_find_deps");
+            } else if( f->dep_management == DEP_MANAGEMENT_PAGED_ARRAY ) {
+                (void)jdf_add_function_property(&f->properties, JDF_PROP_UD_FIND_DEPS_FN_NAME, "parsec_paged_find_deps");
             } else {
                 assert(0);
             }
@@ -8323,6 +8667,10 @@ int jdf_optimize( jdf_t* jdf )
     jdf_dataflow_t* flow;
     jdf_dep_t *dep;
 
+    /* Fold the compile-time constants first, this simplifies all the other analyses */
+    if( jdf_fold_constants(jdf) < 0 )
+        return -1;
+
     sa = string_arena_new(64);
     /**
      * Check if any function is marked as high priority (via the properties) or if all
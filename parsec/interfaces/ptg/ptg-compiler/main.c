@@ -39,7 +39,8 @@ static jdf_compiler_global_args_t DEFAULTS = {
 #else
     .noline = 0, /*< Otherwise, go for it (without INDENT or with INDENT but without AWK, lines will be ok) */
 #endif
-    .ignore_properties = NULL
+    .ignore_properties = NULL,
+    .constants = NULL
 };
 jdf_compiler_global_args_t JDF_COMPILER_GLOBAL_ARGS = { 0, .compile = 1 };
 
@@ -64,8 +65,9 @@ static void usage(void)
             "                     (default %s)\n"
             "\n"
             "  --dep-management|-M Select how dependencies tracking is managed. Possible choices\n"
-            "                      are '"DEP_MANAGEMENT_INDEX_ARRAY_STRING"' or '"DEP_MANAGEMENT_DYNAMIC_HASH_TABLE_STRING"'\n"
-            "                      (default '%s')\n"
+            "                      are '"DEP_MANAGEMENT_INDEX_ARRAY_STRING"', '"DEP_MANAGEMENT_PAGED_ARRAY_STRING"'\n"
+            "                      or '"DEP_MANAGEMENT_DYNAMIC_HASH_TABLE_STRING"' (default '%s'). Task classes\n"
+            "                      can override it with the '"JDF_PROP_DEP_MANAGEMENT_NAME"' property\n"
             "\n"
             "  --noline           Do not dump the JDF line number in the .c output file\n"
             "  --line             Force dumping the JDF line number in the .c output file\n"
@@ -85,6 +87,9 @@ static void usage(void)
             "                     in the source code (default don't)\n"
             "  --ignore-property  List (comma separated) of properties to ignore in the JDF\n"
             "                     (default none)\n"
+            "  --constant         List (comma separated) of NAME=VALUE globals to handle as\n"
+            "                     compile-time constants. The generated code is specialized\n"
+            "                     for these values (default none)\n"
             "\n",
             DEFAULTS.input,
             DEFAULTS.output_c,
@@ -92,7 +97,8 @@ static void usage(void)
             DEFAULTS.funcid,
             (DEFAULTS.dep_management == DEP_MANAGEMENT_INDEX_ARRAY ? DEP_MANAGEMENT_INDEX_ARRAY_STRING :
              (DEFAULTS.dep_management == DEP_MANAGEMENT_DYNAMIC_HASH_TABLE ? DEP_MANAGEMENT_DYNAMIC_HASH_TABLE_STRING :
-              ("Unknown dep management string"))),
+              (DEFAULTS.dep_management == DEP_MANAGEMENT_PAGED_ARRAY ? DEP_MANAGEMENT_PAGED_ARRAY_STRING :
+               ("Unknown dep management string")))),
             DEFAULTS.noline?"--noline":"--line");
 }
 
@@ -151,6 +157,36 @@ static void add_to_ignore_properties(const char *optarg)
     }
 }
 
+static void add_to_constants(const char *optarg)
+{
+    jdf_def_list_t *c;
+    char *arg = strdup(optarg);
+    char *l, *v, *end, *last = NULL;
+    long value;
+
+    while( (l = strtok_r(arg, ",", &last)) ) {
+        arg = last;
+        if( (NULL == (v = strchr(l, '='))) || (v == l) ) {
+            fprintf(stderr, "Malformed constant '%s' (expected NAME=VALUE)\n", l);
+            exit(1);
+        }
+        *v++ = '\0';
+        value = strtol(v, &end, 0);
+        if( (*v == '\0') || (*end != '\0') || (value < INT32_MIN) || (value > INT32_MAX) ) {
+            fprintf(stderr, "Value of constant %s is not an integer: '%s'\n", l, v);
+            exit(1);
+        }
+        c = (jdf_def_list_t*)calloc(1, sizeof(jdf_def_list_t));
+        c->name = l;
+        c->expr = (jdf_expr_t*)calloc(1, sizeof(jdf_expr_t));
+        c->expr->op = JDF_CST;
+        c->expr->jdf_type = EXPR_TYPE_INT32;
+        c->expr->jdf_cst = (int32_t)value;
+        c->next = JDF_COMPILER_GLOBAL_ARGS.constants;
+        JDF_COMPILER_GLOBAL_ARGS.constants = c;
+    }
+}
+
 static void parse_args(int argc, char *argv[])
 {
     int ch, i, print_compile_cmd = 0;
@@ -187,12 +223,14 @@ static void parse_args(int argc, char *argv[])
         { "dep-management",required_argument,       NULL,  'M' },
         { "force-profile", no_argument,             NULL,   2  },
         { "ignore-properties", required_argument,   NULL,  'I' },
+        { "constant",      required_argument,       NULL,   3  },
         { NULL,            0,                       NULL,   0  }
     };
 
     JDF_COMPILER_GLOBAL_ARGS.wmask = JDF_ALL_WARNINGS;
     JDF_COMPILER_GLOBAL_ARGS.dep_management = DEFAULTS.dep_management;
     JDF_COMPILER_GLOBAL_ARGS.ignore_properties = NULL;
+    JDF_COMPILER_GLOBAL_ARGS.constants = NULL;
 
     print_jdf_line = !DEFAULTS.noline;
 
@@ -240,6 +278,9 @@ static void parse_args(int argc, char *argv[])
         case 2:
             add_to_ignore_properties("profile");
             break;
+        case 3:
+            add_to_constants(optarg);
+            break;
         case 'E':
             /* Don't compile the preprocessed file, instead stop after the preprocessing stage */
             JDF_COMPILER_GLOBAL_ARGS.compile = 0;
@@ -252,6 +293,8 @@ static void parse_args(int argc, char *argv[])
                 JDF_COMPILER_GLOBAL_ARGS.dep_management = DEP_MANAGEMENT_DYNAMIC_HASH_TABLE;
             else if( strcmp(optarg, DEP_MANAGEMENT_INDEX_ARRAY_STRING) == 0 )
                 JDF_COMPILER_GLOBAL_ARGS.dep_management = DEP_MANAGEMENT_INDEX_ARRAY;
+            else if( strcmp(optarg, DEP_MANAGEMENT_PAGED_ARRAY_STRING) == 0 )
+                JDF_COMPILER_GLOBAL_ARGS.dep_management = DEP_MANAGEMENT_PAGED_ARRAY;
             else {
                 fprintf(stderr, "Unknown dependencies management method: '%s'\n", optarg);
                 usage();
@@ -409,7 +452,9 @@ int main(int argc, char *argv[])
     }
 
     /* Lets try to optimize the jdf */
-    jdf_optimize( &current_jdf );
+    if( jdf_optimize( &current_jdf ) < 0 ) {
+        return 1;
+    }
 
     if( jdf2c(JDF_COMPILER_GLOBAL_ARGS.output_c,
               JDF_COMPILER_GLOBAL_ARGS.output_h,
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/parsec_internal.h"
+#include "parsec/execution_stream.h"
+#include "parsec/utils/mca_param.h"
+#include "parsec/utils/debug.h"
+#include "parsec/live_metrics.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+#include <sys/stat.h> /* For mode constants */
+#include <fcntl.h> /* For O_* constants */
+
+parsec_live_header_t *parsec_live = NULL;
+parsec_live_peer_t   *parsec_live_peers = NULL;
+
+static char              parsec_live_shm_name[256];
+static size_t            parsec_live_size = 0;
+static parsec_live_es_t *parsec_live_streams = NULL;
+
+int parsec_live_init(parsec_context_t *context)
+{
+    char *parsec_live_name = NULL;
+
+    parsec_mca_param_reg_string_name("runtime", "live_metrics",
+                                     "Export the live counters of the process (tasks, steals, idle time, arena memory\n"
+                                     "and communication volume) in the shared memory region /<name>.<rank>, for\n"
+                                     "parsec-live to read. Empty to disable.",
+                                     false, false, "", &parsec_live_name);
+    if( NULL == parsec_live_name || '\0' == parsec_live_name[0] ) {
+        free(parsec_live_name);
+        return PARSEC_SUCCESS;
+    }
+
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+    parsec_live_header_t *h;
+    parsec_live_stream_t *s;
+    uint32_t nb_streams = 1;  /* the communication thread */
+    int fd, vp, th, idx;
+
+    for( vp = 0; vp < context->nb_vp; vp++ )
+        nb_streams += context->virtual_processes[vp]->nb_cores;
+
+    parsec_live_size = sizeof(parsec_live_header_t)
+        + nb_streams * sizeof(parsec_live_stream_t)
+        + context->nb_nodes * sizeof(parsec_live_peer_t);
+
+    snprintf(parsec_live_shm_name, sizeof(parsec_live_shm_name), "/%s.%d",
+             parsec_live_name, context->my_rank);
+    free(parsec_live_name);
+    fd = shm_open(parsec_live_shm_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if( -1 == fd ) {
+        parsec_warning("Live metrics: cannot create the shared memory region %s (%s). Live metrics disabled.",
+                       parsec_live_shm_name, strerror(errno));
+        return PARSEC_ERROR;
+    }
+    if( 0 != ftruncate(fd, parsec_live_size) ) {
+        parsec_warning("Live metrics: cannot size the shared memory region %s (%s). Live metrics disabled.",
+                       parsec_live_shm_name, strerror(errno));
+        close(fd);
+        shm_unlink(parsec_live_shm_name);
+        return PARSEC_ERROR;
+    }
+    h = (parsec_live_header_t*)mmap(NULL, parsec_live_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if( MAP_FAILED == h ) {
+        parsec_warning("Live metrics: cannot map the shared memory region %s (%s). Live metrics disabled.",
+                       parsec_live_shm_name, strerror(errno));
+        shm_unlink(parsec_live_shm_name);
+        return PARSEC_ERROR;
+    }
+    parsec_live_streams = (parsec_live_es_t*)calloc(nb_streams, sizeof(parsec_live_es_t));
+
+    /* ftruncate zeroed the region, only the layout needs to be filled */
+    h->version        = PARSEC_LIVE_VERSION;
+    h->header_size    = sizeof(parsec_live_header_t);
+    h->stream_size    = sizeof(parsec_live_stream_t);
+    h->peer_size      = sizeof(parsec_live_peer_t);
+    h->rank           = context->my_rank;
+    h->nb_ranks       = context->nb_nodes;
+    h->pid            = (int32_t)getpid();
+    h->nb_streams     = nb_streams;
+    h->nb_peers       = context->nb_nodes;
+    h->streams_offset = sizeof(parsec_live_header_t);
+    h->peers_offset   = h->streams_offset + nb_streams * sizeof(parsec_live_stream_t);
+
+    s = (parsec_live_stream_t*)((char*)h + h->streams_offset);
+    for( idx = 0, vp = 0; vp < context->nb_vp; vp++ ) {
+        for( th = 0; th < context->virtual_processes[vp]->nb_cores; th++, idx++ ) {
+            s[idx].vp_id = vp;
+            s[idx].th_id = th;
+            parsec_live_streams[idx].shm = &s[idx];
+        }
+    }
+    s[idx].vp_id = -1;
+    s[idx].th_id = 0;
+    parsec_live_streams[idx].shm = &s[idx];
+
+    parsec_live_peers = (parsec_live_peer_t*)((char*)h + h->peers_offset);
+    /* The magic last: a reader does not look at a region without it */
+    memcpy(h->magic, PARSEC_LIVE_MAGIC, sizeof(h->magic));
+    parsec_atomic_wmb();
+    h->state = PARSEC_LIVE_STATE_RUNNING;
+    parsec_live = h;
+
+    parsec_debug_verbose(4, parsec_debug_output, "Live metrics exported in the shared memory region %s (%zu bytes)",
+                         parsec_live_shm_name, parsec_live_size);
+    return PARSEC_SUCCESS;
+#else
+    (void)context;
+    free(parsec_live_name);
+    parsec_warning("Live metrics: shared memory is not available on this platform. Live metrics disabled.");
+    return PARSEC_ERROR;
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+}
+
+void parsec_live_stream_init(parsec_execution_stream_t *es, int vp_id, int th_id)
+{
+    parsec_context_t *context = es->virtual_process->parsec_context;
+    int vp, idx = 0;
+
+    es->live_metrics = NULL;
+    if( NULL == parsec_live )
+        return;
+    if( vp_id < 0 ) {
+        idx = parsec_live->nb_streams - 1;
+    } else {
+        for( vp = 0; vp < vp_id; vp++ )
+            idx += context->virtual_processes[vp]->nb_cores;
+        idx += th_id;
+    }
+    parsec_live_streams[idx].es = es;
+    es->live_metrics = &parsec_live_streams[idx];
+}
+
+void parsec_live_fini(void)
+{
+#if defined(PARSEC_HAVE_SYS_MMAN_H)
+    parsec_live_header_t *h = parsec_live;
+
+    if( NULL == h )
+        return;
+    parsec_live = NULL;
+    parsec_live_peers = NULL;
+    /* The streams are torn down later, they must not update their records anymore */
+    for( uint32_t idx = 0; idx < h->nb_streams; idx++ ) {
+        if( NULL != parsec_live_streams[idx].es )
+            parsec_live_streams[idx].es->live_metrics = NULL;
+    }
+    parsec_atomic_wmb();
+    h->state = PARSEC_LIVE_STATE_FINISHED;
+    /* A reader keeps its mapping of the region until it unmaps it */
+    munmap(h, parsec_live_size);
+    shm_unlink(parsec_live_shm_name);
+    free(parsec_live_streams);
+    parsec_live_streams = NULL;
+#endif  /* defined(PARSEC_HAVE_SYS_MMAN_H) */
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#ifndef PARSEC_LIVE_METRICS_H_HAS_BEEN_INCLUDED
+#define PARSEC_LIVE_METRICS_H_HAS_BEEN_INCLUDED
+
+#include "parsec/parsec_config.h"
+#include <stdint.h>
+
+/**
+ * @defgroup parsec_internal_live_metrics Live metrics
+ * @ingroup parsec_internal_runtime
+ * @{
+ *
+ * @brief Counters of a running process, exported in shared memory for a
+ *   local reader (parsec-live) to poll, without tracing.
+ *
+ * @details
+ *   When the MCA parameter runtime_live_metrics is set to a name, each rank
+ *   creates the POSIX shared memory region /<name>.<rank>, laid out as:
+ *
+ *     parsec_live_header_t
+ *     nb_streams x parsec_live_stream_t  (at streams_offset)
+ *     nb_peers   x parsec_live_peer_t    (at peers_offset)
+ *
+ *   The computation streams come first, in (vp, thread) order, and the
+ *   communication thread last. The region is filled before state becomes
+ *   PARSEC_LIVE_STATE_RUNNING, and it does not change shape afterwards.
+ *
+ *   There is no lock: each counter is 64 bits, naturally aligned, and
+ *   written either by a single thread or with atomic additions, so a
+ *   reader never sees a torn value. Counters only grow, except the arena
+ *   bytes and the idle flag. The version changes when the meaning of a field
+ *   changes; new fields are appended to the records, whose sizes are in
+ *   the header, so readers must use the sizes and offsets of the header
+ *   rather than their own sizeof.
+ */
+
+#define PARSEC_LIVE_MAGIC          "PARSEC LIVE"
+#define PARSEC_LIVE_VERSION        1
+
+#define PARSEC_LIVE_STATE_INIT     0
+#define PARSEC_LIVE_STATE_RUNNING  1
+#define PARSEC_LIVE_STATE_FINISHED 2
+
+typedef struct parsec_live_header_s {
+    char              magic[12];          /**< PARSEC_LIVE_MAGIC */
+    uint32_t          version;            /**< PARSEC_LIVE_VERSION */
+    uint32_t          header_size;
+    uint32_t          stream_size;        /**< size of a stream record */
+    uint32_t          peer_size;          /**< size of a peer record */
+    volatile uint32_t state;              /**< PARSEC_LIVE_STATE_* */
+    int32_t           rank;
+    int32_t           nb_ranks;
+    int32_t           pid;
+    uint32_t          nb_streams;
+    uint32_t          nb_peers;
+    uint32_t          reserved;
+    uint64_t          streams_offset;
+    uint64_t          peers_offset;
+    volatile int64_t  arena_used_bytes;   /**< arena memory handed out to data copies */
+    volatile int64_t  arena_held_bytes;   /**< arena memory allocated, used or cached in the free lists */
+} parsec_live_header_t;
+
+/** One cache line per stream, to keep the writers apart */
+typedef struct parsec_live_stream_s {
+    int32_t           vp_id;              /**< -1 for the communication thread */
+    int32_t           th_id;
+    volatile uint64_t tasks_retired;      /**< tasks completed by the stream */
+    volatile uint64_t tasks_selected;     /**< tasks obtained from the scheduler */
+    volatile uint64_t tasks_stolen;       /**< selected tasks found at a non-zero distance (not in the stream's own queue) */
+    volatile uint64_t tasks_scheduled;    /**< tasks given to the scheduler through this stream (atomic) */
+    volatile uint64_t idle_ns;            /**< time spent looking for a task without finding any (timer unit, nanoseconds with clock_gettime or the TSC) */
+    volatile uint64_t idle;               /**< 1 while the stream is looking for a task without finding any */
+    uint64_t          reserved;
+} parsec_live_stream_t;
+
+/** Activations and data exchanged with each rank, updated by the communication thread */
+typedef struct parsec_live_peer_s {
+    volatile uint64_t msgs_sent;          /**< activation messages */
+    volatile uint64_t msgs_recv;
+    volatile uint64_t bytes_sent;         /**< activation messages and data transfers */
+    volatile uint64_t bytes_recv;
+} parsec_live_peer_t;
+
+#if defined(BUILDING_PARSEC)
+
+#include "parsec/runtime.h"
+#include "parsec/os-spec-timing.h"
+#include "parsec/sys/atomic.h"
+
+BEGIN_C_DECLS
+
+/** The process side of a stream record */
+typedef struct parsec_live_es_s {
+    parsec_execution_stream_t *es;        /**< the stream attached to the record */
+    parsec_live_stream_t *shm;
+    parsec_time_t         idle_since;
+    int32_t               idle;
+} parsec_live_es_t;
+
+/** The mapped region, NULL when live metrics are disabled */
+extern parsec_live_header_t *parsec_live;
+extern parsec_live_peer_t   *parsec_live_peers;
+
+/** Create the region, once the number of ranks is known and before the threads start */
+int  parsec_live_init(parsec_context_t *context);
+/** Mark the region finished, remove its name and detach the streams from their records */
+void parsec_live_fini(void);
+/** Attach an execution stream to its record (vp_id < 0 for the communication thread) */
+void parsec_live_stream_init(parsec_execution_stream_t *es, int vp_id, int th_id);
+
+static inline void parsec_live_select(parsec_live_es_t *l, parsec_task_t *task, int32_t distance)
+{
+    if( NULL == task ) {
+        if( !l->idle ) {
+            l->idle = 1;
+            l->idle_since = take_time();
+            l->shm->idle = 1;
+        }
+        return;
+    }
+    if( l->idle ) {
+        l->idle = 0;
+        l->shm->idle_ns += diff_time(l->idle_since, take_time());
+        l->shm->idle = 0;
+    }
+    l->shm->tasks_selected++;
+    if( 0 != distance )
+        l->shm->tasks_stolen++;
+}
+
+static inline void parsec_live_scheduled(parsec_live_es_t *l, int nb)
+{
+    parsec_atomic_fetch_add_int64((volatile int64_t*)&l->shm->tasks_scheduled, nb);
+}
+
+static inline void parsec_live_arena(int64_t used, int64_t held)
+{
+    parsec_live_header_t *h = parsec_live;
+    if( PARSEC_LIKELY(NULL == h) ) return;
+    if( 0 != used ) parsec_atomic_fetch_add_int64(&h->arena_used_bytes, used);
+    if( 0 != held ) parsec_atomic_fetch_add_int64(&h->arena_held_bytes, held);
+}
+
+static inline void parsec_live_peer(int peer, uint64_t msgs_sent, uint64_t msgs_recv,
+                                    uint64_t bytes_sent, uint64_t bytes_recv)
+{
+    parsec_live_peer_t *p = parsec_live_peers;
+    if( PARSEC_LIKELY(NULL == p) ) return;
+    p += peer;
+    p->msgs_sent  += msgs_sent;
+    p->msgs_recv  += msgs_recv;
+    p->bytes_sent += bytes_sent;
+    p->bytes_recv += bytes_recv;
+}
+
+END_C_DECLS
+
+#endif  /* defined(BUILDING_PARSEC) */
+
+/** @} */
+
+#endif  /* PARSEC_LIVE_METRICS_H_HAS_BEEN_INCLUDED */
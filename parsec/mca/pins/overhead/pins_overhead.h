@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#ifndef PINS_OVERHEAD_H
+#define PINS_OVERHEAD_H
+
+#include "parsec/parsec_config.h"
+#include "parsec/runtime.h"
+#include "parsec/mca/mca.h"
+#include "parsec/mca/pins/pins.h"
+
+BEGIN_C_DECLS
+
+/**
+ * This module accounts for the time each execution stream spends in the
+ * phases of the runtime around the tasks (SELECT, PREPARE_INPUT, EXEC,
+ * COMPLETE_EXEC, RELEASE_DEPS, ACTIVATE_CB and DATA_FLUSH). Each phase
+ * feeds a log2 histogram per stream and per task class, merged and
+ * reported by rank when PaRSEC is finalized. When PAPI-SDE is enabled the
+ * total time and count of each phase are also exposed as live counters
+ * named PINS::OVERHEAD::PHASE=<phase>::{TIME,COUNT}.
+ */
+
+/**
+ * Globally exported variable
+ */
+PARSEC_DECLSPEC extern const parsec_pins_base_component_t parsec_pins_overhead_component;
+PARSEC_DECLSPEC extern const parsec_pins_module_t parsec_pins_overhead_module;
+/* static accessor */
+mca_base_component_t * pins_overhead_static_component(void);
+
+END_C_DECLS
+
+#endif  /* PINS_OVERHEAD_H */
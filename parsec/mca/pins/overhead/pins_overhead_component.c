@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/runtime.h"
+#include "parsec/papi_sde.h"
+#include "parsec/include/parsec/os-spec-timing.h"
+
+#include "parsec/mca/pins/pins.h"
+#include "parsec/mca/pins/overhead/pins_overhead.h"
+
+/*
+ * Local function
+ */
+static int pins_overhead_component_query(mca_base_module_t **module, int *priority);
+static int pins_overhead_component_register(void);
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+const parsec_pins_base_component_t parsec_pins_overhead_component = {
+
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+
+    {
+        PARSEC_PINS_BASE_VERSION_2_0_0,
+
+        /* Component name and version */
+        "overhead",
+        "", /* options */
+        PARSEC_VERSION_MAJOR,
+        PARSEC_VERSION_MINOR,
+
+        /* Component open and close functions */
+        NULL,
+        NULL,
+        pins_overhead_component_query,
+        /*< specific query to return the module and add it to the list of available modules */
+        pins_overhead_component_register,
+        "", /*< no reserve */
+    },
+    {
+        /* The component has no metadata */
+        MCA_BASE_METADATA_PARAM_NONE,
+        "", /*< no reserve */
+    }
+};
+mca_base_component_t * pins_overhead_static_component(void)
+{
+    return (mca_base_component_t *)&parsec_pins_overhead_component;
+}
+
+static int pins_overhead_component_query(mca_base_module_t **module, int *priority)
+{
+    /* module type should be: const mca_base_module_t ** */
+    void *ptr = (void*)&parsec_pins_overhead_module;
+    *priority = 5;
+    *module = (mca_base_module_t *)ptr;
+    return MCA_SUCCESS;
+}
+
+static int pins_overhead_component_register(void)
+{
+    PARSEC_PAPI_SDE_DESCRIBE_COUNTER("PINS::OVERHEAD::PHASE=<PHASE>::TIME",
+                              "the time (in " TIMER_UNIT ") spent by all execution streams in the runtime phase <PHASE>");
+    PARSEC_PAPI_SDE_DESCRIBE_COUNTER("PINS::OVERHEAD::PHASE=<PHASE>::COUNT",
+                              "the number of times all execution streams went through the runtime phase <PHASE>");
+    PARSEC_PAPI_SDE_DESCRIBE_COUNTER("PINS::OVERHEAD::PHASE=<PHASE>::TIME::THREAD=<VPID>/<THID>",
+                              "the time (in " TIMER_UNIT ") spent by the execution stream <THID> of the virtual process <VPID> in the runtime phase <PHASE>");
+    PARSEC_PAPI_SDE_DESCRIBE_COUNTER("PINS::OVERHEAD::PHASE=<PHASE>::COUNT::THREAD=<VPID>/<THID>",
+                              "the number of times the execution stream <THID> of the virtual process <VPID> went through the runtime phase <PHASE>");
+    return MCA_SUCCESS;
+}
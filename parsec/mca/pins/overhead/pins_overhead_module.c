@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "pins_overhead.h"
+#include "parsec/mca/pins/pins.h"
+#include "parsec/utils/debug.h"
+#include "parsec/utils/mca_param.h"
+#include "parsec/parsec_internal.h"
+#include "parsec/execution_stream.h"
+#include "parsec/papi_sde.h"
+#include "parsec/sys/atomic.h"
+#include "parsec/include/parsec/os-spec-timing.h"
+
+/**
+ * The phases of the runtime accounted for by this module. Each phase is
+ * delimited by a BEGIN and an END PINS event. COMPLETE_EXEC encloses
+ * RELEASE_DEPS, the other phases do not overlap on a stream. SELECT covers
+ * the time to find the next task, including the idle polling of the
+ * scheduler; it is accounted to the task class of the selected task.
+ */
+typedef enum {
+    OVERHEAD_SELECT = 0,
+    OVERHEAD_PREPARE_INPUT,
+    OVERHEAD_EXEC,
+    OVERHEAD_COMPLETE_EXEC,
+    OVERHEAD_RELEASE_DEPS,
+    OVERHEAD_ACTIVATE_CB,
+    OVERHEAD_DATA_FLUSH,
+    OVERHEAD_NB_PHASES
+} overhead_phase_t;
+
+static const char *overhead_phase_name[OVERHEAD_NB_PHASES] = {
+    "SELECT", "PREPARE_INPUT", "EXEC", "COMPLETE_EXEC",
+    "RELEASE_DEPS", "ACTIVATE_CB", "DATA_FLUSH"
+};
+
+static const PARSEC_PINS_FLAG overhead_phase_begin[OVERHEAD_NB_PHASES] = {
+    SELECT_BEGIN, PREPARE_INPUT_BEGIN, EXEC_BEGIN, COMPLETE_EXEC_BEGIN,
+    RELEASE_DEPS_BEGIN, ACTIVATE_CB_BEGIN, DATA_FLUSH_BEGIN
+};
+
+/* Bucket b counts the durations d such that 2^b <= d < 2^(b+1) (and d == 0 in bucket 0) */
+#define OVERHEAD_NB_BUCKETS 64
+
+typedef struct overhead_histogram_s {
+    uint64_t count;
+    uint64_t total;
+    uint64_t buckets[OVERHEAD_NB_BUCKETS];
+} overhead_histogram_t;
+
+typedef struct overhead_class_s {
+    const parsec_task_class_t *tc;  /**< key on the stream, NULL once merged */
+    char                      *name;
+    overhead_histogram_t       phases[OVERHEAD_NB_PHASES];
+} overhead_class_t;
+
+struct overhead_stream_s;
+
+/**
+ * One link per registered callback: the PINS chain needs a distinct
+ * parsec_pins_next_callback_t for each (event, callback) pair.
+ */
+typedef struct overhead_link_s {
+    parsec_pins_next_callback_t  cb_data;
+    struct overhead_stream_s    *stream;
+    overhead_phase_t             phase;
+} overhead_link_t;
+
+typedef struct overhead_stream_s {
+    overhead_link_t     begin[OVERHEAD_NB_PHASES];
+    overhead_link_t     end[OVERHEAD_NB_PHASES];
+    parsec_time_t       start[OVERHEAD_NB_PHASES];
+    /* Totals over all classes, exported as PAPI-SDE counters */
+    long long int       time[OVERHEAD_NB_PHASES];
+    long long int       count[OVERHEAD_NB_PHASES];
+    /* The events without a task (ACTIVATE_CB, DATA_FLUSH, the last SELECT).
+     * ACTIVATE_CB is triggered by the communication thread on a copy of the
+     * first stream, so these are kept out of the class array that may be
+     * reallocated under its feet. */
+    overhead_class_t    runtime;
+    overhead_class_t   *last;
+    overhead_class_t  **classes;
+    int                 nb_classes;
+    int                 size_classes;
+} overhead_stream_t;
+
+static char *overhead_output = NULL;
+static parsec_atomic_lock_t overhead_lock = PARSEC_ATOMIC_UNLOCKED;
+static overhead_class_t **overhead_classes = NULL;
+static int overhead_nb_classes = 0;
+
+static void pins_init_overhead(parsec_context_t *master_context);
+static void pins_fini_overhead(parsec_context_t *master_context);
+static void pins_thread_init_overhead(parsec_execution_stream_t *es);
+static void pins_thread_fini_overhead(parsec_execution_stream_t *es);
+
+const parsec_pins_module_t parsec_pins_overhead_module = {
+    &parsec_pins_overhead_component,
+    {
+        pins_init_overhead,
+        pins_fini_overhead,
+        NULL,
+        NULL,
+        pins_thread_init_overhead,
+        pins_thread_fini_overhead
+    },
+    { NULL }
+};
+
+static void overhead_begin(parsec_execution_stream_t *es,
+                           parsec_task_t *task,
+                           parsec_pins_next_callback_t *data)
+{
+    overhead_link_t *link = (overhead_link_t*)data;
+    link->stream->start[link->phase] = take_time();
+    (void)es; (void)task;
+}
+
+static overhead_class_t *overhead_class_new(const char *name)
+{
+    overhead_class_t *c = (overhead_class_t*)calloc(1, sizeof(overhead_class_t));
+    c->name = strdup(name);
+    return c;
+}
+
+static overhead_class_t *overhead_stream_class(overhead_stream_t *s,
+                                               const parsec_task_class_t *tc)
+{
+    int i;
+    for( i = 0; i < s->nb_classes; i++ ) {
+        if( s->classes[i]->tc == tc ) return s->classes[i];
+    }
+    if( s->nb_classes == s->size_classes ) {
+        s->size_classes = (0 == s->size_classes) ? 8 : 2 * s->size_classes;
+        s->classes = (overhead_class_t**)realloc(s->classes, s->size_classes * sizeof(overhead_class_t*));
+    }
+    s->classes[s->nb_classes] = overhead_class_new(tc->name);
+    s->classes[s->nb_classes]->tc = tc;
+    return s->classes[s->nb_classes++];
+}
+
+static inline void overhead_histogram_add(overhead_histogram_t *h, uint64_t d)
+{
+    h->count++;
+    h->total += d;
+    h->buckets[0 == d ? 0 : 63 - __builtin_clzll(d)]++;
+}
+
+static void overhead_end(parsec_execution_stream_t *es,
+                         parsec_task_t *task,
+                         parsec_pins_next_callback_t *data)
+{
+    overhead_link_t *link = (overhead_link_t*)data;
+    overhead_stream_t *s = link->stream;
+    overhead_class_t *c;
+    uint64_t d = diff_time(s->start[link->phase], take_time());
+
+    if( NULL == task ) {
+        c = &s->runtime;
+    } else if( NULL != s->last && s->last->tc == task->task_class ) {
+        c = s->last;
+    } else {
+        c = s->last = overhead_stream_class(s, task->task_class);
+    }
+    overhead_histogram_add(&c->phases[link->phase], d);
+    s->time[link->phase] += (long long int)d;
+    s->count[link->phase]++;
+    (void)es;
+}
+
+static void pins_init_overhead(parsec_context_t *master_context)
+{
+    (void)master_context;
+    parsec_mca_param_reg_string_name("pins", "overhead_output",
+                                     "Where to write the runtime overhead histograms at the end of the run: "
+                                     "empty for the standard output, otherwise a file name to which the rank is appended.\n",
+                                     false, false,
+                                     "", &overhead_output);
+}
+
+static void pins_thread_init_overhead(parsec_execution_stream_t *es)
+{
+    overhead_stream_t *s = (overhead_stream_t*)calloc(1, sizeof(overhead_stream_t));
+    int p;
+
+    s->runtime.name = "<runtime>";
+    for( p = 0; p < OVERHEAD_NB_PHASES; p++ ) {
+        s->begin[p].stream = s->end[p].stream = s;
+        s->begin[p].phase  = s->end[p].phase  = (overhead_phase_t)p;
+        s->start[p] = take_time();
+        PARSEC_PINS_REGISTER(es, overhead_phase_begin[p], overhead_begin,
+                             (parsec_pins_next_callback_t*)&s->begin[p]);
+        PARSEC_PINS_REGISTER(es, overhead_phase_begin[p] + 1, overhead_end,
+                             (parsec_pins_next_callback_t*)&s->end[p]);
+    }
+#if defined(PARSEC_PAPI_SDE)
+    {
+        char event_name[PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN];
+        char group_name[PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN];
+        for( p = 0; p < OVERHEAD_NB_PHASES; p++ ) {
+            snprintf(event_name, PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN, "PINS::OVERHEAD::PHASE=%s::TIME::THREAD=%d/%d",
+                     overhead_phase_name[p], es->virtual_process->vp_id, es->th_id);
+            snprintf(group_name, PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN, "PINS::OVERHEAD::PHASE=%s::TIME",
+                     overhead_phase_name[p]);
+            parsec_papi_sde_register_counter(event_name, PAPI_SDE_RO|PAPI_SDE_DELTA,
+                                             PAPI_SDE_long_long, &s->time[p]);
+            parsec_papi_sde_add_counter_to_group(event_name, group_name, PAPI_SDE_SUM);
+            snprintf(event_name, PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN, "PINS::OVERHEAD::PHASE=%s::COUNT::THREAD=%d/%d",
+                     overhead_phase_name[p], es->virtual_process->vp_id, es->th_id);
+            snprintf(group_name, PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN, "PINS::OVERHEAD::PHASE=%s::COUNT",
+                     overhead_phase_name[p]);
+            parsec_papi_sde_register_counter(event_name, PAPI_SDE_RO|PAPI_SDE_DELTA,
+                                             PAPI_SDE_long_long, &s->count[p]);
+            parsec_papi_sde_add_counter_to_group(event_name, group_name, PAPI_SDE_SUM);
+        }
+    }
+#endif  /* defined(PARSEC_PAPI_SDE) */
+}
+
+static void overhead_merge(overhead_class_t *c)
+{
+    overhead_class_t *into = NULL;
+    int i, p, b;
+
+    for( i = 0; i < overhead_nb_classes; i++ ) {
+        if( 0 == strcmp(overhead_classes[i]->name, c->name) ) {
+            into = overhead_classes[i];
+            break;
+        }
+    }
+    if( NULL == into ) {
+        overhead_classes = (overhead_class_t**)realloc(overhead_classes, (overhead_nb_classes + 1) * sizeof(overhead_class_t*));
+        into = overhead_classes[overhead_nb_classes++] = overhead_class_new(c->name);
+    }
+    for( p = 0; p < OVERHEAD_NB_PHASES; p++ ) {
+        into->phases[p].count += c->phases[p].count;
+        into->phases[p].total += c->phases[p].total;
+        for( b = 0; b < OVERHEAD_NB_BUCKETS; b++ )
+            into->phases[p].buckets[b] += c->phases[p].buckets[b];
+    }
+}
+
+static void pins_thread_fini_overhead(parsec_execution_stream_t *es)
+{
+    overhead_stream_t *s = NULL;
+    parsec_pins_next_callback_t *cb;
+    int p, i;
+
+    for( p = 0; p < OVERHEAD_NB_PHASES; p++ ) {
+        PARSEC_PINS_UNREGISTER(es, overhead_phase_begin[p], overhead_begin, &cb);
+        s = ((overhead_link_t*)cb)->stream;
+        PARSEC_PINS_UNREGISTER(es, overhead_phase_begin[p] + 1, overhead_end, &cb);
+#if defined(PARSEC_PAPI_SDE)
+        PARSEC_PAPI_SDE_UNREGISTER_COUNTER("PINS::OVERHEAD::PHASE=%s::TIME::THREAD=%d/%d",
+                                           overhead_phase_name[p], es->virtual_process->vp_id, es->th_id);
+        PARSEC_PAPI_SDE_UNREGISTER_COUNTER("PINS::OVERHEAD::PHASE=%s::COUNT::THREAD=%d/%d",
+                                           overhead_phase_name[p], es->virtual_process->vp_id, es->th_id);
+#endif  /* defined(PARSEC_PAPI_SDE) */
+    }
+    if( NULL == s ) return;
+
+    parsec_atomic_lock(&overhead_lock);
+    overhead_merge(&s->runtime);
+    for( i = 0; i < s->nb_classes; i++ ) {
+        overhead_merge(s->classes[i]);
+        free(s->classes[i]->name);
+        free(s->classes[i]);
+    }
+    parsec_atomic_unlock(&overhead_lock);
+    free(s->classes);
+    free(s);
+}
+
+/* Upper bound of the bucket holding the q-quantile of the histogram */
+static uint64_t overhead_quantile(const overhead_histogram_t *h, double q)
+{
+    uint64_t rank = (uint64_t)(q * (double)h->count), seen = 0;
+    int b;
+    for( b = 0; b < OVERHEAD_NB_BUCKETS - 1; b++ ) {
+        seen += h->buckets[b];
+        if( seen > rank ) break;
+    }
+    return (b == OVERHEAD_NB_BUCKETS - 1) ? UINT64_MAX : (2ULL << b);
+}
+
+static void pins_fini_overhead(parsec_context_t *master_context)
+{
+    FILE *f = stdout;
+    int i, p;
+
+    if( NULL != overhead_output && '\0' != overhead_output[0] ) {
+        char *filename;
+        if( -1 == asprintf(&filename, "%s-%d.txt", overhead_output, master_context->my_rank) ) {
+            filename = NULL;
+        }
+        if( NULL == filename || NULL == (f = fopen(filename, "w")) ) {
+            parsec_warning("PINS overhead: unable to open %s (%s), writing to the standard output",
+                           NULL == filename ? overhead_output : filename, strerror(errno));
+            f = stdout;
+        }
+        free(filename);
+    }
+
+    fprintf(f, "# PINS runtime overhead on rank %d (durations in %s, quantiles are bucket upper bounds)\n",
+            master_context->my_rank, TIMER_UNIT);
+    fprintf(f, "# %-30s %-14s %12s %16s %12s %12s %12s %12s\n",
+            "class", "phase", "count", "total", "mean", "p50<", "p90<", "p99<");
+    for( i = 0; i < overhead_nb_classes; i++ ) {
+        overhead_class_t *c = overhead_classes[i];
+        uint64_t exec_count = c->phases[OVERHEAD_EXEC].count, runtime = 0;
+        for( p = 0; p < OVERHEAD_NB_PHASES; p++ ) {
+            const overhead_histogram_t *h = &c->phases[p];
+            if( 0 == h->count ) continue;
+            fprintf(f, "  %-30s %-14s %12" PRIu64 " %16" PRIu64 " %12.0f %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+                    c->name, overhead_phase_name[p], h->count, h->total,
+                    (double)h->total / (double)h->count,
+                    overhead_quantile(h, 0.5), overhead_quantile(h, 0.9), overhead_quantile(h, 0.99));
+        }
+        /* RELEASE_DEPS is already part of COMPLETE_EXEC */
+        runtime = c->phases[OVERHEAD_SELECT].total + c->phases[OVERHEAD_PREPARE_INPUT].total +
+            c->phases[OVERHEAD_COMPLETE_EXEC].total;
+        if( 0 != exec_count ) {
+            fprintf(f, "  %-30s %-14s %12" PRIu64 " %16" PRIu64 " %12.0f (%.2f%% of EXEC)\n",
+                    c->name, "RUNTIME/TASK", exec_count, runtime, (double)runtime / (double)exec_count,
+                    0 == c->phases[OVERHEAD_EXEC].total ? 0.0 :
+                    100.0 * (double)runtime / (double)c->phases[OVERHEAD_EXEC].total);
+        }
+        free(c->name);
+        free(c);
+    }
+    fflush(f);
+    if( stdout != f ) fclose(f);
+    free(overhead_classes);
+    overhead_classes = NULL;
+    overhead_nb_classes = 0;
+}
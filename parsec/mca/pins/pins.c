@@ -65,6 +65,7 @@ int parsec_pins_register_callback(struct parsec_execution_stream_s* es,
 
     cb_event->cb_func = cb_func;
     cb_event->cb_data = cb_data;
+    es->pins_events_mask |= (1U << method_flag);
 
     return PARSEC_SUCCESS;
 }
@@ -95,5 +96,7 @@ int parsec_pins_unregister_callback(struct parsec_execution_stream_s* es,
     assert(cb_event->cb_func == cb);
     *cb_data = cb_event->cb_data;
     *cb_event = **cb_data;
+    if( NULL == es->pins_events_cb[method_flag].cb_func )
+        es->pins_events_mask &= ~(1U << method_flag);
     return PARSEC_SUCCESS;
 }
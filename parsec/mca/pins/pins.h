@@ -48,7 +48,8 @@ typedef enum PARSEC_PINS_FLAG {
      PARSEC_PROLOGUE,
      PARSEC_RELEASE,
      */
-    /* PARSEC_PINS_FLAG_COUNT is not an event at all */
+    /* PARSEC_PINS_FLAG_COUNT is not an event at all, and it must not exceed
+     * 32 for the events to fit in the pins_events_mask of the streams */
     PARSEC_PINS_FLAG_COUNT
 } PARSEC_PINS_FLAG;
 
@@ -151,8 +152,17 @@ int parsec_pins_unregister_callback(struct parsec_execution_stream_s* es,
 
 #ifdef PARSEC_PROF_PINS
 
-#define PARSEC_PINS(unit, method_flag, task)         \
-    parsec_pins_instrument(unit, method_flag, task)
+/**
+ * The events without any registered callback on the stream cost a load and
+ * a test of the stream mask, so that the PINS hooks of the runtime are
+ * (almost) free when no module is listening.
+ */
+#define PARSEC_PINS(unit, method_flag, task)                            \
+    do {                                                                \
+        struct parsec_execution_stream_s *__pins_es = (unit);           \
+        if( PARSEC_UNLIKELY(__pins_es->pins_events_mask & (1U << (method_flag))) ) \
+            parsec_pins_instrument(__pins_es, (method_flag), (task));   \
+    } while (0)
 #define PARSEC_PINS_DISABLE_REGISTRATION(boolean)      \
     parsec_pins_disable_registration(boolean)
 #define PARSEC_PINS_REGISTER(unit, method_flag, cb, data)       \
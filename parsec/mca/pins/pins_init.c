@@ -150,6 +150,7 @@ void parsec_pins_thread_init(parsec_execution_stream_t* es)
         es->pins_events_cb[i].cb_func = NULL;
         es->pins_events_cb[i].cb_data = NULL;
     }
+    es->pins_events_mask = 0;
     if (NULL != modules_activated) {
         for(i = 0; i < num_modules_activated; i++) {
             if ( NULL != modules_activated[i]->module.thread_init)
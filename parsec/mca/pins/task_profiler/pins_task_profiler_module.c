@@ -20,6 +20,11 @@ int activate_cb_trace_keyout;
 int data_flush_trace_keyin;
 int data_flush_trace_keyout;
 
+/* Bits of prof_sampled: each pair of begin and end events is sampled on its
+ * own, the begin callback deciding for the end one. */
+#define TASK_PROFILER_SAMPLED_EXEC    0x1
+#define TASK_PROFILER_SAMPLED_RELEASE 0x2
+
 /* init functions */
 static void pins_init_task_profiler(parsec_context_t *master_context);
 static void pins_fini_task_profiler(parsec_context_t *master_context);
@@ -145,16 +150,36 @@ static void pins_thread_fini_task_profiler(struct parsec_execution_stream_s * es
  PINS CALLBACKS
  */
 
+/* The start key of the class of the task, or -1 when it is not traced */
+static inline int task_profiler_class_key(const struct parsec_task_s *task)
+{
+    if( (NULL == task->taskpool->profiling_array) ||
+        (task->task_class->task_class_id >= task->taskpool->nb_task_classes) )
+        return -1;
+    return task->taskpool->profiling_array[2*task->task_class->task_class_id];
+}
+
 static void
 task_profiler_release_deps_begin(struct parsec_execution_stream_s*   es,
                                  struct parsec_task_s*               task,
                                  struct parsec_pins_next_callback_s* cb_data)
 {
     int32_t tcid = task->task_class->task_class_id;
-
+    uint64_t event_id;
+
+    event_id = task->task_class->key_functions->key_hash(
+                   task->task_class->make_key(task->taskpool, task->locals), NULL);
+    /* The tasks released without being executed (remote or flushed DTD
+     * tasks) never reach EXEC_BEGIN, so this pair is decided here. */
+    if( PARSEC_PROFILING_SAMPLED(task_profiler_class_key(task), event_id, task->taskpool->taskpool_id) ) {
+        task->prof_sampled |= TASK_PROFILER_SAMPLED_RELEASE;
+    } else {
+        task->prof_sampled &= ~TASK_PROFILER_SAMPLED_RELEASE;
+        return;
+    }
     PARSEC_PROFILING_TRACE(es->es_profile,
                            release_deps_trace_keyin,
-                           task->task_class->key_functions->key_hash(task->task_class->make_key(task->taskpool, task->locals), NULL),
+                           event_id,
                            task->taskpool->taskpool_id,
                            (void *)&tcid);
 
@@ -168,6 +193,7 @@ task_profiler_release_deps_end(struct parsec_execution_stream_s*   es,
 {
     int32_t tcid = task->task_class->task_class_id;
 
+    if( !(task->prof_sampled & TASK_PROFILER_SAMPLED_RELEASE) ) return;
     PARSEC_PROFILING_TRACE(es->es_profile,
                            release_deps_trace_keyout,
                            task->task_class->key_functions->key_hash(task->task_class->make_key(task->taskpool, task->locals), NULL),
@@ -235,13 +261,21 @@ task_profiler_exec_count_begin(struct parsec_execution_stream_s*   es,
                                struct parsec_task_s*               task,
                                struct parsec_pins_next_callback_s* cb_data)
 {
-    if (NULL != task->taskpool->profiling_array &&
-        task->task_class->task_class_id < task->taskpool->nb_task_classes)
-        PARSEC_PROFILING_TRACE(es->es_profile,
-                               task->taskpool->profiling_array[2*task->task_class->task_class_id],
-                               task->task_class->key_functions->key_hash(
-                                       task->task_class->make_key( task->taskpool, task->locals ), NULL),
-                               task->taskpool->taskpool_id, NULL);
+    int key = task_profiler_class_key(task);
+    uint64_t event_id;
+
+    /* Without a key the execution is not traced, the key of the task is not
+     * needed */
+    task->prof_sampled &= ~TASK_PROFILER_SAMPLED_EXEC;
+    if( -1 != key ) {
+        event_id = task->task_class->key_functions->key_hash(
+                       task->task_class->make_key( task->taskpool, task->locals ), NULL);
+        if( PARSEC_PROFILING_SAMPLED(key, event_id, task->taskpool->taskpool_id) ) {
+            task->prof_sampled |= TASK_PROFILER_SAMPLED_EXEC;
+            PARSEC_PROFILING_TRACE(es->es_profile, key, event_id,
+                                   task->taskpool->taskpool_id, NULL);
+        }
+    }
     (void)cb_data;
 }
 
@@ -250,8 +284,7 @@ task_profiler_exec_count_end(struct parsec_execution_stream_s*   es,
                              struct parsec_task_s*               task,
                              struct parsec_pins_next_callback_s* cb_data)
 {
-    if (NULL != task->taskpool->profiling_array &&
-        task->task_class->task_class_id < task->taskpool->nb_task_classes)
+    if( task->prof_sampled & TASK_PROFILER_SAMPLED_EXEC )
         PARSEC_TASK_PROF_TRACE(es->es_profile,
                                task->taskpool->profiling_array[2*task->task_class->task_class_id+1],
                                task);
@@ -41,7 +41,8 @@ const parsec_sched_module_t parsec_sched_ap_module = {
         sched_ap_schedule,
         sched_ap_select,
         NULL,
-        sched_ap_remove
+        sched_ap_remove,
+        PARSEC_SCHED_FLAG_UNORDERED_RINGS
     }
 };
 
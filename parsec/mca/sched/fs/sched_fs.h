@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Fair Share Scheduler
+ *
+ * Weighted fair sharing of the execution streams between the taskpools:
+ * each virtual process keeps one queue of tasks per taskpool with ready
+ * tasks, sorted by priority, and a select serves the taskpools in stride
+ * order. A taskpool is served in proportion to its weight (see
+ * parsec_taskpool_set_scheduling_weight), so a small, latency sensitive
+ * taskpool is not starved by a large one, whatever the priorities of the
+ * tasks of the large one. Within a taskpool, the tasks are selected by
+ * priority.
+ */
+
+
+#ifndef MCA_SCHED_FS_H
+#define MCA_SCHED_FS_H
+
+#include "parsec/parsec_config.h"
+#include "parsec/mca/mca.h"
+#include "parsec/mca/sched/sched.h"
+
+
+BEGIN_C_DECLS
+
+/**
+ * Globally exported variable
+ */
+PARSEC_DECLSPEC extern const parsec_sched_base_component_t parsec_sched_fs_component;
+PARSEC_DECLSPEC extern const parsec_sched_module_t parsec_sched_fs_module;
+/* static accessor */
+mca_base_component_t *sched_fs_static_component(void);
+
+END_C_DECLS
+#endif /* MCA_SCHED_FS_H */
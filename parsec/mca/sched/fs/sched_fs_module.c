@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/parsec_internal.h"
+#include "parsec/utils/debug.h"
+#include "parsec/mca/sched/sched.h"
+#include "parsec/mca/sched/fs/sched_fs.h"
+#include "parsec/mca/pins/pins.h"
+#include "parsec/papi_sde.h"
+
+#include <stdlib.h>
+
+/**
+ * Module functions
+ */
+static int sched_fs_install(parsec_context_t* master);
+static int sched_fs_schedule(parsec_execution_stream_t* es,
+                             parsec_task_t* new_context,
+                             int32_t distance);
+static parsec_task_t*
+sched_fs_select(parsec_execution_stream_t *es,
+                int32_t* distance);
+static int flow_fs_init(parsec_execution_stream_t* es, struct parsec_barrier_t* barrier);
+static void sched_fs_remove(parsec_context_t* master);
+
+const parsec_sched_module_t parsec_sched_fs_module = {
+    &parsec_sched_fs_component,
+    {
+        sched_fs_install,
+        flow_fs_init,
+        sched_fs_schedule,
+        sched_fs_select,
+        NULL,
+        sched_fs_remove,
+        PARSEC_SCHED_FLAG_UNORDERED_RINGS
+    }
+};
+
+/* The pass of a taskpool advances by FS_STRIDE1 / weight at each of its
+ * selections, the taskpool with the lowest pass is served first. */
+#define FS_STRIDE1 (1U << 20)
+
+typedef struct fs_queue_s {
+    const parsec_taskpool_t *tp;
+    uint64_t                 pass;
+    uint32_t                 stride;
+    parsec_list_t            tasks;    /**< sorted by priority, only used under the lock of the vp */
+    struct fs_queue_s       *next_free;
+} fs_queue_t;
+
+typedef struct {
+    parsec_atomic_lock_t lock;
+    uint64_t             vtime;        /**< pass of the last taskpool served */
+    volatile int         nb_active;    /**< the taskpools with ready tasks */
+    int                  size_active;
+    fs_queue_t         **active;
+    fs_queue_t          *free_queues;
+    int32_t              nb_tasks;
+} fs_vp_t;
+
+#define LOCAL_SCHED_OBJECT(eu_context) ((fs_vp_t*)(eu_context)->scheduler_object)
+
+#if defined(PARSEC_PAPI_SDE)
+static long long int sched_fs_pending_tasks(void *arg)
+{
+    fs_vp_t *fs = (fs_vp_t*)arg;
+    return fs->nb_tasks;
+}
+#endif
+
+static int sched_fs_install( parsec_context_t *master )
+{
+    (void)master;
+    return PARSEC_SUCCESS;
+}
+
+static int flow_fs_init(parsec_execution_stream_t* es, struct parsec_barrier_t* barrier)
+{
+    parsec_vp_t *vp = es->virtual_process;
+    fs_vp_t *fs;
+
+    if (es == vp->execution_streams[0]) {
+        fs = (fs_vp_t*)calloc(1, sizeof(fs_vp_t));
+        parsec_atomic_lock_init(&fs->lock);
+        es->scheduler_object = fs;
+    }
+
+    parsec_barrier_wait(barrier);
+
+    if( es != vp->execution_streams[0] ) {
+        es->scheduler_object = LOCAL_SCHED_OBJECT(vp->execution_streams[0]);
+    }
+
+#if defined(PARSEC_PAPI_SDE)
+    if( 0 == es->th_id ) {
+        char event_name[PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN];
+        snprintf(event_name, PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN,
+                 "SCHEDULER::PENDING_TASKS::QUEUE=%d::SCHED=FS", es->virtual_process->vp_id);
+        parsec_papi_sde_register_fp_counter(event_name, PAPI_SDE_RO|PAPI_SDE_INSTANT, PAPI_SDE_int,
+                                            (papi_sde_fptr_t)sched_fs_pending_tasks, LOCAL_SCHED_OBJECT(es));
+        parsec_papi_sde_add_counter_to_group(event_name, "SCHEDULER::PENDING_TASKS", PAPI_SDE_SUM);
+        parsec_papi_sde_add_counter_to_group(event_name, "SCHEDULER::PENDING_TASKS::SCHED=FS", PAPI_SDE_SUM);
+    }
+#endif
+
+    return PARSEC_SUCCESS;
+}
+
+/* Find the queue of a taskpool, activating one if the taskpool had no ready
+ * task. Called with the lock of the vp held. */
+static fs_queue_t *fs_queue_of(fs_vp_t *fs, const parsec_taskpool_t *tp)
+{
+    fs_queue_t *q;
+    int i;
+
+    for( i = 0; i < fs->nb_active; i++ ) {
+        if( fs->active[i]->tp == tp ) return fs->active[i];
+    }
+    if( NULL != (q = fs->free_queues) ) {
+        fs->free_queues = q->next_free;
+    } else {
+        q = (fs_queue_t*)malloc(sizeof(fs_queue_t));
+        PARSEC_OBJ_CONSTRUCT(&q->tasks, parsec_list_t);
+    }
+    if( fs->nb_active == fs->size_active ) {
+        fs->size_active = (0 == fs->size_active) ? 8 : 2 * fs->size_active;
+        fs->active = (fs_queue_t**)realloc(fs->active, fs->size_active * sizeof(fs_queue_t*));
+    }
+    fs->active[fs->nb_active++] = q;
+    q->tp = tp;
+    /* A taskpool does not bank the selections it missed while it had no
+     * ready task, it starts at the pass of the taskpools being served */
+    q->pass = fs->vtime;
+    return q;
+}
+
+static parsec_task_t*
+sched_fs_select(parsec_execution_stream_t *es,
+                int32_t* distance)
+{
+    fs_vp_t *fs = LOCAL_SCHED_OBJECT(es);
+    parsec_task_t *task;
+    fs_queue_t *q;
+    int i, best;
+
+    *distance = 0;
+    if( 0 == fs->nb_active ) return NULL;
+
+    parsec_atomic_lock(&fs->lock);
+    if( 0 == fs->nb_active ) {
+        parsec_atomic_unlock(&fs->lock);
+        return NULL;
+    }
+    for( best = 0, i = 1; i < fs->nb_active; i++ ) {
+        if( fs->active[i]->pass < fs->active[best]->pass ) best = i;
+    }
+    q = fs->active[best];
+    task = (parsec_task_t*)parsec_list_nolock_pop_front(&q->tasks);
+    fs->vtime = q->pass;
+    q->pass += q->stride;
+    fs->nb_tasks--;
+    if( parsec_list_nolock_is_empty(&q->tasks) ) {
+        fs->active[best] = fs->active[--fs->nb_active];
+        q->tp = NULL;
+        q->next_free = fs->free_queues;
+        fs->free_queues = q;
+    }
+    parsec_atomic_unlock(&fs->lock);
+    PARSEC_LIST_ITEM_SINGLETON(task);
+    return task;
+}
+
+static int sched_fs_schedule(parsec_execution_stream_t* es,
+                             parsec_task_t* new_context,
+                             int32_t distance)
+{
+    fs_vp_t *fs = LOCAL_SCHED_OBJECT(es);
+    parsec_list_item_t *ring = &new_context->super, *item;
+    parsec_task_t *task;
+    fs_queue_t *q = NULL;
+    uint32_t weight;
+#if defined(PARSEC_DEBUG_NOISIER)
+    char tmp[MAX_TASK_STRLEN];
+#endif
+
+    parsec_atomic_lock(&fs->lock);
+    while( NULL != ring ) {
+        item = ring;
+        ring = parsec_list_item_ring_chop(item);
+        task = (parsec_task_t*)item;
+#if defined(PARSEC_DEBUG_NOISIER)
+        PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, "FS:\t Pushing task %s",
+                parsec_task_snprintf(tmp, MAX_TASK_STRLEN, task));
+#endif
+        /* the tasks of a ring mostly belong to the same taskpool */
+        if( NULL == q || q->tp != task->taskpool ) {
+            q = fs_queue_of(fs, task->taskpool);
+            weight = task->taskpool->sched_weight;
+            if( weight < 1 ) weight = 1;
+            if( weight > FS_STRIDE1 ) weight = FS_STRIDE1;
+            q->stride = FS_STRIDE1 / weight;
+        }
+        /* a taskpool releases its tasks mostly in priority order, append
+         * without walking the queue when it does */
+        if( parsec_list_nolock_is_empty(&q->tasks) ||
+            !A_HIGHER_PRIORITY_THAN_B(item, PARSEC_LIST_ITERATOR_LAST(&q->tasks),
+                                      parsec_execution_context_priority_comparator) ) {
+            parsec_list_nolock_push_back(&q->tasks, item);
+        } else {
+            parsec_list_nolock_push_sorted(&q->tasks, item, parsec_execution_context_priority_comparator);
+        }
+        fs->nb_tasks++;
+    }
+    parsec_atomic_unlock(&fs->lock);
+    (void)distance;
+    return PARSEC_SUCCESS;
+}
+
+static void sched_fs_remove( parsec_context_t *master )
+{
+    int p, t;
+    parsec_vp_t *vp;
+    fs_vp_t *fs;
+    fs_queue_t *q;
+
+    for(p = 0; p < master->nb_vp; p++) {
+        vp = master->virtual_processes[p];
+        fs = LOCAL_SCHED_OBJECT(vp->execution_streams[0]);
+        if( NULL != fs ) {
+            assert(0 == fs->nb_active);
+            while( NULL != (q = fs->free_queues) ) {
+                fs->free_queues = q->next_free;
+                PARSEC_OBJ_DESTRUCT(&q->tasks);
+                free(q);
+            }
+            free(fs->active);
+            free(fs);
+        }
+        for(t = 0; t < vp->nb_cores; t++) {
+            vp->execution_streams[t]->scheduler_object = NULL;
+        }
+        PARSEC_PAPI_SDE_UNREGISTER_COUNTER("SCHEDULER::PENDING_TASKS::QUEUE=%d::SCHED=FS", p);
+    }
+    PARSEC_PAPI_SDE_UNREGISTER_COUNTER("SCHEDULER::PENDING_TASKS::SCHED=FS");
+}
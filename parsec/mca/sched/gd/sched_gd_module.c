@@ -40,7 +40,8 @@ const parsec_sched_module_t parsec_sched_gd_module = {
         sched_gd_schedule,
         sched_gd_select,
         NULL,
-        sched_gd_remove
+        sched_gd_remove,
+        0
     }
 };
 
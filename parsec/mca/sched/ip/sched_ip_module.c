@@ -40,7 +40,8 @@ const parsec_sched_module_t parsec_sched_ip_module = {
         sched_ip_schedule,
         sched_ip_select,
         NULL,
-        sched_ip_remove
+        sched_ip_remove,
+        0
     }
 };
 
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * MultiQueue Scheduler
+ *
+ * A relaxed priority queue: each virtual process owns a few binary heaps
+ * per execution stream, each protected by its own lock. Tasks are pushed
+ * into a random heap, and a select pops the best of the tops of two random
+ * heaps. The order is close to the global priority order of the virtual
+ * process, while the contention stays that of a per-thread structure.
+ */
+
+
+#ifndef MCA_SCHED_MQ_H
+#define MCA_SCHED_MQ_H
+
+#include "parsec/parsec_config.h"
+#include "parsec/mca/mca.h"
+#include "parsec/mca/sched/sched.h"
+
+
+BEGIN_C_DECLS
+
+/**
+ * Globally exported variable
+ */
+PARSEC_DECLSPEC extern const parsec_sched_base_component_t parsec_sched_mq_component;
+PARSEC_DECLSPEC extern const parsec_sched_module_t parsec_sched_mq_module;
+/* static accessor */
+mca_base_component_t *sched_mq_static_component(void);
+
+END_C_DECLS
+#endif /* MCA_SCHED_MQ_H */
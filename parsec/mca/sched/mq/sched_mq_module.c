@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/parsec_internal.h"
+#include "parsec/utils/debug.h"
+#include "parsec/utils/mca_param.h"
+#include "parsec/mca/sched/sched.h"
+#include "parsec/mca/sched/mq/sched_mq.h"
+#include "parsec/mca/pins/pins.h"
+#include "parsec/papi_sde.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Module functions
+ */
+static int sched_mq_install(parsec_context_t* master);
+static int sched_mq_schedule(parsec_execution_stream_t* es,
+                             parsec_task_t* new_context,
+                             int32_t distance);
+static parsec_task_t*
+sched_mq_select(parsec_execution_stream_t *es,
+                int32_t* distance);
+static int flow_mq_init(parsec_execution_stream_t* es, struct parsec_barrier_t* barrier);
+static void sched_mq_remove(parsec_context_t* master);
+
+const parsec_sched_module_t parsec_sched_mq_module = {
+    &parsec_sched_mq_component,
+    {
+        sched_mq_install,
+        flow_mq_init,
+        sched_mq_schedule,
+        sched_mq_select,
+        NULL,
+        sched_mq_remove,
+        PARSEC_SCHED_FLAG_UNORDERED_RINGS
+    }
+};
+
+/* Tasks of equal priority leave a heap in their arrival order, like they
+ * leave the sorted list of ap: a task that asks to be rescheduled cannot
+ * starve the others. */
+typedef struct {
+    parsec_task_t *task;
+    int32_t        priority;
+    uint64_t       seq;
+} mq_entry_t;
+
+typedef struct {
+    parsec_atomic_lock_t lock;
+    volatile int32_t     size;      /**< read without the lock to choose a heap */
+    volatile int32_t     top;       /**< priority of the root, valid when size > 0 */
+    int32_t              capacity;
+    uint64_t             seq;
+    mq_entry_t          *heap;
+} mq_queue_t;
+
+/* One cache line per heap, the heaps are hammered by all the streams */
+#define MQ_CACHE_LINE_SIZE 64
+typedef union {
+    mq_queue_t q;
+    char       pad[MQ_CACHE_LINE_SIZE * ((sizeof(mq_queue_t) + MQ_CACHE_LINE_SIZE - 1) / MQ_CACHE_LINE_SIZE)];
+} mq_padded_queue_t;
+
+typedef struct {
+    int                nb_queues;
+    int                per_stream;
+    mq_padded_queue_t *queues;
+} mq_vp_t;
+
+#define LOCAL_SCHED_OBJECT(eu_context) ((mq_vp_t*)(eu_context)->scheduler_object)
+
+static int sched_mq_queues_per_stream = 2;
+
+static inline int mq_entry_before(const mq_entry_t *a, const mq_entry_t *b)
+{
+    return (a->priority > b->priority) || (a->priority == b->priority && a->seq < b->seq);
+}
+
+static void mq_heap_push(mq_queue_t *q, parsec_task_t *task)
+{
+    mq_entry_t e = { task, task->priority, q->seq++ };
+    int i, parent;
+
+    if( q->size == q->capacity ) {
+        q->capacity = (0 == q->capacity) ? 64 : 2 * q->capacity;
+        q->heap = (mq_entry_t*)realloc(q->heap, q->capacity * sizeof(mq_entry_t));
+    }
+    for( i = q->size; i > 0; i = parent ) {
+        parent = (i - 1) / 2;
+        if( !mq_entry_before(&e, &q->heap[parent]) ) break;
+        q->heap[i] = q->heap[parent];
+    }
+    q->heap[i] = e;
+    q->size = q->size + 1;
+    q->top = q->heap[0].priority;
+}
+
+static parsec_task_t *mq_heap_pop(mq_queue_t *q)
+{
+    parsec_task_t *task = q->heap[0].task;
+    int32_t n = q->size - 1;
+    mq_entry_t last = q->heap[n];
+    int i = 0, child;
+
+    while( (child = 2 * i + 1) < n ) {
+        if( child + 1 < n && mq_entry_before(&q->heap[child + 1], &q->heap[child]) ) child++;
+        if( !mq_entry_before(&q->heap[child], &last) ) break;
+        q->heap[i] = q->heap[child];
+        i = child;
+    }
+    q->heap[i] = last;
+    q->size = n;
+    if( n > 0 ) q->top = q->heap[0].priority;
+    return task;
+}
+
+#if defined(PARSEC_PAPI_SDE)
+static long long int sched_mq_pending_tasks(void *arg)
+{
+    mq_vp_t *mq = (mq_vp_t*)arg;
+    long long int len = 0;
+    for(int i = 0; i < mq->nb_queues; i++)
+        len += mq->queues[i].q.size;
+    return len;
+}
+#endif
+
+static int sched_mq_install( parsec_context_t *master )
+{
+    (void)master;
+    parsec_mca_param_reg_int_name("sched", "mq_queues_per_stream",
+                                  "Number of heaps per execution stream of the MQ scheduler. More heaps lower\n"
+                                  "the contention, fewer heaps give an order closer to the priorities.",
+                                  false, false, sched_mq_queues_per_stream, &sched_mq_queues_per_stream);
+    if( sched_mq_queues_per_stream < 1 )
+        sched_mq_queues_per_stream = 1;
+    return PARSEC_SUCCESS;
+}
+
+static int flow_mq_init(parsec_execution_stream_t* es, struct parsec_barrier_t* barrier)
+{
+    parsec_vp_t *vp = es->virtual_process;
+    mq_vp_t *mq;
+
+    if (es == vp->execution_streams[0]) {
+        mq = (mq_vp_t*)malloc(sizeof(mq_vp_t));
+        mq->per_stream = sched_mq_queues_per_stream;
+        mq->nb_queues = vp->nb_cores * mq->per_stream;
+        /* two random heaps must be able to differ */
+        if( mq->nb_queues < 2 ) mq->nb_queues = 2;
+        if( 0 != posix_memalign((void**)&mq->queues, MQ_CACHE_LINE_SIZE,
+                                mq->nb_queues * sizeof(mq_padded_queue_t)) ) {
+            parsec_fatal("MQ scheduler: cannot allocate %d heaps", mq->nb_queues);
+        }
+        memset(mq->queues, 0, mq->nb_queues * sizeof(mq_padded_queue_t));
+        for(int i = 0; i < mq->nb_queues; i++)
+            parsec_atomic_lock_init(&mq->queues[i].q.lock);
+        es->scheduler_object = mq;
+    }
+
+    parsec_barrier_wait(barrier);
+
+    if( es != vp->execution_streams[0] ) {
+        es->scheduler_object = LOCAL_SCHED_OBJECT(vp->execution_streams[0]);
+    }
+
+#if defined(PARSEC_PAPI_SDE)
+    if( 0 == es->th_id ) {
+        char event_name[PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN];
+        snprintf(event_name, PARSEC_PAPI_SDE_MAX_COUNTER_NAME_LEN,
+                 "SCHEDULER::PENDING_TASKS::QUEUE=%d::SCHED=MQ", es->virtual_process->vp_id);
+        parsec_papi_sde_register_fp_counter(event_name, PAPI_SDE_RO|PAPI_SDE_INSTANT, PAPI_SDE_int,
+                                            (papi_sde_fptr_t)sched_mq_pending_tasks, LOCAL_SCHED_OBJECT(es));
+        parsec_papi_sde_add_counter_to_group(event_name, "SCHEDULER::PENDING_TASKS", PAPI_SDE_SUM);
+        parsec_papi_sde_add_counter_to_group(event_name, "SCHEDULER::PENDING_TASKS::SCHED=MQ", PAPI_SDE_SUM);
+    }
+#endif
+
+    return PARSEC_SUCCESS;
+}
+
+static parsec_task_t*
+sched_mq_select(parsec_execution_stream_t *es,
+                int32_t* distance)
+{
+    mq_vp_t *mq = LOCAL_SCHED_OBJECT(es);
+    mq_queue_t *q, *q2;
+    parsec_task_t *task;
+    int attempt, i, first;
+
+    /* Best of two random heaps, skipping the busy ones */
+    for( attempt = 0; attempt < 2 * mq->nb_queues; attempt++ ) {
+        q  = &mq->queues[rand_r(&es->rand_seed) % mq->nb_queues].q;
+        q2 = &mq->queues[rand_r(&es->rand_seed) % mq->nb_queues].q;
+        if( 0 == q->size || (0 != q2->size && q2->top > q->top) ) q = q2;
+        if( 0 == q->size ) continue;
+        if( !parsec_atomic_trylock(&q->lock) ) continue;
+        if( 0 == q->size ) {
+            parsec_atomic_unlock(&q->lock);
+            continue;
+        }
+        goto found;
+    }
+
+    /* The random probes missed: sweep the heaps, starting from the ones of
+     * this stream, before reporting the virtual process empty */
+    first = (es->th_id * mq->per_stream) % mq->nb_queues;
+    for( i = 0; i < mq->nb_queues; i++ ) {
+        q = &mq->queues[(first + i) % mq->nb_queues].q;
+        if( 0 == q->size ) continue;
+        parsec_atomic_lock(&q->lock);
+        if( 0 != q->size ) goto found;
+        parsec_atomic_unlock(&q->lock);
+    }
+    *distance = 0;
+    return NULL;
+
+  found:
+    task = mq_heap_pop(q);
+    parsec_atomic_unlock(&q->lock);
+    PARSEC_LIST_ITEM_SINGLETON(task);
+    /* The heaps of a stream are its first choice only in the final sweep,
+     * a task from any other heap is reported as remote */
+    i = (int)((mq_padded_queue_t*)q - mq->queues) - es->th_id * mq->per_stream;
+    *distance = (i >= 0 && i < mq->per_stream) ? 0 : 1;
+    return task;
+}
+
+static int sched_mq_schedule(parsec_execution_stream_t* es,
+                             parsec_task_t* new_context,
+                             int32_t distance)
+{
+    mq_vp_t *mq = LOCAL_SCHED_OBJECT(es);
+    parsec_task_t *task = new_context, *next;
+    mq_queue_t *q;
+#if defined(PARSEC_DEBUG_NOISIER)
+    char tmp[MAX_TASK_STRLEN];
+#endif
+
+    do {
+        /* another stream may select the task as soon as it is pushed */
+        next = (parsec_task_t*)task->super.list_next;
+#if defined(PARSEC_DEBUG_NOISIER)
+        PARSEC_DEBUG_VERBOSE(20, parsec_debug_output, "MQ:\t Pushing task %s",
+                parsec_task_snprintf(tmp, MAX_TASK_STRLEN, task));
+#endif
+        /* The seed of the stream is shared when the communication thread
+         * schedules on behalf of the stream, a race only costs randomness */
+        do {
+            q = &mq->queues[rand_r(&es->rand_seed) % mq->nb_queues].q;
+        } while( !parsec_atomic_trylock(&q->lock) );
+        mq_heap_push(q, task);
+        parsec_atomic_unlock(&q->lock);
+        task = next;
+    } while( task != new_context );
+    (void)distance;
+    return PARSEC_SUCCESS;
+}
+
+static void sched_mq_remove( parsec_context_t *master )
+{
+    int p, t, i;
+    parsec_vp_t *vp;
+    mq_vp_t *mq;
+
+    for(p = 0; p < master->nb_vp; p++) {
+        vp = master->virtual_processes[p];
+        mq = LOCAL_SCHED_OBJECT(vp->execution_streams[0]);
+        if( NULL != mq ) {
+            for(i = 0; i < mq->nb_queues; i++) {
+                assert(0 == mq->queues[i].q.size);
+                free(mq->queues[i].q.heap);
+            }
+            free(mq->queues);
+            free(mq);
+        }
+        for(t = 0; t < vp->nb_cores; t++) {
+            vp->execution_streams[t]->scheduler_object = NULL;
+        }
+        PARSEC_PAPI_SDE_UNREGISTER_COUNTER("SCHEDULER::PENDING_TASKS::QUEUE=%d::SCHED=MQ", p);
+    }
+    PARSEC_PAPI_SDE_UNREGISTER_COUNTER("SCHEDULER::PENDING_TASKS::SCHED=MQ");
+}
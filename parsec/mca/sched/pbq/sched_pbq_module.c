@@ -43,7 +43,8 @@ const parsec_sched_module_t parsec_sched_pbq_module = {
         sched_pbq_schedule,
         sched_pbq_select,
         NULL,
-        sched_pbq_remove
+        sched_pbq_remove,
+        0
     }
 };
 
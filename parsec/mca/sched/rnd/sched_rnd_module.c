@@ -40,7 +40,8 @@ const parsec_sched_module_t parsec_sched_rnd_module = {
         sched_rnd_schedule,
         sched_rnd_select,
         NULL,
-        sched_rnd_remove
+        sched_rnd_remove,
+        PARSEC_SCHED_FLAG_UNORDERED_RINGS
     }
 };
 
@@ -329,8 +329,16 @@ struct parsec_sched_base_module_1_0_0_t {
     parsec_sched_base_module_select_fn_t       select;
     parsec_sched_base_module_stats_fn_t        display_stats;
     parsec_sched_base_module_remove_fn_t       remove;
+    uint32_t                                   flags;  /**< PARSEC_SCHED_FLAG_* */
 };
 
+/**
+ * The schedule function of the module does not need the rings of tasks to be
+ * sorted by priority (it orders the tasks itself, or does not order them), the
+ * runtime can hand them over in any order.
+ */
+#define PARSEC_SCHED_FLAG_UNORDERED_RINGS 0x1
+
 typedef struct parsec_sched_base_module_1_0_0_t parsec_sched_base_module_1_0_0_t;
 typedef struct parsec_sched_base_module_1_0_0_t parsec_sched_base_module_t;
 
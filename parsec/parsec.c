@@ -29,6 +29,7 @@
 #include "parsec/utils/output.h"
 #include "parsec/utils/show_help.h"
 #include "parsec/data_internal.h"
+#include "parsec/data_compress.h"
 #include "parsec/class/list.h"
 #include "parsec/scheduling.h"
 #include "parsec/class/barrier.h"
@@ -49,12 +50,14 @@
 #include "parsec/sys/tls.h"
 #include "parsec/data_distribution.h"
 #include "parsec/papi_sde.h"
+#include "parsec/live_metrics.h"
 
 #include "parsec/mca/mca_repository.h"
 
 #ifdef PARSEC_PROF_TRACE
 #include "parsec/profiling.h"
 #endif
+#include "parsec/os-spec-timing.h"
 
 #include "parsec/parsec_hwloc.h"
 #ifdef PARSEC_HAVE_HWLOC
@@ -157,6 +160,7 @@ static int parsec_runtime_bind_main_thread = 1;
 static int parsec_runtime_bind_threads     = 1;
 
 int parsec_runtime_keep_highest_priority_task = 1;
+int parsec_runtime_persistent_workers = 0;
 
 PARSEC_TLS_DECLARE(parsec_tls_execution_stream);
 
@@ -178,6 +182,7 @@ static void __parsec_taskpool_constructor(parsec_taskpool_t* tp)
     tp->devices_index_mask = 0;  /* no support for any device. Requires initialization */
     tp->nb_task_classes = 0;
     tp->priority = 0;
+    tp->sched_weight = 1;
     tp->nb_pending_actions = 0;
     tp->context = NULL;  /* not atached to any context */
     tp->startup_hook = NULL;
@@ -189,6 +194,7 @@ static void __parsec_taskpool_constructor(parsec_taskpool_t* tp)
     tp->update_nb_runtime_task = NULL;
     tp->dependencies_array = NULL;
     tp->repo_array = NULL;
+    tp->no_prefetch_affinity = 0;
     tp->tdm.callback = NULL;
     tp->tdm.monitor = NULL;
     tp->tdm.module = NULL;
@@ -261,7 +267,9 @@ static void* __parsec_thread_init( __parsec_temporary_thread_initialization_t* s
     es->rand_seed        = tv_now.tv_usec + startup->th_id;
     es->scheduler_object = NULL;
     es->next_task        = NULL;
+    es->busy             = 0;
     startup->virtual_process->execution_streams[startup->th_id] = es;
+    parsec_live_stream_init(es, startup->virtual_process->vp_id, startup->th_id);
     es->core_id          = startup->bindto;
 #if defined(PARSEC_HAVE_HWLOC)
     es->socket_id        = parsec_hwloc_socket_id(startup->bindto);
@@ -407,6 +415,11 @@ parsec_context_t* parsec_init( int nb_cores, int* pargc, char** pargv[] )
 
     gethostname(parsec_hostname_array, sizeof(parsec_hostname_array));
 
+#if defined(PARSEC_HAVE_TIMER_TSC)
+    /* Before anything takes a timestamp: select the source and calibrate */
+    parsec_timer_init();
+#endif  /* defined(PARSEC_HAVE_TIMER_TSC) */
+
     PARSEC_PAPI_SDE_INIT();
 
     parsec_installdirs_open();
@@ -532,6 +545,8 @@ parsec_context_t* parsec_init( int nb_cores, int* pargc, char** pargv[] )
      */
     parsec_mca_param_reg_int_name("runtime", "keep_highest_priority_task", "Allow a compute thread to retain the highest priority task to be executed locally. This change makes the scheduling decision non-deterministic because some tasks will never be handled to the scheduler.", false, false,
                                   parsec_runtime_keep_highest_priority_task, &parsec_runtime_keep_highest_priority_task);
+    parsec_mca_param_reg_int_name("runtime", "persistent_workers", "Keep the compute threads in the scheduling loop between the end of a parsec_context_wait and the next parsec_context_start, instead of putting them to sleep in a barrier. This shortens the start/wait turnaround of applications running many small taskpools, at the cost of idle threads polling for tasks between the rounds.", false, false,
+                                  parsec_runtime_persistent_workers, &parsec_runtime_persistent_workers);
 
     if( parsec_cmd_line_is_taken(cmd_line, "gpus") ) {
         parsec_warning("Option g (for accelerators) is deprecated as an argument. Use the MCA parameter instead.");
@@ -795,6 +810,8 @@ parsec_context_t* parsec_init( int nb_cores, int* pargc, char** pargv[] )
     /* Introduce communication engine */
     (void)parsec_remote_dep_init(context);
 
+    (void)parsec_live_init(context);
+
     (void)check_overlapping_binding(context);
 
     PARSEC_PINS_INIT(context);
@@ -1220,6 +1237,7 @@ int parsec_fini( parsec_context_t** pcontext )
     }
 
     parsec_rusage(true);
+    parsec_data_compress_fini();
 
     PARSEC_PINS_THREAD_FINI(context->virtual_processes[0]->execution_streams[0]);
 
@@ -1250,6 +1268,8 @@ int parsec_fini( parsec_context_t** pcontext )
 
     (void) parsec_remote_dep_fini(context);
 
+    parsec_live_fini();
+
     parsec_remove_scheduler( context );
 
     parsec_data_fini(context);
@@ -1559,6 +1579,40 @@ parsec_hash_find_deps(const parsec_taskpool_t *tp,
     return &hd->dependency;
 }
 
+parsec_dependency_t*
+parsec_paged_find_deps(const parsec_taskpool_t *tp,
+                       parsec_execution_stream_t *es,
+                       const parsec_task_t* restrict task)
+{
+    parsec_paged_dependencies_t *pd;
+    parsec_dependency_t *page;
+    parsec_key_t key;
+    uint64_t pidx;
+
+    pd = (parsec_paged_dependencies_t*)tp->dependencies_array[task->task_class->task_class_id];
+    assert(NULL != pd);
+    key = task->task_class->make_key(tp, task->locals);
+    assert((uint64_t)key < pd->nb_keys);
+    pidx = (uint64_t)key >> PARSEC_DEPENDENCIES_PAGE_SHIFT;
+    page = pd->pages[pidx];
+    if( NULL == page ) {
+        if( NULL == es ) {
+            /* This is a call for debugging purpose, don't allocate a page for
+             * a task that has not been touched yet */
+            return NULL;
+        }
+        page = (parsec_dependency_t*)calloc(PARSEC_DEPENDENCIES_PAGE_SIZE, sizeof(parsec_dependency_t));
+        if( parsec_atomic_cas_ptr(&pd->pages[pidx], NULL, page) ) {
+            (void)parsec_atomic_fetch_inc_int32(&pd->nb_allocated_pages);
+        } else {
+            /* Another thread installed the page first, use theirs */
+            free(page);
+            page = pd->pages[pidx];
+        }
+    }
+    return &page[key & (PARSEC_DEPENDENCIES_PAGE_SIZE - 1)];
+}
+
 int
 parsec_update_deps_with_counter(parsec_taskpool_t *tp,
                                 const parsec_task_t* restrict task,
@@ -1896,9 +1950,8 @@ parsec_release_local_OUT_dependencies(parsec_execution_stream_t* es,
 #endif
             } else {
                 *pready_ring = (parsec_task_t*)
-                    parsec_list_item_ring_push_sorted( (parsec_list_item_t*)(*pready_ring),
-                                                       &new_context->super,
-                                                       parsec_execution_context_priority_comparator );
+                    parsec_list_item_ring_push_front( (parsec_list_item_t*)(*pready_ring),
+                                                      &new_context->super );
             }
         }
     } else { /* Service not ready */
@@ -2130,6 +2183,35 @@ size_t parsec_destruct_dependencies(parsec_dependencies_t* d)
     return ret;
 }
 
+parsec_paged_dependencies_t *parsec_paged_dependencies_new(uint64_t nb_keys)
+{
+    parsec_paged_dependencies_t *pd;
+    uint64_t nb_pages = (nb_keys + PARSEC_DEPENDENCIES_PAGE_SIZE - 1) >> PARSEC_DEPENDENCIES_PAGE_SHIFT;
+
+    pd = (parsec_paged_dependencies_t*)calloc(1, sizeof(parsec_paged_dependencies_t) +
+                                              (nb_pages > 0 ? nb_pages - 1 : 0) * sizeof(parsec_dependency_t*));
+    pd->nb_keys = nb_keys;
+    pd->nb_pages = nb_pages;
+    pd->nb_allocated_pages = 0;
+    return pd;
+}
+
+size_t parsec_paged_dependencies_destruct(parsec_paged_dependencies_t *pd)
+{
+    uint64_t i;
+    size_t ret;
+
+    if( NULL == pd ) return 0;
+    ret = sizeof(parsec_paged_dependencies_t) +
+        (pd->nb_pages > 0 ? pd->nb_pages - 1 : 0) * sizeof(parsec_dependency_t*) +
+        (size_t)pd->nb_allocated_pages * PARSEC_DEPENDENCIES_PAGE_SIZE * sizeof(parsec_dependency_t);
+    for(i = 0; i < pd->nb_pages; i++) {
+        free(pd->pages[i]);
+    }
+    free(pd);
+    return ret;
+}
+
 int
 parsec_taskpool_set_complete_callback( parsec_taskpool_t* tp,
                                        parsec_event_cb_t complete_cb,
@@ -2190,6 +2272,14 @@ parsec_taskpool_set_priority( parsec_taskpool_t* tp, int32_t new_priority )
     return old_priority;
 }
 
+uint32_t
+parsec_taskpool_set_scheduling_weight( parsec_taskpool_t* tp, uint32_t new_weight )
+{
+    uint32_t old_weight = tp->sched_weight;
+    tp->sched_weight = (0 == new_weight) ? 1 : new_weight;
+    return old_weight;
+}
+
 /* TODO: Change this code to something better */
 static parsec_atomic_lock_t taskpool_array_lock = PARSEC_ATOMIC_UNLOCKED;
 static parsec_taskpool_t** taskpool_array = NULL;
@@ -42,6 +42,7 @@ typedef struct parsec_profiling_output_s {
 #define PROFILING_BUFFER_TYPE_THREAD      3
 #define PROFILING_BUFFER_TYPE_GLOBAL_INFO 4
 #define PROFILING_BUFFER_TYPE_HEADER      5
+#define PROFILING_BUFFER_TYPE_COMPACT_EVENTS 6
 typedef struct parsec_profiling_buffer_s {
     off_t    this_buffer_file_offset;    /* Used by the malloc / write method. MUST BE THE FIRST ELEMENT */
     off_t    next_buffer_file_offset;
@@ -128,6 +129,113 @@ typedef struct parsec_profiling_perf_s {
     uint32_t perf_number_calls;
 } parsec_profiling_perf_t;
 
+/**
+ * Compact encoding of the events (PROFILING_BUFFER_TYPE_COMPACT_EVENTS
+ * buffers). Each event is stored as the varints of its key and flags, the
+ * code of its taskpool id in a small per-buffer dictionary (a code equal to
+ * the number of entries is followed by the varint of a new id), the zigzag
+ * varints of the differences of its event id and timestamp with the previous
+ * event of the buffer, and the raw info blob. The state is reset at the start
+ * of each buffer, so that buffers can be decoded independently.
+ */
+#define PARSEC_PROFILING_COMPACT_TASKPOOLS  64
+#define PARSEC_PROFILING_COMPACT_MAX_LENGTH (3 + 3 + 1 + 5 + 10 + 10)
+
+typedef struct parsec_profiling_compact_state_s {
+    uint64_t event_id;
+    uint64_t timestamp;
+    int      nb_taskpools;
+    uint32_t taskpools[PARSEC_PROFILING_COMPACT_TASKPOOLS];
+} parsec_profiling_compact_state_t;
+
+static inline size_t parsec_profiling_varint_encode(char *out, uint64_t v)
+{
+    size_t n = 0;
+    while( v >= 0x80 ) {
+        out[n++] = (char)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (char)v;
+    return n;
+}
+
+static inline size_t parsec_profiling_varint_decode(const char *in, uint64_t *v)
+{
+    size_t n = 0;
+    int shift = 0;
+    *v = 0;
+    do {
+        *v |= (uint64_t)(in[n] & 0x7f) << shift;
+        shift += 7;
+    } while( in[n++] & 0x80 );
+    return n;
+}
+
+#define PARSEC_PROFILING_ZIGZAG(d)   (((uint64_t)(d) << 1) ^ (uint64_t)((int64_t)(d) >> 63))
+#define PARSEC_PROFILING_UNZIGZAG(z) (((z) >> 1) ^ (uint64_t)(-(int64_t)((z) & 1)))
+
+/**
+ * Encode the header of an event in out, which must have room for
+ * PARSEC_PROFILING_COMPACT_MAX_LENGTH bytes, and return its length.
+ */
+static inline size_t
+parsec_profiling_compact_encode(parsec_profiling_compact_state_t *state, char *out,
+                                const parsec_profiling_output_base_event_t *event)
+{
+    size_t n;
+    int tp;
+
+    n  = parsec_profiling_varint_encode(out, event->key);
+    n += parsec_profiling_varint_encode(out + n, event->flags);
+    for( tp = 0; tp < state->nb_taskpools; tp++ )
+        if( state->taskpools[tp] == event->taskpool_id ) break;
+    out[n++] = (char)tp;
+    if( tp == state->nb_taskpools ) {
+        n += parsec_profiling_varint_encode(out + n, event->taskpool_id);
+        if( state->nb_taskpools < PARSEC_PROFILING_COMPACT_TASKPOOLS )
+            state->taskpools[state->nb_taskpools++] = event->taskpool_id;
+    }
+    n += parsec_profiling_varint_encode(out + n, PARSEC_PROFILING_ZIGZAG(event->event_id - state->event_id));
+    n += parsec_profiling_varint_encode(out + n, PARSEC_PROFILING_ZIGZAG(event->timestamp - state->timestamp));
+    state->event_id  = event->event_id;
+    state->timestamp = event->timestamp;
+    return n;
+}
+
+/**
+ * Decode the header of the event at in, and return its length. The info
+ * blob, if any, follows.
+ */
+static inline size_t
+parsec_profiling_compact_decode(parsec_profiling_compact_state_t *state, const char *in,
+                                parsec_profiling_output_base_event_t *event)
+{
+    uint64_t v;
+    size_t n;
+    int tp;
+
+    n  = parsec_profiling_varint_decode(in, &v);
+    event->key = (uint16_t)v;
+    n += parsec_profiling_varint_decode(in + n, &v);
+    event->flags = (uint16_t)v;
+    tp = (unsigned char)in[n++];
+    if( tp >= state->nb_taskpools ) {
+        n += parsec_profiling_varint_decode(in + n, &v);
+        event->taskpool_id = (uint32_t)v;
+        if( state->nb_taskpools < PARSEC_PROFILING_COMPACT_TASKPOOLS )
+            state->taskpools[state->nb_taskpools++] = event->taskpool_id;
+    } else {
+        event->taskpool_id = state->taskpools[tp];
+    }
+    n += parsec_profiling_varint_decode(in + n, &v);
+    event->event_id = state->event_id + PARSEC_PROFILING_UNZIGZAG(v);
+    n += parsec_profiling_varint_decode(in + n, &v);
+    event->timestamp = state->timestamp + PARSEC_PROFILING_UNZIGZAG(v);
+    state->event_id  = event->event_id;
+    state->timestamp = event->timestamp;
+    return n;
+}
+
 struct tl_freelist_s;
 
 struct parsec_profiling_stream_s {
@@ -143,6 +251,7 @@ struct parsec_profiling_stream_s {
     pthread_t                  thread_owner;
     off_t                      current_events_buffer_offset;
     parsec_profiling_buffer_t *current_events_buffer;     /* points to the events buffer in which we are writing. */
+    parsec_profiling_compact_state_t compact;              /* Encoding state of the current compact events buffer */
 };
 
 typedef struct {
@@ -150,6 +259,8 @@ typedef struct {
     char *attributes;
     char *convertor;
     int32_t info_length;
+    int32_t sample_rate;  /* one in sample_rate instances is traced */
+    int32_t sampled;      /* the instances were sampled with this rate */
 } parsec_profiling_key_t;
 
 #define PARSEC_PROFILING_MAGICK "#PARSEC BINARY PROFILE "
@@ -134,6 +134,8 @@ struct parsec_taskpool_s {
     uint16_t                   devices_index_mask; /**< A bitmask of devices indexes this taskpool has been registered with */
     uint32_t                   nb_task_classes;    /**< Number of task classes in the taskpool */
     int32_t                    priority;           /**< A constant used to bump the priority of tasks related to this taskpool */
+    uint32_t                   sched_weight;       /**< Share of the execution streams given to this taskpool by the
+                                                    *   schedulers sharing them between taskpools (at least 1) */
     volatile int32_t           nb_pending_actions; /**< Internal counter of pending actions tracking all runtime
                                                     *   activities (such as communications, data movement, and
                                                     *   so on). Also, its value is increase by one for all the tasks
@@ -158,6 +160,8 @@ struct parsec_taskpool_s {
                                                      *   Indexed on the same index as task_classes_array */
     data_repo_t**               repo_array; /**< Array of data repositories
                                              *   Indexed on the same index as functions array */
+    volatile int64_t            no_prefetch_affinity; /**< Task classes (bit task_class_id, for the first 64)
+                                                       *   whose affinity is in a collection that does not prefetch */
 };
 
 PARSEC_DECLSPEC PARSEC_OBJ_CLASS_DECLARATION(parsec_taskpool_t);
@@ -228,6 +232,30 @@ struct parsec_hashable_dependency_s {
 };
 typedef struct parsec_hashable_dependency_s parsec_hashable_dependency_t;
 
+/**
+ * Number of dependencies per page (as a power of 2) in the paged
+ * dependencies tracking.
+ */
+#define PARSEC_DEPENDENCIES_PAGE_SHIFT 9
+#define PARSEC_DEPENDENCIES_PAGE_SIZE  (1 << PARSEC_DEPENDENCIES_PAGE_SHIFT)
+
+/**
+ * This structure is used when dependencies are resolved as a lazily allocated
+ * two-level array indexed by the (collision-free) key of the tasks. Only the
+ * directory of pages is allocated upfront, the pages themselves are allocated
+ * by the first thread that needs them and installed with an atomic CAS.
+ */
+typedef struct parsec_paged_dependencies_s {
+    uint64_t                       nb_keys;     /**< Upper bound of the keys space */
+    uint64_t                       nb_pages;    /**< Number of entries in the directory */
+    int32_t                        nb_allocated_pages;
+    /* keep this as the last field in the structure */
+    parsec_dependency_t * volatile pages[1];
+} parsec_paged_dependencies_t;
+
+parsec_paged_dependencies_t *parsec_paged_dependencies_new(uint64_t nb_keys);
+size_t parsec_paged_dependencies_destruct(parsec_paged_dependencies_t *pd);
+
 /**
  * Functions for DAG manipulation.
  */
@@ -346,6 +374,9 @@ parsec_dependency_t *parsec_default_find_deps(const parsec_taskpool_t *tp,
 parsec_dependency_t *parsec_hash_find_deps(const parsec_taskpool_t *tp,
                                            parsec_execution_stream_t *es,
                                            const parsec_task_t* task);
+parsec_dependency_t *parsec_paged_find_deps(const parsec_taskpool_t *tp,
+                                            parsec_execution_stream_t *es,
+                                            const parsec_task_t* task);
 typedef int (parsec_update_dependency_fn_t)(parsec_taskpool_t *tp,
                                             const parsec_task_t* restrict task,
                                             parsec_dependency_t *deps,
@@ -469,6 +500,16 @@ PARSEC_DECLSPEC extern int parsec_want_rusage;
  */
 PARSEC_DECLSPEC extern int parsec_runtime_keep_highest_priority_task;
 
+/**
+ * Global configuration variable controlling the behavior of the execution
+ * streams between two rounds (parsec_context_start / parsec_context_wait).
+ * If this is enabled the streams other than the master stay in the
+ * scheduling loop until parsec_fini, instead of sleeping in a barrier until
+ * the next parsec_context_start. The turnaround of a round is faster, but
+ * the streams keep polling for tasks (with a backoff) between the rounds.
+ */
+PARSEC_DECLSPEC extern int parsec_runtime_persistent_workers;
+
 /**
  * Description of the state of the task. It indicates what will be the next
  * next stage in the life-time of a task to be executed.
@@ -495,7 +536,8 @@ PARSEC_DECLSPEC extern int parsec_runtime_keep_highest_priority_task;
     int32_t                        priority;         \
     uint8_t                        status;           \
     uint8_t                        chore_mask;       \
-    uint8_t                        unused[2];        \
+    uint8_t                        prof_sampled; /* sampling bits of the task profiler */ \
+    uint8_t                        unused;           \
     struct data_repo_entry_s      *repo_entry; /* The task contains its own data repo entry;
                                                 * It is created during datalookup if it hasn't
                                                 * been already created by a predecessor
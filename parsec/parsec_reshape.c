@@ -16,9 +16,251 @@
 #include "parsec/execution_stream.h"
 #include "parsec/data_distribution.h"
 
+#include <sched.h>
+
 #define PARSEC_UNFULFILLED_RESHAPE_PROMISE 0
 #define PARSEC_FULFILLED_RESHAPE_PROMISE   1
 
+/**
+ * Entry of the reshape cache, chained on the parsec_data_t of the source
+ * copy. The source copy is not retained: its entries are purged when it is
+ * detached from its data. The arena of the reshaped copy is retained, as the
+ * copy may outlive the taskpool owning the arena; matching on the arena also
+ * prevents a later taskpool from hitting entries built with datatypes that
+ * may have been freed since. The entries are evicted at the latest when the
+ * taskpool that built them completes.
+ */
+typedef struct parsec_reshape_cache_entry_s {
+    struct parsec_reshape_cache_entry_s *next;
+    struct parsec_reshape_cache_entry_s *rnext;            /* chaining in the registry */
+    struct parsec_reshape_cache_entry_s **rprev;
+    struct parsec_reshape_cache_s       *cache;
+    const parsec_taskpool_t             *taskpool;         /* the taskpool that built the copy */
+    parsec_data_copy_t                  *source;
+    uint32_t                             source_version;
+    parsec_dep_type_description_t        local;
+    parsec_data_copy_t                  *reshape;          /* retained by the cache */
+    uint32_t                             reshape_version;
+} parsec_reshape_cache_entry_t;
+
+struct parsec_reshape_cache_s {
+    parsec_atomic_lock_t                 lock;
+    parsec_reshape_cache_entry_t        *entries;
+};
+
+/* All the entries of all the caches, such that the entries of a taskpool can be
+ * evicted when it completes. The registry lock is only taken with the lock of
+ * a cache held, or with a trylock of the cache lock. */
+static parsec_atomic_lock_t parsec_reshape_cache_registry_lock = PARSEC_ATOMIC_UNLOCKED;
+static parsec_reshape_cache_entry_t *parsec_reshape_cache_registry = NULL;
+
+static inline void
+parsec_reshape_cache_register(parsec_reshape_cache_entry_t *entry)
+{
+    parsec_atomic_lock(&parsec_reshape_cache_registry_lock);
+    entry->rnext = parsec_reshape_cache_registry;
+    entry->rprev = &parsec_reshape_cache_registry;
+    if( NULL != entry->rnext ) entry->rnext->rprev = &entry->rnext;
+    parsec_reshape_cache_registry = entry;
+    parsec_atomic_unlock(&parsec_reshape_cache_registry_lock);
+}
+
+/* Must be called with the registry lock held */
+static inline void
+parsec_reshape_cache_unregister(parsec_reshape_cache_entry_t *entry)
+{
+    *entry->rprev = entry->rnext;
+    if( NULL != entry->rnext ) entry->rnext->rprev = entry->rprev;
+}
+
+static inline int
+parsec_reshape_cache_match(const parsec_dep_type_description_t *a,
+                           const parsec_dep_type_description_t *b)
+{
+    return (a->arena == b->arena)
+        && (a->src_datatype == b->src_datatype) && (a->src_displ == b->src_displ) && (a->src_count == b->src_count)
+        && (a->dst_datatype == b->dst_datatype) && (a->dst_displ == b->dst_displ) && (a->dst_count == b->dst_count);
+}
+
+/**
+ * Unlink from the cache the entries of source (of all sources if NULL) that
+ * are outdated, or all of them if all is set. Must be called with the cache
+ * lock held.
+ *
+ * @return the list of unlinked entries, to be released once the lock is dropped.
+ */
+static parsec_reshape_cache_entry_t *
+parsec_reshape_cache_unlink(struct parsec_reshape_cache_s *cache,
+                            parsec_data_copy_t *source, int all)
+{
+    parsec_reshape_cache_entry_t *entry, **prev = &cache->entries, *evicted = NULL;
+
+    while( NULL != (entry = *prev) ) {
+        if( ((NULL == source) || (entry->source == source)) &&
+            (all || (entry->source_version != entry->source->version)
+                 || (entry->reshape_version != entry->reshape->version)) ) {
+            *prev = entry->next;
+            parsec_atomic_lock(&parsec_reshape_cache_registry_lock);
+            parsec_reshape_cache_unregister(entry);
+            parsec_atomic_unlock(&parsec_reshape_cache_registry_lock);
+            entry->next = evicted;
+            evicted = entry;
+            continue;
+        }
+        prev = &entry->next;
+    }
+    return evicted;
+}
+
+static void
+parsec_reshape_cache_release(parsec_reshape_cache_entry_t *evicted)
+{
+    parsec_reshape_cache_entry_t *next;
+    for( ; NULL != evicted; evicted = next ) {
+        next = evicted->next;
+        PARSEC_DEBUG_VERBOSE(12, parsec_debug_output,
+                             "RESHAPE_CACHE EVICT [%p:%u -> %p]",
+                             evicted->source, evicted->source_version, evicted->reshape);
+        PARSEC_DATA_COPY_RELEASE(evicted->reshape);
+        PARSEC_OBJ_RELEASE(evicted->local.arena);
+        free(evicted);
+    }
+}
+
+parsec_data_copy_t *
+parsec_reshape_cache_lookup(parsec_data_copy_t *source,
+                            const parsec_dep_type_description_t *local)
+{
+    struct parsec_reshape_cache_s *cache;
+    parsec_reshape_cache_entry_t *entry, *evicted;
+    parsec_data_copy_t *reshape = NULL;
+
+    if( (NULL == source->original) || (NULL == (cache = source->original->reshape_cache)) )
+        return NULL;
+
+    parsec_atomic_lock(&cache->lock);
+    evicted = parsec_reshape_cache_unlink(cache, source, 0);
+    for( entry = cache->entries; NULL != entry; entry = entry->next ) {
+        if( (entry->source == source) && parsec_reshape_cache_match(&entry->local, local) ) {
+            reshape = entry->reshape;
+            PARSEC_OBJ_RETAIN(reshape);
+            break;
+        }
+    }
+    parsec_atomic_unlock(&cache->lock);
+    parsec_reshape_cache_release(evicted);
+    return reshape;
+}
+
+void
+parsec_reshape_cache_insert(parsec_data_copy_t *source,
+                            const parsec_dep_type_description_t *local,
+                            parsec_data_copy_t *reshape,
+                            const parsec_taskpool_t *tp)
+{
+    parsec_data_t *data = source->original;
+    struct parsec_reshape_cache_s *cache;
+    parsec_reshape_cache_entry_t *entry, *evicted;
+
+    /* Without a taskpool the entry could not be evicted when it completes */
+    if( (NULL == data) || (NULL == local->arena) || (NULL == tp) ) return;
+    if( NULL == (cache = data->reshape_cache) ) {
+        parsec_atomic_lock_t unlocked = PARSEC_ATOMIC_UNLOCKED;
+        cache = (struct parsec_reshape_cache_s*)malloc(sizeof(struct parsec_reshape_cache_s));
+        cache->lock    = unlocked;
+        cache->entries = NULL;
+        if( !parsec_atomic_cas_ptr(&data->reshape_cache, NULL, cache) ) {
+            free(cache);
+            cache = data->reshape_cache;
+        }
+    }
+
+    parsec_atomic_lock(&cache->lock);
+    evicted = parsec_reshape_cache_unlink(cache, source, 0);
+    for( entry = cache->entries; NULL != entry; entry = entry->next ) {
+        /* Another consumer raced us, keep the first converted copy */
+        if( (entry->source == source) && parsec_reshape_cache_match(&entry->local, local) ) break;
+    }
+    if( NULL == entry ) {
+        entry = (parsec_reshape_cache_entry_t*)malloc(sizeof(parsec_reshape_cache_entry_t));
+        entry->cache           = cache;
+        entry->taskpool        = tp;
+        entry->source          = source;
+        entry->source_version  = source->version;
+        entry->local           = *local;
+        entry->reshape         = reshape;
+        entry->reshape_version = reshape->version;
+        PARSEC_OBJ_RETAIN(reshape);
+        PARSEC_OBJ_RETAIN(local->arena);
+        entry->next    = cache->entries;
+        cache->entries = entry;
+        parsec_reshape_cache_register(entry);
+        PARSEC_DEBUG_VERBOSE(12, parsec_debug_output,
+                             "RESHAPE_CACHE INSERT [%p:%u -> %p]",
+                             source, source->version, reshape);
+    }
+    parsec_atomic_unlock(&cache->lock);
+    parsec_reshape_cache_release(evicted);
+}
+
+void
+parsec_reshape_cache_purge(parsec_data_t *data, parsec_data_copy_t *source)
+{
+    struct parsec_reshape_cache_s *cache = data->reshape_cache;
+    parsec_reshape_cache_entry_t *evicted;
+
+    if( NULL == cache ) return;
+    parsec_atomic_lock(&cache->lock);
+    evicted = parsec_reshape_cache_unlink(cache, source, 1);
+    parsec_atomic_unlock(&cache->lock);
+    parsec_reshape_cache_release(evicted);
+    if( NULL == source ) {
+        data->reshape_cache = NULL;
+        free(cache);
+    }
+}
+
+void
+parsec_reshape_cache_evict_taskpool(const parsec_taskpool_t *tp)
+{
+    parsec_reshape_cache_entry_t *entry, *next, **prev, *evicted = NULL;
+    int busy;
+
+    if( NULL == parsec_reshape_cache_registry ) return;
+    do {
+        busy = 0;
+        parsec_atomic_lock(&parsec_reshape_cache_registry_lock);
+        for( entry = parsec_reshape_cache_registry; NULL != entry; entry = next ) {
+            next = entry->rnext;
+            if( entry->taskpool != tp ) continue;
+            /* the lock order is cache then registry, do not wait on the cache */
+            if( !parsec_atomic_trylock(&entry->cache->lock) ) {
+                busy = 1;
+                continue;
+            }
+            for( prev = &entry->cache->entries; *prev != entry; prev = &(*prev)->next );
+            *prev = entry->next;
+            parsec_reshape_cache_unregister(entry);
+            parsec_atomic_unlock(&entry->cache->lock);
+            entry->next = evicted;
+            evicted = entry;
+        }
+        parsec_atomic_unlock(&parsec_reshape_cache_registry_lock);
+        if( busy ) sched_yield();
+    } while( busy );
+    parsec_reshape_cache_release(evicted);
+}
+
+/**
+ * Check if the flow of a consumer only reads the data, in which case the
+ * reshaped copy it receives can be shared through the reshape cache.
+ */
+static inline int
+parsec_reshape_flow_is_read_only(const parsec_flow_t *flow)
+{
+    return (NULL != flow) && !(flow->flow_flags & PARSEC_FLOW_ACCESS_WRITE);
+}
+
 
 /**
  *
@@ -131,6 +373,7 @@ parsec_new_reshape_promise(parsec_dep_data_description_t* data,
     future_in_data->remote_send_guard            = 0;
 #endif
     future_in_data->remote_recv_guard            = 0;
+    future_in_data->read_only                    = 0;
 
     parsec_future_init(data_future, parsec_local_reshape, future_in_data,
                        parsec_reshape_check_match_datatypes, match_data,
@@ -173,6 +416,8 @@ void parsec_setup_nested_future(parsec_datacopy_future_t** future,
     data->local.src_count    = old_cb_data_in->local->src_count;
     data->local.src_displ    = old_cb_data_in->local->src_displ;
     *future = parsec_new_reshape_promise(data, PARSEC_UNFULFILLED_RESHAPE_PROMISE);
+    /* Nested promises are only consumed by consumers of the parent one */
+    ((parsec_reshape_promise_description_t *)(*future)->cb_fulfill_data_in)->read_only = old_cb_data_in->read_only;
 
     /*However the match data has to match the one pass as arg */
     ((parsec_datatype_t*)(*future)->cb_match_data_in)[0] = match_d0;
@@ -233,6 +478,7 @@ void parsec_setup_nested_future(parsec_datacopy_future_t** future,
  * @param[inout] ouput_usage counter for the predecessor repo usage.
  *
  * @param[in] promise_type fulfilled or unfulfilled reshape promise.
+ * @param[in] read_only whether this consumer only reads the reshaped copy.
  */
 static void
 parsec_create_reshape_promise(parsec_execution_stream_t *es,
@@ -248,7 +494,8 @@ parsec_create_reshape_promise(parsec_execution_stream_t *es,
                               data_repo_t **setup_repo,
                               parsec_key_t *setup_repo_key,
                               uint32_t *output_usage,
-                              int promise_type)
+                              int promise_type,
+                              int read_only)
 {
     parsec_reshape_promise_description_t *future_in_data;
     uint8_t setup_flow_index;
@@ -318,6 +565,8 @@ parsec_create_reshape_promise(parsec_execution_stream_t *es,
 
     future_in_data = ((parsec_reshape_promise_description_t *)data->data_future->cb_fulfill_data_in);
     assert( data->data == future_in_data->data );
+    /* The reshaped copy can only be shared if none of the consumers modifies it */
+    future_in_data->read_only = new_future ? read_only : (future_in_data->read_only && read_only);
 
 #ifdef PARSEC_RESHAPE_BEFORE_SEND_TO_REMOTE
     if ( dst_rank != src_rank ) {
@@ -481,7 +730,9 @@ parsec_set_up_reshape_promise(parsec_execution_stream_t *es,
                                   &setup_repo,
                                   &setup_repo_key,
                                   &arg->output_usage,
-                                  promise_type);
+                                  promise_type,
+                                  (dst_rank != es->virtual_process->parsec_context->my_rank)
+                                  || parsec_reshape_flow_is_read_only(dep->flow));
 
     if(arg->action_mask & PARSEC_ACTION_RESHAPE_REMOTE_ON_RELEASE){
         /* Mark this future as originated after a reception
@@ -535,8 +786,8 @@ parsec_set_up_reshape_promise(parsec_execution_stream_t *es,
  *
  * Auxiliary routine to create an inline reshape promise, i.e., creating and
  * fulfilling a local future promise (only the current task instance is involved).
- * Each thread accessing the same original tile on the matrix will
- * create a new reshaped copy.
+ * Tasks only reading the same original tile on the matrix share one
+ * reshaped copy through the reshape cache, the others create their own.
  * The reshape promise is stored on the task instance repo entry
  * (for reshape promises) while it's been triggered and completed.
  *
@@ -566,6 +817,16 @@ parsec_get_copy_reshape_inline(parsec_execution_stream_t *es,
     data_repo_entry_t *reshape_repo_entry = NULL;
     data_repo_t *setup_repo;
     parsec_key_t setup_repo_key;
+    const parsec_flow_t *flow = NULL;
+    int read_only;
+
+    for( int i = 0; (i < MAX_PARAM_COUNT) && (NULL != task->task_class->in[i]); i++ ) {
+        if( dep_flow_index == task->task_class->in[i]->flow_index ) {
+            flow = task->task_class->in[i];
+            break;
+        }
+    }
+    read_only = parsec_reshape_flow_is_read_only(flow);
 
     /* Set up the reshaping promise */
     reshape_repo_entry = data_repo_lookup_entry(reshape_repo, reshape_entry_key);
@@ -583,7 +844,8 @@ parsec_get_copy_reshape_inline(parsec_execution_stream_t *es,
                                       &setup_repo,
                                       &setup_repo_key,
                                       NULL,
-                                      PARSEC_UNFULFILLED_RESHAPE_PROMISE);
+                                      PARSEC_UNFULFILLED_RESHAPE_PROMISE,
+                                      read_only);
 
 
 #if defined(PARSEC_DEBUG_NOISIER) || defined(PARSEC_DEBUG_PARANOID)
@@ -640,8 +902,9 @@ parsec_get_copy_reshape_inline(parsec_execution_stream_t *es,
  * a tile from the datacollection.
  * If a reshape needs to be performed, it is done using an inline reshape
  * promise, i.e., creating and fulfilling a local future promise (only
- * the current task instance is involved). Each thread accessing the same
- * original tile on the matrix will create a new reshaped copy.
+ * the current task instance is involved). Tasks only reading the same
+ * original tile on the matrix share one reshaped copy through the reshape
+ * cache, the others create their own.
  * Used in data_lookup_of for the second-level reshaping (the local one, not
  * set up by predecessors)
  * The reshape promise is stored on the task instance repo entry
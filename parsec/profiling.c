@@ -15,6 +15,7 @@
 #include <inttypes.h>
 #include <pthread.h>
 #include <errno.h>
+#include <time.h>
 #if defined(PARSEC_PROFILING_USE_MMAP)
 #include <sys/mman.h>
 #endif
@@ -27,6 +28,7 @@
 #include "parsec/data_distribution.h"
 #include "parsec/utils/debug.h"
 #include "parsec/class/list.h"
+#include "parsec/class/lifo.h"
 #include "parsec/parsec_hwloc.h"
 #include "parsec/os-spec-timing.h"
 #include "parsec/sys/atomic.h"
@@ -42,6 +44,7 @@
 #endif /* defined(HOST_NAME_MAX) */
 
 int parsec_profile_enabled = 0;
+int parsec_profile_sampling = 0;
 static int __profile_initialized = 0;  /* not initialized */
 
 /**
@@ -88,15 +91,19 @@ static parsec_profiling_info_t *parsec_profiling_infos = NULL;
 static char  parsec_profiling_last_error[MAX_PROFILING_ERROR_STRING_LEN+1] = { '\0', };
 static int   parsec_profiling_raise_error = 0;
 
-/* File backend globals. */
+/* File backend globals. The segments are reserved with an atomic
+ * increment of file_backend_next_offset; the lock only serializes the
+ * extensions of the file. */
 static pthread_mutex_t file_backend_lock = PTHREAD_MUTEX_INITIALIZER;
-static off_t  file_backend_next_offset = 0;
-static size_t file_backend_size = 0;
+static volatile int64_t file_backend_next_offset = 0;
+static volatile int64_t file_backend_size = 0;
+static volatile int32_t file_backend_grow_requested = 0;
 static int    file_backend_fd = -1;
 
 /* File backend constants, computed at init time */
 static size_t event_buffer_size = 0;
-static int    parsec_profiling_file_multiplier = 1;
+static int    parsec_profiling_file_multiplier = 64;
+static int64_t file_backend_chunk = 0;
 static size_t event_avail_space = 0;
 static int file_backend_extendable;
 
@@ -105,6 +112,10 @@ static char *bpf_filename = NULL;
 PARSEC_TLS_DECLARE(tls_profiling);
 
 static int parsec_profiling_show_profiling_performance = 0;
+static int parsec_profiling_compact = 1;
+static int parsec_profiling_sample_rate = 1;
+static char *parsec_profiling_sample_rates = NULL;
+static int parsec_profiling_sample_window = 0;
 static parsec_profiling_perf_t parsec_profiling_global_perf[PERF_MAX];
 
 #define do_and_measure_perf( perf_counter, code ) do {                  \
@@ -123,33 +134,64 @@ static parsec_profiling_perf_t parsec_profiling_global_perf[PERF_MAX];
         pa->perf_number_calls++;                                        \
     } while(0)
 
+#if defined(PARSEC_PROFILING_USE_HELPER_THREAD)
+static void io_cmd_post_grow(void);
+#endif
+
 /**
- * Reserve space for the next batch of event. If the backend file
- * still has room for additional pages return the offset of the next
- * page, otherwise extend the backend file and return the offset of
- * the next page.
- * If the file cannot be extended, return a negative value.
+ * Extend the (sparse) backend file by chunks until it holds at least
+ * size bytes. Return -1 if the file cannot be extended.
  */
-static off_t find_free_segment(void)
+static int grow_backend_file(int64_t size)
 {
-    off_t my_offset;
+    int64_t new_size;
+    int rc = 0;
+
     do_and_measure_perf(PERF_WAITING,
       pthread_mutex_lock( &file_backend_lock ));
-    if( file_backend_next_offset + event_buffer_size > file_backend_size ) {
-        file_backend_size += parsec_profiling_file_multiplier * event_buffer_size;
+    if( file_backend_size < size && file_backend_extendable ) {
+        new_size = file_backend_size;
+        while( new_size < size )
+            new_size += file_backend_chunk;
         do_and_measure_perf(PERF_RESIZE,
-          if( ftruncate(file_backend_fd, file_backend_size) == -1 ) {
-              fprintf(stderr, "### Profiling: unable to resize backend file to %"PRIu64" bytes: %s\n",
-                      (uint64_t)file_backend_size, strerror(errno));
-              file_backend_extendable = 0;
-              pthread_mutex_unlock(&file_backend_lock);
-              return (off_t)-1;
-          });
-    }
-    my_offset = file_backend_next_offset;
-    file_backend_next_offset += event_buffer_size;
+          rc = ftruncate(file_backend_fd, new_size));
+        if( -1 == rc ) {
+            fprintf(stderr, "### Profiling: unable to resize backend file to %"PRIu64" bytes: %s\n",
+                    (uint64_t)new_size, strerror(errno));
+            file_backend_extendable = 0;
+        } else {
+            parsec_atomic_wmb();
+            file_backend_size = new_size;
+        }
+    }
+    if( file_backend_size < size ) rc = -1;
     pthread_mutex_unlock(&file_backend_lock);
-    return my_offset;
+    return rc;
+}
+
+/**
+ * Reserve space for the next batch of event. Return the offset of
+ * the next page, extending the backend file if the extensions done
+ * ahead of time (by the helper thread, if any) did not keep up.
+ * If the file cannot be extended, return a negative value.
+ */
+static off_t find_free_segment(void)
+{
+    int64_t my_offset;
+
+    my_offset = parsec_atomic_fetch_add_int64(&file_backend_next_offset, event_buffer_size);
+    if( my_offset + (int64_t)event_buffer_size > file_backend_size ) {
+        if( 0 != grow_backend_file(my_offset + event_buffer_size) )
+            return (off_t)-1;
+    }
+#if defined(PARSEC_PROFILING_USE_HELPER_THREAD)
+    /* Extend the file in the background when half of the last chunk is used */
+    if( (file_backend_size - my_offset) < file_backend_chunk / 2 &&
+        parsec_atomic_cas_int32(&file_backend_grow_requested, 0, 1) ) {
+        io_cmd_post_grow();
+    }
+#endif
+    return (off_t)my_offset;
 }
 
 /**
@@ -255,7 +297,7 @@ static void
 free_to_freelist(tl_freelist_t *fl, parsec_profiling_buffer_t *b)
 {
 #if !defined(PARSEC_PROFILING_USE_MMAP)
-    int ret;
+    ssize_t ret;
 #endif
     if( NULL == b )
         return;
@@ -270,22 +312,13 @@ free_to_freelist(tl_freelist_t *fl, parsec_profiling_buffer_t *b)
     if( NULL == b )
         return;
 #else
-    do_and_measure_perf(PERF_WAITING,
-      pthread_mutex_lock( &file_backend_lock ));
-    do_and_measure_perf(PERF_LSEEK,
-      ret = lseek(file_backend_fd, b->this_buffer_file_offset, SEEK_SET));
-    if(ret == (off_t)-1 ) {
-        fprintf(stderr, "Warning profiling system: seek in the events backend file at %ld failed: %s. Events trace will be truncated.\n",
-                (long)b->this_buffer_file_offset, strerror(errno));
-    } else {
-        do_and_measure_perf(PERF_WRITE,
-           ret = write(file_backend_fd, b, event_buffer_size));
-        if( (size_t)(ret) != event_buffer_size ) {
-            fprintf(stderr, "Warning profiling system: write in the events backend file at %ld failed: %s. Events trace will be truncated.\n",
-                     (long)b->this_buffer_file_offset, strerror(errno));
-        }
+    /* Positioned write, the segments do not overlap */
+    do_and_measure_perf(PERF_WRITE,
+       ret = pwrite(file_backend_fd, b, event_buffer_size, b->this_buffer_file_offset));
+    if( (size_t)(ret) != event_buffer_size ) {
+        fprintf(stderr, "Warning profiling system: write in the events backend file at %ld failed: %s. Events trace will be truncated.\n",
+                 (long)b->this_buffer_file_offset, strerror(errno));
     }
-    pthread_mutex_unlock( &file_backend_lock );
     profiling_assign_buffer_to_free_segment(b);
 #endif
 
@@ -307,121 +340,141 @@ free_to_freelist(tl_freelist_t *fl, parsec_profiling_buffer_t *b)
  *       the io_cmd_flush_counter, and signal this on the
  *       io_cmd_flush_cond. This means that all I/O operations
  *       enqueued prior to that command have been exectued.
+ *   if buffer == IO_CMD_GROW, the helper thread extends the backend
+ *       file ahead of the segment reservations.
  *   For all other values of buffer:
  *       buffer should be unmapped
  *       a new buffer should be mapped into the backend file
  *       that new buffer should be added to the buffers freelist of fl
  */
 typedef struct io_cmd_s {
+    parsec_list_item_t         super;   /**< to keep the unused commands in a lifo */
     struct io_cmd_s           *next;
     parsec_profiling_buffer_t *buffer;
     tl_freelist_t             *fl;
 } io_cmd_t;
 #define IO_CMD_STOP   ((void*)-1)
 #define IO_CMD_FLUSH  ((void*) 0)
+#define IO_CMD_GROW   ((void*) 1)
 
+/**
+ * Multiple producers, single consumer queue of commands. The producers
+ * push on a lock-free stack, and the helper thread detaches the whole
+ * stack at once and reverses it to execute the commands in order. The
+ * lock and condition are only used to put the helper thread to sleep
+ * when there is nothing to do.
+ */
 typedef struct io_cmd_queue_s {
-    io_cmd_t *next;
-    io_cmd_t *last;
-    pthread_mutex_t lock;
-    pthread_cond_t  cond;
+    io_cmd_t * volatile head;
+    volatile int32_t    sleeping;
+    pthread_mutex_t     lock;
+    pthread_cond_t      cond;
 } io_cmd_queue_t;
 static io_cmd_queue_t cmd_queue;
-static io_cmd_queue_t free_cmd_queue;
+static parsec_lifo_t  free_cmd_lifo;
 static pthread_t io_helper_thread_id;
 
 static int             io_cmd_flush_counter;
 static pthread_mutex_t io_cmd_flush_mutex;
 static pthread_cond_t  io_cmd_flush_cond;
 
-static io_cmd_t *io_cmd_allocate(void)
+static void io_cmd_post(parsec_profiling_buffer_t *buffer, tl_freelist_t *fl)
 {
-    io_cmd_t *cmd;
-    pthread_mutex_lock(&free_cmd_queue.lock);
-    if( free_cmd_queue.next == NULL ) {
-        pthread_mutex_unlock(&free_cmd_queue.lock);
-        cmd = (io_cmd_t*)malloc(sizeof(io_cmd_t));
-    } else {
-        cmd = free_cmd_queue.next;
-        free_cmd_queue.next = cmd->next;
-        pthread_mutex_unlock(&free_cmd_queue.lock);
+    io_cmd_t *cmd, *head;
+
+    cmd = (io_cmd_t*)parsec_lifo_pop(&free_cmd_lifo);
+    if( NULL == cmd ) {
+        cmd = (io_cmd_t*)parsec_lifo_item_alloc(&free_cmd_lifo, sizeof(io_cmd_t));
     }
-    return cmd;
-}
+    cmd->buffer = buffer;
+    cmd->fl = fl;
+    do {
+        head = cmd_queue.head;
+        cmd->next = head;
+    } while( !parsec_atomic_cas_ptr(&cmd_queue.head, head, cmd) );
 
-static void io_cmd_free(io_cmd_t *cmd)
-{
-    pthread_mutex_lock(&free_cmd_queue.lock);
-    cmd->next = free_cmd_queue.next;
-    free_cmd_queue.next = cmd;
-    pthread_mutex_unlock(&free_cmd_queue.lock);
+    /* The helper thread sets sleeping before checking the queue a last time */
+    if( cmd_queue.sleeping ) {
+        pthread_mutex_lock(&cmd_queue.lock);
+        pthread_cond_signal(&cmd_queue.cond);
+        pthread_mutex_unlock(&cmd_queue.lock);
+    }
 }
 
-static void io_cmd_queue_init(io_cmd_queue_t *queue)
+static void io_cmd_post_grow(void)
 {
-    queue->next = NULL;
-    queue->last = NULL;
-    pthread_mutex_init(&queue->lock, NULL);
-    pthread_cond_init(&queue->cond, NULL);
-
+    io_cmd_post(IO_CMD_GROW, NULL);
 }
 
-static void io_cmd_queue_destroy(io_cmd_queue_t *queue)
+static io_cmd_t *io_cmd_take_all(void)
 {
-    io_cmd_t *cmd;
-    pthread_mutex_lock(&queue->lock);
-    while( NULL != queue->next ) {
-        cmd = queue->next;
-        queue->next = cmd->next;
-        free(cmd);
-    }
-    queue->last = NULL;
-    pthread_mutex_unlock(&queue->lock);
-    pthread_mutex_destroy(&queue->lock);
-    pthread_cond_destroy(&queue->cond);
+    io_cmd_t *head, *next, *cmds = NULL;
+
+    do {
+        head = cmd_queue.head;
+    } while( NULL != head && !parsec_atomic_cas_ptr(&cmd_queue.head, head, NULL) );
+    /* Reverse the stack to get the commands in order */
+    for( ; NULL != head; head = next ) {
+        next = head->next;
+        head->next = cmds;
+        cmds = head;
+    }
+    return cmds;
 }
 
 static void *io_helper_thread_fct(void *_)
 {
     int stop = 0;
-    io_cmd_t *cmd;
+    io_cmd_t *cmd, *cmds;
     (void)_;
 
     while( stop == 0 ) {
-        pthread_mutex_lock(&cmd_queue.lock);
-        while( NULL == cmd_queue.next ) {
-            pthread_cond_wait(&cmd_queue.cond, &cmd_queue.lock);
+        while( NULL == (cmds = io_cmd_take_all()) ) {
+            pthread_mutex_lock(&cmd_queue.lock);
+            cmd_queue.sleeping = 1;
+            parsec_mfence();
+            if( NULL == cmd_queue.head )
+                pthread_cond_wait(&cmd_queue.cond, &cmd_queue.lock);
+            cmd_queue.sleeping = 0;
+            pthread_mutex_unlock(&cmd_queue.lock);
         }
-        cmd = cmd_queue.next;
-        if( cmd_queue.next == cmd_queue.last )
-            cmd_queue.last = NULL;
-        cmd_queue.next = cmd->next;
-        pthread_mutex_unlock(&cmd_queue.lock);
 
-        if( IO_CMD_FLUSH == cmd->buffer ) {
-            pthread_mutex_lock(&io_cmd_flush_mutex);
-            io_cmd_flush_counter++;
-            pthread_cond_signal(&io_cmd_flush_cond);
-            pthread_mutex_unlock(&io_cmd_flush_mutex);
-        } else if( IO_CMD_STOP == cmd->buffer ) {
-            stop = 1;
-        } else {
-            free_to_freelist(cmd->fl, cmd->buffer);
+        for( ; NULL != cmds; cmds = cmd->next ) {
+            cmd = cmds;
+            if( IO_CMD_FLUSH == cmd->buffer ) {
+                pthread_mutex_lock(&io_cmd_flush_mutex);
+                io_cmd_flush_counter++;
+                pthread_cond_signal(&io_cmd_flush_cond);
+                pthread_mutex_unlock(&io_cmd_flush_mutex);
+            } else if( IO_CMD_STOP == cmd->buffer ) {
+                stop = 1;
+            } else if( IO_CMD_GROW == cmd->buffer ) {
+                grow_backend_file(file_backend_next_offset + file_backend_chunk);
+                file_backend_grow_requested = 0;
+            } else {
+                free_to_freelist(cmd->fl, cmd->buffer);
+            }
+            parsec_lifo_push(&free_cmd_lifo, &cmd->super);
         }
-
-        io_cmd_free(cmd);
     }
 
-    io_cmd_queue_destroy(&cmd_queue);
-    io_cmd_queue_destroy(&free_cmd_queue);
+    while( NULL != (cmd = (io_cmd_t*)parsec_lifo_pop(&free_cmd_lifo)) ) {
+        parsec_lifo_item_free(&cmd->super);
+    }
+    PARSEC_OBJ_DESTRUCT(&free_cmd_lifo);
+    pthread_mutex_destroy(&cmd_queue.lock);
+    pthread_cond_destroy(&cmd_queue.cond);
 
     return NULL;
 }
 
 static void io_helper_thread_init(void)
 {
-    io_cmd_queue_init(&cmd_queue);
-    io_cmd_queue_init(&free_cmd_queue);
+    cmd_queue.head = NULL;
+    cmd_queue.sleeping = 0;
+    pthread_mutex_init(&cmd_queue.lock, NULL);
+    pthread_cond_init(&cmd_queue.cond, NULL);
+    PARSEC_OBJ_CONSTRUCT(&free_cmd_lifo, parsec_lifo_t);
     io_cmd_flush_counter = 0;
     pthread_mutex_init(&io_cmd_flush_mutex, NULL);
     pthread_cond_init(&io_cmd_flush_cond, NULL);
@@ -500,21 +553,40 @@ int parsec_profiling_init( int process_id )
                                  " (default is 1, must be at least large enough to hold the binary file header)",
                                  false, false, parsec_profiling_minimal_ebs, &parsec_profiling_minimal_ebs);
     parsec_mca_param_reg_int_name("profile", "file_resize", "Number of buffers per file resize"
-                                 " (default is 1)",
+                                 " (default is 64)",
                                  false, false, parsec_profiling_file_multiplier, &parsec_profiling_file_multiplier);
     parsec_mca_param_reg_int_name("profile", "show_profiling_performance", "Print profiling performance at the end of the execution"
                                       " (default is no/0)",
                                       false, false, parsec_profiling_show_profiling_performance, &parsec_profiling_show_profiling_performance);
+    parsec_mca_param_reg_int_name("profile", "compact", "Store the events with a compact delta encoding"
+                                  " (default is yes/1)",
+                                  false, false, parsec_profiling_compact, &parsec_profiling_compact);
+    parsec_mca_param_reg_int_name("profile", "sample_rate", "Trace one in N instances of each task class"
+                                  " (default is 1, all of them)",
+                                  false, false, parsec_profiling_sample_rate, &parsec_profiling_sample_rate);
+    parsec_mca_param_reg_string_name("profile", "sample_rates", "Comma separated list of NAME:N, to trace one in N"
+                                     " instances of the task class NAME instead of profile_sample_rate (default is none)",
+                                     false, false, NULL, &parsec_profiling_sample_rates);
+    parsec_mca_param_reg_int_name("profile", "sample_window", "Only trace the tasks starting during the first M"
+                                  " milliseconds of every second (default is 0, at any time)",
+                                  false, false, parsec_profiling_sample_window, &parsec_profiling_sample_window);
     if( parsec_profiling_minimal_ebs <= 0 )
         parsec_profiling_minimal_ebs = 10;
     if( parsec_profiling_file_multiplier <= 0 )
         parsec_profiling_file_multiplier = 1;
+    if( parsec_profiling_sample_rate <= 0 )
+        parsec_profiling_sample_rate = 1;
+    if( parsec_profiling_sample_window < 0 || parsec_profiling_sample_window >= 1000 )
+        parsec_profiling_sample_window = 0;
+    parsec_profile_sampling = (parsec_profiling_sample_rate > 1) || (parsec_profiling_sample_window > 0) ||
+        (NULL != parsec_profiling_sample_rates && '\0' != parsec_profiling_sample_rates[0]);
 
     event_buffer_size = parsec_profiling_minimal_ebs*ps;
     while( event_buffer_size < sizeof(parsec_profiling_binary_file_header_t) ){
         parsec_profiling_minimal_ebs++;
         event_buffer_size = parsec_profiling_minimal_ebs*ps;
     }
+    file_backend_chunk = (int64_t)parsec_profiling_file_multiplier * event_buffer_size;
 
     event_avail_space = event_buffer_size -
         ( (char*)&dummy_events_buffer.buffer[0] - (char*)&dummy_events_buffer);
@@ -560,6 +632,25 @@ int parsec_profiling_init( int process_id )
     } else
         parsec_profiling_add_information("cwd", "");
 
+    /* the sampling window, for the analysis tools to rescale the counts */
+    if( parsec_profiling_sample_window > 0 ) {
+        snprintf(buf, HOST_NAME_MAX, "%d", parsec_profiling_sample_window);
+        parsec_profiling_add_information("SAMPLE_WINDOW", buf);
+    }
+
+    /* the source of the timestamps, and the frequency of the TSC the
+     * durations were converted from */
+#if defined(PARSEC_HAVE_TIMER_TSC)
+    parsec_timer_init();
+    if( PARSEC_TIMER_SOURCE_TSC == parsec_timer_source ) {
+        parsec_profiling_add_information("TIMER_SOURCE", "TSC");
+        snprintf(buf, HOST_NAME_MAX, "%.0f", 4294967296.0 * 1e9 / (double)parsec_timer_tsc_mult);
+        parsec_profiling_add_information("TIMER_TSC_HZ", buf);
+    } else {
+        parsec_profiling_add_information("TIMER_SOURCE", "CLOCK_MONOTONIC");
+    }
+#endif  /* defined(PARSEC_HAVE_TIMER_TSC) */
+
 #if defined(PARSEC_PROFILING_USE_HELPER_THREAD)
     io_helper_thread_init();
 #endif
@@ -691,19 +782,7 @@ int parsec_profiling_fini( void )
     PARSEC_OBJ_DESTRUCT(&threads);
 
 #if defined(PARSEC_PROFILING_USE_HELPER_THREAD)
-    io_cmd_t *cmd = io_cmd_allocate();
-    cmd->buffer = IO_CMD_STOP;
-    cmd->fl = NULL;
-    cmd->next = NULL;
-    pthread_mutex_lock(&cmd_queue.lock);
-    if( NULL == cmd_queue.last ) {
-        cmd_queue.last = cmd_queue.next = cmd;
-    } else {
-        cmd_queue.last->next = cmd;
-        cmd_queue.last = cmd;
-    }
-    pthread_cond_signal(&cmd_queue.cond);
-    pthread_mutex_unlock(&cmd_queue.lock);
+    io_cmd_post(IO_CMD_STOP, NULL);
     pthread_join(io_helper_thread_id, NULL);
 #endif
     
@@ -729,7 +808,6 @@ int parsec_profiling_fini( void )
 #else
                 "#   %sTime Spent Allocating Buffers: %"PRIu64" %s. Number of malloc: %u\n"
                 "#   %sTime Spent Freeing Buffers: %"PRIu64" %s. Number of free: %u\n"
-                "#   %sTime Spent Seeking in file: %"PRIu64" %s. Number of lseeks: %u\n"
                 "#   %sTime Spent Writing (synchronously) Buffers: %"PRIu64" %s. Number of writes: %u\n"
 #endif
                 "#   %sTime Spent Resetting Buffers to 0: %"PRIu64" %s. Number of memset: %u\n"
@@ -747,7 +825,6 @@ int parsec_profiling_fini( void )
 #else
                 ti, pa[PERF_MALLOC].perf_time_spent, TIMER_UNIT, pa[PERF_MALLOC].perf_number_calls,
                 ti, pa[PERF_FREE].perf_time_spent, TIMER_UNIT, pa[PERF_FREE].perf_number_calls,
-                ti, pa[PERF_LSEEK].perf_time_spent, TIMER_UNIT, pa[PERF_LSEEK].perf_number_calls,
                 ti, pa[PERF_WRITE].perf_time_spent, TIMER_UNIT, pa[PERF_WRITE].perf_number_calls,
 #endif
                 ti, pa[PERF_MEMSET].perf_time_spent, TIMER_UNIT, pa[PERF_MEMSET].perf_number_calls,
@@ -781,6 +858,7 @@ int parsec_profiling_reset( void )
     PARSEC_LIST_ITERATOR(&threads, it, {
         t = (parsec_profiling_stream_t*)it;
         t->next_event_position = 0;
+        memset(&t->compact, 0, sizeof(parsec_profiling_compact_state_t));
         /* TODO: should reset the backend file / recreate it */
     });
 
@@ -788,6 +866,86 @@ int parsec_profiling_reset( void )
 }
 
 static pthread_mutex_t profiling_keyword_lock = PTHREAD_MUTEX_INITIALIZER;
+/**
+ * If the entry of the profile_sample_rates list at p is for name,
+ * return its rate, otherwise return 0.
+ */
+static int sample_rate_entry(const char *p, const char *name)
+{
+    size_t len = strlen(name);
+    int rate;
+
+    if( 0 != strncmp(p, name, len) || ':' != p[len] || ':' == p[len+1] )
+        return 0;
+    rate = atoi(p + len + 1);
+    return (rate > 0) ? rate : 1;
+}
+
+/**
+ * Return the sampling rate of the dictionary entry key_name, as given
+ * by the profile_sample_rates list or by default profile_sample_rate.
+ * The task classes can be named with or without their taskpool prefix
+ * (taskpool::class).
+ */
+static int32_t sample_rate_of(const char *key_name)
+{
+    const char *p = parsec_profiling_sample_rates;
+    const char *short_name = strstr(key_name, "::");
+    int rate;
+
+    while( NULL != p && '\0' != *p ) {
+        if( (0 != (rate = sample_rate_entry(p, key_name))) ||
+            (NULL != short_name && 0 != (rate = sample_rate_entry(p, short_name + 2))) )
+            return rate;
+        p = strchr(p, ',');
+        if( NULL != p ) p++;
+    }
+    return parsec_profiling_sample_rate;
+}
+
+int parsec_profiling_sample(int key, uint64_t event_id, uint32_t taskpool_id)
+{
+    int32_t rate;
+
+    if( key < 0 ) return 1;
+    if( !parsec_prof_keys[BASE_KEY(key)].sampled )
+        parsec_prof_keys[BASE_KEY(key)].sampled = 1;
+    rate = parsec_prof_keys[BASE_KEY(key)].sample_rate;
+    if( rate > 1 ) {
+        /* Mix the bits, as the keys of the tasks of a class are often linear */
+        uint64_t h = event_id * 0x9E3779B97F4A7C15ULL + taskpool_id;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+        if( 0 != h % (uint64_t)rate ) return 0;
+    }
+    if( parsec_profiling_sample_window > 0 ) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        if( ts.tv_nsec >= parsec_profiling_sample_window * 1000000L ) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Store the rates of the sampled dictionary entries in the information
+ * of the trace, as SAMPLE_RATE:<name>.
+ */
+static void add_sampling_infos(void)
+{
+    char info_value[16];
+    int i;
+
+    for( i = 0; i < parsec_prof_keys_count; i++ ) {
+        if( NULL == parsec_prof_keys[i].name || !parsec_prof_keys[i].sampled )
+            continue;
+        char info_key[strlen(parsec_prof_keys[i].name) + 16];
+        snprintf(info_key, sizeof(info_key), "SAMPLE_RATE:%s", parsec_prof_keys[i].name);
+        snprintf(info_value, sizeof(info_value), "%d", parsec_prof_keys[i].sample_rate);
+        parsec_profiling_add_information(info_key, info_value);
+    }
+}
+
 int parsec_profiling_add_dictionary_keyword( const char* key_name, const char* attributes,
                                             size_t info_length,
                                             const char* convertor_code,
@@ -829,6 +987,8 @@ int parsec_profiling_add_dictionary_keyword( const char* key_name, const char* a
         parsec_prof_keys[pos].convertor = strdup(convertor_code);
     else
         parsec_prof_keys[pos].convertor = NULL;
+    parsec_prof_keys[pos].sample_rate = sample_rate_of(key_name);
+    parsec_prof_keys[pos].sampled = 0;
 
     *key_start = START_KEY(pos);
     *key_end = END_KEY(pos);
@@ -881,6 +1041,7 @@ allocate_empty_buffer(tl_freelist_t *fl, off_t *offset, char type)
         res->buffer_type = type;
         switch( type ) {
         case PROFILING_BUFFER_TYPE_EVENTS:
+        case PROFILING_BUFFER_TYPE_COMPACT_EVENTS:
             res->this_buffer.nb_events = 0;
             break;
         case PROFILING_BUFFER_TYPE_DICTIONARY:
@@ -911,20 +1072,8 @@ static void write_down_existing_buffer(tl_freelist_t *fl,
       memset( &(buffer->buffer[count]), 0, event_avail_space - count ));
 
 #if defined(PARSEC_PROFILING_USE_HELPER_THREAD)
-    io_cmd_t *cmd = io_cmd_allocate();
-    cmd->buffer = buffer;
-    cmd->fl = fl;
-    cmd->next = NULL;
     do_and_measure_perf(PERF_USER_WAITING,
-       pthread_mutex_lock(&cmd_queue.lock));
-    if( NULL == cmd_queue.last ) {
-        cmd_queue.last = cmd_queue.next = cmd;
-    } else {
-        cmd_queue.last->next = cmd;
-        cmd_queue.last = cmd;
-    }
-    pthread_cond_signal(&cmd_queue.cond);
-    pthread_mutex_unlock(&cmd_queue.lock);
+       io_cmd_post(buffer, fl));
 #else
     free_to_freelist(fl, buffer);
 #endif
@@ -936,7 +1085,9 @@ static int switch_event_buffer( parsec_profiling_stream_t *context )
     parsec_profiling_buffer_t *old_buffer;
     off_t off;
 
-    new_buffer = allocate_empty_buffer(context->buffers_freelist, &off, PROFILING_BUFFER_TYPE_EVENTS);
+    new_buffer = allocate_empty_buffer(context->buffers_freelist, &off,
+                                       parsec_profiling_compact ? PROFILING_BUFFER_TYPE_COMPACT_EVENTS :
+                                                                  PROFILING_BUFFER_TYPE_EVENTS);
     if( NULL == new_buffer ) {  /* no more profiling */
         return PARSEC_ERR_OUT_OF_RESOURCE;
     }
@@ -952,6 +1103,7 @@ static int switch_event_buffer( parsec_profiling_stream_t *context )
     context->current_events_buffer = new_buffer;
     context->current_events_buffer_offset = off;
     context->next_event_position = 0;
+    memset(&context->compact, 0, sizeof(parsec_profiling_compact_state_t));
 
     return 0;
 }
@@ -989,6 +1141,38 @@ parsec_profiling_trace_flags(parsec_profiling_stream_t* context, int key,
 
     assert( key >= 2 );
 
+    if( parsec_profiling_compact ) {
+        parsec_profiling_output_base_event_t event;
+        size_t info_length = (NULL != info) ? (size_t)parsec_prof_keys[ BASE_KEY(key) ].info_length : 0;
+        char *pos;
+
+        /* Switch on the worst case length, the state is reset by the switch */
+        if( context->next_event_position + PARSEC_PROFILING_COMPACT_MAX_LENGTH + info_length > event_avail_space ) {
+            int rc = switch_event_buffer(context);
+            if( 0 > rc ) {
+                return rc;
+            }
+        }
+        assert( context->current_events_buffer->buffer_type == PROFILING_BUFFER_TYPE_COMPACT_EVENTS );
+        event.key = (uint16_t)key;
+        event.event_id = event_id;
+        event.taskpool_id = taskpool_id;
+        event.flags = ((NULL != info) ? PARSEC_PROFILING_EVENT_HAS_INFO : 0) | flags;
+        now = take_time();
+        event.timestamp = diff_time(parsec_start_time, now);
+
+        pos = &context->current_events_buffer->buffer[context->next_event_position];
+        this_event_length = parsec_profiling_compact_encode(&context->compact, pos, &event);
+        if( NULL != info ) {
+            memcpy(pos + this_event_length, info, info_length);
+            this_event_length += info_length;
+        }
+        context->current_events_buffer->this_buffer.nb_events++;
+        context->next_event_position += this_event_length;
+        context->nb_events++;
+        return 0;
+    }
+
     this_event_length = EVENT_LENGTH( key, (NULL != info) );
     assert( this_event_length < event_avail_space );
     if( context->next_event_position + this_event_length > event_avail_space ) {
@@ -1325,6 +1509,8 @@ int parsec_profiling_dbp_dump( void )
     profile_head->dictionary_offset = dump_dictionary(&nb_dico);
     profile_head->dictionary_size = nb_dico;
 
+    if( parsec_profile_sampling )
+        add_sampling_infos();
     profile_head->info_offset = dump_global_infos(&nb_infos);
     profile_head->info_size = nb_infos;
 
@@ -1345,20 +1531,7 @@ int parsec_profiling_dbp_dump( void )
     my_flush_ticket = io_cmd_flush_counter + 1;
     pthread_mutex_unlock(&io_cmd_flush_mutex);
 
-    io_cmd_t *cmd = io_cmd_allocate();
-    cmd->buffer = IO_CMD_FLUSH;
-    cmd->fl = NULL;
-    cmd->next = NULL;
-    do_and_measure_perf(PERF_USER_WAITING,
-       pthread_mutex_lock(&cmd_queue.lock));
-    if( NULL == cmd_queue.last ) {
-        cmd_queue.last = cmd_queue.next = cmd;
-    } else {
-        cmd_queue.last->next = cmd;
-        cmd_queue.last = cmd;
-    }
-    pthread_cond_signal(&cmd_queue.cond);
-    pthread_mutex_unlock(&cmd_queue.lock);
+    io_cmd_post(IO_CMD_FLUSH, NULL);
 
     pthread_mutex_lock(&io_cmd_flush_mutex);
     while( io_cmd_flush_counter != my_flush_ticket ) {
@@ -1390,8 +1563,13 @@ int parsec_profiling_dbp_dump( void )
     }
 #endif
 
-    /* Close the backend file */
+    /* Close the backend file, without the chunk extended ahead */
     pthread_mutex_lock(&file_backend_lock);
+    if( file_backend_next_offset < file_backend_size &&
+        ftruncate(file_backend_fd, file_backend_next_offset) == -1 ) {
+        fprintf(stderr, "### Profiling: unable to shrink backend file to %"PRIu64" bytes: %s\n",
+                (uint64_t)file_backend_next_offset, strerror(errno));
+    }
     close(file_backend_fd);
     file_backend_fd = -1;
     file_backend_extendable = 0;
@@ -1428,6 +1606,13 @@ int parsec_profiling_dbp_start( const char *basefile, const char *hr_info )
         file_backend_extendable = 0;
         return PARSEC_ERROR;
     }
+    file_backend_next_offset = 0;
+    file_backend_size = 0;
+    file_backend_grow_requested = 0;
+    if( 0 != grow_backend_file(file_backend_chunk) ) {
+        set_last_error("Profiling system: error: this process could not size the backend file. Events not logged.\n");
+        return PARSEC_ERROR;
+    }
 
     default_freelist = malloc(sizeof(tl_freelist_t));
     tl_freelist_buffer_t *e;
@@ -446,6 +446,41 @@ typedef struct {
  */
 extern int parsec_profile_enabled;
 
+/**
+ * @brief A boolean that is not 0 only if the tasks are sampled
+ * @details
+ * Set by the init call when one of the profile_sample_rate,
+ * profile_sample_rates or profile_sample_window MCA parameters asks
+ * to trace only some of the instances of the task classes.
+ */
+extern int parsec_profile_sampling;
+
+/**
+ * @brief Decide if an instance of a task class should be traced
+ * @details
+ * One in N instances of each task class is traced, N being the sampling
+ * rate of the dictionary entry of key. The instances are chosen with a
+ * hash of event_id and taskpool_id, so all the events of an instance
+ * agree. With a sampling window of M ms, only the instances starting
+ * during the first M ms of every second are traced. The rates of the
+ * sampled entries (SAMPLE_RATE:<name>) and the window (SAMPLE_WINDOW) are
+ * stored in the information of the trace, for the analysis tools to
+ * rescale the counts.
+ * @param[in] key the start key of the task class
+ * @param[in] event_id the event id of the instance
+ * @param[in] taskpool_id the taskpool id of the instance
+ * @return 1 if the instance should be traced, 0 otherwise
+ * @remark thread safe
+ */
+int parsec_profiling_sample(int key, uint64_t event_id, uint32_t taskpool_id);
+
+/**
+ * @brief Convenience macro to decide if an instance should be traced,
+ * without a call when sampling is disabled
+ */
+#define PARSEC_PROFILING_SAMPLED(key, event_id, object_id)              \
+    (!parsec_profile_sampling || parsec_profiling_sample((key), (event_id), (object_id)))
+
 /**
  * @brief Enable the profiling of new events.
  * @details
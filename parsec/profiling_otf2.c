@@ -79,6 +79,7 @@ PARSEC_OBJ_CLASS_INSTANCE(parsec_profiling_info_t, parsec_list_item_t,
                    NULL, NULL);
 
 int parsec_profile_enabled = 0;
+int parsec_profile_sampling = 0;  /* no sampling with OTF2 */
 
 PARSEC_TLS_DECLARE(tls_profiling);
 static parsec_list_t threads;
@@ -1152,6 +1153,12 @@ void parsec_profiling_disable(void)
     parsec_profile_enabled = 0;
 }
 
+int parsec_profiling_sample(int key, uint64_t event_id, uint32_t taskpool_id)
+{
+    (void)key; (void)event_id; (void)taskpool_id;
+    return 1;
+}
+
 void profiling_save_dinfo(const char *key, double value)
 {
     char *svalue;
@@ -114,6 +114,8 @@ struct parsec_reshape_promise_description_s {
                                                               * the same reshape promise (workaround comm engine) */
 #endif
     uint32_t                              remote_recv_guard; /* Use to prevent re-reshaping after reception */
+    uint32_t                              read_only;    /* None of the consumers modifies the reshaped copy,
+                                                         * it can be shared through the reshape cache */
 };
 
 /* Callback to do a local reshaping of a datacopy */
@@ -122,6 +124,29 @@ void parsec_local_reshape(parsec_base_future_t *future,
                           parsec_execution_stream_t *es,
                           parsec_task_t *task);
 
+/**
+ * Reshape cache: the reshaped copies only read by their consumers are kept
+ * on the parsec_data_t of their source copy, keyed by the source copy, its
+ * version and the reshape description, such that all the consumers
+ * requesting the same shape share one converted copy. Entries are evicted
+ * when the version of the source (or of the reshaped copy) changes, when
+ * the source copy is detached from its data, and when the taskpool that
+ * built them completes.
+ */
+
+/* Return the cached reshaped copy (retained) or NULL */
+parsec_data_copy_t *parsec_reshape_cache_lookup(parsec_data_copy_t *source,
+                                                const struct parsec_dep_type_description_s *local);
+/* Keep reshape (retained by the cache) as the shape local of source, built by tp */
+void parsec_reshape_cache_insert(parsec_data_copy_t *source,
+                                 const struct parsec_dep_type_description_s *local,
+                                 parsec_data_copy_t *reshape,
+                                 const parsec_taskpool_t *tp);
+/* Evict the entries of source from the cache of data (all if source is NULL) */
+void parsec_reshape_cache_purge(parsec_data_t *data, parsec_data_copy_t *source);
+/* Evict the entries built by the taskpool tp from all the caches */
+void parsec_reshape_cache_evict_taskpool(const parsec_taskpool_t *tp);
+
 
 
 struct remote_dep_output_param_s {
@@ -9,6 +9,7 @@
 #include "parsec/debug_marks.h"
 #include "parsec/data.h"
 #include "parsec/papi_sde.h"
+#include "parsec/live_metrics.h"
 #include "parsec/interfaces/dtd/insert_function_internal.h"
 #include "parsec/remote_dep.h"
 #include "parsec/class/dequeue.h"
@@ -16,6 +17,7 @@
 #include "parsec/parsec_binary_profile.h"
 
 #include "parsec/parsec_internal.h"
+#include "parsec/data_compress.h"
 
 #if defined(PARSEC_DEBUG)
 static int64_t count_reshaping = 0;
@@ -41,6 +43,10 @@ static int parsec_param_nb_tasks_extracted = 20;
  */
 static size_t parsec_param_short_limit = RDEP_MSG_SHORT_LIMIT;
 static int parsec_param_enable_aggregate = 0;
+/* Local reshapes are done by the native datatype engine whenever possible */
+static int parsec_param_native_reshape = 1;
+/* Reshaped copies only read by their consumers are shared through the reshape cache */
+static int parsec_param_reshape_cache = 1;
 
 parsec_mempool_t *parsec_remote_dep_cb_data_mempool;
 
@@ -113,11 +119,13 @@ parsec_execution_stream_t parsec_comm_es = {
 #endif /* PARSEC_PROF_TRACE */
     .scheduler_object = NULL,
     .next_task = NULL,
+    .live_metrics = NULL,
 #if defined(PARSEC_SIM)
     .largest_simulation_date = 0,
 #endif
 #if defined(PARSEC_PROF_PINS)
     .pins_events_cb = {{0}},
+    .pins_events_mask = 0,
 #endif  /* defined(PARSEC_PROF_PINS) */
 #if defined(PARSEC_PROF_RUSAGE_EU)
 #if defined(PARSEC_HAVE_GETRUSAGE) || !defined(__bgp__)
@@ -250,6 +258,10 @@ static void remote_dep_mpi_params(parsec_context_t* context) {
 #endif
     parsec_mca_param_reg_int_name("runtime", "comm_aggregate", "Aggregate multiple dependencies in the same short message (1=true,0=false).",
                                   false, false, parsec_param_enable_aggregate, &parsec_param_enable_aggregate);
+    parsec_mca_param_reg_int_name("runtime", "comm_native_reshape", "Perform the local reshapes with the native datatype engine, directly on the worker threads, instead of delegating them to MPI on the communication thread (1=true,0=false). Datatypes the native engine cannot handle still go through MPI.",
+                                  false, false, parsec_param_native_reshape, &parsec_param_native_reshape);
+    parsec_mca_param_reg_int_name("runtime", "comm_reshape_cache", "Share one reshaped copy among all the consumers only reading the same version of a data with the same shape, instead of converting the data for each of them (1=true,0=false).",
+                                  false, false, parsec_param_reshape_cache, &parsec_param_reshape_cache);
 }
 
 int
@@ -279,6 +291,8 @@ remote_dep_dequeue_init(parsec_context_t* context)
         return 1;
     }
     parsec_communication_engine_up = 0;  /* we have communication capabilities */
+    if( parsec_param_native_reshape )
+        parsec_type_native_init();
 
     MPI_Query_thread( &thread_level_support );
     if( thread_level_support == MPI_THREAD_SINGLE ||
@@ -395,6 +409,7 @@ remote_dep_dequeue_fini(parsec_context_t* context)
     PARSEC_OBJ_DESTRUCT(&dep_cmd_queue);
     assert(NULL == parsec_dequeue_pop_front(&dep_cmd_fifo));
     PARSEC_OBJ_DESTRUCT(&dep_cmd_fifo);
+    parsec_type_native_fini();
     mpi_initialized = 0;
 
 #if defined(PARSEC_DEBUG)
@@ -470,9 +485,18 @@ remote_dep_dequeue_off(parsec_context_t* context)
 static void
 remote_dep_mpi_initialize_execution_stream(parsec_context_t *context)
 {
+#if defined(PARSEC_PROF_TRACE)
+    /* Keep the profiling stream of the communication thread, a stream
+     * cannot be shared with the first computation thread */
+    parsec_profiling_stream_t *es_profile = parsec_comm_es.es_profile;
+#endif
     memcpy(&parsec_comm_es, context->virtual_processes[0]->execution_streams[0],
            sizeof(parsec_execution_stream_t));
+#if defined(PARSEC_PROF_TRACE)
+    parsec_comm_es.es_profile = es_profile;
+#endif
     parsec_comm_es.next_task = (parsec_task_t*)0xdeadbeef;  /* should not be NULL, but it should also never be used */
+    parsec_live_stream_init(&parsec_comm_es, -1, 0);
 }
 
 void* remote_dep_dequeue_main(parsec_context_t* context)
@@ -587,6 +611,66 @@ remote_dep_dequeue_send(parsec_execution_stream_t* es, int rank,
     return 1;
 }
 
+/**
+ * Retrieve the native layouts of both sides of a local copy. Datatypes that
+ * have not been decoded yet are decoded only if the calling thread is allowed
+ * to call into MPI, otherwise the native copy is declined.
+ *
+ * @return 0 if the copy can be done by parsec_type_native_copy, with both
+ * layouts to be released by the caller, -1 otherwise.
+ */
+static inline int
+remote_dep_native_layouts(parsec_datatype_t dst_datatype, parsec_datatype_t src_datatype,
+                          int can_decode,
+                          parsec_type_native_layout_t **dst_layout,
+                          parsec_type_native_layout_t **src_layout)
+{
+    if( !parsec_param_native_reshape ) return -1;
+    if( (NULL == (*src_layout = parsec_type_native_find(src_datatype))) &&
+        (!can_decode || (NULL == (*src_layout = parsec_type_native_decode(src_datatype)))) )
+        return -1;
+    if( (NULL == (*dst_layout = parsec_type_native_find(dst_datatype))) &&
+        (!can_decode || (NULL == (*dst_layout = parsec_type_native_decode(dst_datatype)))) ) {
+        parsec_type_native_release(*src_layout);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Perform a local copy with the native datatype engine, if both layouts are
+ * supported.
+ *
+ * @return 0 if the copy has been done, -1 otherwise.
+ */
+static int
+remote_dep_native_copy(parsec_data_copy_t *dst, int64_t dst_displ, parsec_datatype_t dst_datatype, uint64_t dst_count,
+                       parsec_data_copy_t *src, int64_t src_displ, parsec_datatype_t src_datatype, uint64_t src_count,
+                       int can_decode)
+{
+    parsec_type_native_layout_t *dst_layout, *src_layout;
+    int rc;
+
+    if( 0 != remote_dep_native_layouts(dst_datatype, src_datatype, can_decode, &dst_layout, &src_layout) )
+        return -1;
+    rc = parsec_type_native_copy((char*)PARSEC_DATA_COPY_GET_PTR(dst) + dst_displ, dst_layout, dst_count,
+                                 (char*)PARSEC_DATA_COPY_GET_PTR(src) + src_displ, src_layout, src_count);
+    parsec_type_native_release(dst_layout);
+    parsec_type_native_release(src_layout);
+    return (PARSEC_SUCCESS == rc) ? 0 : -1;
+}
+
+/**
+ * The content of dst is about to be overwritten without changing its version:
+ * evict the reshaped copies derived from it.
+ */
+static inline void
+remote_dep_reshape_cache_invalidate(parsec_data_copy_t *dst)
+{
+    if( (NULL != dst) && (NULL != dst->original) && (NULL != dst->original->reshape_cache) )
+        parsec_reshape_cache_purge(dst->original, dst);
+}
+
 void parsec_remote_dep_memcpy(parsec_execution_stream_t* es,
                               parsec_taskpool_t* tp,
                               parsec_data_copy_t *dst,
@@ -594,11 +678,26 @@ void parsec_remote_dep_memcpy(parsec_execution_stream_t* es,
                               parsec_dep_data_description_t* data)
 {
     assert( dst );
+    remote_dep_reshape_cache_invalidate(dst);
+    /* dst cannot be compressed while it is being written */
+    PARSEC_OBJ_RETAIN(dst);
+    if( 0 != parsec_data_compress_nb_collections ) {
+        parsec_data_compress_touch(dst);
+        parsec_data_compress_touch(src);
+    }
+    /* if the native datatype engine supports both layouts do the reshaping in place */
+    if( 0 == remote_dep_native_copy(dst, data->local.dst_displ, data->local.dst_datatype, data->local.dst_count,
+                                    src, data->local.src_displ, data->local.src_datatype, data->local.src_count,
+                                    parsec_ce.parsec_context->flags & PARSEC_CONTEXT_FLAG_COMM_MT) ) {
+        PARSEC_DATA_COPY_RELEASE(dst);
+        return;
+    }
     /* if the communication engine supports multithreads do the reshaping in place */
     if( parsec_ce.parsec_context->flags & PARSEC_CONTEXT_FLAG_COMM_MT ) {
         if( 0 == parsec_ce.reshape(&parsec_ce, es,
                                    dst, data->local.dst_displ, data->local.dst_datatype, data->local.dst_count,
                                    src, data->local.src_displ, data->local.src_datatype, data->local.src_count) ) {
+            PARSEC_DATA_COPY_RELEASE(dst);
             return;
         }
     }
@@ -617,6 +716,7 @@ void parsec_remote_dep_memcpy(parsec_execution_stream_t* es,
     item->cmd.memcpy.destination  = dst;
     item->cmd.memcpy.layout       = data->local;
 
+    /* dst remains retained until the copy is done */
     PARSEC_OBJ_RETAIN(src);
     remote_dep_inc_flying_messages(tp);
 
@@ -658,6 +758,27 @@ reshape_copy_allocate(parsec_dep_type_description_t* data)
     return dc;
 }
 
+/**
+ *
+ * Fulfill a reshape promise with a new reshaped copy, and keep this copy in
+ * the reshape cache if it can be shared with other consumers.
+ *
+ * @param[inout] future future for the reshaping.
+ * @param[in] dt input arguments for the reshaping.
+ * @param[in] reshape_data the reshaped copy.
+ * @param[in] tp the taskpool of the consumer, NULL if unknown.
+ */
+static inline void
+reshape_promise_fulfill(void *future,
+                        parsec_reshape_promise_description_t *dt,
+                        parsec_data_copy_t *reshape_data,
+                        parsec_taskpool_t *tp)
+{
+    if( parsec_param_reshape_cache && dt->read_only )
+        parsec_reshape_cache_insert(dt->data, dt->local, reshape_data, tp);
+    parsec_future_set(future, reshape_data);
+}
+
 /**
  *
  * Routine to fulfilled a reshape promise by the current thread
@@ -707,12 +828,63 @@ void parsec_local_reshape(parsec_base_future_t *future,
     }
 #endif
 
+    /* if another consumer already did the same reshaping share its copy */
+    if( parsec_param_reshape_cache && dt->read_only ) {
+        parsec_data_copy_t *reshape_data = parsec_reshape_cache_lookup(dt->data, dt->local);
+        if( NULL != reshape_data ) {
+            PARSEC_DEBUG_VERBOSE(2, parsec_debug_output,
+                                 "th%d RESHAPE_PROMISE COMPLETED CACHED to [%p:%p:%s -> %p:%p:%s] for %s fut %p",
+                                 es->th_id, dt->data, dt->data->dtt, type_name_src,
+                                 reshape_data, dt->local->dst_datatype, type_name_dst, task_string, future);
+            parsec_future_set(future, reshape_data);
+            return;
+        }
+    }
+
+    /* the source may have been compressed since it was produced */
+    if( 0 != parsec_data_compress_nb_collections )
+        parsec_data_compress_touch(dt->data);
+
+    /* if the native datatype engine supports both layouts do the reshaping in
+     * place. If the native copy fails the copy is kept for the MPI reshaping. */
+    parsec_data_copy_t *reshape_data = NULL;
+    {
+        parsec_type_native_layout_t *dst_layout, *src_layout;
+        int can_decode = (es->virtual_process->parsec_context->flags & PARSEC_CONTEXT_FLAG_COMM_MT)
+                          || (tp == NULL && task == NULL);
+        if( 0 == remote_dep_native_layouts(dt->local->dst_datatype, dt->local->src_datatype, can_decode,
+                                           &dst_layout, &src_layout) ) {
+            int rc;
+
+            reshape_data = reshape_copy_allocate(dt->local);
+            rc = parsec_type_native_copy((char*)PARSEC_DATA_COPY_GET_PTR(reshape_data) + dt->local->dst_displ,
+                                         dst_layout, dt->local->dst_count,
+                                         (char*)PARSEC_DATA_COPY_GET_PTR(dt->data) + dt->local->src_displ,
+                                         src_layout, dt->local->src_count);
+            parsec_type_native_release(dst_layout);
+            parsec_type_native_release(src_layout);
+            if( PARSEC_SUCCESS == rc ) {
+                PARSEC_DEBUG_VERBOSE(2, parsec_debug_output,
+                                     "th%d RESHAPE_PROMISE COMPLETED NATIVE to [%p:%p:%s -> %p:%p:%s] for %s fut %p",
+                                     es->th_id, dt->data, dt->data->dtt, type_name_src,
+                                     reshape_data, dt->local->dst_datatype, type_name_dst, task_string, future);
+
+                reshape_promise_fulfill(future, dt, reshape_data, tp);
+
+#if defined(PARSEC_DEBUG)
+                parsec_atomic_fetch_add_int64(&count_reshaping,1);
+#endif
+                return;
+            }
+        }
+    }
 
     /* if MPI is multithreaded do not thread-shift the sendrecv */
     if( (es->virtual_process->parsec_context->flags & PARSEC_CONTEXT_FLAG_COMM_MT)
             || (tp == NULL && task == NULL)/* || I AM COMM THREAD */)
     {
-        parsec_data_copy_t *reshape_data = reshape_copy_allocate(dt->local);
+        if( NULL == reshape_data )
+            reshape_data = reshape_copy_allocate(dt->local);
 
         PARSEC_DEBUG_VERBOSE(2, parsec_debug_output,
                              "th%d RESHAPE_PROMISE COMPLETED COMP-THREAD to [%p:%p:%s -> %p:%p:%s] for %s fut %p",
@@ -723,7 +895,7 @@ void parsec_local_reshape(parsec_base_future_t *future,
                           reshape_data, dt->local->dst_displ, dt->local->dst_datatype, dt->local->dst_count,
                           dt->data, dt->local->src_displ, dt->local->src_datatype, dt->local->src_count);
 
-        parsec_future_set(future, reshape_data);
+        reshape_promise_fulfill(future, dt, reshape_data, tp);
 
 #if defined(PARSEC_DEBUG)
         parsec_atomic_fetch_add_int64(&count_reshaping,1);
@@ -742,7 +914,7 @@ void parsec_local_reshape(parsec_base_future_t *future,
     item->priority = 0;
     item->cmd.memcpy.taskpool    = tp;
     item->cmd.memcpy.source      = dt->data;
-    item->cmd.memcpy.destination = NULL;
+    item->cmd.memcpy.destination = reshape_data;  /* allocated by the comm thread if NULL */
     item->cmd.memcpy.layout      = *(dt->local);
 
     item->cmd.memcpy_reshape.future = (parsec_datacopy_future_t *)future;
@@ -1210,6 +1382,7 @@ remote_dep_dequeue_nothread_progress(parsec_execution_stream_t* es,
         goto have_same_pos;
     case DEP_MEMCPY:
         remote_dep_nothread_memcpy(es, item);
+        PARSEC_DATA_COPY_RELEASE(item->cmd.memcpy.destination);
         break;
     case DEP_MEMCPY_RESHAPE:
         local_dep_nothread_reshape(es, item);
@@ -1418,10 +1591,19 @@ static int remote_dep_nothread_memcpy(parsec_execution_stream_t* es,
                          (char*)PARSEC_DATA_COPY_GET_PTR(cmd->memcpy.destination) + cmd->memcpy.layout.dst_displ, cmd->memcpy.layout.dst_datatype,
                          cmd->memcpy.layout.dst_count);
 
-    int rc = parsec_ce.reshape(&parsec_ce, es,
+    /* We are allowed to call into MPI: decode the layouts such that the next
+     * local copies between the same datatypes are done on the worker threads. */
+    int rc = remote_dep_native_copy(cmd->memcpy.destination, cmd->memcpy.layout.dst_displ, cmd->memcpy.layout.dst_datatype, cmd->memcpy.layout.dst_count,
+                                    cmd->memcpy.source, cmd->memcpy.layout.src_displ, cmd->memcpy.layout.src_datatype, cmd->memcpy.layout.src_count,
+                                    1);
+    if( 0 != rc ) {
+        rc = parsec_ce.reshape(&parsec_ce, es,
                                cmd->memcpy.destination, cmd->memcpy.layout.dst_displ, cmd->memcpy.layout.dst_datatype, cmd->memcpy.layout.dst_count,
                                cmd->memcpy.source, cmd->memcpy.layout.src_displ, cmd->memcpy.layout.src_datatype, cmd->memcpy.layout.src_count);
+    }
 
+    /* A consumer may have reshaped the destination while the copy was pending */
+    remote_dep_reshape_cache_invalidate(cmd->memcpy.destination);
     PARSEC_DATA_COPY_RELEASE(cmd->memcpy.source);
     remote_dep_dec_flying_messages(item->cmd.memcpy.taskpool);
     (void)es;
@@ -1440,7 +1622,9 @@ static int local_dep_nothread_reshape(parsec_execution_stream_t* es,
 {
 
     dep_cmd_t* cmd = &item->cmd;
-    cmd->memcpy.destination = reshape_copy_allocate(item->cmd.memcpy_reshape.dt->local);
+    /* the worker thread may have allocated the copy before a failed native copy */
+    if( NULL == cmd->memcpy.destination )
+        cmd->memcpy.destination = reshape_copy_allocate(item->cmd.memcpy_reshape.dt->local);
 
 #if defined(PARSEC_DEBUG) || defined(PARSEC_DEBUG_NOISIER)
     char task_string[MAX_TASK_STRLEN]="NULL TASK";
@@ -1461,7 +1645,8 @@ static int local_dep_nothread_reshape(parsec_execution_stream_t* es,
     int rc = remote_dep_nothread_memcpy(es, item);
     assert(MPI_SUCCESS == rc);
 
-    parsec_future_set(item->cmd.memcpy_reshape.future, cmd->memcpy.destination);
+    reshape_promise_fulfill(item->cmd.memcpy_reshape.future, item->cmd.memcpy_reshape.dt, cmd->memcpy.destination,
+                            item->cmd.memcpy.taskpool);
 
     /*Not working if rescheduled by commthread, thus future trigger routines return ASYNC */
     /*__parsec_schedule(es, item->cmd.memcpy_reshape.task, 0);*/
@@ -1523,6 +1708,7 @@ static int remote_dep_nothread_send(parsec_execution_stream_t* es,
                         es->virtual_process->parsec_context->my_rank,
                         peer, deps->msg, position, MPI_PACKED, MPI_COMM_WORLD);
     parsec_ce.send_am(&parsec_ce, REMOTE_DEP_ACTIVATE_TAG, peer, packed_buffer, position);
+    parsec_live_peer(peer, 1, 0, position, 0);
     TAKE_TIME(es->es_profile, MPI_Activate_ek, event_id);
     DEBUG_MARK_CTL_MSG_ACTIVATE_SENT(peer, (void*)&deps->msg, &deps->msg);
 
@@ -1722,6 +1908,11 @@ remote_dep_mpi_put_start(parsec_execution_stream_t* es,
                                    &source_memory_handle, &source_memory_handle_size);
 
         }
+        if( NULL != parsec_live_peers ) {
+            int dtt_size;
+            parsec_type_size(dtt, &dtt_size);
+            parsec_live_peer(item->cmd.activate.peer, 0, 0, (uint64_t)dtt_size * nbdtt, 0);
+        }
 
         parsec_ce_mem_reg_handle_t remote_memory_handle = item->cmd.activate.remote_memory_handle;
 
@@ -1876,6 +2067,8 @@ remote_dep_mpi_save_activate_cb(parsec_comm_engine_t *ce, parsec_ce_tag_t tag,
     int position = 0, length = msg_size, rc;
     parsec_remote_deps_t* deps = NULL;
 
+    parsec_live_peer(src, 0, 1, 0, msg_size);
+
     while(position < length) {
         deps = remote_deps_allocate(&parsec_remote_dep_context.freelist);
 
@@ -2066,6 +2259,11 @@ static void remote_dep_mpi_get_start(parsec_execution_stream_t* es,
                                    &receiver_memory_handle, &receiver_memory_handle_size);
 
         }
+        if( NULL != parsec_live_peers ) {
+            int dtt_size;
+            parsec_type_size(dtt, &dtt_size);
+            parsec_live_peer(from, 0, 0, 0, (uint64_t)dtt_size * nbdtt);
+        }
 
 #  if defined(PARSEC_DEBUG_NOISIER)
         MPI_Type_get_name(dtt, type_name, &len);
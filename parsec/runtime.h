@@ -579,6 +579,23 @@ void parsec_usage(void);
  */
 int32_t parsec_taskpool_set_priority( parsec_taskpool_t* taskpool, int32_t new_priority );
 
+/**
+ * @brief Change the share of the execution streams given to a taskpool
+ *
+ * @details
+ * The schedulers sharing the execution streams between the taskpools, such
+ * as the fair share scheduler (mca_sched=fs), give each taskpool with ready
+ * tasks a share of the selections proportional to its weight, whatever the
+ * priorities of the tasks of the other taskpools. The default weight of a
+ * taskpool is 1, a weight of 0 is raised to 1. The other schedulers ignore
+ * the weight. The new weight applies to the tasks scheduled after this call.
+ *
+ * @param[inout] taskpool the taskpool to weight
+ * @param[in] new_weight the new weight of the taskpool
+ * @return The weight of the taskpool before being assigned new_weight
+ */
+uint32_t parsec_taskpool_set_scheduling_weight( parsec_taskpool_t* taskpool, uint32_t new_weight );
+
 /**
  * @brief Human-readable print function for tasks
  *
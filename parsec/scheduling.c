@@ -15,7 +15,11 @@
 #include "parsec/os-spec-timing.h"
 #include "parsec/remote_dep.h"
 #include "parsec/scheduling.h"
+#include "parsec/data_internal.h"
+#include "parsec/data_distribution.h"
+#include "parsec/data_compress.h"
 #include "parsec/papi_sde.h"
+#include "parsec/live_metrics.h"
 
 #include "parsec/debug_marks.h"
 #include "parsec/ayudame.h"
@@ -121,6 +125,25 @@ int __parsec_context_wait_task( parsec_execution_stream_t* es,
 }
 #endif
 
+/*
+ * Notify the data collections providing an access method that a task starts
+ * using their data, so that they can account for the data actually in use.
+ */
+static void
+__parsec_access_task_data(parsec_task_t* task)
+{
+    const parsec_task_class_t* tc = task->task_class;
+    parsec_data_collection_t* dc;
+    parsec_data_t* data;
+
+    for( int i = 0; i < tc->nb_flows; i++ ) {
+        if( NULL == task->data[i].data_in ) continue;
+        data = task->data[i].data_in->original;
+        if( (NULL == data) || (NULL == (dc = data->dc)) || (NULL == dc->access) ) continue;
+        dc->access(dc, data->key);
+    }
+}
+
 int __parsec_execute( parsec_execution_stream_t* es,
                       parsec_task_t* task )
 {
@@ -149,6 +172,12 @@ int __parsec_execute( parsec_execution_stream_t* es,
         return PARSEC_HOOK_RETURN_ERROR;
     }
 
+    /* Restore the compressed tiles used by the task */
+    if( 0 != parsec_data_compress_nb_collections )
+        parsec_data_compress_task_data(task);
+    if( 0 != parsec_data_collection_nb_prefetch )
+        __parsec_access_task_data(task);
+
     PARSEC_PINS(es, EXEC_BEGIN, task);
     /* Try all the incarnations until one agree to execute. */
     do {
@@ -179,8 +208,8 @@ int __parsec_execute( parsec_execution_stream_t* es,
         rc = hook( es, task );
 #if defined(PARSEC_PROF_TRACE)
         task->prof_info.task_return_code = rc;
-        PARSEC_PINS(es, EXEC_END, task);
 #endif
+        PARSEC_PINS(es, EXEC_END, task);
         if( PARSEC_HOOK_RETURN_NEXT != rc ) {
             if( PARSEC_HOOK_RETURN_ASYNC != rc ) {
                 /* Let's assume everything goes just fine */
@@ -222,6 +251,8 @@ static inline int all_tasks_done(parsec_context_t* context)
 
 void parsec_taskpool_termination_detected(parsec_taskpool_t *tp)
 {
+    /* the reshaped copies shared by the tasks of the taskpool are not needed anymore */
+    parsec_reshape_cache_evict_taskpool(tp);
     if( NULL != tp->on_complete ) {
         (void)tp->on_complete( tp, tp->on_complete_data );
     }
@@ -271,6 +302,38 @@ int parsec_set_scheduler( parsec_context_t *parsec )
     return PARSEC_SUCCESS;
 }
 
+/*
+ * Advise the data collections providing a prefetch method about the data used
+ * by a task that just became ready: the data already attached to the task
+ * flows, and the data the task has affinity with. The affinity of a task class
+ * always designates the same collection, once the taskpool found it does not
+ * prefetch the affinity of the tasks of the class is not evaluated anymore.
+ */
+static void
+__parsec_prefetch_task_data(parsec_task_t* task)
+{
+    const parsec_task_class_t* tc = task->task_class;
+    int64_t tc_bit = (tc->task_class_id < 64) ? ((int64_t)1 << tc->task_class_id) : 0;
+    parsec_data_collection_t* dc;
+    parsec_data_ref_t ref;
+    parsec_data_t* data;
+
+    for( int i = 0; i < tc->nb_flows; i++ ) {
+        if( NULL == task->data[i].data_in ) continue;
+        data = task->data[i].data_in->original;
+        if( (NULL == data) || (NULL == (dc = data->dc)) || (NULL == dc->prefetch) ) continue;
+        dc->prefetch(dc, data->key);
+    }
+    if( (NULL != tc->data_affinity) && !(task->taskpool->no_prefetch_affinity & tc_bit) ) {
+        ref.dc = NULL;
+        tc->data_affinity(task, &ref);
+        if( (NULL != ref.dc) && (NULL != ref.dc->prefetch) )
+            ref.dc->prefetch(ref.dc, ref.key);
+        else if( (NULL != ref.dc) && (0 != tc_bit) )
+            (void)parsec_atomic_fetch_or_int64(&task->taskpool->no_prefetch_affinity, tc_bit);
+    }
+}
+
 /*
  * Dispatch a ring of tasks to the requested execution stream, using the provided
  * distance. This function provides little benefit by itself, but it allows to
@@ -322,6 +385,17 @@ __parsec_schedule(parsec_execution_stream_t* es,
     PARSEC_PAPI_SDE_COUNTER_ADD(PARSEC_PAPI_SDE_TASKS_ENABLED, len);
 #endif  /* defined(PARSEC_PAPI_SDE) */
 
+    if( NULL != es->live_metrics ) {
+        int nb = 0;
+        _LIST_ITEM_ITERATOR(task, &task->super, item, {nb++; });
+        parsec_live_scheduled(es->live_metrics, nb);
+    }
+
+    if( 0 != parsec_data_collection_nb_prefetch ) {
+        _LIST_ITEM_ITERATOR(task, &task->super, item,
+                            { __parsec_prefetch_task_data((parsec_task_t*)item); });
+    }
+
     ret = parsec_current_scheduler->module.schedule(es, tasks_ring, distance);
 
     return ret;
@@ -329,9 +403,11 @@ __parsec_schedule(parsec_execution_stream_t* es,
 
 /*
  * Schedule an array of rings of tasks with one entry per virtual process.
+ * The rings are collected in any order by the release of the dependencies,
+ * they are sorted by priority here, once, unless the scheduler does not need
+ * them sorted (PARSEC_SCHED_FLAG_UNORDERED_RINGS).
  * If an execution stream is provided, this function will save the highest
- * priority task (assuming the ring is ordered or the first task in the ring
- * otherwise) on the current execution stream virtual process as the next
+ * priority task on the current execution stream virtual process as the next
  * task to be executed on the provided execution stream. Everything else gets
  * pushed into the execution stream 0 of the corresponding virtual process.
  * If the provided execution stream is NULL, all tasks are delivered to their
@@ -347,6 +423,7 @@ int __parsec_schedule_vp(parsec_execution_stream_t* es,
 {
     parsec_execution_stream_t* target_es;
     const parsec_vp_t** vps = (const parsec_vp_t**)es->virtual_process->parsec_context->virtual_processes;
+    int sort = !(parsec_current_scheduler->module.flags & PARSEC_SCHED_FLAG_UNORDERED_RINGS);
     int ret = 0;
 
 #if  defined(PARSEC_DEBUG_PARANOID)
@@ -359,6 +436,9 @@ int __parsec_schedule_vp(parsec_execution_stream_t* es,
         for(int vp = 0; vp < es->virtual_process->parsec_context->nb_vp; vp++ ) {
             parsec_task_t* ring = task_rings[vp];
             if( NULL == ring ) continue;
+            if( sort )
+                ring = (parsec_task_t*)parsec_list_item_ring_sort(&ring->super,
+                                                                  parsec_execution_context_priority_comparator);
 
             target_es = vps[vp]->execution_streams[0];
 
@@ -374,6 +454,11 @@ int __parsec_schedule_vp(parsec_execution_stream_t* es,
         parsec_task_t* ring = task_rings[vp];
         if( NULL == ring ) continue;
 
+        /* the highest priority task is kept, whatever the scheduler */
+        if( sort || (vp == es->virtual_process->vp_id && NULL == es->next_task) )
+            ring = (parsec_task_t*)parsec_list_item_ring_sort(&ring->super,
+                                                              parsec_execution_context_priority_comparator);
+
         target_es = vps[vp]->execution_streams[0];
 
         if( vp == es->virtual_process->vp_id ) {
@@ -453,6 +538,8 @@ int __parsec_complete_execution( parsec_execution_stream_t *es,
         rc = task->task_class->complete_execution( es, task );
 
     PARSEC_PAPI_SDE_COUNTER_ADD(PARSEC_PAPI_SDE_TASKS_RETIRED, 1);
+    if( NULL != es->live_metrics )
+        es->live_metrics->shm->tasks_retired++;
     PARSEC_PINS(es, COMPLETE_EXEC_END, task);
     PARSEC_AYU_TASK_COMPLETE(task);
 
@@ -532,6 +619,30 @@ int __parsec_task_progress( parsec_execution_stream_t* es,
     return rc;
 }
 
+/*
+ * With persistent workers the end of a round is not a barrier: the master
+ * waits for the other streams to leave the task they may still be working
+ * on. A stream raises its busy flag before checking for the end of the round,
+ * so once all the taskpools are done a stream is either seen busy here, or
+ * sees the end of the round and does not select any task.
+ */
+static void __parsec_wait_for_idle_streams( parsec_context_t* context,
+                                            parsec_execution_stream_t* es )
+{
+    parsec_execution_stream_t* other;
+
+    parsec_mfence();
+    for(int vp = 0; vp < context->nb_vp; vp++) {
+        for(int th = 0; th < context->virtual_processes[vp]->nb_cores; th++) {
+            other = context->virtual_processes[vp]->execution_streams[th];
+            while( (other != es) && other->busy ) {
+                sched_yield();
+            }
+        }
+    }
+    parsec_atomic_rmb();
+}
+
 int __parsec_context_wait( parsec_execution_stream_t* es )
 {
     uint64_t misses_in_a_row;
@@ -539,6 +650,8 @@ int __parsec_context_wait( parsec_execution_stream_t* es )
     int32_t my_barrier_counter = parsec_context->__parsec_internal_finalization_counter;
     parsec_task_t* task;
     int nbiterations = 0, distance, rc;
+    /* Persistent workers run the rounds back to back, until the finalization */
+    int persistent = parsec_runtime_persistent_workers && !PARSEC_THREAD_IS_MASTER(es);
     struct timespec rqtp;
 
     rqtp.tv_sec = 0;
@@ -569,7 +682,12 @@ int __parsec_context_wait( parsec_execution_stream_t* es )
     /* Wait until all threads are here and the main thread signal the begining of the work */
     parsec_barrier_wait( &(parsec_context->barrier) );
 
-    if( parsec_context->__parsec_internal_finalization_in_progress ) {
+    /* A persistent worker released by the start barrier (the master marks the
+     * context before crossing it) may only see parsec_fini once out of the
+     * barrier: it still has to join the finalization barrier, at the end of
+     * the scheduling loop. */
+    if( parsec_context->__parsec_internal_finalization_in_progress &&
+        !(persistent && (PARSEC_CONTEXT_FLAG_WORKERS_LOOPING & parsec_context->flags)) ) {
         my_barrier_counter++;
         for(; my_barrier_counter <= parsec_context->__parsec_internal_finalization_counter; my_barrier_counter++ ) {
             parsec_barrier_wait( &(parsec_context->barrier) );
@@ -583,7 +701,8 @@ int __parsec_context_wait( parsec_execution_stream_t* es )
     }
 
   skip_first_barrier:
-    while( !all_tasks_done(parsec_context) ) {
+    while( persistent ? !parsec_context->__parsec_internal_finalization_in_progress
+                      : !all_tasks_done(parsec_context) ) {
 
         if(PARSEC_THREAD_IS_MASTER(es)) {
             /* Here we detach all dtd taskpools registered with us */
@@ -607,8 +726,19 @@ int __parsec_context_wait( parsec_execution_stream_t* es )
         }
         misses_in_a_row++;  /* assume we fail to extract a task */
 
+        if( persistent ) {
+            es->busy = 1;
+            parsec_mfence();
+            if( all_tasks_done(parsec_context) ) {  /* between two rounds */
+                es->busy = 0;
+                continue;
+            }
+        }
+
         if( NULL == (task = es->next_task) ) {
             task = parsec_current_scheduler->module.select(es, &distance);
+            if( NULL != es->live_metrics )
+                parsec_live_select(es->live_metrics, task, distance);
         } else {
             es->next_task = NULL;
             distance = 1;
@@ -622,10 +752,24 @@ int __parsec_context_wait( parsec_execution_stream_t* es )
 
             nbiterations++;
         }
+        if( persistent ) {
+            parsec_atomic_wmb();
+            es->busy = 0;
+        }
     }
 
     parsec_rusage_per_es(es, true);
 
+    if( parsec_runtime_persistent_workers ) {
+        if( persistent ) {
+            /* Join the finalization barrier of parsec_fini */
+            parsec_barrier_wait( &(parsec_context->barrier) );
+        } else {
+            __parsec_wait_for_idle_streams(parsec_context, es);
+        }
+        goto finalize_progress;
+    }
+
     /* We're all done ? */
     parsec_barrier_wait( &(parsec_context->barrier) );
 
@@ -747,8 +891,12 @@ int parsec_context_start( parsec_context_t* context )
         (void)parsec_remote_dep_on(context);
         /* Mark the context so that we will skip the initial barrier during the _wait */
         context->flags |= PARSEC_CONTEXT_FLAG_CONTEXT_ACTIVE;
-        /* Wake up the other threads */
-        parsec_barrier_wait( &(context->barrier) );
+        /* Wake up the other threads, persistent workers are woken up once */
+        if( !(PARSEC_CONTEXT_FLAG_WORKERS_LOOPING & context->flags) ) {
+            if( parsec_runtime_persistent_workers )
+                context->flags |= PARSEC_CONTEXT_FLAG_WORKERS_LOOPING;
+            parsec_barrier_wait( &(context->barrier) );
+        }
         /* we keep one extra reference on the context to make sure we only match this with an
          * explicit call to parsec_context_wait.
          */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/os-spec-timing.h"
+
+#if defined(PARSEC_HAVE_TIMER_TSC)
+#include <stdio.h>
+#include <string.h>
+#include <cpuid.h>
+#include "parsec/sys/atomic.h"
+
+/* How long the TSC is compared with CLOCK_MONOTONIC during the calibration */
+#define PARSEC_TIMER_CALIBRATION_NS  10000000ULL
+
+int parsec_timer_source = PARSEC_TIMER_SOURCE_UNKNOWN;
+uint64_t parsec_timer_tsc_mult = 0;
+
+static inline uint64_t parsec_timer_monotonic(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t parsec_timer_rdtsc(void)
+{
+    unsigned hi, lo;
+    __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ( (uint64_t)lo)|( ((uint64_t)hi)<<32 );
+}
+
+/**
+ * The TSC is usable if it is invariant (CPUID.80000007H:EDX[8]) and, when
+ * the kernel tells, if it is also the clocksource of the kernel: Linux
+ * demotes the TSC when it finds it unsynchronized between the cores.
+ */
+static int parsec_timer_detect(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    char clocksource[32];
+    FILE *f;
+
+    if( 0 == __get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007 )
+        return PARSEC_TIMER_SOURCE_MONOTONIC;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    if( !(edx & (1U << 8)) )
+        return PARSEC_TIMER_SOURCE_MONOTONIC;
+
+    f = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if( NULL != f ) {
+        int rc = fscanf(f, "%31s", clocksource);
+        fclose(f);
+        if( 1 == rc && 0 != strcmp(clocksource, "tsc") )
+            return PARSEC_TIMER_SOURCE_MONOTONIC;
+    }
+    return PARSEC_TIMER_SOURCE_TSC;
+}
+
+uint64_t parsec_timer_take_time_slow(void)
+{
+    if( PARSEC_TIMER_SOURCE_UNKNOWN == parsec_timer_source ) {
+        /* All the threads reach the same conclusion, the race is harmless */
+        parsec_timer_source = parsec_timer_detect();
+        if( PARSEC_TIMER_SOURCE_TSC == parsec_timer_source )
+            return parsec_timer_rdtsc();
+    }
+    return parsec_timer_monotonic();
+}
+
+/* Read CLOCK_MONOTONIC and the TSC at the same instant, keeping the
+ * tightest of a few attempts */
+static void parsec_timer_sample(uint64_t *tsc, uint64_t *ns)
+{
+    uint64_t t0, t1, best = UINT64_MAX;
+    int i;
+    for( i = 0; i < 8; i++ ) {
+        t0 = parsec_timer_rdtsc();
+        uint64_t now = parsec_timer_monotonic();
+        t1 = parsec_timer_rdtsc();
+        if( t1 - t0 < best ) {
+            best = t1 - t0;
+            *tsc = t0 + (t1 - t0) / 2;
+            *ns = now;
+        }
+    }
+}
+
+uint64_t parsec_timer_tsc_calibrate(void)
+{
+    static parsec_atomic_lock_t calibration_lock = PARSEC_ATOMIC_UNLOCKED;
+    uint64_t tsc0 = 0, tsc1 = 0, ns0 = 0, ns1 = 0, mult;
+    struct timespec pause = { 0, PARSEC_TIMER_CALIBRATION_NS };
+
+    parsec_atomic_lock(&calibration_lock);
+    if( 0 != (mult = parsec_timer_tsc_mult) ) {
+        parsec_atomic_unlock(&calibration_lock);
+        return mult;
+    }
+    parsec_timer_sample(&tsc0, &ns0);
+    do {
+        nanosleep(&pause, NULL);
+        parsec_timer_sample(&tsc1, &ns1);
+    } while( ns1 - ns0 < PARSEC_TIMER_CALIBRATION_NS || tsc1 <= tsc0 );
+    mult = (uint64_t)(((unsigned __int128)(ns1 - ns0) << 32) / (tsc1 - tsc0));
+    parsec_timer_tsc_mult = (0 == mult) ? 1 : mult;
+    parsec_atomic_unlock(&calibration_lock);
+    return parsec_timer_tsc_mult;
+}
+
+void parsec_timer_init(void)
+{
+    if( PARSEC_TIMER_SOURCE_UNKNOWN == parsec_timer_source )
+        (void)parsec_timer_take_time_slow();
+    if( PARSEC_TIMER_SOURCE_TSC == parsec_timer_source )
+        (void)parsec_timer_tsc_calibrate();
+}
+
+#endif  /* defined(PARSEC_HAVE_TIMER_TSC) */
@@ -192,6 +192,52 @@ static void check_list_sort(parsec_list_t* l1, parsec_list_t* l2)
     check_lifo_translate_inorder(l2,l1,"l2","l1");
 }
 
+typedef struct {
+    parsec_list_item_t list;
+    int prio;
+    unsigned int id;
+} ring_elt_t;
+
+#define ring_elt_comparator offsetof(ring_elt_t, prio)
+
+/* Rings built with push_front then sorted must be in the order of push_sorted,
+ * including between items of equal priority */
+static void check_ring_sort(void)
+{
+    ring_elt_t *a, *b;
+    parsec_list_item_t *ra, *rb, *ia, *ib;
+    unsigned int e, n;
+
+    for(n = 1; n <= NBELT; n *= 3) {
+        printf(" - sort a ring of %u items, check it is in the order of push_sorted\n", n);
+        a = (ring_elt_t*)calloc(n, sizeof(ring_elt_t));
+        b = (ring_elt_t*)calloc(n, sizeof(ring_elt_t));
+        ra = rb = NULL;
+        for(e = 0; e < n; e++) {
+            PARSEC_OBJ_CONSTRUCT(&a[e].list, parsec_list_item_t);
+            PARSEC_OBJ_CONSTRUCT(&b[e].list, parsec_list_item_t);
+            a[e].prio = b[e].prio = rand() % (1 + n / 4);
+            a[e].id = b[e].id = e;
+            ra = parsec_list_item_ring_push_sorted(ra, &a[e].list, ring_elt_comparator);
+            rb = parsec_list_item_ring_push_front(rb, &b[e].list);
+        }
+        rb = parsec_list_item_ring_sort(rb, ring_elt_comparator);
+        for(ia = ra, ib = rb, e = 0; e < n; e++) {
+            if( ((ring_elt_t*)ia)->id != ((ring_elt_t*)ib)->id )
+                fatal(" ! Error: item %u of the sorted ring is %u, expecting %u\n",
+                      e, ((ring_elt_t*)ib)->id, ((ring_elt_t*)ia)->id);
+            if( ib->list_next->list_prev != ib )
+                fatal(" ! Error: item %u of the sorted ring has a broken link\n", e);
+            ia = (parsec_list_item_t*)ia->list_next;
+            ib = (parsec_list_item_t*)ib->list_next;
+        }
+        if( ib != rb )
+            fatal(" ! Error: the sorted ring is not closed after %u items\n", n);
+        free(a);
+        free(b);
+    }
+}
+
 static pthread_mutex_t heavy_synchro_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  heavy_synchro_cond = PTHREAD_COND_INITIALIZER;
 static unsigned int    heavy_synchro = 0;
@@ -318,6 +364,7 @@ int main(int argc, char *argv[])
     check_lifo_translate_inorder(&l2, &l1, "l2", "l1");
 
     check_list_sort(&l1, &l2);
+    check_ring_sort();
 
 
     printf("Parallel test.\n");
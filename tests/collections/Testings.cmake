@@ -1,11 +1,39 @@
 
 parsec_addtest_cmd(collections/reduce ${SHM_TEST_CMD_LIST} collections/reduce)
 
+parsec_addtest_cmd(collections/accessors ${SHM_TEST_CMD_LIST} collections/accessors)
+if( MPI_C_FOUND )
+  parsec_addtest_cmd(collections/accessors:mp ${MPI_TEST_CMD_LIST} 4 collections/accessors)
+endif( MPI_C_FOUND )
+
+parsec_addtest_cmd(collections/tabular_balance ${SHM_TEST_CMD_LIST} collections/tabular_balance)
+if( MPI_C_FOUND )
+  parsec_addtest_cmd(collections/tabular_balance:mp ${MPI_TEST_CMD_LIST} 4 collections/tabular_balance)
+endif( MPI_C_FOUND )
+
+parsec_addtest_cmd(collections/ooc ${SHM_TEST_CMD_LIST} collections/ooc)
+if( MPI_C_FOUND )
+  parsec_addtest_cmd(collections/ooc:mp ${MPI_TEST_CMD_LIST} 4 collections/ooc)
+endif( MPI_C_FOUND )
+
+parsec_addtest_cmd(collections/compress ${SHM_TEST_CMD_LIST} collections/compress)
+if( MPI_C_FOUND )
+  parsec_addtest_cmd(collections/compress:mp ${MPI_TEST_CMD_LIST} 4 collections/compress)
+endif( MPI_C_FOUND )
+
 if( MPI_C_FOUND )
     parsec_addtest_cmd(collections/redistribute:mp ${MPI_TEST_CMD_LIST} 8 collections/redistribute/testing_redistribute -M 2400 -N 2400 -a 2400 -A 2400 -t 300 -T 300 -b 200 -B 200 -m 2000 -n 2000 -I 30 -J 40 -i 100 -j 121 -v -z -x -P 2 -Q 4 -p 4 -q 2)
+    parsec_addtest_cmd(collections/redistribute_aggregate:mp ${MPI_TEST_CMD_LIST} 8 collections/redistribute/testing_redistribute -M 2400 -N 2400 -a 2400 -A 2400 -t 300 -T 300 -b 200 -B 200 -m 2000 -n 2000 -I 30 -J 40 -i 100 -j 121 -v -z -x -P 2 -Q 4 -p 4 -q 2 -y 2)
+    parsec_addtest_cmd(collections/redistribute_aggregate_misaligned:mp ${MPI_TEST_CMD_LIST} 4 collections/redistribute/testing_redistribute -M 8 -N 8 -t 4 -T 4 -I 2 -J 2 -a 8 -A 8 -b 4 -B 4 -i 3 -j 3 -m 3 -n 3 -x -P 2 -Q 2 -p 2 -q 2 -y 2)
+    set_tests_properties(collections/redistribute_aggregate_misaligned:mp
+      PROPERTIES PASS_REGULAR_EXPRESSION "Redistribute Result is CORRECT")
     parsec_addtest_cmd(collections/redistribute_random:mp ${MPI_TEST_CMD_LIST} 8 collections/redistribute/testing_redistribute_random -M 2400 -N 2400 -a 2400 -A 2400 -t 300 -T 300 -b 200 -B 200 -m 2000 -n 2000 -I 30 -J 40 -i 100 -j 121 -v -z -x -P 2 -Q 4 -p 4 -q 2)
 else( MPI_C_FOUND )
     parsec_addtest_cmd(collections/redistribute ${MPI_TEST_CMD_LIST} collections/redistribute/testing_redistribute -M 2400 -N 2400 -a 2400 -A 2400 -t 300 -T 300 -b 200 -B 200 -m 2000 -n 2000 -I 30 -J 40 -i 100 -j 121 -v -z -x)
+    parsec_addtest_cmd(collections/redistribute_aggregate ${MPI_TEST_CMD_LIST} collections/redistribute/testing_redistribute -M 2400 -N 2400 -a 2400 -A 2400 -t 300 -T 300 -b 200 -B 200 -m 2000 -n 2000 -I 30 -J 40 -i 100 -j 121 -v -z -x -y 2)
+    parsec_addtest_cmd(collections/redistribute_aggregate_misaligned ${MPI_TEST_CMD_LIST} collections/redistribute/testing_redistribute -M 8 -N 8 -t 4 -T 4 -I 2 -J 2 -a 8 -A 8 -b 4 -B 4 -i 3 -j 3 -m 3 -n 3 -x -c 1 -y 2)
+    set_tests_properties(collections/redistribute_aggregate_misaligned
+      PROPERTIES PASS_REGULAR_EXPRESSION "Redistribute Result is CORRECT")
     parsec_addtest_cmd(collections/redistribute_random ${MPI_TEST_CMD_LIST} collections/redistribute/testing_redistribute_random -M 2400 -N 2400 -a 2400 -A 2400 -t 300 -T 300 -b 200 -B 200 -m 2000 -n 2000 -I 30 -J 40 -i 100 -j 121 -v -z -x)
 endif( MPI_C_FOUND )
 
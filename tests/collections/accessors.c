@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/**
+ * This test checks that the fixed-arity and batched accessors of the data
+ * collections return the same ranks and data as the variadic accessors, for
+ * 2D block cyclic matrices, their k-cyclic views and 1D vectors, and that
+ * they do not bypass a rank_of overridden after they have been installed,
+ * whether or not they have been cleared.
+ */
+#include "parsec/runtime.h"
+#include "parsec/data_dist/matrix/two_dim_rectangle_cyclic.h"
+#include "parsec/data_dist/matrix/vector_two_dim_cyclic.h"
+#include <stdlib.h>
+#include <stdarg.h>
+
+static int check_2d(parsec_data_collection_t *dc, int mt, int nt, const char *name)
+{
+    int count = mt * nt, errors = 0;
+    int *m = malloc(count * sizeof(int)), *n = malloc(count * sizeof(int));
+    uint32_t *ranks = malloc(count * sizeof(uint32_t));
+    parsec_data_t **datas = malloc(count * sizeof(parsec_data_t*));
+    int nb_local = 0;
+
+    for( int i = 0; i < mt; i++ ) {
+        for( int j = 0; j < nt; j++ ) {
+            m[i * nt + j] = i;
+            n[i * nt + j] = j;
+        }
+    }
+    parsec_data_collection_rank_of_batch(dc, count, m, n, ranks);
+    for( int k = 0; k < count; k++ ) {
+        uint32_t rank = dc->rank_of(dc, m[k], n[k]);
+        if( (rank != ranks[k]) || (rank != parsec_data_collection_rank_of_2d(dc, m[k], n[k])) ) {
+            fprintf(stderr, "%s: rank of (%d, %d) is %u, batched %u\n", name, m[k], n[k], rank, ranks[k]);
+            errors++;
+        }
+        if( rank == dc->myrank ) {
+            /* Compact the local tiles at the beginning of the arrays */
+            m[nb_local] = m[k];
+            n[nb_local] = n[k];
+            nb_local++;
+        }
+    }
+    parsec_data_collection_data_of_batch(dc, nb_local, m, n, datas);
+    for( int k = 0; k < nb_local; k++ ) {
+        parsec_data_t *data = dc->data_of(dc, m[k], n[k]);
+        if( (data != datas[k]) || (data != parsec_data_collection_data_of_2d(dc, m[k], n[k])) ) {
+            fprintf(stderr, "%s: data of (%d, %d) differs\n", name, m[k], n[k]);
+            errors++;
+        }
+        if( dc->vpid_of(dc, m[k], n[k]) != parsec_data_collection_vpid_of_2d(dc, m[k], n[k]) ) {
+            fprintf(stderr, "%s: vpid of (%d, %d) differs\n", name, m[k], n[k]);
+            errors++;
+        }
+    }
+    free(m); free(n); free(ranks); free(datas);
+    return errors;
+}
+
+static int nb_overridden_calls = 0;
+
+static uint32_t overridden_rank_of(parsec_data_collection_t *dc, ...)
+{
+    int m, n;
+    va_list ap;
+
+    va_start(ap, dc);
+    m = va_arg(ap, int);
+    n = va_arg(ap, int);
+    va_end(ap);
+    nb_overridden_calls++;
+    return parsec_matrix_block_cyclic_rank_of(dc, m, n);
+}
+
+int main( int argc, char* argv[] )
+{
+    parsec_context_t* parsec;
+    parsec_matrix_block_cyclic_t dcA, viewA, overA;
+    parsec_vector_two_dim_cyclic_t dcV;
+    int world = 1, rank = 0, P, errors = 0;
+    int nb = 4, n = 40;
+
+#if defined(PARSEC_HAVE_MPI)
+    {
+        int provided;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+    }
+    MPI_Comm_size(MPI_COMM_WORLD, &world);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+    parsec = parsec_init(-1, &argc, &argv);
+
+    P = (0 == world % 2) ? 2 : 1;
+    parsec_matrix_block_cyclic_init( &dcA, PARSEC_MATRIX_FLOAT, PARSEC_MATRIX_TILE,
+                                     rank, nb, nb, n, n, 0, 0, n, n,
+                                     P, world/P, 1, 1, 0, 0);
+    dcA.mat = parsec_data_allocate((size_t)dcA.super.nb_local_tiles *
+                                   (size_t)dcA.super.bsiz *
+                                   (size_t)parsec_datadist_getsizeoftype(dcA.super.mtype));
+    errors += check_2d(&dcA.super.super, dcA.super.mt, dcA.super.nt, "block cyclic");
+
+    parsec_matrix_block_cyclic_kview( &viewA, &dcA, 2, 2 );
+    errors += check_2d(&viewA.super.super, viewA.super.mt, viewA.super.nt, "k-cyclic view");
+
+    overA = dcA;
+    overA.super.super.rank_of = overridden_rank_of;
+    errors += check_2d(&overA.super.super, overA.super.mt, overA.super.nt, "overridden rank_of");
+    if( nb_overridden_calls < 3 * overA.super.mt * overA.super.nt ) {
+        fprintf(stderr, "overridden rank_of: the override was bypassed\n");
+        errors++;
+    }
+
+    nb_overridden_calls = 0;
+    parsec_data_collection_clear_fixed_arity(&overA.super.super);
+    errors += check_2d(&overA.super.super, overA.super.mt, overA.super.nt, "cleared rank_of");
+    if( nb_overridden_calls < 3 * overA.super.mt * overA.super.nt ) {
+        fprintf(stderr, "cleared rank_of: the override was bypassed\n");
+        errors++;
+    }
+
+    parsec_vector_two_dim_cyclic_init( &dcV, PARSEC_MATRIX_FLOAT, PARSEC_VECTOR_DISTRIB_DIAG,
+                                       rank, nb, n, 0, n, P, world/P );
+    dcV.mat = parsec_data_allocate((size_t)dcV.super.nb_local_tiles *
+                                   (size_t)dcV.super.bsiz *
+                                   (size_t)parsec_datadist_getsizeoftype(dcV.super.mtype));
+    errors += check_2d(&dcV.super.super, dcV.super.mt, 1, "vector");
+
+    parsec_data_free(dcV.mat);
+    parsec_tiled_matrix_destroy(&dcV.super);
+    parsec_data_free(dcA.mat);
+    parsec_tiled_matrix_destroy(&dcA.super);
+
+    parsec_fini(&parsec);
+
+#if defined(PARSEC_HAVE_MPI)
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Finalize();
+#endif  /* defined(PARSEC_HAVE_MPI) */
+
+    if( 0 == rank ) {
+        printf("Data collection accessors test %s\n", (0 == errors) ? "passed" : "failed");
+    }
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -64,6 +64,7 @@ void print_usage(void)
             " -e --num-runs         : number of runs\n"
             " -f --thread_multiple  : 0/default, init mpi with MPI_THREAD_SERIALIZED; others, MPI_THREAD_MULTIPLE\n"
             " -y --no-optimization  : no_optimization version, send the whole tile to target; default 0, not no_optimization version\n"
+            "                         2, aggregated version, one message per pair of ranks\n"
             " -c --cores            : number of concurent threads (default: number of physical hyper-threads)\n"
             " -- -flag              : use parsec 'flag', details -- --help\n"
             "\n");
@@ -151,7 +151,12 @@ int main(int argc, char *argv[])
         /* Main part, call parsec_redistribute; double is default, which could be
          * changed in parsec/data_dist/matrix/redistribute/redistribute_internal.h
          */
-        if( no_optimization_version )
+        if( 2 == no_optimization_version )
+            parsec_redistribute_aggregate(parsec, (parsec_tiled_matrix_t *)&dcY,
+                                          (parsec_tiled_matrix_t *)&dcT,
+                                          size_row, size_col, disi_Y, disj_Y,
+                                          disi_T, disj_T);
+        else if( no_optimization_version )
             parsec_redistribute_no_optimization(parsec, (parsec_tiled_matrix_t *)&dcY,
                                                 (parsec_tiled_matrix_t *)&dcT,
                                                 size_row, size_col, disi_Y, disj_Y,
@@ -197,10 +202,16 @@ int main(int argc, char *argv[])
                           (parsec_tiled_matrix_unary_op_t)redistribute_init_ops, op_args);
 
             /* Redistribute back from dcT to dcY */
-            parsec_redistribute(parsec, (parsec_tiled_matrix_t *)&dcT,
-                                (parsec_tiled_matrix_t *)&dcY,
-                                size_row, size_col, disi_T, disj_T,
-                                disi_Y, disj_Y);
+            if( 2 == no_optimization_version )
+                parsec_redistribute_aggregate(parsec, (parsec_tiled_matrix_t *)&dcT,
+                                              (parsec_tiled_matrix_t *)&dcY,
+                                              size_row, size_col, disi_T, disj_T,
+                                              disi_Y, disj_Y);
+            else
+                parsec_redistribute(parsec, (parsec_tiled_matrix_t *)&dcT,
+                                    (parsec_tiled_matrix_t *)&dcY,
+                                    size_row, size_col, disi_T, disj_T,
+                                    disi_Y, disj_Y);
 
             parsec_redistribute_check2(parsec, (parsec_tiled_matrix_t *)&dcY,
                                        size_row, size_col, disi_Y, disj_Y);
@@ -15,12 +15,17 @@
 
 #include "local_no_reshape.h"
 #include "local_read_reshape.h"
+#include "local_shared_reshape.h"
 #include "local_output_reshape.h"
 #include "local_input_reshape.h"
 #include "remote_read_reshape.h"
 #include "remote_no_re_reshape.h"
 #include "local_input_LU_LL.h"
 
+extern int32_t local_shared_reshape_nb_errors;
+extern int32_t local_shared_reshape_nb_conversions;
+extern void **local_shared_reshape_copies;
+
 /* Program to test the different reshaping functionalities
  * Each different test is comented on the main program.
  */
@@ -131,6 +136,50 @@ int main(int argc, char *argv[])
       DO_CHECK(local_read_reshape, dcA, dcA_check);
     }
 
+    /*************************
+     * Local reshape shared among readers
+     * Tasks only reading the same tile with the same [type] share the
+     * reshaped datacopy, and see the lower part of the original tile.
+     * The original tiles are not modified.
+     *************************/
+    op_args = (int *)malloc(sizeof(int));
+    op_args[0] = 1;
+    parsec_apply( parsec, PARSEC_MATRIX_FULL,
+                  (parsec_tiled_matrix_t *)&dcA,
+                  (parsec_tiled_matrix_unary_op_t)reshape_set_matrix_value, op_args);
+
+    op_args = (int *)malloc(sizeof(int));
+    op_args[0] = 1;
+    parsec_apply( parsec, PARSEC_MATRIX_FULL,
+                  (parsec_tiled_matrix_t *)&dcA_check,
+                  (parsec_tiled_matrix_unary_op_t)reshape_set_matrix_value, op_args);
+
+    {
+      parsec_local_shared_reshape_taskpool_t *ctp = NULL;
+      local_shared_reshape_copies = (void**)calloc(dcA.super.mt * dcA.super.nt, sizeof(void*));
+      ctp = parsec_local_shared_reshape_new((parsec_tiled_matrix_t *)&dcA, 4);
+
+      ctp->arenas_datatypes[PARSEC_local_shared_reshape_DEFAULT_ADT_IDX]    = adt_default;
+      ctp->arenas_datatypes[PARSEC_local_shared_reshape_LOWER_TILE_ADT_IDX] = adt_lower;
+      PARSEC_OBJ_RETAIN(adt_default.arena);
+      PARSEC_OBJ_RETAIN(adt_lower.arena);
+
+      DO_RUN(ctp);
+      if( 0 != local_shared_reshape_nb_errors ) {
+          fprintf(stderr, "local_shared_reshape: %d readers received a wrong tile\n",
+                  local_shared_reshape_nb_errors);
+          ret |= 1;
+      }
+      /* with the reshape cache, the 4 readers of a tile share one conversion */
+      if( (int)dcA.super.nb_local_tiles != local_shared_reshape_nb_conversions ) {
+          fprintf(stderr, "local_shared_reshape: %d conversions for %d tiles\n",
+                  local_shared_reshape_nb_conversions, (int)dcA.super.nb_local_tiles);
+          ret |= 1;
+      }
+      free(local_shared_reshape_copies);
+      DO_CHECK(local_shared_reshape, dcA, dcA_check);
+    }
+
     /************************
      * Local reshape on output
      * When using [type] on an output dependency, a new datacopy with the correct
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/**
+ * This test builds balanced tables for the lower triangular workload of a
+ * symmetric matrix, over more ranks than the process runs with, and checks
+ * that they are better balanced than the 2D block cyclic distribution. It
+ * then checks that the incremental rebalance of a distribution in column
+ * slabs reaches the tolerance and reports the tiles it moves, and that costs
+ * read from a file are accounted to the right tiles.
+ */
+#include "parsec/runtime.h"
+#include "parsec/data_dist/matrix/two_dim_tabular.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NODES 6
+#define P     2
+#define Q     3
+
+/* Work of a Cholesky-like factorization on the lower triangle */
+static double triangular_cost(int m, int n, void *op_data)
+{
+    (void)op_data;
+    return (m >= n) ? (double)(n + 1) : 0.0;
+}
+
+static double max_load(const parsec_two_dim_td_table_t *table, const double *costs,
+                       double *average)
+{
+    double loads[NODES] = { 0.0 }, max = 0.0, total = 0.0;
+
+    for( int k = 0; k < table->nbelem; k++ ) {
+        loads[table->elems[k].rank] += costs[k];
+        total += costs[k];
+    }
+    for( int r = 0; r < NODES; r++ )
+        if( loads[r] > max ) max = loads[r];
+    *average = total / NODES;
+    return max;
+}
+
+int main( int argc, char* argv[] )
+{
+    parsec_context_t* parsec;
+    parsec_matrix_tabular_t dc, dcA;
+    parsec_two_dim_td_table_t *table, *cyclic, *slabs, *rebalanced;
+    int world = 1, rank = 0, errors = 0, nb = 8, n = 40 * nb;
+    int nbtiles, *moved, nb_moved;
+    double *costs, average, cyclic_max, balanced_max;
+
+#if defined(PARSEC_HAVE_MPI)
+    {
+        int provided;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+    }
+    MPI_Comm_size(MPI_COMM_WORLD, &world);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+    parsec = parsec_init(-1, &argc, &argv);
+
+    /* Tables for NODES ranks, only used to compute the mappings */
+    parsec_matrix_tabular_init( &dc, PARSEC_MATRIX_DOUBLE, NODES, rank % NODES,
+                                nb, nb, n, n, 0, 0, n, n, NULL );
+    nbtiles = dc.super.lmt * dc.super.lnt;
+    costs = malloc(nbtiles * sizeof(double));
+    parsec_matrix_tabular_costs_from_function(&dc, triangular_cost, NULL, costs);
+
+    cyclic = malloc(sizeof(parsec_two_dim_td_table_t) + (nbtiles-1)*sizeof(parsec_two_dim_td_table_elem_t));
+    cyclic->nbelem = nbtiles;
+    for( int j = 0; j < dc.super.lnt; j++ )
+        for( int i = 0; i < dc.super.lmt; i++ )
+            cyclic->elems[j * dc.super.lmt + i].rank = (i % P) * Q + (j % Q);
+    cyclic_max = max_load(cyclic, costs, &average);
+
+    for( int cycles = 1; cycles <= 4; cycles *= 2 ) {
+        table = parsec_matrix_tabular_balanced_table(&dc, costs, cycles);
+        balanced_max = max_load(table, costs, &average);
+        /* Each segment can exceed its share by at most half a tile */
+        if( balanced_max > average + cycles * (double)dc.super.lnt ) {
+            fprintf(stderr, "Balanced table over %d cycles: max load %g for an average of %g\n",
+                    cycles, balanced_max, average);
+            errors++;
+        }
+        if( balanced_max >= cyclic_max ) {
+            fprintf(stderr, "Balanced table over %d cycles: max load %g, %g with 2D cyclic\n",
+                    cycles, balanced_max, cyclic_max);
+            errors++;
+        }
+        free(table);
+    }
+
+    /* Rebalance a table of column slabs for the triangular costs */
+    slabs = malloc(sizeof(parsec_two_dim_td_table_t) + (nbtiles-1)*sizeof(parsec_two_dim_td_table_elem_t));
+    slabs->nbelem = nbtiles;
+    for( int j = 0; j < dc.super.lnt; j++ )
+        for( int i = 0; i < dc.super.lmt; i++ )
+            slabs->elems[j * dc.super.lmt + i].rank = j * NODES / dc.super.lnt;
+    dc.tiles_table = slabs;
+    rebalanced = parsec_matrix_tabular_rebalance(&dc, costs, 0.05, &moved, &nb_moved);
+    balanced_max = max_load(rebalanced, costs, &average);
+    if( balanced_max > 1.05 * average || 0 == nb_moved ) {
+        fprintf(stderr, "Rebalanced table: max load %g for an average of %g after %d moves\n",
+                balanced_max, average, nb_moved);
+        errors++;
+    }
+    for( int k = 0, i = 0; k < nbtiles; k++ ) {
+        int has_moved = (i < nb_moved && moved[i] == k);
+        if( has_moved != (rebalanced->elems[k].rank != slabs->elems[k].rank) ) {
+            fprintf(stderr, "Rebalanced table: tile %d %s reported as moved\n", k, has_moved ? "wrongly" : "not");
+            errors++;
+            break;
+        }
+        i += has_moved;
+    }
+    free(moved);
+    /* Nothing moves when the table is already balanced */
+    dc.tiles_table = rebalanced;
+    table = parsec_matrix_tabular_rebalance(&dc, costs, 0.05, NULL, &nb_moved);
+    if( 0 != nb_moved ) {
+        fprintf(stderr, "Balanced table: %d tiles moved\n", nb_moved);
+        errors++;
+    }
+    free(table);
+    free(rebalanced);
+    free(slabs);
+    free(cyclic);
+    dc.tiles_table = NULL;
+
+    /* Costs read from a file */
+    if( 0 == rank ) {
+        char filename[] = "tabular_balance_XXXXXX";
+        double *read_costs = malloc(nbtiles * sizeof(double));
+        int fd = mkstemp(filename);
+        FILE *f = fdopen(fd, "w");
+        fprintf(f, "# key cost\n3 1.5\n%d 2\n3 0.5\n%d 7\n", nbtiles - 1, nbtiles);
+        fclose(f);
+        if( PARSEC_SUCCESS != parsec_matrix_tabular_costs_from_file(&dc, filename, read_costs) ||
+            2.0 != read_costs[3] || 2.0 != read_costs[nbtiles - 1] || 0.0 != read_costs[0] ) {
+            fprintf(stderr, "Costs incorrectly read from a file\n");
+            errors++;
+        }
+        unlink(filename);
+        free(read_costs);
+    }
+    parsec_tiled_matrix_destroy(&dc.super);
+
+    /* A usable collection over the actual ranks */
+    parsec_matrix_tabular_init( &dcA, PARSEC_MATRIX_DOUBLE, world, rank,
+                                nb, nb, n, n, 0, 0, n, n, NULL );
+    parsec_matrix_tabular_set_balanced_table(&dcA, costs, 2);
+    for( int k = 0; k < nbtiles; k++ ) {
+        parsec_two_dim_td_table_elem_t *elem = &dcA.tiles_table->elems[k];
+        if( (elem->rank == (uint32_t)rank) != (NULL != elem->data) ) {
+            fprintf(stderr, "Rank %d: tile %d of rank %u is %sallocated\n",
+                    rank, k, elem->rank, (NULL != elem->data) ? "" : "not ");
+            errors++;
+            break;
+        }
+    }
+    parsec_matrix_tabular_destroy(&dcA);
+    free(costs);
+
+    parsec_fini(&parsec);
+
+#if defined(PARSEC_HAVE_MPI)
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Finalize();
+#endif  /* defined(PARSEC_HAVE_MPI) */
+
+    if( 0 == rank ) {
+        printf("Balanced tabular distribution test %s\n", (0 == errors) ? "passed" : "failed");
+    }
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+/* parsec things */
+#include "parsec/runtime.h"
+
+/* system and io */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "parsec/interfaces/dtd/insert_function_internal.h"
+#include "parsec/utils/debug.h"
+
+#if defined(PARSEC_HAVE_MPI)
+#include <mpi.h>
+#endif  /* defined(PARSEC_HAVE_MPI) */
+
+/*
+ * Two taskpools share a single execution stream under the fair share
+ * scheduler: the second one, with a weight of 3, must get 3 selections for
+ * each selection of the first one, instead of waiting for the tasks of the
+ * first one inserted before its own.
+ */
+
+#define NB_TASKS_A 60
+#define NB_TASKS_B 30
+#define WEIGHT_B   3
+
+static char order[NB_TASKS_A + NB_TASKS_B];
+static int  nb_executed = 0;
+
+static int
+task_record(parsec_execution_stream_t *es, parsec_task_t *this_task)
+{
+    char name;
+
+    (void)es;
+    parsec_dtd_unpack_args(this_task, &name);
+    order[nb_executed++] = name;
+    return PARSEC_HOOK_RETURN_DONE;
+}
+
+int main(int argc, char ** argv)
+{
+    parsec_context_t* parsec;
+    parsec_taskpool_t *tp_a, *tp_b;
+    int rank, rc, i, last_b = -1, ret = EXIT_SUCCESS;
+    char name_a = 'A', name_b = 'B';
+    char *parsec_argv[] = { argv[0], "--mca", "mca_sched", "fs", NULL };
+    char **pargv = parsec_argv;
+    int parsec_argc = 4;
+
+#if defined(PARSEC_HAVE_MPI)
+    {
+        int provided;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#else
+    rank = 0;
+#endif
+    (void)argc;
+
+    /* A single stream makes the order of the selections deterministic */
+    parsec = parsec_init( 1, &parsec_argc, &pargv );
+    if( NULL == parsec ) {
+        exit(-1);
+    }
+
+    tp_a = parsec_dtd_taskpool_new();
+    tp_b = parsec_dtd_taskpool_new();
+    parsec_taskpool_set_scheduling_weight(tp_b, WEIGHT_B);
+
+    rc = parsec_context_add_taskpool( parsec, tp_a );
+    PARSEC_CHECK_ERROR(rc, "parsec_context_add_taskpool");
+    rc = parsec_context_add_taskpool( parsec, tp_b );
+    PARSEC_CHECK_ERROR(rc, "parsec_context_add_taskpool");
+
+    /* All the tasks are ready before the stream starts selecting */
+    for( i = 0; i < NB_TASKS_A; i++ ) {
+        parsec_dtd_insert_task(tp_a, task_record, 0, PARSEC_DEV_CPU, "task_a",
+                               sizeof(char), &name_a, PARSEC_VALUE,
+                               PARSEC_DTD_ARG_END);
+    }
+    for( i = 0; i < NB_TASKS_B; i++ ) {
+        parsec_dtd_insert_task(tp_b, task_record, 0, PARSEC_DEV_CPU, "task_b",
+                               sizeof(char), &name_b, PARSEC_VALUE,
+                               PARSEC_DTD_ARG_END);
+    }
+
+    rc = parsec_context_start(parsec);
+    PARSEC_CHECK_ERROR(rc, "parsec_context_start");
+    rc = parsec_dtd_taskpool_wait( tp_a );
+    PARSEC_CHECK_ERROR(rc, "parsec_dtd_taskpool_wait");
+    rc = parsec_dtd_taskpool_wait( tp_b );
+    PARSEC_CHECK_ERROR(rc, "parsec_dtd_taskpool_wait");
+
+    for( i = 0; i < nb_executed; i++ ) {
+        if( 'B' == order[i] ) last_b = i;
+    }
+    /* The last task of B runs after NB_TASKS_B / WEIGHT_B tasks of A, the
+     * slack accounts for the task a stream may keep for itself */
+    if( nb_executed != NB_TASKS_A + NB_TASKS_B ||
+        last_b > NB_TASKS_B + NB_TASKS_B / WEIGHT_B + 2 ) {
+        parsec_warning("Fair share: unexpected order of the %d tasks: %.*s",
+                       nb_executed, nb_executed, order);
+        ret = EXIT_FAILURE;
+    } else if( 0 == rank ) {
+        parsec_output(0, "Fair share: %.*s\n", nb_executed, order);
+    }
+
+    rc = parsec_context_wait(parsec);
+    PARSEC_CHECK_ERROR(rc, "parsec_context_wait");
+
+    parsec_taskpool_free( tp_a );
+    parsec_taskpool_free( tp_b );
+
+    parsec_fini(&parsec);
+
+#ifdef PARSEC_HAVE_MPI
+    MPI_Finalize();
+#endif
+
+    return ret;
+}
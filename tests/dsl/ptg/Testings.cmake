@@ -6,3 +6,8 @@ parsec_addtest_cmd(dsl/ptg/startup1 ${SHM_TEST_CMD_LIST} dsl/ptg/startup -i=10 -
 parsec_addtest_cmd(dsl/ptg/startup2 ${SHM_TEST_CMD_LIST} dsl/ptg/startup -i=10 -j=20 -k=30 -v=5)
 parsec_addtest_cmd(dsl/ptg/startup3 ${SHM_TEST_CMD_LIST} dsl/ptg/startup -i=30 -j=30 -k=30 -v=5)
 parsec_addtest_cmd(dsl/ptg/strange ${SHM_TEST_CMD_LIST} dsl/ptg/strange)
+parsec_addtest_cmd(dsl/ptg/rank_of_inline ${SHM_TEST_CMD_LIST} dsl/ptg/rank_of_inline)
+
+if( MPI_C_FOUND )
+  parsec_addtest_cmd(dsl/ptg/rank_of_inline:mp ${MPI_TEST_CMD_LIST} 4 dsl/ptg/rank_of_inline)
+endif( MPI_C_FOUND )
@@ -48,6 +48,8 @@ set_tests_properties(
 )
 
 parsec_addtest_cmd(dsl/ptg/ptgpp/write_check ${SHM_TEST_CMD_LIST} dsl/ptg/ptgpp/write_check)
+parsec_addtest_cmd(dsl/ptg/ptgpp/constant_globals ${SHM_TEST_CMD_LIST} dsl/ptg/ptgpp/constant_globals)
+parsec_addtest_cmd(dsl/ptg/ptgpp/paged_deps ${SHM_TEST_CMD_LIST} dsl/ptg/ptgpp/paged_deps)
 
 if( MPI_C_FOUND )
   parsec_addtest_cmd(dsl/ptg/ptgpp/forward_RW_NULL:mp   ${MPI_TEST_CMD_LIST} 2 dsl/ptg/ptgpp/jdf_forward_RW_NULL)
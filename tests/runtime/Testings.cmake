@@ -1 +1,9 @@
 include(runtime/scheduling/Testings.cmake)
+
+if( MPI_C_FOUND )
+  parsec_addtest_cmd(runtime/native_datatype ${SHM_TEST_CMD_LIST} runtime/native_datatype)
+endif( MPI_C_FOUND )
+
+parsec_addtest_cmd(runtime/context_turnaround ${SHM_TEST_CMD_LIST} runtime/context_turnaround -c 4 -n 1000)
+parsec_addtest_cmd(runtime/context_turnaround:persistent ${SHM_TEST_CMD_LIST} runtime/context_turnaround -c 4 -n 1000 -- --mca runtime_persistent_workers 1)
+parsec_addtest_cmd(runtime/context_turnaround:taskpool:persistent ${SHM_TEST_CMD_LIST} runtime/context_turnaround -c 4 -n 100 -p -t 32 -- --mca runtime_persistent_workers 1)
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/*
+ * Measure the turnaround of a round of the runtime: parsec_context_start
+ * then parsec_context_wait, again and again. By default the rounds are
+ * empty, and their cost is the synchronization of the execution streams at
+ * the start and the end of the round; compare with
+ * --mca runtime_persistent_workers 1. With -p each round also adds a DTD
+ * taskpool with -t empty tasks (the creation of the taskpool is timed).
+ *
+ * Usage: context_turnaround [-c cores] [-n rounds] [-p] [-t tasks per round] [-- parsec options]
+ */
+
+#include "parsec/runtime.h"
+#include "parsec/interfaces/dtd/insert_function_internal.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(PARSEC_HAVE_MPI)
+#include <mpi.h>
+#endif  /* defined(PARSEC_HAVE_MPI) */
+
+#include "tests/tests_timing.h"
+
+double time_elapsed;
+double sync_time_elapsed;
+
+static int
+empty_task(parsec_execution_stream_t *es, parsec_task_t *this_task)
+{
+    (void)es; (void)this_task;
+    return PARSEC_HOOK_RETURN_DONE;
+}
+
+int main(int argc, char *argv[])
+{
+    parsec_context_t *parsec;
+    parsec_taskpool_t *tp = NULL;
+    int cores = -1, rounds = 1000, tasks = 0, with_tp = 0, rank = 0, arg, i, t, rc;
+    int parsec_argc = 0;
+    char **parsec_argv = NULL;
+    double start, round, total = 0.0, best = 1e300, worst = 0.0;
+
+#if defined(PARSEC_HAVE_MPI)
+    {
+        int provided;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+    for( arg = 1; arg < argc; arg++ ) {
+        if( !strcmp(argv[arg], "-c") && arg + 1 < argc ) cores = atoi(argv[++arg]);
+        else if( !strcmp(argv[arg], "-n") && arg + 1 < argc ) rounds = atoi(argv[++arg]);
+        else if( !strcmp(argv[arg], "-t") && arg + 1 < argc ) tasks = atoi(argv[++arg]);
+        else if( !strcmp(argv[arg], "-p") ) with_tp = 1;
+        else if( !strcmp(argv[arg], "--") ) {
+            parsec_argc = argc - arg;
+            parsec_argv = &argv[arg];
+            break;
+        } else {
+            fprintf(stderr, "Usage: %s [-c cores] [-n rounds] [-p] [-t tasks per round] [-- parsec options]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    parsec = parsec_init(cores, &parsec_argc, &parsec_argv);
+    if( NULL == parsec ) {
+        exit(-1);
+    }
+    for( cores = 0, i = 0; i < parsec->nb_vp; i++ )
+        cores += parsec->virtual_processes[i]->nb_cores;
+
+    /* The first round pays for the startup of the threads */
+    for( i = -1; i < rounds; i++ ) {
+        start = get_cur_time();
+        if( with_tp ) {
+            tp = parsec_dtd_taskpool_new();
+            rc = parsec_context_add_taskpool(parsec, tp);
+            PARSEC_CHECK_ERROR(rc, "parsec_context_add_taskpool");
+        }
+        rc = parsec_context_start(parsec);
+        PARSEC_CHECK_ERROR(rc, "parsec_context_start");
+        for( t = 0; with_tp && t < tasks; t++ ) {
+            parsec_dtd_insert_task(tp, empty_task, 0, PARSEC_DEV_CPU, "empty_task",
+                                   PARSEC_DTD_ARG_END);
+        }
+        rc = parsec_context_wait(parsec);
+        PARSEC_CHECK_ERROR(rc, "parsec_context_wait");
+        if( with_tp ) {
+            parsec_taskpool_free(tp);
+        }
+        round = get_cur_time() - start;
+        if( i < 0 ) continue;
+        total += round;
+        if( round < best ) best = round;
+        if( round > worst ) worst = round;
+    }
+
+    if( 0 == rank && rounds > 0 ) {
+        printf("[%4d] %d rounds of %s%d tasks on %d cores: %10.2f us per round (min %10.2f max %10.2f)\n",
+               rank, rounds, with_tp ? "a taskpool of " : "", with_tp ? tasks : 0, cores,
+               1e6 * total / rounds, 1e6 * best, 1e6 * worst);
+    }
+
+    parsec_fini(&parsec);
+
+#if defined(PARSEC_HAVE_MPI)
+    MPI_Finalize();
+#endif
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/*
+ * Check the native datatype engine used by the local reshapes against MPI:
+ * packing and unpacking vector, indexed and struct datatypes must produce the
+ * same bytes as MPI_Pack and MPI_Unpack, and a copy into a destination too
+ * small must be reported, such that the caller can fall back to MPI. A layout
+ * must remain usable until it is released, even if its datatype is freed.
+ */
+
+#include "parsec/parsec_config.h"
+#include "parsec/datatype.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+
+#define COUNT 3
+
+static int check_datatype(const char *name, MPI_Datatype dtt)
+{
+    parsec_type_native_layout_t *layout, *bytes;
+    MPI_Aint lb, extent;
+    char *src, *packed, *native, *unpacked, *native_unpacked;
+    int size, position = 0, i, errors = 0;
+
+    MPI_Type_commit(&dtt);
+    MPI_Type_get_extent(dtt, &lb, &extent);
+    MPI_Pack_size(COUNT, dtt, MPI_COMM_WORLD, &size);
+
+    layout = parsec_type_native_decode(dtt);
+    bytes  = parsec_type_native_decode(MPI_BYTE);
+    if( (NULL == layout) || (NULL == bytes) ) {
+        fprintf(stderr, "%s: the native engine does not handle the datatype\n", name);
+        parsec_type_native_release(layout);
+        parsec_type_native_release(bytes);
+        MPI_Type_free(&dtt);
+        return 1;
+    }
+
+    src             = (char*)malloc(lb + extent * COUNT);
+    unpacked        = (char*)calloc(1, lb + extent * COUNT);
+    native_unpacked = (char*)calloc(1, lb + extent * COUNT);
+    packed          = (char*)calloc(1, size);
+    native          = (char*)calloc(1, size);
+    for( i = 0; i < lb + extent * COUNT; i++ )
+        src[i] = (char)(i * 7 + 1);
+
+    /* pack */
+    MPI_Pack(src, COUNT, dtt, packed, size, &position, MPI_COMM_WORLD);
+    if( PARSEC_SUCCESS != parsec_type_native_copy(native, bytes, position, src, layout, COUNT) ) {
+        fprintf(stderr, "%s: native pack failed\n", name);
+        errors++;
+    } else if( memcmp(native, packed, position) ) {
+        fprintf(stderr, "%s: native pack differs from MPI_Pack\n", name);
+        errors++;
+    }
+
+    /* unpack */
+    position = 0;
+    MPI_Unpack(packed, size, &position, unpacked, COUNT, dtt, MPI_COMM_WORLD);
+    if( PARSEC_SUCCESS != parsec_type_native_copy(native_unpacked, layout, COUNT, packed, bytes, position) ) {
+        fprintf(stderr, "%s: native unpack failed\n", name);
+        errors++;
+    } else if( memcmp(native_unpacked, unpacked, lb + extent * COUNT) ) {
+        fprintf(stderr, "%s: native unpack differs from MPI_Unpack\n", name);
+        errors++;
+    }
+
+    /* a destination too small is an error, not a silent truncation */
+    if( PARSEC_SUCCESS == parsec_type_native_copy(native, bytes, position - 1, src, layout, COUNT) ) {
+        fprintf(stderr, "%s: native copy into a destination too small succeeded\n", name);
+        errors++;
+    }
+
+    /* freeing the datatype evicts the layout from the cache, not from its users */
+    MPI_Type_free(&dtt);
+    memset(native, 0, size);
+    if( (PARSEC_SUCCESS != parsec_type_native_copy(native, bytes, position, src, layout, COUNT)) ||
+        memcmp(native, packed, position) ) {
+        fprintf(stderr, "%s: native pack differs once the datatype is freed\n", name);
+        errors++;
+    }
+    parsec_type_native_release(layout);
+    parsec_type_native_release(bytes);
+
+    free(src); free(packed); free(native); free(unpacked); free(native_unpacked);
+    if( 0 == errors )
+        printf("%s: ok\n", name);
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    MPI_Datatype dtt;
+    int errors = 0;
+
+    MPI_Init(&argc, &argv);
+    parsec_type_native_init();
+
+    MPI_Type_vector(4, 3, 7, MPI_INT, &dtt);
+    errors += check_datatype("vector", dtt);
+
+    {
+        int blocklens[3] = { 2, 1, 3 };
+        int displs[3]    = { 0, 5, 9 };
+        MPI_Type_indexed(3, blocklens, displs, MPI_DOUBLE, &dtt);
+        errors += check_datatype("indexed", dtt);
+    }
+
+    {
+        int blocklens[3]        = { 1, 2, 1 };
+        MPI_Aint displs[3]      = { 0, 8, 28 };
+        MPI_Datatype types[3], vector, resized;
+        /* a struct with holes, a nested vector and a resized extent */
+        MPI_Type_vector(2, 1, 3, MPI_FLOAT, &vector);
+        types[0] = MPI_INT; types[1] = MPI_DOUBLE; types[2] = vector;
+        MPI_Type_create_struct(3, blocklens, displs, types, &dtt);
+        MPI_Type_create_resized(dtt, 0, 64, &resized);
+        MPI_Type_free(&dtt);
+        MPI_Type_free(&vector);
+        errors += check_datatype("struct", resized);
+    }
+
+    parsec_type_native_fini();
+    MPI_Finalize();
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/*
+ * Poll the live metrics of the PaRSEC processes of this node.
+ *
+ * The processes export their counters when the runtime_live_metrics MCA
+ * parameter names the shared memory regions (/<name>.<rank>, see
+ * parsec/live_metrics.h). At each interval, the rates of each stream (tasks
+ * retired, steals, idle time), the ready tasks, the arena memory and the
+ * traffic with each peer are printed, followed by the spread between the
+ * busiest and the idlest streams. The reader stops when all the processes
+ * are finished.
+ */
+#include "parsec/parsec_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "parsec/live_metrics.h"
+
+/* How many ranks are probed while looking for the first region */
+#define LIVE_MAX_PROBE 4096
+
+typedef struct {
+    int                   rank;
+    int                   done;
+    size_t                size;
+    parsec_live_header_t *h;
+    parsec_live_stream_t *last_streams;   /* counters at the previous poll */
+    parsec_live_peer_t   *last_peers;
+} region_t;
+
+static parsec_live_stream_t *region_stream(region_t *r, uint32_t i)
+{
+    return (parsec_live_stream_t*)((char*)r->h + r->h->streams_offset + (size_t)i * r->h->stream_size);
+}
+
+static parsec_live_peer_t *region_peer(region_t *r, uint32_t i)
+{
+    return (parsec_live_peer_t*)((char*)r->h + r->h->peers_offset + (size_t)i * r->h->peer_size);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Map the region of a rank, returns 0 if it does not exist (yet) */
+static int region_open(const char *name, int rank, region_t *r)
+{
+    char shm_name[256];
+    struct stat st;
+    parsec_live_header_t *h;
+    int fd;
+
+    snprintf(shm_name, sizeof(shm_name), "/%s.%d", name, rank);
+    if( -1 == (fd = shm_open(shm_name, O_RDONLY, 0)) )
+        return 0;
+    if( 0 != fstat(fd, &st) || (size_t)st.st_size < sizeof(parsec_live_header_t) ) {
+        close(fd);
+        return 0;
+    }
+    h = (parsec_live_header_t*)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if( MAP_FAILED == h )
+        return 0;
+    if( memcmp(h->magic, PARSEC_LIVE_MAGIC, sizeof(h->magic)) || PARSEC_LIVE_STATE_INIT == h->state ) {
+        /* not filled yet */
+        munmap(h, st.st_size);
+        return 0;
+    }
+    if( PARSEC_LIVE_VERSION != h->version ||
+        h->stream_size < sizeof(parsec_live_stream_t) || h->peer_size < sizeof(parsec_live_peer_t) ) {
+        fprintf(stderr, "%s: unsupported layout (version %u), this reader knows version %d\n",
+                shm_name, h->version, PARSEC_LIVE_VERSION);
+        munmap(h, st.st_size);
+        return -1;
+    }
+    r->rank = rank;
+    r->done = 0;
+    r->size = st.st_size;
+    r->h    = h;
+    r->last_streams = calloc(h->nb_streams, sizeof(parsec_live_stream_t));
+    r->last_peers   = calloc(h->nb_peers, sizeof(parsec_live_peer_t));
+    /* the first rates are since the region was found */
+    for( uint32_t i = 0; i < h->nb_streams; i++ )
+        memcpy(&r->last_streams[i], region_stream(r, i), sizeof(parsec_live_stream_t));
+    for( uint32_t i = 0; i < h->nb_peers; i++ )
+        memcpy(&r->last_peers[i], region_peer(r, i), sizeof(parsec_live_peer_t));
+    return 1;
+}
+
+static void stream_name(const parsec_live_stream_t *s, char *buf, size_t len)
+{
+    if( s->vp_id < 0 ) snprintf(buf, len, "comm");
+    else snprintf(buf, len, "%d/%d", s->vp_id, s->th_id);
+}
+
+/* Print the rates since the previous poll, and keep the current counters */
+static void region_report(region_t *r, double dt, double *min_rate, double *max_rate,
+                          double *min_idle, double *max_idle)
+{
+    parsec_live_header_t *h = r->h;
+    parsec_live_stream_t cur;
+    parsec_live_peer_t pcur;
+    int64_t scheduled = 0, selected = 0;
+    char name[32];
+    uint32_t i;
+
+    printf("rank %d (pid %d)%s\n", r->rank, h->pid,
+           PARSEC_LIVE_STATE_FINISHED == h->state ? " finished" : "");
+    printf("  %-8s %12s %10s %10s %8s\n", "stream", "tasks", "tasks/s", "stolen/s", "idle");
+    for( i = 0; i < h->nb_streams; i++ ) {
+        parsec_live_stream_t *last = &r->last_streams[i];
+        memcpy(&cur, region_stream(r, i), sizeof(cur));
+        double rate   = (cur.tasks_retired - last->tasks_retired) / dt;
+        double stolen = (cur.tasks_stolen - last->tasks_stolen) / dt;
+        double idle   = 100.0 * (cur.idle_ns - last->idle_ns) / (dt * 1e9);
+        /* an idle period is accounted when it ends */
+        if( cur.idle && idle < 1e-3 ) idle = 100.0;
+        if( idle > 100.0 ) idle = 100.0;
+        scheduled += cur.tasks_scheduled;
+        selected  += cur.tasks_selected;
+        stream_name(&cur, name, sizeof(name));
+        printf("  %-8s %12" PRIu64 " %10.1f %10.1f %7.1f%%\n", name, cur.tasks_retired, rate, stolen, idle);
+        if( cur.vp_id >= 0 ) {
+            if( rate < *min_rate ) *min_rate = rate;
+            if( rate > *max_rate ) *max_rate = rate;
+            if( idle < *min_idle ) *min_idle = idle;
+            if( idle > *max_idle ) *max_idle = idle;
+        }
+        *last = cur;
+    }
+    printf("  ready %" PRId64 "  arena used %.1f MB held %.1f MB\n",
+           scheduled > selected ? scheduled - selected : 0,
+           h->arena_used_bytes / 1e6, h->arena_held_bytes / 1e6);
+    for( i = 0; i < h->nb_peers; i++ ) {
+        parsec_live_peer_t *last = &r->last_peers[i];
+        memcpy(&pcur, region_peer(r, i), sizeof(pcur));
+        if( 0 == pcur.msgs_sent && 0 == pcur.msgs_recv && 0 == pcur.bytes_sent && 0 == pcur.bytes_recv )
+            continue;
+        printf("  peer %-4u sent %9.2f MB/s %8.1f msg/s  recv %9.2f MB/s %8.1f msg/s\n", i,
+               (pcur.bytes_sent - last->bytes_sent) / dt / 1e6, (pcur.msgs_sent - last->msgs_sent) / dt,
+               (pcur.bytes_recv - last->bytes_recv) / dt / 1e6, (pcur.msgs_recv - last->msgs_recv) / dt);
+        *last = pcur;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *name = NULL;
+    int interval_ms = 1000, count = -1, arg, i, nb_ranks = 0, nb_regions, nb_done, rc;
+    region_t *regions = NULL;
+    uint64_t last, now;
+
+    for(arg = 1; arg < argc; arg++) {
+        if( !strcmp(argv[arg], "-i") && arg + 1 < argc ) interval_ms = atoi(argv[++arg]);
+        else if( !strcmp(argv[arg], "-n") && arg + 1 < argc ) count = atoi(argv[++arg]);
+        else name = argv[arg];
+    }
+    if( NULL == name || interval_ms <= 0 ) {
+        fprintf(stderr,
+                "Usage: %s [-i <interval ms>] [-n <count>] <name>\n"
+                "  Poll the live metrics of the PaRSEC processes of this node started with\n"
+                "  the MCA parameter runtime_live_metrics=<name>.\n", argv[0]);
+        return 1;
+    }
+
+    /* Wait for the first process, its header gives the number of ranks */
+    while( NULL == regions ) {
+        for( i = 0; i < LIVE_MAX_PROBE; i++ ) {
+            region_t r;
+            if( 0 == (rc = region_open(name, i, &r)) ) continue;
+            if( rc < 0 ) return 1;
+            nb_ranks = r.h->nb_ranks;
+            regions = calloc(nb_ranks, sizeof(region_t));
+            regions[r.rank] = r;
+            break;
+        }
+        if( NULL == regions ) usleep(interval_ms * 1000);
+    }
+    last = now_ns();
+
+    do {
+        double min_rate = 1e300, max_rate = 0, min_idle = 1e300, max_idle = 0, dt;
+
+        usleep(interval_ms * 1000);
+        now = now_ns();
+        dt = (now - last) / 1e9;
+        last = now;
+
+        /* The ranks of other nodes never appear, the local ones may be late */
+        for( nb_regions = nb_done = 0, i = 0; i < nb_ranks; i++ ) {
+            if( NULL == regions[i].h && region_open(name, i, &regions[i]) < 0 ) return 1;
+            if( NULL == regions[i].h ) continue;
+            nb_regions++;
+            nb_done += regions[i].done;
+        }
+        printf("--- %d process(es), %.2f s\n", nb_regions - nb_done, dt);
+        for( i = 0; i < nb_ranks; i++ ) {
+            if( NULL == regions[i].h || regions[i].done ) continue;
+            /* the state is read first, to report the last counters of a finished process */
+            regions[i].done = (PARSEC_LIVE_STATE_FINISHED == regions[i].h->state);
+            region_report(&regions[i], dt, &min_rate, &max_rate, &min_idle, &max_idle);
+            nb_done += regions[i].done;
+        }
+        if( max_rate > 0 ) {
+            printf("imbalance: tasks/s min %.1f max %.1f (%.2fx), idle min %.1f%% max %.1f%%\n",
+                   min_rate, max_rate, min_rate > 0 ? max_rate / min_rate : 0.0, min_idle, max_idle);
+        }
+        fflush(stdout);
+    } while( nb_done < nb_regions && 0 != --count );
+
+    for( i = 0; i < nb_ranks; i++ ) {
+        if( NULL == regions[i].h ) continue;
+        munmap(regions[i].h, regions[i].size);
+        free(regions[i].last_streams);
+        free(regions[i].last_peers);
+    }
+    free(regions);
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/*
+ * Extract from a profiling trace the time spent in the tasks of each tile of
+ * a data collection, to build balanced tables for the next runs (see
+ * parsec_matrix_tabular_costs_from_file). A task is accounted to the tile of
+ * its affinity. The collection is designated by the name given to
+ * parsec_data_collection_set_key.
+ */
+#include "parsec/parsec_config.h"
+#undef PARSEC_HAVE_MPI
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <errno.h>
+
+#include "parsec/profiling.h"
+#include "parsec/parsec_binary_profile.h"
+#include "dbpreader.h"
+
+typedef struct {
+    int      key;
+    uint64_t event_id;
+    uint32_t taskpool_id;
+    uint64_t start;
+} open_event_t;
+
+static double  *costs    = NULL;
+static uint32_t nb_costs = 0;
+
+static void add_cost(uint32_t data_id, double cost)
+{
+    if( data_id >= nb_costs ) {
+        uint32_t n = (data_id + 1 > 2 * nb_costs) ? data_id + 1 : 2 * nb_costs;
+        costs = realloc(costs, n * sizeof(double));
+        memset(costs + nb_costs, 0, (n - nb_costs) * sizeof(double));
+        nb_costs = n;
+    }
+    costs[data_id] += cost;
+}
+
+static void account_thread(const dbp_file_t *file, const dbp_thread_t *th,
+                           const char *is_task, uint64_t dc_key)
+{
+    dbp_event_iterator_t *it;
+    const dbp_event_t *e;
+    open_event_t *open = NULL;
+    int nb_open = 0, size_open = 0, key, i;
+
+    it = dbp_iterator_new_from_thread( th );
+    while( (e = dbp_iterator_current(it)) != NULL ) {
+        key = dbp_event_get_key(e);
+        if( !is_task[BASE_KEY(key)] ) {
+            dbp_iterator_next(it);
+            continue;
+        }
+        if( KEY_IS_START(key) ) {
+            if( nb_open == size_open ) {
+                size_open = 2 * size_open + 8;
+                open = realloc(open, size_open * sizeof(open_event_t));
+            }
+            open[nb_open].key         = BASE_KEY(key);
+            open[nb_open].event_id    = dbp_event_get_event_id(e);
+            open[nb_open].taskpool_id = dbp_event_get_taskpool_id(e);
+            open[nb_open].start       = dbp_event_get_timestamp(e);
+            nb_open++;
+        } else {
+            /* The end of a task carries its profiling information */
+            for(i = nb_open - 1; i >= 0; i--) {
+                if( open[i].key == BASE_KEY(key) &&
+                    open[i].event_id == dbp_event_get_event_id(e) &&
+                    open[i].taskpool_id == dbp_event_get_taskpool_id(e) )
+                    break;
+            }
+            if( i >= 0 ) {
+                if( (dbp_event_get_flags(e) & PARSEC_PROFILING_EVENT_HAS_INFO) &&
+                    (dbp_event_info_len(e, file) >= (int)sizeof(parsec_task_prof_info_t)) ) {
+                    parsec_task_prof_info_t *info = dbp_event_get_info(e);
+                    if( (uint64_t)(uintptr_t)info->desc == dc_key ) {
+                        add_cost(info->data_id, (double)(dbp_event_get_timestamp(e) - open[i].start));
+                    }
+                }
+                open[i] = open[--nb_open];
+            }
+        }
+        dbp_iterator_next(it);
+    }
+    dbp_iterator_delete(it);
+    free(open);
+}
+
+static int account_file(const dbp_file_t *file, const char *dc_name)
+{
+    char info_key[strlen(dc_name) + 20];
+    int i, nb_dico = dbp_file_nb_dictionary_entries(file);
+    uint64_t dc_key = 0;
+    char *is_task;
+    int found = 0;
+
+    snprintf(info_key, sizeof(info_key), "DATA_COLLECTION:%s", dc_name);
+    for(i = 0; i < dbp_file_nb_infos(file); i++) {
+        dbp_info_t *info = dbp_file_get_info(file, i);
+        if( !strcmp(dbp_info_get_key(info), info_key) ) {
+            dc_key = strtoull(dbp_info_get_value(info), NULL, 10);
+            found = 1;
+            break;
+        }
+    }
+    if( !found ) {
+        fprintf(stderr, "No data collection called '%s' in %s\n", dc_name, dbp_file_get_name(file));
+        return 0;
+    }
+
+    is_task = calloc(nb_dico, sizeof(char));
+    for(i = 0; i < nb_dico; i++) {
+        dbp_dictionary_t *dico = dbp_file_get_dictionary(file, i);
+        /* The task classes append their locals to the task information */
+        is_task[i] = !strncmp(dbp_dictionary_convertor(dico), PARSEC_TASK_PROF_INFO_CONVERTOR,
+                              strlen(PARSEC_TASK_PROF_INFO_CONVERTOR));
+    }
+    for(i = 0; i < dbp_file_nb_threads(file); i++) {
+        account_thread(file, dbp_file_get_thread(file, i), is_task, dc_key);
+    }
+    free(is_task);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    dbp_multifile_reader_t *dbp;
+    const char *dc_name, *filename;
+    int ifd, nb_found = 0;
+    FILE *out;
+
+    if( argc < 4 ) {
+        fprintf(stderr,
+                "Usage: %s <collection> <output> <trace files...>\n"
+                "  Write the time spent in the tasks of each tile of the data collection\n"
+                "  named <collection> to <output>, as 'key cost' lines.\n", argv[0]);
+        return 1;
+    }
+    dc_name  = argv[1];
+    filename = argv[2];
+
+    dbp = dbp_reader_open_files(argc-3, argv+3);
+    if( NULL == dbp ) {
+        return 1;
+    }
+    for(ifd = 0; ifd < dbp_reader_nb_files(dbp); ifd++) {
+        nb_found += account_file(dbp_reader_get_file(dbp, ifd), dc_name);
+    }
+    dbp_reader_close_files(dbp);
+    free(dbp);
+    if( 0 == nb_found ) {
+        free(costs);
+        return 1;
+    }
+
+    out = fopen(filename, "w");
+    if( NULL == out ) {
+        fprintf(stderr, "Unable to open %s in write mode: %s\n", filename, strerror(errno));
+        free(costs);
+        return 1;
+    }
+    fprintf(out, "# Time spent in the tasks of each tile of %s\n", dc_name);
+    fprintf(out, "# key cost\n");
+    for(uint32_t k = 0; k < nb_costs; k++) {
+        if( costs[k] > 0.0 )
+            fprintf(out, "%" PRIu32 " %g\n", k, costs[k]);
+    }
+    fclose(out);
+    free(costs);
+    return 0;
+}
@@ -0,0 +1,702 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/*
+ * Convert profiling traces into an HDF5 file organized in columns, without
+ * going through Python: every field is an extensible, chunked dataset,
+ * appended as the events are read. Each rank is read by a worker thread
+ * that matches the begin and end events into chunks of rows, and the main
+ * thread writes the full chunks, so the memory used is bounded by the
+ * number of chunks in flight whatever the size of the traces.
+ *
+ * Layout of the output, following the tables of pbt2ptt (version 2):
+ *   /dictionary/{name,attributes,convertor,keylen}  one row per event type
+ *   /nodes/<rank>             attributes: the infos of the rank
+ *   /nodes/<rank>/<thread>    attributes: the infos of the thread
+ *   /events/{node_id,stream_id,taskpool_id,type,begin,end,flags,id}
+ *   /errors/{the columns of /events,reason}  begin events without a valid end
+ *   /infos/<type>/{event,<fields of the convertor>}  the infos of the events
+ *                             of a type, event is their row in /events
+ */
+#include "parsec/parsec_config.h"
+#undef PARSEC_HAVE_MPI
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <hdf5.h>
+
+#include "parsec/profiling.h"
+#include "parsec/parsec_binary_profile.h"
+#include "parsec/mca/pins/pins.h"
+#include "dbpreader.h"
+
+#define DBP2H5_CHUNK_ROWS 65536
+/* rows of the chunks of the datasets in the file, most infos are small */
+#define DBP2H5_STORAGE_ROWS 8192
+
+/* Reasons of the rows of /errors */
+#define DBP2H5_NO_END          1
+#define DBP2H5_END_BEFORE_BEGIN 2
+
+#define NB_EVENT_COLUMNS 8
+#define NB_ERROR_COLUMNS 9
+
+/* A chunk of rows of /events or /errors, filled by a worker */
+typedef struct chunk_s {
+    struct chunk_s *next;
+    int       errors;
+    int       nb;
+    int32_t  *node_id;
+    int32_t  *stream_id;
+    uint32_t *taskpool_id;
+    int32_t  *type;
+    uint64_t *begin;
+    uint64_t *end;
+    int32_t  *flags;
+    uint64_t *id;
+    uint8_t  *reason;
+    int64_t  *info;       /* offset of the info of the row in infos, or -1 */
+    char     *infos;
+    size_t    infos_len;
+    size_t    infos_size;
+} chunk_t;
+
+/* A set of columns of the same length */
+typedef struct {
+    int      nb_columns;
+    hid_t   *datasets;
+    hid_t   *types;
+    hsize_t  nb_rows;
+} table_t;
+
+typedef struct {
+    char   *name;
+    hid_t   type;
+    size_t  offset;
+} info_field_t;
+
+/* The infos of an event type, and the rows waiting to be written */
+typedef struct {
+    int           nb_fields;
+    info_field_t *fields;
+    size_t        row_size;
+    table_t       table;
+    char         *rows;
+    uint64_t     *events;
+    int           nb;
+} info_table_t;
+
+typedef struct {
+    dbp_multifile_reader_t *dbp;
+    int             nb_types;
+    info_table_t   *infos;
+    int             chunk_rows;
+    /* the chunks to write, and the files to read */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    chunk_t        *head;
+    chunk_t        *tail;
+    int             nb_queued;
+    int             max_queued;
+    int             next_file;
+    int             nb_running;
+} convert_t;
+
+static hid_t chunk_properties = H5I_INVALID_HID;
+
+static chunk_t *chunk_new(int rows, int errors)
+{
+    chunk_t *c = (chunk_t*)calloc(1, sizeof(chunk_t));
+    c->errors      = errors;
+    c->node_id     = malloc(rows * sizeof(int32_t));
+    c->stream_id   = malloc(rows * sizeof(int32_t));
+    c->taskpool_id = malloc(rows * sizeof(uint32_t));
+    c->type        = malloc(rows * sizeof(int32_t));
+    c->begin       = malloc(rows * sizeof(uint64_t));
+    c->end         = malloc(rows * sizeof(uint64_t));
+    c->flags       = malloc(rows * sizeof(int32_t));
+    c->id          = malloc(rows * sizeof(uint64_t));
+    c->reason      = malloc(rows * sizeof(uint8_t));
+    c->info        = malloc(rows * sizeof(int64_t));
+    return c;
+}
+
+static void chunk_delete(chunk_t *c)
+{
+    free(c->node_id);
+    free(c->stream_id);
+    free(c->taskpool_id);
+    free(c->type);
+    free(c->begin);
+    free(c->end);
+    free(c->flags);
+    free(c->id);
+    free(c->reason);
+    free(c->info);
+    free(c->infos);
+    free(c);
+}
+
+/* Hand a chunk over to the writer, waiting while too many are queued */
+static void chunk_push(convert_t *cv, chunk_t *c)
+{
+    pthread_mutex_lock(&cv->lock);
+    while( cv->nb_queued >= cv->max_queued )
+        pthread_cond_wait(&cv->cond, &cv->lock);
+    c->next = NULL;
+    if( NULL == cv->tail ) cv->head = c;
+    else cv->tail->next = c;
+    cv->tail = c;
+    cv->nb_queued++;
+    pthread_cond_broadcast(&cv->cond);
+    pthread_mutex_unlock(&cv->lock);
+}
+
+static void chunk_add(convert_t *cv, chunk_t **pc, const dbp_file_t *file, int stream_id,
+                      int type, const dbp_event_t *begin, const dbp_event_t *end, int reason)
+{
+    const dbp_event_t *with_info = NULL;
+    chunk_t *c = *pc;
+    int i;
+
+    if( c->nb == cv->chunk_rows ) {
+        int errors = c->errors;
+        /* c belongs to the writer once pushed */
+        chunk_push(cv, c);
+        *pc = c = chunk_new(cv->chunk_rows, errors);
+    }
+    i = c->nb++;
+    c->node_id[i]     = dbp_file_get_rank(file);
+    c->stream_id[i]   = stream_id;
+    c->taskpool_id[i] = dbp_event_get_taskpool_id(begin);
+    c->type[i]        = type;
+    c->begin[i]       = dbp_event_get_timestamp(begin);
+    c->end[i]         = (NULL != end) ? dbp_event_get_timestamp(end) : 0;
+    c->flags[i]       = dbp_event_get_flags(begin);
+    c->id[i]          = dbp_event_get_event_id(begin);
+    c->reason[i]      = reason;
+    c->info[i]        = -1;
+
+    /* as in pbt2ptt, the info of the end event prevails */
+    if( NULL != end && NULL != dbp_event_get_info(end) ) with_info = end;
+    else if( NULL != dbp_event_get_info(begin) ) with_info = begin;
+    if( NULL != with_info && cv->infos[type].nb_fields > 0 ) {
+        size_t size = cv->infos[type].row_size;
+        size_t len = (size_t)dbp_event_info_len(with_info, file);
+
+        if( c->infos_len + size > c->infos_size ) {
+            c->infos_size = 2 * c->infos_size + size;
+            c->infos = realloc(c->infos, c->infos_size);
+        }
+        memset(c->infos + c->infos_len, 0, size);
+        memcpy(c->infos + c->infos_len, dbp_event_get_info(with_info), (len < size) ? len : size);
+        c->info[i] = c->infos_len;
+        c->infos_len += size;
+    }
+}
+
+static void convert_file(convert_t *cv, const dbp_file_t *file)
+{
+    chunk_t *events = chunk_new(cv->chunk_rows, 0);
+    chunk_t *errors = chunk_new(cv->chunk_rows, 1);
+    dbp_event_iterator_t *it, *m;
+    const dbp_event_t *e, *end;
+    int t, type;
+
+    for(t = 0; t < dbp_file_nb_threads(file); t++) {
+        it = dbp_iterator_new_from_thread(dbp_file_get_thread(file, t));
+        for( e = dbp_iterator_current(it); NULL != e; e = dbp_iterator_next(it) ) {
+            if( !KEY_IS_START(dbp_event_get_key(e)) )
+                continue;
+            type = dbp_file_translate_local_dico_to_global(file, BASE_KEY(dbp_event_get_key(e)));
+            if( type < 0 || type >= cv->nb_types )
+                continue;
+            m = dbp_iterator_find_matching_event_all_threads(it);
+            end = (NULL != m) ? dbp_iterator_current(m) : NULL;
+            if( NULL == end ) {
+                chunk_add(cv, &errors, file, t, type, e, NULL, DBP2H5_NO_END);
+            } else if( dbp_event_get_timestamp(end) < dbp_event_get_timestamp(e) ) {
+                chunk_add(cv, &errors, file, t, type, e, end, DBP2H5_END_BEFORE_BEGIN);
+            } else {
+                chunk_add(cv, &events, file, t, type, e, end, 0);
+            }
+            if( NULL != m ) dbp_iterator_delete(m);
+        }
+        dbp_iterator_delete(it);
+    }
+    chunk_push(cv, events);
+    chunk_push(cv, errors);
+}
+
+static void *convert_worker(void *arg)
+{
+    convert_t *cv = (convert_t*)arg;
+    int f;
+
+    for(;;) {
+        pthread_mutex_lock(&cv->lock);
+        f = cv->next_file++;
+        pthread_mutex_unlock(&cv->lock);
+        if( f >= dbp_reader_nb_files(cv->dbp) )
+            break;
+        convert_file(cv, dbp_reader_get_file(cv->dbp, f));
+    }
+    pthread_mutex_lock(&cv->lock);
+    cv->nb_running--;
+    pthread_cond_broadcast(&cv->cond);
+    pthread_mutex_unlock(&cv->lock);
+    return NULL;
+}
+
+static int table_create(table_t *t, hid_t parent, const char *name, int nb_columns,
+                        const char *names[], const hid_t types[])
+{
+    hsize_t dims = 0, maxdims = H5S_UNLIMITED;
+    hid_t group, space;
+    int i;
+
+    group = H5Gcreate2(parent, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if( group < 0 )
+        return -1;
+    space = H5Screate_simple(1, &dims, &maxdims);
+    t->nb_columns = nb_columns;
+    t->nb_rows    = 0;
+    t->datasets   = malloc(nb_columns * sizeof(hid_t));
+    t->types      = malloc(nb_columns * sizeof(hid_t));
+    for(i = 0; i < nb_columns; i++) {
+        t->types[i]    = H5Tcopy(types[i]);
+        t->datasets[i] = H5Dcreate2(group, names[i], t->types[i], space,
+                                    H5P_DEFAULT, chunk_properties, H5P_DEFAULT);
+    }
+    H5Sclose(space);
+    H5Gclose(group);
+    return 0;
+}
+
+static void table_append(table_t *t, hsize_t nb, const void *columns[])
+{
+    hsize_t start = t->nb_rows, size = t->nb_rows + nb;
+    hid_t fspace, mspace;
+    int i;
+
+    if( 0 == nb )
+        return;
+    mspace = H5Screate_simple(1, &nb, NULL);
+    for(i = 0; i < t->nb_columns; i++) {
+        H5Dset_extent(t->datasets[i], &size);
+        fspace = H5Dget_space(t->datasets[i]);
+        H5Sselect_hyperslab(fspace, H5S_SELECT_SET, &start, NULL, &nb, NULL);
+        H5Dwrite(t->datasets[i], t->types[i], mspace, fspace, H5P_DEFAULT, columns[i]);
+        H5Sclose(fspace);
+    }
+    H5Sclose(mspace);
+    t->nb_rows = size;
+}
+
+static void table_close(table_t *t)
+{
+    for(int i = 0; i < t->nb_columns; i++) {
+        H5Dclose(t->datasets[i]);
+        H5Tclose(t->types[i]);
+    }
+    free(t->datasets);
+    free(t->types);
+    t->nb_columns = 0;
+}
+
+/* The HDF5 type of a type of the convertors, as understood by pbt2ptt */
+static hid_t convertor_type(const char *type)
+{
+    int len;
+
+    if( !strcmp(type, "int8_t") || !strcmp(type, "signed char") ) return H5Tcopy(H5T_NATIVE_INT8);
+    if( !strcmp(type, "uint8_t") || !strcmp(type, "unsigned char") ) return H5Tcopy(H5T_NATIVE_UINT8);
+    if( !strcmp(type, "int16_t") || !strcmp(type, "short") ) return H5Tcopy(H5T_NATIVE_INT16);
+    if( !strcmp(type, "uint16_t") || !strcmp(type, "unsigned short") ) return H5Tcopy(H5T_NATIVE_UINT16);
+    if( !strcmp(type, "int32_t") || !strcmp(type, "int") ) return H5Tcopy(H5T_NATIVE_INT32);
+    if( !strcmp(type, "uint32_t") || !strcmp(type, "unsigned int") ) return H5Tcopy(H5T_NATIVE_UINT32);
+    if( !strcmp(type, "long") ) return H5Tcopy(H5T_NATIVE_LONG);
+    if( !strcmp(type, "unsigned long") ) return H5Tcopy(H5T_NATIVE_ULONG);
+    if( !strcmp(type, "int64_t") || !strcmp(type, "long long") ) return H5Tcopy(H5T_NATIVE_INT64);
+    if( !strcmp(type, "uint64_t") || !strcmp(type, "unsigned long long") ) return H5Tcopy(H5T_NATIVE_UINT64);
+    if( !strcmp(type, "double") ) return H5Tcopy(H5T_NATIVE_DOUBLE);
+    if( !strcmp(type, "float") ) return H5Tcopy(H5T_NATIVE_FLOAT);
+    if( 1 == sscanf(type, "char[%d]", &len) && len > 0 ) {
+        hid_t str = H5Tcopy(H5T_C_S1);
+        H5Tset_size(str, len);
+        H5Tset_strpad(str, H5T_STR_NULLPAD);
+        return str;
+    }
+    return H5I_INVALID_HID;
+}
+
+/**
+ * Parse a convertor (NAME{TYPE};...) into the fields of the info, laid
+ * out with the alignment of a C structure. The fields whose name starts
+ * with ## are padding. Returns the number of fields, 0 if a type is not
+ * known.
+ */
+static int parse_convertor(info_table_t *it, const char *convertor, int keylen)
+{
+    char *conv = strdup(convertor), *save = NULL, *tok, *brace;
+    size_t offset = 0, size, align;
+    hid_t type;
+
+    it->nb_fields = 0;
+    it->fields = NULL;
+    for( tok = strtok_r(conv, PARSEC_PINS_SEPARATOR, &save); NULL != tok;
+         tok = strtok_r(NULL, PARSEC_PINS_SEPARATOR, &save) ) {
+        if( NULL == (brace = strchr(tok, '{')) || brace == tok )
+            continue;
+        *brace = '\0';
+        brace[strcspn(brace + 1, "}") + 1] = '\0';
+        type = convertor_type(brace + 1);
+        if( type < 0 ) {
+            fprintf(stderr, "Unknown type '%s' in the convertor '%s', its infos are ignored\n",
+                    brace + 1, convertor);
+            goto parse_failed;
+        }
+        size  = H5Tget_size(type);
+        align = (H5T_STRING == H5Tget_class(type)) ? 1 : size;
+        offset = (offset + align - 1) / align * align;
+        if( !strncmp(tok, "##", 2) ) {
+            H5Tclose(type);
+        } else {
+            it->fields = realloc(it->fields, (it->nb_fields + 1) * sizeof(info_field_t));
+            it->fields[it->nb_fields].name   = strdup(tok);
+            it->fields[it->nb_fields].type   = type;
+            it->fields[it->nb_fields].offset = offset;
+            for(char *c = it->fields[it->nb_fields].name; *c; c++)
+                if( ' ' == *c || '/' == *c ) *c = '_';
+            it->nb_fields++;
+        }
+        offset += size;
+    }
+    if( offset > (size_t)keylen ) {
+        fprintf(stderr, "The convertor '%s' needs %zu bytes, more than the %d bytes of the infos, "
+                "they are ignored\n", convertor, offset, keylen);
+        goto parse_failed;
+    }
+    it->row_size = offset;
+    free(conv);
+    return it->nb_fields;
+
+  parse_failed:
+    for(int i = 0; i < it->nb_fields; i++) {
+        free(it->fields[i].name);
+        H5Tclose(it->fields[i].type);
+    }
+    free(it->fields);
+    it->fields = NULL;
+    it->nb_fields = 0;
+    free(conv);
+    return 0;
+}
+
+static void info_table_flush(info_table_t *it)
+{
+    const void *columns[it->nb_fields + 1];
+    char *gathered;
+    size_t size;
+    int f, i;
+
+    if( 0 == it->nb )
+        return;
+    columns[0] = it->events;
+    for(f = 0; f < it->nb_fields; f++) {
+        size = H5Tget_size(it->fields[f].type);
+        gathered = malloc(it->nb * size);
+        for(i = 0; i < it->nb; i++)
+            memcpy(gathered + i * size, it->rows + i * it->row_size + it->fields[f].offset, size);
+        columns[f + 1] = gathered;
+    }
+    table_append(&it->table, it->nb, columns);
+    for(f = 0; f < it->nb_fields; f++)
+        free((void*)columns[f + 1]);
+    it->nb = 0;
+}
+
+static void write_chunk(convert_t *cv, table_t *events, table_t *errors, chunk_t *c)
+{
+    const void *columns[NB_ERROR_COLUMNS] = { c->node_id, c->stream_id, c->taskpool_id, c->type,
+                                              c->begin, c->end, c->flags, c->id, c->reason };
+    hsize_t first = events->nb_rows;
+    info_table_t *it;
+
+    if( c->errors ) {
+        table_append(errors, c->nb, columns);
+        return;
+    }
+    table_append(events, c->nb, columns);
+    for(int i = 0; i < c->nb; i++) {
+        if( c->info[i] < 0 )
+            continue;
+        it = &cv->infos[c->type[i]];
+        memcpy(it->rows + it->nb * it->row_size, c->infos + c->info[i], it->row_size);
+        it->events[it->nb++] = first + i;
+        if( it->nb == cv->chunk_rows )
+            info_table_flush(it);
+    }
+}
+
+static void set_string_attribute(hid_t obj, const char *name, const char *value)
+{
+    hid_t type, space, attr;
+
+    if( NULL == value || H5Aexists(obj, name) > 0 )
+        return;
+    type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, strlen(value) + 1);
+    space = H5Screate(H5S_SCALAR);
+    attr = H5Acreate2(obj, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+    if( attr >= 0 ) {
+        H5Awrite(attr, type, value);
+        H5Aclose(attr);
+    }
+    H5Sclose(space);
+    H5Tclose(type);
+}
+
+static void write_dictionary(convert_t *cv, hid_t h5)
+{
+    const char *names[] = { "name", "attributes", "convertor", "keylen" };
+    hid_t types[4], str = H5Tcopy(H5T_C_S1);
+    const char **name = malloc(cv->nb_types * sizeof(char*));
+    const char **attributes = malloc(cv->nb_types * sizeof(char*));
+    const char **convertor = malloc(cv->nb_types * sizeof(char*));
+    int32_t *keylen = malloc(cv->nb_types * sizeof(int32_t));
+    table_t t;
+
+    H5Tset_size(str, H5T_VARIABLE);
+    types[0] = types[1] = types[2] = str;
+    types[3] = H5T_NATIVE_INT32;
+    for(int i = 0; i < cv->nb_types; i++) {
+        dbp_dictionary_t *dico = dbp_reader_get_dictionary(cv->dbp, i);
+        name[i]       = dbp_dictionary_name(dico);
+        attributes[i] = dbp_dictionary_attributes(dico);
+        convertor[i]  = dbp_dictionary_convertor(dico);
+        keylen[i]     = dbp_dictionary_keylen(dico);
+    }
+    table_create(&t, h5, "dictionary", 4, names, types);
+    table_append(&t, cv->nb_types, (const void*[]){ name, attributes, convertor, keylen });
+    table_close(&t);
+    H5Tclose(str);
+    free(name);
+    free(attributes);
+    free(convertor);
+    free(keylen);
+}
+
+static void write_nodes(convert_t *cv, hid_t h5)
+{
+    hid_t nodes, node, stream;
+    char id[32];
+    int f, t, i;
+
+    nodes = H5Gcreate2(h5, "nodes", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    for(f = 0; f < dbp_reader_nb_files(cv->dbp); f++) {
+        dbp_file_t *file = dbp_reader_get_file(cv->dbp, f);
+        snprintf(id, sizeof(id), "%d", dbp_file_get_rank(file));
+        node = H5Gcreate2(nodes, id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if( node < 0 )
+            continue;
+        set_string_attribute(node, "filename", dbp_file_get_name(file));
+        set_string_attribute(node, "exe", dbp_file_hr_id(file));
+        for(i = 0; i < dbp_file_nb_infos(file); i++) {
+            dbp_info_t *info = dbp_file_get_info(file, i);
+            set_string_attribute(node, dbp_info_get_key(info), dbp_info_get_value(info));
+        }
+        for(t = 0; t < dbp_file_nb_threads(file); t++) {
+            dbp_thread_t *th = dbp_file_get_thread(file, t);
+            snprintf(id, sizeof(id), "%d", t);
+            stream = H5Gcreate2(node, id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            set_string_attribute(stream, "description", dbp_thread_get_hr_id(th));
+            for(i = 0; i < dbp_thread_nb_infos(th); i++) {
+                dbp_info_t *info = dbp_thread_get_info(th, i);
+                set_string_attribute(stream, dbp_info_get_key(info), dbp_info_get_value(info));
+            }
+            H5Gclose(stream);
+        }
+        H5Gclose(node);
+    }
+    H5Gclose(nodes);
+}
+
+static void create_info_tables(convert_t *cv, hid_t h5)
+{
+    hid_t infos = H5Gcreate2(h5, "infos", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), group;
+
+    cv->infos = calloc(cv->nb_types, sizeof(info_table_t));
+    for(int i = 0; i < cv->nb_types; i++) {
+        dbp_dictionary_t *dico = dbp_reader_get_dictionary(cv->dbp, i);
+        info_table_t *it = &cv->infos[i];
+        char name[strlen(dbp_dictionary_name(dico)) + 1];
+
+        if( 0 == parse_convertor(it, dbp_dictionary_convertor(dico), dbp_dictionary_keylen(dico)) )
+            continue;
+        const char *names[it->nb_fields + 1];
+        hid_t types[it->nb_fields + 1];
+        names[0] = "event";
+        types[0] = H5T_NATIVE_UINT64;
+        for(int f = 0; f < it->nb_fields; f++) {
+            names[f + 1] = it->fields[f].name;
+            types[f + 1] = it->fields[f].type;
+        }
+        strcpy(name, dbp_dictionary_name(dico));
+        for(char *c = name; *c; c++)
+            if( '/' == *c || '.' == *c ) *c = '_';
+        if( table_create(&it->table, infos, name, it->nb_fields + 1, names, types) < 0 ) {
+            fprintf(stderr, "Unable to create the infos of %s\n", dbp_dictionary_name(dico));
+            continue;
+        }
+        group = H5Gopen2(infos, name, H5P_DEFAULT);
+        set_string_attribute(group, "convertor", dbp_dictionary_convertor(dico));
+        H5Gclose(group);
+        it->rows   = malloc((size_t)cv->chunk_rows * it->row_size);
+        it->events = malloc(cv->chunk_rows * sizeof(uint64_t));
+    }
+    H5Gclose(infos);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-j workers] [-c rows] [-z level] <output.h5> <trace files...>\n"
+            "  Write the events of the traces in columns of an HDF5 file.\n"
+            "  -j: number of ranks read in parallel (default: the number of cores)\n"
+            "  -c: number of rows of the chunks written at once (default: %d)\n"
+            "  -z: deflate compression level of the columns (default: 0, no compression)\n",
+            name, DBP2H5_CHUNK_ROWS);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *event_names[NB_ERROR_COLUMNS] = { "node_id", "stream_id", "taskpool_id", "type",
+                                                  "begin", "end", "flags", "id", "reason" };
+    hid_t event_types[NB_ERROR_COLUMNS];
+    int nb_workers = 0, level = 0, arg = 1, i;
+    dbp_multifile_reader_t *dbp;
+    table_t events, errors;
+    pthread_t *workers;
+    hsize_t chunk_rows;
+    convert_t cv;
+    chunk_t *c;
+    hid_t h5;
+
+    memset(&cv, 0, sizeof(convert_t));
+    cv.chunk_rows = DBP2H5_CHUNK_ROWS;
+    for( ; arg + 1 < argc && '-' == argv[arg][0]; arg += 2 ) {
+        if( !strcmp(argv[arg], "-j") ) nb_workers = atoi(argv[arg + 1]);
+        else if( !strcmp(argv[arg], "-c") ) cv.chunk_rows = atoi(argv[arg + 1]);
+        else if( !strcmp(argv[arg], "-z") ) level = atoi(argv[arg + 1]);
+        else break;
+    }
+    if( argc - arg < 2 || cv.chunk_rows <= 0 ) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    dbp = dbp_reader_open_files(argc - arg - 1, argv + arg + 1);
+    if( NULL == dbp ) {
+        return 1;
+    }
+    if( nb_workers <= 0 ) {
+        nb_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if( nb_workers > dbp_reader_nb_files(dbp) ) {
+        nb_workers = dbp_reader_nb_files(dbp);
+    }
+    /* the matching of the events uses the index of the traces */
+    dbp_reader_index(dbp, nb_workers);
+
+    h5 = H5Fcreate(argv[arg], H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if( h5 < 0 ) {
+        fprintf(stderr, "Unable to create %s\n", argv[arg]);
+        dbp_reader_close_files(dbp);
+        free(dbp);
+        return 1;
+    }
+    chunk_rows = (cv.chunk_rows < DBP2H5_STORAGE_ROWS) ? cv.chunk_rows : DBP2H5_STORAGE_ROWS;
+    chunk_properties = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(chunk_properties, 1, &chunk_rows);
+    if( level > 0 ) {
+        H5Pset_deflate(chunk_properties, level);
+    }
+
+    cv.dbp = dbp;
+    cv.nb_types = dbp_reader_nb_dictionary_entries(dbp);
+    write_dictionary(&cv, h5);
+    write_nodes(&cv, h5);
+    create_info_tables(&cv, h5);
+    event_types[0] = event_types[1] = event_types[3] = event_types[6] = H5T_NATIVE_INT32;
+    event_types[2] = H5T_NATIVE_UINT32;
+    event_types[4] = event_types[5] = event_types[7] = H5T_NATIVE_UINT64;
+    event_types[8] = H5T_NATIVE_UINT8;
+    table_create(&events, h5, "events", NB_EVENT_COLUMNS, event_names, event_types);
+    table_create(&errors, h5, "errors", NB_ERROR_COLUMNS, event_names, event_types);
+
+    /* the workers read the ranks, this thread writes the chunks they fill */
+    pthread_mutex_init(&cv.lock, NULL);
+    pthread_cond_init(&cv.cond, NULL);
+    cv.max_queued = 2 * nb_workers;
+    cv.nb_running = nb_workers;
+    workers = malloc(nb_workers * sizeof(pthread_t));
+    for(i = 0; i < nb_workers; i++) {
+        pthread_create(&workers[i], NULL, convert_worker, &cv);
+    }
+    pthread_mutex_lock(&cv.lock);
+    for(;;) {
+        while( NULL == cv.head && cv.nb_running > 0 )
+            pthread_cond_wait(&cv.cond, &cv.lock);
+        if( NULL == (c = cv.head) )
+            break;
+        cv.head = c->next;
+        if( NULL == cv.head ) cv.tail = NULL;
+        cv.nb_queued--;
+        pthread_cond_broadcast(&cv.cond);
+        pthread_mutex_unlock(&cv.lock);
+        write_chunk(&cv, &events, &errors, c);
+        chunk_delete(c);
+        pthread_mutex_lock(&cv.lock);
+    }
+    pthread_mutex_unlock(&cv.lock);
+    for(i = 0; i < nb_workers; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    pthread_cond_destroy(&cv.cond);
+    pthread_mutex_destroy(&cv.lock);
+
+    for(i = 0; i < cv.nb_types; i++) {
+        info_table_t *it = &cv.infos[i];
+        if( 0 == it->nb_fields )
+            continue;
+        info_table_flush(it);
+        table_close(&it->table);
+        for(int f = 0; f < it->nb_fields; f++) {
+            free(it->fields[f].name);
+            H5Tclose(it->fields[f].type);
+        }
+        free(it->fields);
+        free(it->rows);
+        free(it->events);
+    }
+    free(cv.infos);
+    printf("%" PRIu64 " events and %" PRIu64 " errors written to %s\n",
+           (uint64_t)events.nb_rows, (uint64_t)errors.nb_rows, argv[arg]);
+    table_close(&events);
+    table_close(&errors);
+    H5Pclose(chunk_properties);
+    H5Fclose(h5);
+
+    dbp_reader_close_files(dbp);
+    free(dbp);
+    return 0;
+}
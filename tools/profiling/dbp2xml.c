@@ -271,6 +271,7 @@ int main(int argc, char *argv[])
     }
 
     dbp = dbp_reader_open_files(nbfiles, files);
+    dbp_reader_index(dbp, 0);
 
     dump_xml( "out.xml", dbp, raw);
 
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2024      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ */
+
+/*
+ * Find what bounds the makespan of an execution from its profiling traces.
+ *
+ * The time of each thread is split into compute (the tasks), communication
+ * (the MPI_* events), runtime overhead (the other events) and idle time.
+ *
+ * When the DOT files of the execution are given (--dot, or the parsec_dot
+ * MCA parameter, of a build with PARSEC_PROF_GRAPHER), the executed DAG is
+ * rebuilt by joining their nodes with the task events of the traces
+ * (taskpool, task class and task key). Two paths are then reported:
+ *  - the span of the DAG, the longest chain of task durations, which bounds
+ *    the makespan whatever the number of cores;
+ *  - the executed critical path, going back from the last task through the
+ *    predecessor that completed last, with the contribution of each task
+ *    class and the time spent waiting on local and remote dependencies.
+ */
+#include "parsec/parsec_config.h"
+#undef PARSEC_HAVE_MPI
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "parsec/profiling.h"
+#include "parsec/parsec_binary_profile.h"
+#include "dbpreader.h"
+
+/* Categories of the time of the threads, by decreasing priority */
+enum { CAT_COMPUTE = 0, CAT_COMM, CAT_OVERHEAD, CAT_IDLE, NB_CATS };
+static const char *cat_names[NB_CATS] = { "compute", "comm", "overhead", "idle" };
+
+typedef struct {
+    uint64_t begin;
+    uint64_t end;
+    int      cat;
+} interval_t;
+
+typedef struct {
+    uint32_t tpid;
+    int32_t  tcid;
+    uint64_t id;
+    uint64_t begin;
+    uint64_t end;
+    int      rank;
+    int      type;      /* global dictionary entry of the task class */
+} task_t;
+
+typedef struct {
+    char *name;
+    int   task;         /* index in tasks, -1 when the task is not traced */
+} node_t;
+
+typedef struct {
+    int         rank;
+    int         thread;
+    uint64_t    times[NB_CATS];
+    interval_t *iv;
+    int         nb;
+} thread_time_t;
+
+static task_t *tasks    = NULL;
+static int     nb_tasks = 0;
+static node_t *nodes    = NULL;
+static int     nb_nodes = 0;
+static int    *edges    = NULL;  /* pairs of task indexes */
+static int     nb_edges = 0;
+
+static int task_cmp(const void *a, const void *b)
+{
+    const task_t *ta = (const task_t*)a, *tb = (const task_t*)b;
+    if( ta->tpid != tb->tpid ) return (ta->tpid < tb->tpid) ? -1 : 1;
+    if( ta->tcid != tb->tcid ) return (ta->tcid < tb->tcid) ? -1 : 1;
+    if( ta->id != tb->id ) return (ta->id < tb->id) ? -1 : 1;
+    return 0;
+}
+
+static int node_cmp(const void *a, const void *b)
+{
+    return strcmp(((const node_t*)a)->name, ((const node_t*)b)->name);
+}
+
+static int find_node(const char *name)
+{
+    node_t key = { .name = (char*)name }, *n;
+    n = bsearch(&key, nodes, nb_nodes, sizeof(node_t), node_cmp);
+    return (NULL == n) ? -1 : n->task;
+}
+
+static int interval_cmp(const void *a, const void *b)
+{
+    const interval_t *ia = (const interval_t*)a, *ib = (const interval_t*)b;
+    return (ia->begin < ib->begin) ? -1 : (ia->begin > ib->begin);
+}
+
+/* Split [start, stop] between the categories of the intervals, the
+ * category of highest priority taking the time where they overlap */
+static void split_time(interval_t *iv, int nb, uint64_t start, uint64_t stop,
+                       uint64_t times[NB_CATS])
+{
+    uint64_t now = start, cat_end[NB_CATS] = { 0 };
+    int i = 0, c;
+
+    qsort(iv, nb, sizeof(interval_t), interval_cmp);
+    while( now < stop ) {
+        uint64_t next = stop;
+        /* open the intervals starting now */
+        for( ; i < nb && iv[i].begin <= now; i++ )
+            if( iv[i].end > cat_end[iv[i].cat] ) cat_end[iv[i].cat] = iv[i].end;
+        for( c = 0; c < CAT_IDLE && cat_end[c] <= now; c++ ) ;
+        if( i < nb && iv[i].begin < next ) next = iv[i].begin;
+        if( c < CAT_IDLE && cat_end[c] < next ) next = cat_end[c];
+        times[c] += next - now;
+        now = next;
+    }
+}
+
+static int event_category(const dbp_dictionary_t *dico)
+{
+    if( !strncmp(dbp_dictionary_convertor(dico), PARSEC_TASK_PROF_INFO_CONVERTOR,
+                 strlen(PARSEC_TASK_PROF_INFO_CONVERTOR)) )
+        return CAT_COMPUTE;
+    if( !strncmp(dbp_dictionary_name(dico), "MPI_", 4) )
+        return CAT_COMM;
+    return CAT_OVERHEAD;
+}
+
+/* Collect the intervals of a thread and its tasks */
+static int read_thread(const dbp_multifile_reader_t *dbp, const dbp_file_t *file,
+                       const dbp_thread_t *th, interval_t **piv, int *psize)
+{
+    dbp_event_iterator_t *it, *m;
+    const dbp_event_t *e, *end;
+    int nb = 0, type, cat;
+
+    it = dbp_iterator_new_from_thread(th);
+    for( e = dbp_iterator_current(it); NULL != e; e = dbp_iterator_next(it) ) {
+        if( !KEY_IS_START(dbp_event_get_key(e)) )
+            continue;
+        type = dbp_file_translate_local_dico_to_global(file, BASE_KEY(dbp_event_get_key(e)));
+        if( type < 0 || type >= dbp_reader_nb_dictionary_entries(dbp) )
+            continue;
+        if( NULL == (m = dbp_iterator_find_matching_event_all_threads(it)) )
+            continue;
+        end = dbp_iterator_current(m);
+        if( dbp_event_get_timestamp(end) < dbp_event_get_timestamp(e) ) {
+            dbp_iterator_delete(m);
+            continue;
+        }
+        cat = event_category(dbp_reader_get_dictionary(dbp, type));
+        if( nb == *psize ) {
+            *psize = 2 * *psize + 1024;
+            *piv = realloc(*piv, *psize * sizeof(interval_t));
+        }
+        (*piv)[nb].begin = dbp_event_get_timestamp(e);
+        (*piv)[nb].end   = dbp_event_get_timestamp(end);
+        (*piv)[nb].cat   = cat;
+        nb++;
+
+        if( CAT_COMPUTE == cat ) {
+            const dbp_event_t *with_info = (NULL != dbp_event_get_info(end)) ? end : e;
+            parsec_task_prof_info_t *info = dbp_event_get_info(with_info);
+            if( NULL != info && dbp_event_info_len(with_info, file) >= (int)sizeof(parsec_task_prof_info_t) ) {
+                if( 0 == (nb_tasks % 4096) )
+                    tasks = realloc(tasks, (nb_tasks + 4096) * sizeof(task_t));
+                tasks[nb_tasks].tpid  = dbp_event_get_taskpool_id(e);
+                tasks[nb_tasks].tcid  = info->task_class_id;
+                tasks[nb_tasks].id    = dbp_event_get_event_id(e);
+                tasks[nb_tasks].begin = dbp_event_get_timestamp(e);
+                tasks[nb_tasks].end   = dbp_event_get_timestamp(end);
+                tasks[nb_tasks].rank  = dbp_file_get_rank(file);
+                tasks[nb_tasks].type  = type;
+                nb_tasks++;
+            }
+        }
+        dbp_iterator_delete(m);
+    }
+    dbp_iterator_delete(it);
+    return nb;
+}
+
+/**
+ * Read the nodes of the tasks (name [... tooltip="tpid=..:tcid=..:
+ * tcname=..:tid=.."]) of the DOT files, then the edges between them
+ * (name -> name [...]).
+ */
+static int read_dot_files(int nb_files, char *files[])
+{
+    char *line = NULL, from[1024], to[1024];
+    size_t len = 0;
+    int f, pass, nb_lines = 0;
+    FILE *dot;
+    task_t key;
+
+    qsort(tasks, nb_tasks, sizeof(task_t), task_cmp);
+    for(pass = 0; pass < 2; pass++) {
+        for(f = 0; f < nb_files; f++) {
+            if( NULL == (dot = fopen(files[f], "r")) ) {
+                fprintf(stderr, "Unable to open %s\n", files[f]);
+                return -1;
+            }
+            while( getline(&line, &len, dot) > 0 ) {
+                char *tooltip = strstr(line, "tooltip=\"tpid=");
+                if( 0 == pass && NULL != tooltip ) {
+                    task_t *found;
+                    memset(&key, 0, sizeof(task_t));
+                    if( 1 != sscanf(line, "%1023s", from) ||
+                        3 != sscanf(tooltip, "tooltip=\"tpid=%u:tcid=%d:tcname=%*[^:]:tid=%" SCNu64,
+                                    &key.tpid, &key.tcid, &key.id) )
+                        continue;
+                    found = bsearch(&key, tasks, nb_tasks, sizeof(task_t), task_cmp);
+                    if( 0 == (nb_nodes % 4096) )
+                        nodes = realloc(nodes, (nb_nodes + 4096) * sizeof(node_t));
+                    nodes[nb_nodes].name = strdup(from);
+                    nodes[nb_nodes].task = (NULL == found) ? -1 : (int)(found - tasks);
+                    nb_nodes++;
+                } else if( 1 == pass && NULL == tooltip &&
+                           2 == sscanf(line, "%1023s -> %1023s", from, to) ) {
+                    int a = find_node(from), b = find_node(to);
+                    if( a < 0 || b < 0 || a == b )
+                        continue;
+                    if( 0 == (nb_edges % 4096) )
+                        edges = realloc(edges, 2 * (nb_edges + 4096) * sizeof(int));
+                    edges[2 * nb_edges]     = a;
+                    edges[2 * nb_edges + 1] = b;
+                    nb_edges++;
+                }
+                nb_lines++;
+            }
+            fclose(dot);
+        }
+        if( 0 == pass ) {
+            qsort(nodes, nb_nodes, sizeof(node_t), node_cmp);
+        }
+    }
+    free(line);
+    return nb_lines;
+}
+
+/* Compressed adjacency of the edges, by their end (0) or by their start (1) */
+static void adjacency(int side, int **pfirst, int **padj)
+{
+    int *first = calloc(nb_tasks + 1, sizeof(int)), *adj = malloc((nb_edges + 1) * sizeof(int));
+    int e, t;
+
+    for(e = 0; e < nb_edges; e++) first[edges[2 * e + 1 - side] + 1]++;
+    for(t = 0; t < nb_tasks; t++) first[t + 1] += first[t];
+    int *pos = malloc(nb_tasks * sizeof(int));
+    memcpy(pos, first, nb_tasks * sizeof(int));
+    for(e = 0; e < nb_edges; e++) adj[pos[edges[2 * e + 1 - side]]++] = edges[2 * e + side];
+    free(pos);
+    *pfirst = first;
+    *padj = adj;
+}
+
+static void report_paths(const dbp_multifile_reader_t *dbp, uint64_t start, uint64_t stop)
+{
+    int nb_types = dbp_reader_nb_dictionary_entries(dbp);
+    uint64_t *span = calloc(nb_tasks, sizeof(uint64_t));
+    uint64_t *class_time = calloc(nb_types, sizeof(uint64_t));
+    int *class_count = calloc(nb_types, sizeof(int));
+    int *from, *pred, *to, *succ, *indegree, *queue, *best = malloc(nb_tasks * sizeof(int));
+    uint64_t work = 0, dag_span = 0, local_wait = 0, remote_wait = 0, length;
+    int head = 0, tail = 0, t, i, last = -1, nb_path = 0;
+
+    adjacency(0, &from, &pred);
+    adjacency(1, &to, &succ);
+
+    /* span of the DAG, in a topological order */
+    indegree = calloc(nb_tasks, sizeof(int));
+    queue = malloc(nb_tasks * sizeof(int));
+    for(t = 0; t < nb_tasks; t++) {
+        indegree[t] = from[t + 1] - from[t];
+        if( 0 == indegree[t] ) queue[tail++] = t;
+        work += tasks[t].end - tasks[t].begin;
+        if( last < 0 || tasks[t].end > tasks[last].end ) last = t;
+    }
+    while( head < tail ) {
+        t = queue[head++];
+        span[t] += tasks[t].end - tasks[t].begin;
+        if( span[t] > dag_span ) dag_span = span[t];
+        for(i = to[t]; i < to[t + 1]; i++) {
+            if( span[t] > span[succ[i]] ) span[succ[i]] = span[t];
+            if( 0 == --indegree[succ[i]] ) queue[tail++] = succ[i];
+        }
+    }
+    if( tail < nb_tasks ) {
+        fprintf(stderr, "Warning: %d tasks are on cycles of the DAG, the DOT files do not match the traces\n",
+                nb_tasks - tail);
+    }
+
+    /* executed critical path, from the last task through the predecessors
+     * that completed last */
+    for(t = last; t >= 0; ) {
+        int p = -1;
+        best[nb_path++] = t;
+        class_time[tasks[t].type] += tasks[t].end - tasks[t].begin;
+        class_count[tasks[t].type]++;
+        for(i = from[t]; i < from[t + 1]; i++)
+            if( tasks[pred[i]].end <= tasks[t].begin && (p < 0 || tasks[pred[i]].end > tasks[p].end) )
+                p = pred[i];
+        if( p >= 0 ) {
+            if( tasks[p].rank == tasks[t].rank ) local_wait += tasks[t].begin - tasks[p].end;
+            else remote_wait += tasks[t].begin - tasks[p].end;
+        }
+        t = p;
+    }
+    length = stop - start;
+
+    printf("\nDAG: %d tasks, %d dependencies\n", nb_tasks, nb_edges);
+    printf("  work %" PRIu64 ", span %" PRIu64 ": parallelism %.2f, achieved %.2f\n",
+           work, dag_span, dag_span ? (double)work / dag_span : 0.0, length ? (double)work / length : 0.0);
+    printf("\nExecuted critical path: %d tasks, the makespan splits into\n", nb_path);
+    for(t = 0; t < nb_types; t++) {
+        if( 0 == class_count[t] ) continue;
+        printf("  %-32s %8d tasks %14" PRIu64 " %5.1f%%\n",
+               dbp_dictionary_name(dbp_reader_get_dictionary(dbp, t)), class_count[t],
+               class_time[t], 100.0 * class_time[t] / length);
+    }
+    printf("  %-32s %14s %14" PRIu64 " %5.1f%%\n", "wait on local dependencies", "",
+           local_wait, 100.0 * local_wait / length);
+    printf("  %-32s %14s %14" PRIu64 " %5.1f%%\n", "wait on remote dependencies", "",
+           remote_wait, 100.0 * remote_wait / length);
+    if( nb_path > 0 ) {
+        uint64_t before = tasks[best[nb_path - 1]].begin - start, after = stop - tasks[last].end;
+        printf("  %-32s %14s %14" PRIu64 " %5.1f%%\n", "before and after the path", "",
+               before + after, 100.0 * (before + after) / length);
+    }
+    if( dag_span > 0 ) {
+        if( length > 2 * dag_span )
+            printf("\nThe makespan is %.1f times the span of the DAG: more cores, or less waiting on the\n"
+                   "critical path, would shorten the execution.\n", (double)length / dag_span);
+        else
+            printf("\nThe makespan is within %.1f times the span of the DAG: the execution is bound by the\n"
+                   "critical path, shorten its tasks rather than adding cores.\n", (double)length / dag_span);
+    }
+
+    free(span); free(class_time); free(class_count); free(best);
+    free(from); free(pred); free(to); free(succ); free(indegree); free(queue);
+}
+
+int main(int argc, char *argv[])
+{
+    char **traces = malloc(argc * sizeof(char*)), **dots = malloc(argc * sizeof(char*));
+    int nb_traces = 0, nb_dots = 0, ifd, t, c, nb, size = 0, arg;
+    uint64_t start = UINT64_MAX, stop = 0, total[NB_CATS] = { 0 };
+    dbp_multifile_reader_t *dbp;
+    interval_t *iv = NULL;
+    thread_time_t *threads = NULL;
+    int nb_threads = 0;
+
+    for(arg = 1; arg < argc; arg++) {
+        if( !strcmp(argv[arg], "--dot") && arg + 1 < argc ) dots[nb_dots++] = argv[++arg];
+        else if( strlen(argv[arg]) > 4 && !strcmp(argv[arg] + strlen(argv[arg]) - 4, ".dot") ) dots[nb_dots++] = argv[arg];
+        else traces[nb_traces++] = argv[arg];
+    }
+    if( 0 == nb_traces ) {
+        fprintf(stderr,
+                "Usage: %s <trace files...> [<dot files...>]\n"
+                "  Split the time of the threads into compute, communication, runtime overhead\n"
+                "  and idle time. With the DOT files of the execution (--dot), report the span of\n"
+                "  the DAG and the executed critical path.\n", argv[0]);
+        return 1;
+    }
+
+    dbp = dbp_reader_open_files(nb_traces, traces);
+    if( NULL == dbp ) {
+        return 1;
+    }
+    dbp_reader_index(dbp, 0);
+
+    /* read all the intervals first, the makespan bounds the idle time */
+    for(ifd = 0; ifd < dbp_reader_nb_files(dbp); ifd++) {
+        dbp_file_t *file = dbp_reader_get_file(dbp, ifd);
+        for(t = 0; t < dbp_file_nb_threads(file); t++) {
+            nb = read_thread(dbp, file, dbp_file_get_thread(file, t), &iv, &size);
+            threads = realloc(threads, (nb_threads + 1) * sizeof(thread_time_t));
+            threads[nb_threads].rank   = dbp_file_get_rank(file);
+            threads[nb_threads].thread = t;
+            threads[nb_threads].nb     = nb;
+            threads[nb_threads].iv     = malloc((nb + 1) * sizeof(interval_t));
+            memcpy(threads[nb_threads].iv, iv, nb * sizeof(interval_t));
+            memset(threads[nb_threads].times, 0, sizeof(threads[nb_threads].times));
+            for(int i = 0; i < nb; i++) {
+                if( iv[i].begin < start ) start = iv[i].begin;
+                if( iv[i].end > stop ) stop = iv[i].end;
+            }
+            nb_threads++;
+        }
+    }
+    free(iv);
+    if( start >= stop ) {
+        fprintf(stderr, "No complete event in the traces\n");
+        return 1;
+    }
+
+    printf("Makespan: %" PRIu64 " (from %" PRIu64 " to %" PRIu64 ")\n\n", stop - start, start, stop);
+    printf("%6s %6s", "rank", "thread");
+    for(c = 0; c < NB_CATS; c++) printf(" %9s", cat_names[c]);
+    printf("\n");
+    for(t = 0; t < nb_threads; t++) {
+        split_time(threads[t].iv, threads[t].nb, start, stop, threads[t].times);
+        printf("%6d %6d", threads[t].rank, threads[t].thread);
+        for(c = 0; c < NB_CATS; c++) {
+            printf(" %8.1f%%", 100.0 * threads[t].times[c] / (stop - start));
+            total[c] += threads[t].times[c];
+        }
+        printf("\n");
+        free(threads[t].iv);
+    }
+    printf("%13s", "all");
+    for(c = 0; c < NB_CATS; c++) printf(" %8.1f%%", 100.0 * total[c] / ((stop - start) * (double)nb_threads));
+    printf("\n");
+    free(threads);
+
+    if( nb_dots > 0 ) {
+        if( read_dot_files(nb_dots, dots) >= 0 ) {
+            report_paths(dbp, start, stop);
+        }
+    } else {
+        printf("\nNo DOT file given, the critical path is not computed.\n");
+    }
+
+    for(t = 0; t < nb_nodes; t++) free(nodes[t].name);
+    free(nodes); free(edges); free(tasks);
+    free(traces); free(dots);
+    dbp_reader_close_files(dbp);
+    free(dbp);
+    return 0;
+}
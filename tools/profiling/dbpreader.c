@@ -16,6 +16,7 @@
 #include <sys/mman.h>
 #endif
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <pthread.h>
 #include <fcntl.h>
 #include <stdarg.h>
@@ -77,6 +78,7 @@ struct dbp_file {
     int    nb_threads;
     int    nb_dico_map;
     int    error;
+    int    index_loaded;  /* the index was read from the index file */
     int   *dico_map;
     struct dbp_info  **infos;
     struct dbp_thread *threads;
@@ -84,6 +86,9 @@ struct dbp_file {
 
 struct dbp_event {
     parsec_profiling_output_t *native;
+    char                      *info;    /* Info blob of the event */
+    size_t                     length;  /* Length of the event in its buffer */
+    parsec_profiling_output_t  decoded; /* Storage of the compact events */
 };
 
 void dbp_file_print(dbp_file_t * file) {
@@ -125,7 +130,7 @@ uint64_t dbp_event_get_timestamp(const dbp_event_t *e)
 void *dbp_event_get_info(const dbp_event_t *e)
 {
     if( EVENT_HAS_INFO( e->native ) ) {
-        return e->native->info;
+        return e->info;
     }
     return NULL;
 }
@@ -145,6 +150,7 @@ struct dbp_event_iterator {
     int64_t                          current_event_position;
     int64_t                          current_event_index;
     int64_t                          current_buffer_position;
+    parsec_profiling_compact_state_t state;  /* Decoding state after the current event */
 #ifndef _NDEBUG
     uint64_t                         last_event_date;
 #endif
@@ -210,15 +216,22 @@ int dbp_file_translate_local_dico_to_global(const dbp_file_t *file, int lid)
     return file->dico_map[lid];
 }
 
+#define DBP_EVENT_INFO_LENGTH(dbp_event, dbp_object)        \
+    ((dbp_object)->parent->dico_keys[(dbp_object)->dico_map[BASE_KEY((dbp_event)->native->event.key)]].keylen)
 #define DBP_EVENT_LENGTH(dbp_event, dbp_object)             \
   (sizeof(parsec_profiling_output_base_event_t) +           \
-   (EVENT_HAS_INFO((dbp_event)->native) ?                   \
-    (dbp_object)->parent->dico_keys[(dbp_object)->dico_map[BASE_KEY((dbp_event)->native->event.key)]].keylen : 0))
+   (EVENT_HAS_INFO((dbp_event)->native) ? DBP_EVENT_INFO_LENGTH(dbp_event, dbp_object) : 0))
+#define DBP_IS_EVENTS_BUFFER(buffer)                             \
+    ((PROFILING_BUFFER_TYPE_EVENTS == (buffer)->buffer_type) ||  \
+     (PROFILING_BUFFER_TYPE_COMPACT_EVENTS == (buffer)->buffer_type))
 
 typedef struct {
     uint64_t timestamp;
     off_t    offset;
     int64_t  event_idx;
+    uint64_t event_id;
+    uint32_t taskpool_id;
+    uint32_t padding;
 } event_cache_item_t;
 
 typedef struct {
@@ -227,10 +240,20 @@ typedef struct {
     size_t              size;
 } event_cache_key_t;
 
+/* An events buffer of a thread, and the time range of its events */
 typedef struct {
-    pthread_mutex_t    mtx;
-    event_cache_key_t *keys;
-    int                done;
+    int64_t  offset;
+    int64_t  first_index;  /* index of its first event in the thread */
+    uint64_t first_time;
+    uint64_t last_time;
+} buffer_index_item_t;
+
+typedef struct {
+    pthread_mutex_t      mtx;
+    event_cache_key_t   *keys;
+    buffer_index_item_t *buffers;
+    int64_t              nb_buffers;
+    int                  done;
 } event_cache_t;
 
 struct dbp_thread {
@@ -270,12 +293,13 @@ static void release_events_buffer(parsec_profiling_buffer_t *buffer)
 
 static parsec_profiling_buffer_t *refer_events_buffer( const dbp_file_t *file, int64_t offset )
 {
-    off_t pos = lseek(file->fd, offset, SEEK_SET);
-    if( -1 == pos ) {
+    ssize_t pos;
+    if( offset < 0 ) {
         return NULL;
     }
+    /* pread, as the threads of the reader share the file descriptor */
     parsec_profiling_buffer_t *res = (parsec_profiling_buffer_t*)malloc(event_buffer_size);
-    pos = read(file->fd, res, event_buffer_size);
+    pos = pread(file->fd, res, event_buffer_size, offset);
     if( pos <= 0 ) {
         free(res);
         res = NULL;
@@ -285,7 +309,10 @@ static parsec_profiling_buffer_t *refer_events_buffer( const dbp_file_t *file, i
 
 #endif  /* defined(PARSEC_PROFILING_USE_MMAP) */
 
-dbp_event_iterator_t *dbp_iterator_new_from_thread(const dbp_thread_t *th)
+static const dbp_event_t *dbp_iterator_move_to_event(dbp_event_iterator_t *it,
+                                                     int64_t event_pos, int64_t event_idx);
+
+static dbp_event_iterator_t *dbp_iterator_new(const dbp_thread_t *th)
 {
     dbp_event_iterator_t *res = (dbp_event_iterator_t*)malloc(sizeof(dbp_event_iterator_t));
     res->thread = th;
@@ -297,6 +324,12 @@ dbp_event_iterator_t *dbp_iterator_new_from_thread(const dbp_thread_t *th)
 #ifndef _NDEBUG
     res->last_event_date = 0;
 #endif
+    return res;
+}
+
+dbp_event_iterator_t *dbp_iterator_new_from_thread(const dbp_thread_t *th)
+{
+    dbp_event_iterator_t *res = dbp_iterator_new(th);
     (void)dbp_iterator_first(res);
     return res;
 }
@@ -305,14 +338,32 @@ dbp_event_iterator_t *dbp_iterator_new_from_iterator(const dbp_event_iterator_t
 {
     dbp_event_iterator_t *res = (dbp_event_iterator_t*)malloc(sizeof(dbp_event_iterator_t));
     res->thread = it->thread;
-    res->current_event.native = it->current_event.native;
-    res->current_event_position = it->current_event_position;
-    res->current_event_index = it->current_event_index;
+    res->current_event.native = NULL;
+    res->current_event_position = 0;
+    res->current_event_index = 0;
     res->current_buffer_position = it->current_buffer_position;
     res->current_events_buffer = refer_events_buffer( it->thread->file, res->current_buffer_position );
 #ifndef _NDEBUG
     res->last_event_date = it->last_event_date;
 #endif
+    /* The event must point in the buffer of this iterator */
+    if( NULL != it->current_event.native && NULL != res->current_events_buffer ) {
+        if( PROFILING_BUFFER_TYPE_COMPACT_EVENTS == res->current_events_buffer->buffer_type ) {
+            /* Take over the decoding state, instead of decoding the buffer again */
+            res->state = it->state;
+            res->current_event = it->current_event;
+            res->current_event.native = &res->current_event.decoded;
+            res->current_event.info = (char*)res->current_events_buffer +
+                (it->current_event.info - (char*)it->current_events_buffer);
+            res->current_event_position = it->current_event_position;
+            res->current_event_index = it->current_event_index;
+        } else {
+#ifndef _NDEBUG
+            res->last_event_date = 0;
+#endif
+            dbp_iterator_move_to_event(res, it->current_event_position, it->current_event_index);
+        }
+    }
     return res;
 }
 
@@ -328,23 +379,53 @@ const dbp_event_t *dbp_iterator_current(dbp_event_iterator_t *it)
     return &it->current_event;
 }
 
+/* decode the compact event at position event_pos, following the current event */
+static inline void
+dbp_iterator_decode_compact_event(dbp_event_iterator_t *it, int64_t event_pos)
+{
+    dbp_event_t *e = &it->current_event;
+    size_t len;
+
+    len = parsec_profiling_compact_decode(&it->state, &it->current_events_buffer->buffer[event_pos],
+                                          &e->decoded.event);
+    e->native = &e->decoded;
+    e->info = &it->current_events_buffer->buffer[event_pos + len];
+    e->length = len + (EVENT_HAS_INFO(e->native) ? DBP_EVENT_INFO_LENGTH(e, it->thread->file) : 0);
+    it->current_event_position = event_pos;
+}
+
 /* move iterator to position event_pos in current buffer and index event_idx */
-static inline const dbp_event_t *
+static const dbp_event_t *
 dbp_iterator_move_to_event(dbp_event_iterator_t *it,
                            int64_t event_pos, int64_t event_idx)
 {
     assert( event_pos >= 0 && event_pos < event_avail_space );
     assert( event_idx >= 0 );
 
-    it->current_event_position = event_pos;
-    it->current_event_index = event_idx;
-
-    if( it->current_events_buffer != NULL ) {
-        assert( it->current_event_index < it->current_events_buffer->this_buffer.nb_events );
-        it->current_event.native = (parsec_profiling_output_t*)&(it->current_events_buffer->buffer[it->current_event_position]);
-    } else {
+    if( it->current_events_buffer == NULL ) {
         it->current_event.native = NULL;
+    } else if( it->current_events_buffer->buffer_type == PROFILING_BUFFER_TYPE_COMPACT_EVENTS ) {
+        assert( event_idx < it->current_events_buffer->this_buffer.nb_events );
+        /* The events are delta encoded: decode from the start of the buffer,
+         * or from the current event if the target follows it */
+        if( NULL == it->current_event.native || event_pos < it->current_event_position ) {
+            memset(&it->state, 0, sizeof(parsec_profiling_compact_state_t));
+            dbp_iterator_decode_compact_event(it, 0);
+            it->current_event_index = 0;
+        }
+        while( it->current_event_position < event_pos ) {
+            dbp_iterator_decode_compact_event(it, it->current_event_position + it->current_event.length);
+            it->current_event_index++;
+        }
+        assert( it->current_event_position == event_pos && it->current_event_index == event_idx );
+    } else {
+        assert( event_idx < it->current_events_buffer->this_buffer.nb_events );
+        it->current_event.native = (parsec_profiling_output_t*)&(it->current_events_buffer->buffer[event_pos]);
+        it->current_event.info = it->current_event.native->info;
+        it->current_event.length = DBP_EVENT_LENGTH(&it->current_event, it->thread->file);
     }
+    it->current_event_position = event_pos;
+    it->current_event_index = event_idx;
 
     assert((it->current_event.native == NULL) ||
            (it->current_event.native->event.timestamp != 0));
@@ -364,7 +445,9 @@ dbp_iterator_set_offset(dbp_event_iterator_t *it, off_t offset)
     it->current_events_buffer = refer_events_buffer( it->thread->file, offset );
     it->current_buffer_position = offset;
 
-    assert( it->current_events_buffer->buffer_type == PROFILING_BUFFER_TYPE_EVENTS );
+    if( NULL == it->current_events_buffer )
+        return NULL;
+    assert( DBP_IS_EVENTS_BUFFER(it->current_events_buffer) );
     return dbp_iterator_move_to_event(it, 0, 0);
 }
 
@@ -379,7 +462,7 @@ static const dbp_event_t *dbp_iterator_next_buffer(dbp_event_iterator_t *it)
 
     if( NULL == it->current_event.native )
         return NULL;
-    assert( it->current_events_buffer->buffer_type == PROFILING_BUFFER_TYPE_EVENTS );
+    assert( DBP_IS_EVENTS_BUFFER(it->current_events_buffer) );
 
     next_off = it->current_events_buffer->next_buffer_file_offset;
     return dbp_iterator_set_offset(it, next_off);
@@ -387,19 +470,16 @@ static const dbp_event_t *dbp_iterator_next_buffer(dbp_event_iterator_t *it)
 
 static const dbp_event_t *dbp_iterator_next_in_buffer(dbp_event_iterator_t *it)
 {
-    size_t elen;
-
     if( NULL == it->current_event.native )
         return NULL;
-    assert( it->current_events_buffer->buffer_type == PROFILING_BUFFER_TYPE_EVENTS );
+    assert( DBP_IS_EVENTS_BUFFER(it->current_events_buffer) );
 
     if( it->current_event_index+1 >= it->current_events_buffer->this_buffer.nb_events ) {
         it->current_event.native = NULL;
         return NULL;
     }
 
-    elen = DBP_EVENT_LENGTH(&it->current_event, it->thread->file);
-    return dbp_iterator_move_to_event(it, it->current_event_position + elen,
+    return dbp_iterator_move_to_event(it, it->current_event_position + it->current_event.length,
                                           it->current_event_index + 1);
 }
 
@@ -407,7 +487,7 @@ const dbp_event_t *dbp_iterator_next(dbp_event_iterator_t *it)
 {
     if( NULL == it->current_event.native )
         return NULL;
-    assert( it->current_events_buffer->buffer_type == PROFILING_BUFFER_TYPE_EVENTS );
+    assert( DBP_IS_EVENTS_BUFFER(it->current_events_buffer) );
 
     if( it->current_event_index+1 >= it->current_events_buffer->this_buffer.nb_events ) {
         return dbp_iterator_next_buffer(it);
@@ -428,97 +508,330 @@ void dbp_iterator_delete(dbp_event_iterator_t *it)
     free(it);
 }
 
+static inline int base_events_match(const parsec_profiling_output_base_event_t *s,
+                                    const parsec_profiling_output_base_event_t *e)
+{
+    return ( (KEY_IS_START(s->key)  && KEY_IS_END(e->key))      &&
+             (BASE_KEY(s->key)      == BASE_KEY(e->key))        &&
+             (s->event_id           == e->event_id)             &&
+             (s->taskpool_id        == e->taskpool_id)          &&
+             (s->timestamp          <= e->timestamp) );
+}
+
 static inline int dbp_events_match(const dbp_event_t *s, const dbp_event_t *e)
 {
-    int s_key = dbp_event_get_key(s);
-    int e_key = dbp_event_get_key(e  );
-    return ( (KEY_IS_START(s_key)          && KEY_IS_END(e_key))            &&
-             (BASE_KEY(    s_key)          == BASE_KEY(  e_key))            &&
-             (dbp_event_get_event_id(   s) == dbp_event_get_event_id(   e)) &&
-             (dbp_event_get_taskpool_id(s) == dbp_event_get_taskpool_id(e)) &&
-             (dbp_event_get_timestamp(  s) <= dbp_event_get_timestamp(  e)) );
+    return base_events_match(&s->native->event, &e->native->event);
 }
 
 /* minimum allocation count for cache */
 #define EVENT_CACHE_MIN_ALLOC 64
-/* build a "cache" of events where the end event
- * does not immediately follow the start event */
-static void build_unmatched_events_in_thread(dbp_thread_t *thr)
-{
-    const dbp_event_t      *e1,  *e2;
-    dbp_event_iterator_t   *i1,  *i2;
-    int key2;
 
-    event_cache_key_t  *cache_key;
+static void cache_unmatched_event(event_cache_key_t *cache_key, const dbp_event_iterator_t *it)
+{
     event_cache_item_t *cache_item;
     size_t              cache_index;
     off_t               offset;
 
+    cache_index = cache_key->len++;
+    /* if index == size, we need to grow the array */
+    if( cache_index == cache_key->size ) {
+        /* if size == 0, this is the first mismatched event with this key */
+        cache_key->size = cache_key->size ? cache_key->size * 2 :
+                                            EVENT_CACHE_MIN_ALLOC;
+        cache_key->items = realloc(cache_key->items, sizeof(event_cache_item_t[cache_key->size]));
+    }
+
+    /* cache timestamp and buffer offset for this event
+     * note that we don't store the exact index of the event,
+     * so a consumer should make sure to search through the buffer */
+    cache_item = &cache_key->items[cache_index];
+
+    /* event pos it always less than event_avail_space
+     * and buffer offset is always a multiple of event_buffer_size
+     * so these can be combined together and recovered */
+    assert( it->current_event_position >= 0 );
+    assert( it->current_event_position < event_avail_space );
+    assert( (it->current_buffer_position % event_buffer_size) == 0 );
+
+    offset = it->current_buffer_position + it->current_event_position;
+    cache_item->timestamp   = dbp_event_get_timestamp(&it->current_event);
+    cache_item->offset      = offset;
+    cache_item->event_idx   = it->current_event_index;
+    cache_item->event_id    = dbp_event_get_event_id(&it->current_event);
+    cache_item->taskpool_id = dbp_event_get_taskpool_id(&it->current_event);
+    cache_item->padding     = 0;
+
+    assert( (offset % event_buffer_size) == it->current_event_position);
+}
+
+/* build the index of a thread in a single pass: the time range of each
+ * events buffer, and a "cache" of events where the end event does not
+ * immediately follow the start event */
+static void build_thread_index(dbp_thread_t *thr)
+{
+    parsec_profiling_output_base_event_t prev;
+    buffer_index_item_t *b;
+    dbp_event_iterator_t *it;
+    const dbp_event_t *e;
+    int64_t index = 0, size = 0;
+    int key;
+
     /* lock cache; we're modifying volatile state! */
     pthread_mutex_lock(&thr->cache.mtx);
     if( thr->cache.done ) {
         /* cache already built, we don't need to do anything */
-        goto build_events_done;
+        goto build_index_done;
     }
 
-    /* iterator 1 points to current event */
-    i1 = dbp_iterator_new_from_thread( thr );
-    e1 = dbp_iterator_current( i1 );
-
-    /* iterator 2 points to next event */
-    i2 = dbp_iterator_new_from_thread( thr );
-    e2 = dbp_iterator_next( i2 );
-
-    while( NULL != e2 ) {
-        key2 = dbp_event_get_key(e2);
-
-        /* if e2 is end event, but e1 doesn't match, e2 not in expected order
-         * store e2 position in cache to lookup later for potential match */
-        if( KEY_IS_END(key2) && !dbp_events_match(e1, e2) ) {
-            cache_key = &thr->cache.keys[BASE_KEY(key2)];
-
-            cache_index = cache_key->len++;
-            /* if index == size, we need to grow the array */
-            if( cache_index == cache_key->size ) {
-                /* if size == 0, this is the first mismatched event with this key */
-                cache_key->size = cache_key->size ? cache_key->size * 2 :
-                                                    EVENT_CACHE_MIN_ALLOC;
-                cache_key->items = realloc(cache_key->items, sizeof(event_cache_item_t[cache_key->size]));
+    memset(&prev, 0, sizeof(prev));
+    it = dbp_iterator_new_from_thread( thr );
+    for( e = dbp_iterator_current(it); NULL != e; e = dbp_iterator_next(it), index++ ) {
+        if( 0 == thr->cache.nb_buffers ||
+            thr->cache.buffers[thr->cache.nb_buffers-1].offset != it->current_buffer_position ) {
+            if( thr->cache.nb_buffers == size ) {
+                size = size ? 2 * size : EVENT_CACHE_MIN_ALLOC;
+                thr->cache.buffers = realloc(thr->cache.buffers, size * sizeof(buffer_index_item_t));
             }
+            b = &thr->cache.buffers[thr->cache.nb_buffers++];
+            b->offset      = it->current_buffer_position;
+            b->first_index = index;
+            b->first_time  = dbp_event_get_timestamp(e);
+        }
+        thr->cache.buffers[thr->cache.nb_buffers-1].last_time = dbp_event_get_timestamp(e);
+
+        /* if e is end event, but the previous event doesn't match, e not in
+         * expected order: store e position in cache to lookup later for
+         * potential match */
+        key = dbp_event_get_key(e);
+        if( KEY_IS_END(key) && ((0 == index) || !base_events_match(&prev, &e->native->event)) ) {
+            cache_unmatched_event(&thr->cache.keys[BASE_KEY(key)], it);
+        }
+        prev = e->native->event;
+    }
+    dbp_iterator_delete( it );
+
+    /* set cache to done - it doesn't need to be rebuilt */
+    thr->cache.done = 1;
 
-            /* cache timestamp and buffer offset for this event
-             * note that we don't store the exact index of the event,
-             * so a consumer should make sure to search through the buffer */
-            cache_item = &cache_key->items[cache_index];
+build_index_done:
+    pthread_mutex_unlock(&thr->cache.mtx);
+}
 
-            /* event pos it always less than event_avail_space
-             * and buffer offset is always a multiple of event_buffer_size
-             * so these can be combined together and recovered */
-            assert( i2->current_event_position >= 0 );
-            assert( i2->current_event_position < event_avail_space );
-            assert( (i2->current_buffer_position % event_buffer_size) == 0 );
+/**
+ * The index of a trace file is stored next to it, in <trace>.idx, and
+ * is reused as long as the trace is not modified. For each thread: the
+ * number of events buffers and their index, then for each key the number
+ * of unmatched end events and their cache.
+ */
+#define DBP_INDEX_MAGICK "#PARSEC DBP INDEX 2"
+
+typedef struct {
+    char    magick[24];
+    int64_t trace_size;
+    int64_t trace_mtime;
+    int32_t buffer_size;
+    int32_t nb_threads;
+    int32_t nb_keys;
+    int32_t padding;
+} dbp_index_header_t;
+
+static int index_header_init(const dbp_file_t *file, dbp_index_header_t *head)
+{
+    struct stat st;
+
+    if( 0 != fstat(file->fd, &st) )
+        return -1;
+    memset(head, 0, sizeof(dbp_index_header_t));
+    strncpy(head->magick, DBP_INDEX_MAGICK, sizeof(head->magick) - 1);
+    head->trace_size  = st.st_size;
+    head->trace_mtime = st.st_mtime;
+    head->buffer_size = event_buffer_size;
+    head->nb_threads  = file->nb_threads;
+    head->nb_keys     = file->nb_dico_map;
+    return 0;
+}
 
-            offset = i2->current_buffer_position + i2->current_event_position;
-            cache_item->timestamp = dbp_event_get_timestamp(e2);
-            cache_item->offset    = offset;
-            cache_item->event_idx = i2->current_event_index;
+static void save_file_index(const dbp_file_t *file)
+{
+    char path[strlen(file->filename) + 32], tmp[strlen(file->filename) + 32];
+    dbp_index_header_t head;
+    const event_cache_t *cache;
+    int t, k, ok = 1;
+    FILE *f;
+
+    for( t = 0; t < file->nb_threads; t++ )
+        if( !file->threads[t].cache.done ) return;
+    if( 0 != index_header_init(file, &head) ) return;
+
+    snprintf(path, sizeof(path), "%s.idx", file->filename);
+    snprintf(tmp, sizeof(tmp), "%s.idx.%d", file->filename, (int)getpid());
+    /* The index is only a cache: no error if it cannot be written */
+    if( NULL == (f = fopen(tmp, "w")) )
+        return;
+    ok = (1 == fwrite(&head, sizeof(head), 1, f));
+    for( t = 0; ok && t < file->nb_threads; t++ ) {
+        cache = &file->threads[t].cache;
+        ok = (1 == fwrite(&cache->nb_buffers, sizeof(int64_t), 1, f)) &&
+             ((size_t)cache->nb_buffers == fwrite(cache->buffers, sizeof(buffer_index_item_t), cache->nb_buffers, f));
+        for( k = 0; ok && k < file->nb_dico_map; k++ ) {
+            int64_t len = cache->keys[k].len;
+            ok = (1 == fwrite(&len, sizeof(int64_t), 1, f)) &&
+                 (cache->keys[k].len == fwrite(cache->keys[k].items, sizeof(event_cache_item_t), len, f));
+        }
+    }
+    ok = (0 == fclose(f)) && ok;
+    if( !ok || 0 != rename(tmp, path) )
+        unlink(tmp);
+}
 
-            assert( (offset % event_buffer_size) == i2->current_event_position);
+static void load_file_index(dbp_file_t *file)
+{
+    char path[strlen(file->filename) + 32];
+    dbp_index_header_t head, expected;
+    event_cache_t *cache;
+    int64_t len;
+    int t, k, ok;
+    FILE *f;
+
+    if( 0 != index_header_init(file, &expected) ) return;
+    snprintf(path, sizeof(path), "%s.idx", file->filename);
+    if( NULL == (f = fopen(path, "r")) )
+        return;
+    ok = (1 == fread(&head, sizeof(head), 1, f)) && (0 == memcmp(&head, &expected, sizeof(head)));
+    for( t = 0; ok && t < file->nb_threads; t++ ) {
+        cache = &file->threads[t].cache;
+        ok = (1 == fread(&len, sizeof(int64_t), 1, f)) && (len >= 0);
+        if( !ok ) break;
+        cache->nb_buffers = len;
+        cache->buffers = malloc((len > 0 ? len : 1) * sizeof(buffer_index_item_t));
+        ok = ((size_t)len == fread(cache->buffers, sizeof(buffer_index_item_t), len, f));
+        for( k = 0; ok && k < file->nb_dico_map; k++ ) {
+            ok = (1 == fread(&len, sizeof(int64_t), 1, f)) && (len >= 0);
+            if( !ok || 0 == len ) continue;
+            cache->keys[k].items = malloc(len * sizeof(event_cache_item_t));
+            cache->keys[k].len = cache->keys[k].size = len;
+            ok = ((size_t)len == fread(cache->keys[k].items, sizeof(event_cache_item_t), len, f));
         }
+    }
+    fclose(f);
+
+    /* Discard an index that could only be read in part */
+    for( t = 0; t < file->nb_threads; t++ ) {
+        cache = &file->threads[t].cache;
+        cache->done = ok;
+        if( ok ) continue;
+        free(cache->buffers);
+        cache->buffers = NULL;
+        cache->nb_buffers = 0;
+        for( k = 0; k < file->nb_dico_map; k++ ) {
+            free(cache->keys[k].items);
+            memset(&cache->keys[k], 0, sizeof(event_cache_key_t));
+        }
+    }
+    file->index_loaded = ok;
+}
+
+typedef struct {
+    dbp_multifile_reader_t *dbp;
+    pthread_mutex_t         lock;
+    int                     next_file;
+    int                     next_thread;
+} index_work_t;
 
-        /* advance both iterators */
-        e1 = dbp_iterator_next( i1 );
-        e2 = dbp_iterator_next( i2 );
+static void *index_worker(void *arg)
+{
+    index_work_t *work = (index_work_t*)arg;
+    dbp_file_t *file;
+    dbp_thread_t *thr;
+
+    while( 1 ) {
+        thr = NULL;
+        pthread_mutex_lock(&work->lock);
+        while( work->next_file < work->dbp->nb_files ) {
+            file = &work->dbp->files[work->next_file];
+            if( SUCCESS == file->error && work->next_thread < file->nb_threads ) {
+                thr = &file->threads[work->next_thread++];
+                break;
+            }
+            work->next_file++;
+            work->next_thread = 0;
+        }
+        pthread_mutex_unlock(&work->lock);
+        if( NULL == thr )
+            return NULL;
+        build_thread_index(thr);
     }
+}
 
-    dbp_iterator_delete( i1 );
-    dbp_iterator_delete( i2 );
+int dbp_reader_index(dbp_multifile_reader_t *dbp, int nb_workers)
+{
+    index_work_t work;
+    pthread_t *workers;
+    int i, nb_started;
 
-    /* set cache to done - it doesn't need to be rebuilt */
-    thr->cache.done = 1;
+    if( nb_workers <= 0 ) {
+        nb_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if( nb_workers <= 0 ) nb_workers = 1;
+    }
+    work.dbp = dbp;
+    work.next_file = 0;
+    work.next_thread = 0;
+    pthread_mutex_init(&work.lock, NULL);
+
+    workers = (pthread_t*)malloc(nb_workers * sizeof(pthread_t));
+    for( nb_started = 0; nb_started < nb_workers - 1; nb_started++ ) {
+        if( 0 != pthread_create(&workers[nb_started], NULL, index_worker, &work) )
+            break;
+    }
+    index_worker(&work);
+    for( i = 0; i < nb_started; i++ )
+        pthread_join(workers[i], NULL);
+    free(workers);
+    pthread_mutex_destroy(&work.lock);
+
+    for( i = 0; i < dbp->nb_files; i++ ) {
+        if( SUCCESS == dbp->files[i].error && !dbp->files[i].index_loaded )
+            save_file_index(&dbp->files[i]);
+    }
+    return 0;
+}
 
-build_events_done:
-    pthread_mutex_unlock(&thr->cache.mtx);
+dbp_event_iterator_t *dbp_iterator_new_from_time(const dbp_thread_t *th, uint64_t time)
+{
+    dbp_event_iterator_t *res = dbp_iterator_new(th);
+    const event_cache_t *cache = &th->cache;
+    const dbp_event_t *e;
+    int64_t lo = 0, hi, mid;
+
+    build_thread_index((dbp_thread_t*)th);
+    /* the first buffer that ends at or after time */
+    hi = cache->nb_buffers;
+    while( lo < hi ) {
+        mid = (lo + hi) / 2;
+        if( cache->buffers[mid].last_time < time )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if( lo == cache->nb_buffers ) {
+        /* set iterator to past-the-end */
+        dbp_iterator_set_offset(res, (off_t)-1);
+        return res;
+    }
+    e = dbp_iterator_set_offset(res, cache->buffers[lo].offset);
+    while( NULL != e && dbp_event_get_timestamp(e) < time )
+        e = dbp_iterator_next(res);
+    return res;
+}
+
+int dbp_thread_time_range(const dbp_thread_t *th, uint64_t *first, uint64_t *last)
+{
+    build_thread_index((dbp_thread_t*)th);
+    if( 0 == th->cache.nb_buffers )
+        return 0;
+    *first = th->cache.buffers[0].first_time;
+    *last = th->cache.buffers[th->cache.nb_buffers-1].last_time;
+    return 1;
 }
 
 typedef struct {
@@ -547,10 +860,10 @@ dbp_event_find_in_cache(const dbp_thread_t *thr,
     bsearch_key_t      bsearch_key = { ref, NULL };
 
     /* ensure we have an unmatched event cache
-     * casts away const because build_unmatched_events_in_thread modifies thr
+     * casts away const because build_thread_index modifies thr
      * thr should be memory we allocated anyway though, so this should be safe
      * ... right? */
-    build_unmatched_events_in_thread((dbp_thread_t*)thr);
+    build_thread_index((dbp_thread_t*)thr);
 
     /* do binary search in cache of key for events at ref timestamp
      * we throw away the results of the search, because it's very unlikely to
@@ -592,6 +905,12 @@ int dbp_iterator_move_to_matching_event(dbp_event_iterator_t *pos,
 
     /* iterate over all cached events containing possible matches */
     while( cache_item < &cache_key->items[cache_key->len] ) {
+        /* only visit the events with the same identifiers */
+        if( cache_item->event_id != dbp_event_get_event_id(ref) ||
+            cache_item->taskpool_id != dbp_event_get_taskpool_id(ref) ) {
+            cache_item++;
+            continue;
+        }
         /* we computed cache_item->offset as buffer_position + event_position,
          * so we must recover these values */
         event_pos = cache_item->offset % event_buffer_size;
@@ -612,6 +931,17 @@ int dbp_iterator_move_to_matching_event(dbp_event_iterator_t *pos,
     return 0;
 }
 
+/* the index of thr has unmatched end events of the key of ref, after ref */
+static int thread_may_match(const dbp_thread_t *thr, const dbp_event_t *ref)
+{
+    const event_cache_key_t *cache_key;
+
+    build_thread_index((dbp_thread_t*)thr);
+    cache_key = &thr->cache.keys[BASE_KEY(dbp_event_get_key(ref))];
+    return (cache_key->len > 0) &&
+           (cache_key->items[cache_key->len-1].timestamp >= dbp_event_get_timestamp(ref));
+}
+
 dbp_event_iterator_t *dbp_iterator_find_matching_event_all_threads(const dbp_event_iterator_t *pos)
 {
     dbp_event_iterator_t *it;
@@ -633,19 +963,21 @@ dbp_event_iterator_t *dbp_iterator_find_matching_event_all_threads(const dbp_eve
     dbp_iterator_delete(it);
 
     /* search through possibly matching events in this thread */
-    it = dbp_iterator_new_from_thread( pos->thread );
-    if( dbp_iterator_move_to_matching_event(it, ref) )
-        return it;
-    dbp_iterator_delete(it);
+    if( thread_may_match(pos->thread, ref) ) {
+        it = dbp_iterator_new( pos->thread );
+        if( dbp_iterator_move_to_matching_event(it, ref) )
+            return it;
+        dbp_iterator_delete(it);
+    }
 
     /* try other threads */
     for( tid = 0; tid < dbp_file_nb_threads(dbp_file); tid++) {
         thr = dbp_file_get_thread(dbp_file, tid);
-        /* skip same thread */
-        if( pos->thread == thr )
+        /* skip same thread, and the threads without a candidate */
+        if( pos->thread == thr || !thread_may_match(thr, ref) )
             continue;
         /* same logic as above */
-        it = dbp_iterator_new_from_thread( thr );
+        it = dbp_iterator_new( thr );
         if( dbp_iterator_move_to_matching_event(it, ref) )
             return it;
         dbp_iterator_delete(it);
@@ -733,6 +1065,26 @@ dbp_info_t *dbp_file_get_info(const dbp_file_t *file, int iid)
     return file->infos[iid];
 }
 
+double dbp_file_sampling_ratio(const dbp_file_t *file, const dbp_dictionary_t *dico)
+{
+    const char *name = dbp_dictionary_name(dico);
+    double rate = 0.0, window = 1000.0;
+    int i;
+
+    for(i = 0; i < file->nb_infos; i++) {
+        const char *key = file->infos[i]->key;
+        if( !strncmp(key, "SAMPLE_RATE:", 12) && !strcmp(key + 12, name) ) {
+            rate = atof(file->infos[i]->value);
+        } else if( !strcmp(key, "SAMPLE_WINDOW") ) {
+            window = atof(file->infos[i]->value);
+        }
+    }
+    /* The entries without a rate were not sampled */
+    if( rate <= 0.0 )
+        return 1.0;
+    return window / (1000.0 * rate);
+}
+
 dbp_file_t *dbp_reader_get_file(const dbp_multifile_reader_t *dbp, int fid)
 {
     assert(fid >= 0 && fid < dbp->nb_files );
@@ -997,6 +1349,8 @@ static int read_threads(dbp_file_t *dbp, const parsec_profiling_binary_file_head
         pthread_mutex_init(&thr->cache.mtx, NULL);
         thr->cache.keys = (event_cache_key_t*)calloc(
                dbp_file_nb_dictionary_entries(dbp), sizeof(event_cache_key_t));
+        thr->cache.buffers = NULL;
+        thr->cache.nb_buffers = 0;
         thr->cache.done  = 0;
 
         pos += sizeof(parsec_profiling_stream_buffer_t) - sizeof(parsec_profiling_info_buffer_t);
@@ -1060,6 +1414,7 @@ static dbp_multifile_reader_t *open_files(int nbfiles, char **filenames)
         dbp->files[n].parent = dbp;
         dbp->files[n].fd = fd;
         dbp->files[n].nb_infos = 0;
+        dbp->files[n].index_loaded = 0;
 
         if( (p = read( fd, &head, sizeof(parsec_profiling_binary_file_header_t) )) != sizeof(parsec_profiling_binary_file_header_t) ) {
             fprintf(stderr, "read %d bytes\n", p);
@@ -1124,6 +1479,8 @@ static dbp_multifile_reader_t *open_files(int nbfiles, char **filenames)
             goto close_and_continue;
         }
 
+        load_file_index(&dbp->files[n]);
+
       close_and_continue:
         if( SUCCESS != dbp->files[n].error ) {
             close(fd);
@@ -25,6 +25,10 @@ int dbp_reader_nb_dictionary_entries(const dbp_multifile_reader_t *dbp);
 int dbp_reader_last_error(const dbp_multifile_reader_t *dbp);
 void dbp_reader_close_files(dbp_multifile_reader_t *dbp);
 void dbp_reader_destruct(dbp_multifile_reader_t *dbp);
+/* Index the threads of all the files with nb_workers threads (all the cores
+ * if nb_workers <= 0), and store the index of each file next to it. The
+ * threads that are not indexed yet are indexed on demand. */
+int dbp_reader_index(dbp_multifile_reader_t *dbp, int nb_workers);
 
 /* Dictionary interface */
 
@@ -50,6 +54,8 @@ int dbp_file_nb_infos(const dbp_file_t *file);
 int dbp_file_nb_dictionary_entries(const dbp_file_t *file);
 int dbp_file_error(const dbp_file_t *file);
 dbp_info_t *dbp_file_get_info(const dbp_file_t *file, int iid);
+/* Fraction of the instances of the dictionary entry traced when sampling */
+double dbp_file_sampling_ratio(const dbp_file_t *file, const dbp_dictionary_t *dico);
 
 /* Single DBP thread interface */
 
@@ -60,6 +66,8 @@ int dbp_thread_nb_events(const dbp_thread_t *th);
 int dbp_thread_nb_infos(const dbp_thread_t *th);
 char *dbp_thread_get_hr_id(const dbp_thread_t *th);
 dbp_info_t *dbp_thread_get_info(const dbp_thread_t *th, int iid);
+/* Time of the first and last events of the thread; 0 if it has no event */
+int dbp_thread_time_range(const dbp_thread_t *th, uint64_t *first, uint64_t *last);
 
 /* Events iteration */
 typedef struct dbp_event dbp_event_t;
@@ -67,6 +75,8 @@ typedef struct dbp_event dbp_event_t;
 typedef struct dbp_event_iterator dbp_event_iterator_t;
 dbp_event_iterator_t *dbp_iterator_new_from_thread(const dbp_thread_t *th);
 dbp_event_iterator_t *dbp_iterator_new_from_iterator(const dbp_event_iterator_t *it);
+/* Iterator on the first event of the thread at or after time, found with the index */
+dbp_event_iterator_t *dbp_iterator_new_from_time(const dbp_thread_t *th, uint64_t time);
 const dbp_event_t *dbp_iterator_current(dbp_event_iterator_t *it);
 const dbp_event_t *dbp_iterator_first(dbp_event_iterator_t *it);
 const dbp_event_t *dbp_iterator_next(dbp_event_iterator_t *it);
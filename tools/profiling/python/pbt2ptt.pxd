@@ -44,6 +44,7 @@ cdef extern from "dbpreader.h":
    int dbp_reader_last_error(const dbp_multifile_reader_t *dbp)
    void dbp_reader_close_files(dbp_multifile_reader_t * dbp)
    void dbp_reader_destruct(dbp_multifile_reader_t * dbp)
+   int dbp_reader_index(dbp_multifile_reader_t * dbp, int nb_workers)
 
    dbp_dictionary_t * dbp_file_get_dictionary(dbp_file_t * file, int did)
    dbp_dictionary_t * dbp_reader_get_dictionary(dbp_multifile_reader_t * dbp, int did)
@@ -70,8 +71,10 @@ cdef extern from "dbpreader.h":
    int dbp_thread_nb_infos(dbp_thread_t *th)
    char * dbp_thread_get_hr_id(dbp_thread_t *th)
    dbp_info_t *dbp_thread_get_info(dbp_thread_t *th, int iid)
+   int dbp_thread_time_range(dbp_thread_t *th, uint64_t *first, uint64_t *last)
 
    dbp_event_iterator_t *dbp_iterator_new_from_thread(dbp_thread_t *th)
+   dbp_event_iterator_t *dbp_iterator_new_from_time(dbp_thread_t *th, uint64_t time)
    dbp_event_iterator_t *dbp_iterator_new_from_iterator(dbp_event_iterator_t *it)
    dbp_event_t *dbp_iterator_current(dbp_event_iterator_t *it)
    dbp_event_t *dbp_iterator_first(dbp_event_iterator_t *it)
@@ -109,6 +109,9 @@ cpdef read(filenames, report_progress=False, skeleton_only=False, multiprocess=F
         multiprocess = 1
     if skeleton_only:
         multiprocess = 1
+    else:
+        # build (or load) the index of the traces once, the processes reuse it
+        dbp_reader_index(dbp, multiprocess)
 
     nb_dict_entries = dbp_reader_nb_dictionary_entries(dbp)
     nb_files = dbp_reader_nb_files(dbp)